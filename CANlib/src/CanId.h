@@ -24,6 +24,7 @@ enum class CanMessageType : uint16_t
 	//unused_was_movement = 50,
 	movementLinear = 51,
 	movementLinearShaped = 52,
+	movementLinearBatch = 53,
 
 	// High priority responses sent by expansion boards and Smart Tools
 	inputStateChanged = 100,
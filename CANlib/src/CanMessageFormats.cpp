@@ -9,11 +9,12 @@
 #include "General/StringFunctions.h"
 #include <cinttypes>
 #include <cstring>
+#include <cmath>
 
 extern "C" void debugPrintf(const char* fmt, ...) noexcept __attribute__ ((format (printf, 1, 2)));
 
 // Round up a message length to the size that will actually be sent. Used to ensure that we include trailing null terminators.
-size_t CanAdjustedLength(size_t rawLength)
+size_t CanAdjustedLength(size_t rawLength) noexcept
 {
 	return (rawLength <= 8) ? rawLength
 			: (rawLength <= 24) ? (rawLength + 3) & ~3
@@ -38,8 +39,8 @@ void CanMessageMovement::DebugPrint() const noexcept
 
 void CanMessageMovementLinear::DebugPrint() const noexcept
 {
-	debugPrintf("Can: %08" PRIx32 " %" PRIu32 " %" PRIu32 " %" PRIu32 " %f %f:",
-		whenToExecute, accelerationClocks, steadyClocks, decelClocks, (double)initialSpeedFraction, (double)finalSpeedFraction);
+	debugPrintf("Can: %08" PRIx32 " %" PRIu32 " %" PRIu32 " %" PRIu32 " %f %f %u:",
+		whenToExecute, accelerationClocks, steadyClocks, decelClocks, (double)initialSpeedFraction, (double)finalSpeedFraction, (unsigned int)smoothingClocksDiv32 * 32);
 	for (size_t i = 0; i < numDrivers; ++i)
 	{
 		debugPrintf(" %" PRIi32, perDrive[i].steps);
@@ -47,6 +48,143 @@ void CanMessageMovementLinear::DebugPrint() const noexcept
 	debugPrintf("\n");
 }
 
+void CanMessageMovementLinearBatch::DebugPrint() const noexcept
+{
+	debugPrintf("CanB: %08" PRIx32 " %u segments %u drivers %u:\n", whenToExecute, numSegments, (unsigned int)numDrivers, (unsigned int)smoothingClocksDiv32 * 32);
+	CanMessageMovementLinear move;
+	for (unsigned int i = 0; GetSegment(i, move); ++i)
+	{
+		move.DebugPrint();
+	}
+}
+
+// Start a new batch with the settings of the first move to be added to it
+void CanMessageMovementLinearBatch::Init(const CanMessageMovementLinear& firstMove) noexcept
+{
+	whenToExecute = firstMove.whenToExecute;
+	pressureAdvanceDrives = firstMove.pressureAdvanceDrives;
+	numDrivers = firstMove.numDrivers;
+	seq = 0;
+	smoothingClocksDiv32 = firstMove.smoothingClocksDiv32;
+	smoothAccel = firstMove.smoothAccel;
+	smoothDecel = firstMove.smoothDecel;
+	numSegments = 0;
+}
+
+// Return the time at which the last segment in the batch ends
+uint32_t CanMessageMovementLinearBatch::GetEndTime() const noexcept
+{
+	uint32_t endTime = whenToExecute;
+	const uint8_t *p = data;
+	for (unsigned int i = 0; i < numSegments; ++i)
+	{
+		endTime += LoadLE16(p) + LoadLE16(p + 2) + LoadLE16(p + 4) + LoadLE16(p + 6);
+		p += GetSegmentLength();
+	}
+	return endTime;
+}
+
+// Try to add a move to the batch. Return false if it is not compatible with the batch, can't be represented in 16 bits, or there is no room.
+bool CanMessageMovementLinearBatch::AddSegment(const CanMessageMovementLinear& move) noexcept
+{
+	if (   numSegments >= MaxSegments
+		|| GetActualDataLength() + GetSegmentLength() > MaxDataLength
+		|| move.numDrivers != numDrivers
+		|| move.pressureAdvanceDrives != pressureAdvanceDrives
+		|| move.smoothingClocksDiv32 != smoothingClocksDiv32 || move.smoothAccel != smoothAccel || move.smoothDecel != smoothDecel
+		|| move.accelerationClocks > UINT16_MAX || move.steadyClocks > UINT16_MAX || move.decelClocks > UINT16_MAX
+	   )
+	{
+		return false;
+	}
+
+	const long initialSpeedFractionRaw = lrintf(move.initialSpeedFraction * SpeedFractionUnit);
+	const long finalSpeedFractionRaw = lrintf(move.finalSpeedFraction * SpeedFractionUnit);
+	if (initialSpeedFractionRaw < 0 || initialSpeedFractionRaw > UINT16_MAX || finalSpeedFractionRaw < 0 || finalSpeedFractionRaw > UINT16_MAX)
+	{
+		return false;
+	}
+
+	const uint32_t gap = move.whenToExecute - ((numSegments == 0) ? whenToExecute : GetEndTime());
+	if (gap > UINT16_MAX)
+	{
+		return false;												// this also catches moves that start before the end of the previous one
+	}
+
+	for (size_t drive = 0; drive < numDrivers; ++drive)
+	{
+		if (move.perDrive[drive].steps < INT16_MIN || move.perDrive[drive].steps > INT16_MAX)
+		{
+			return false;
+		}
+	}
+
+	uint8_t *p = data + numSegments * GetSegmentLength();
+	StoreLE16(p, (uint16_t)gap);
+	StoreLE16(p + 2, (uint16_t)move.accelerationClocks);
+	StoreLE16(p + 4, (uint16_t)move.steadyClocks);
+	StoreLE16(p + 6, (uint16_t)move.decelClocks);
+	StoreLE16(p + 8, (uint16_t)initialSpeedFractionRaw);
+	StoreLE16(p + 10, (uint16_t)finalSpeedFractionRaw);
+	p += 12;
+	for (size_t drive = 0; drive < numDrivers; ++drive)
+	{
+		StoreLE16(p, (uint16_t)(int16_t)move.perDrive[drive].steps);
+		p += 2;
+	}
+	++numSegments;
+	return true;
+}
+
+// Decode a segment of the batch into a linear movement message. Return false if there is no such segment.
+bool CanMessageMovementLinearBatch::GetSegment(unsigned int segmentNumber, CanMessageMovementLinear& move) const noexcept
+{
+	if (segmentNumber >= numSegments)
+	{
+		return false;
+	}
+
+	uint32_t startTime = whenToExecute;
+	const uint8_t *p = data;
+	for (unsigned int i = 0; ; ++i)
+	{
+		startTime += LoadLE16(p);
+		if (i == segmentNumber)
+		{
+			break;
+		}
+		startTime += LoadLE16(p + 2) + LoadLE16(p + 4) + LoadLE16(p + 6);
+		p += GetSegmentLength();
+	}
+
+	move.whenToExecute = startTime;
+	move.accelerationClocks = LoadLE16(p + 2);
+	move.steadyClocks = LoadLE16(p + 4);
+	move.decelClocks = LoadLE16(p + 6);
+	move.initialSpeedFraction = (float)LoadLE16(p + 8) / SpeedFractionUnit;
+	move.finalSpeedFraction = (float)LoadLE16(p + 10) / SpeedFractionUnit;
+	move.pressureAdvanceDrives = pressureAdvanceDrives;
+	move.numDrivers = numDrivers;
+	move.seq = seq;
+	move.smoothingClocksDiv32 = smoothingClocksDiv32;
+	move.smoothAccel = smoothAccel;
+	move.smoothDecel = smoothDecel;
+	p += 12;
+	for (size_t drive = 0; drive < MaxLinearDriversPerCanSlave; ++drive)
+	{
+		if (drive < numDrivers)
+		{
+			move.perDrive[drive].steps = (int16_t)LoadLE16(p);
+			p += 2;
+		}
+		else
+		{
+			move.perDrive[drive].Init();
+		}
+	}
+	return true;
+}
+
 void CanMessageGeneric::DebugPrint(const ParamDescriptor *pt) const noexcept
 {
 	if (pt == nullptr)
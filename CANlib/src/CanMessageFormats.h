@@ -158,7 +158,9 @@ struct __attribute__((packed)) CanMessageMovementLinear
 	uint32_t pressureAdvanceDrives : 8,				// which drivers have pressure advance applied
 			 numDrivers : 4,						// how many drivers we included
 			 seq : 7,								// sequence number
-			 zero : 13;								// unused
+			 smoothingClocksDiv32 : 11,				// acceleration smoothing time in units of 32 step clocks, or zero for trapezoidal acceleration. Older firmware sets this to zero.
+			 smoothAccel : 1,						// true if the main board smoothed the acceleration phase
+			 smoothDecel : 1;						// true if the main board smoothed the deceleration phase
 
 	float initialSpeedFraction;
 	float finalSpeedFraction;
@@ -231,6 +233,42 @@ struct __attribute__((packed)) CanMessageMovementLinearShaped
 	}
 };
 
+// Batched movement message. This holds several consecutive linear movements for one board, to reduce the number of messages sent when there are many short moves.
+// All the segments in a batch use the same drivers, pressure advance and acceleration smoothing settings. Each segment starts when the previous one ends plus a gap.
+// The segments are packed as little-endian 16-bit values: gap, acceleration, steady and deceleration clocks, initial and final speed fractions, then the steps for each driver.
+struct __attribute__((packed)) CanMessageMovementLinearBatch
+{
+	static constexpr CanMessageType messageType = CanMessageType::movementLinearBatch;
+	static constexpr size_t MaxDataLength = 64;
+	static constexpr size_t HeaderLength = 9;
+	static constexpr unsigned int MaxSegments = 8;
+	static constexpr uint32_t SpeedFractionUnit = 1u << 15;			// speed fractions are stored with this representing 1.0
+
+	uint32_t whenToExecute;							// when the first segment starts
+	uint32_t pressureAdvanceDrives : 8,				// which drivers have pressure advance applied
+			 numDrivers : 4,						// how many drivers we included
+			 seq : 7,								// sequence number
+			 smoothingClocksDiv32 : 11,				// acceleration smoothing time in units of 32 step clocks, or zero for trapezoidal acceleration
+			 smoothAccel : 1,						// true if the acceleration phases are smoothed
+			 smoothDecel : 1;						// true if the deceleration phases are smoothed
+	uint8_t numSegments;
+	uint8_t data[MaxDataLength - HeaderLength];
+
+	void SetRequestId(CanRequestId rid) noexcept { }			// these messages don't have RIDs, use the whenToExecute field to avoid duplication
+	void DebugPrint() const noexcept;
+
+	void Init(const CanMessageMovementLinear& firstMove) noexcept;
+	bool AddSegment(const CanMessageMovementLinear& move) noexcept;	// try to add a segment, returning false if it doesn't fit or can't be represented
+	bool GetSegment(unsigned int segmentNumber, CanMessageMovementLinear& move) const noexcept;	// decode a segment, returning false if there isn't one
+	uint32_t GetEndTime() const noexcept;
+	size_t GetSegmentLength() const noexcept { return 12 + 2 * numDrivers; }
+
+	size_t GetActualDataLength() const noexcept
+	{
+		return HeaderLength + numSegments * GetSegmentLength();
+	}
+};
+
 // Change CAN address and normal timing message
 struct __attribute__((packed)) CanMessageSetAddressAndNormalTiming
 {
@@ -849,6 +887,7 @@ constexpr ParamDescriptor M308NewParams[] =
 	CHAR_PARAM('K'),
 	REDUCED_STRING_PARAM('Y'),
 	REDUCED_STRING_PARAM('P'),
+	UINT16_PARAM('I'),
 	END_PARAMS
 };
 
@@ -987,7 +1026,8 @@ struct __attribute__((packed)) CanMessageAnnounce
 
 	uint32_t timeSinceStarted;				// how long since we started up
 	uint32_t numDrivers: 8,					// the number of motor drivers on this board
-			 zero : 24;						// for future expansion, set to zero
+			 acceptsMoveBatches : 1,		// set if the board accepts CanMessageMovementLinearBatch messages
+			 zero : 23;						// for future expansion, set to zero
 	char boardTypeAndFirmwareVersion[56];	// the type short name of this board followed by '|' and the firmware version
 
 	void SetRequestId(CanRequestId rid) noexcept { zero = 0;}	// these messages don't need RIDs
@@ -1197,6 +1237,7 @@ union CanMessage
 	CanMessageMovement move;
 #endif
 	CanMessageMovementLinear moveLinear;
+	CanMessageMovementLinearBatch moveLinearBatch;
 	CanMessageReturnInfo getInfo;
 	CanMessageSetHeaterTemperature setTemp;
 	CanMessageStandardReply standardReply;
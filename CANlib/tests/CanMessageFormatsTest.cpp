@@ -0,0 +1,160 @@
+/*
+ * CanMessageFormatsTest.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host test for the batched movement message encoder and decoder.
+ */
+
+#include <Check.h>
+#include <CanMessageFormats.h>
+#include <cmath>
+#include <cstdarg>
+
+// CanMessageFormats.cpp calls this to print messages
+extern "C" void debugPrintf(const char* fmt, ...) noexcept
+{
+	va_list vargs;
+	va_start(vargs, fmt);
+	std::vprintf(fmt, vargs);
+	va_end(vargs);
+}
+
+static CanMessageMovementLinear MakeMove(uint32_t whenToExecute, uint32_t accel, uint32_t steady, uint32_t decel, float initialFraction, float finalFraction,
+											unsigned int numDrivers, int32_t firstSteps) noexcept
+{
+	CanMessageMovementLinear move;
+	move.whenToExecute = whenToExecute;
+	move.accelerationClocks = accel;
+	move.steadyClocks = steady;
+	move.decelClocks = decel;
+	move.pressureAdvanceDrives = 0x04;
+	move.numDrivers = numDrivers;
+	move.seq = 0;
+	move.smoothingClocksDiv32 = 0;
+	move.smoothAccel = move.smoothDecel = 0;
+	move.initialSpeedFraction = initialFraction;
+	move.finalSpeedFraction = finalFraction;
+	for (size_t drive = 0; drive < MaxLinearDriversPerCanSlave; ++drive)
+	{
+		move.perDrive[drive].steps = (drive < numDrivers) ? firstSteps - 3 * (int32_t)drive : 0;
+	}
+	return move;
+}
+
+static bool SameMove(const CanMessageMovementLinear& a, const CanMessageMovementLinear& b) noexcept
+{
+	constexpr float SpeedFractionTolerance = 0.5f/(float)CanMessageMovementLinearBatch::SpeedFractionUnit;
+	if (   a.whenToExecute != b.whenToExecute || a.accelerationClocks != b.accelerationClocks || a.steadyClocks != b.steadyClocks || a.decelClocks != b.decelClocks
+		|| a.pressureAdvanceDrives != b.pressureAdvanceDrives || a.numDrivers != b.numDrivers
+		|| a.smoothingClocksDiv32 != b.smoothingClocksDiv32 || a.smoothAccel != b.smoothAccel || a.smoothDecel != b.smoothDecel
+		|| std::fabs(a.initialSpeedFraction - b.initialSpeedFraction) > SpeedFractionTolerance
+		|| std::fabs(a.finalSpeedFraction - b.finalSpeedFraction) > SpeedFractionTolerance
+	   )
+	{
+		return false;
+	}
+	for (size_t drive = 0; drive < a.numDrivers; ++drive)
+	{
+		if (a.perDrive[drive].steps != b.perDrive[drive].steps)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Encode some moves and check that they decode to the same moves, apart from quantisation of the speed fractions
+static void TestRoundTrip() noexcept
+{
+	const CanMessageMovementLinear moves[] =
+	{
+		MakeMove(1000000, 1200, 300, 1200, 0.0f, 0.8f, 2, 250),
+		MakeMove(1002700, 0, 5000, 800, 0.8f, 0.123457f, 2, -32000),		// starts as soon as the previous one ends
+		MakeMove(1008500 + 65535, 65535, 0, 0, 0.123457f, 1.0f, 2, 32767),	// the longest gap and the longest phase
+	};
+
+	CanMessageMovementLinearBatch batch;
+	batch.Init(moves[0]);
+	CHECK(batch.GetEndTime() == moves[0].whenToExecute);
+	for (const CanMessageMovementLinear& move : moves)
+	{
+		CHECK(batch.AddSegment(move));
+	}
+	CHECK(batch.numSegments == 3);
+	CHECK(batch.GetActualDataLength() <= CanMessageMovementLinearBatch::MaxDataLength);
+	CHECK(batch.GetEndTime() == moves[2].whenToExecute + 65535);
+
+	CanMessageMovementLinear decoded;
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		CHECK(batch.GetSegment(i, decoded));
+		CHECK(SameMove(decoded, moves[i]));
+		for (size_t drive = decoded.numDrivers; drive < MaxLinearDriversPerCanSlave; ++drive)
+		{
+			CHECK(decoded.perDrive[drive].steps == 0);
+		}
+	}
+	CHECK(!batch.GetSegment(3, decoded));
+
+	batch.Init(moves[1]);
+	CHECK(batch.numSegments == 0);
+	CHECK(!batch.GetSegment(0, decoded));
+}
+
+// Moves that the batch can't represent must be refused and must leave the batch unchanged
+static void TestRejections() noexcept
+{
+	const CanMessageMovementLinear first = MakeMove(5000, 100, 100, 100, 0.0f, 0.5f, 2, 10);
+	CanMessageMovementLinearBatch batch;
+	batch.Init(first);
+	CHECK(batch.AddSegment(first));
+
+	const uint32_t next = 5300;
+	CanMessageMovementLinear move = MakeMove(next, 100, 100, 100, 0.5f, 0.5f, 3, 10);
+	CHECK(!batch.AddSegment(move));										// different number of drivers
+
+	move = MakeMove(next, 100, 100, 100, 0.5f, 0.5f, 2, 10);
+	move.pressureAdvanceDrives = 0;
+	CHECK(!batch.AddSegment(move));										// different pressure advance drivers
+
+	move = MakeMove(next, 100, 100, 100, 0.5f, 0.5f, 2, 10);
+	move.smoothingClocksDiv32 = 5;
+	CHECK(!batch.AddSegment(move));										// different smoothing time
+
+	move = MakeMove(next, 100, 100, 100, 0.5f, 0.5f, 2, 10);
+	move.smoothDecel = 1;
+	CHECK(!batch.AddSegment(move));										// different smoothed phases
+
+	CHECK(!batch.AddSegment(MakeMove(next, 65536, 100, 100, 0.5f, 0.5f, 2, 10)));		// clocks too large
+	CHECK(!batch.AddSegment(MakeMove(next, 100, 100, 100, 0.5f, 2.1f, 2, 10)));		// speed fraction too large
+	CHECK(!batch.AddSegment(MakeMove(next, 100, 100, 100, -0.1f, 0.5f, 2, 10)));		// negative speed fraction
+	CHECK(!batch.AddSegment(MakeMove(next, 100, 100, 100, 0.5f, 0.5f, 2, 32768)));	// too many steps
+	CHECK(!batch.AddSegment(MakeMove(next, 100, 100, 100, 0.5f, 0.5f, 2, -32766)));	// too many steps in reverse on the second driver
+	CHECK(!batch.AddSegment(MakeMove(next - 1, 100, 100, 100, 0.5f, 0.5f, 2, 10)));	// starts before the previous move ends
+	CHECK(!batch.AddSegment(MakeMove(next + 65536, 100, 100, 100, 0.5f, 0.5f, 2, 10)));	// gap too long
+	CHECK(batch.numSegments == 1);
+
+	// Fill the batch, then check that it refuses one more
+	unsigned int added = 1;
+	uint32_t when = next;
+	while (batch.AddSegment(MakeMove(when, 100, 100, 100, 0.5f, 0.5f, 2, 10)))
+	{
+		++added;
+		when += 300;
+	}
+	CHECK(added == batch.numSegments);
+	CHECK(added == CanMessageMovementLinearBatch::MaxSegments || batch.GetActualDataLength() + batch.GetSegmentLength() > CanMessageMovementLinearBatch::MaxDataLength);
+	CHECK(batch.GetActualDataLength() <= CanMessageMovementLinearBatch::MaxDataLength);
+	CHECK(batch.GetEndTime() == when);
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestRejections();
+	return CheckResult("CanMessageMovementLinearBatch");
+}
+
+// End
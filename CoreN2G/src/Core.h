@@ -214,11 +214,20 @@ uint32_t DelayCycles(uint32_t start, uint32_t cycles) noexcept;
  *
  * @return The cycle counter
  */
+#ifdef HOST_SIM
+
+// In the host simulation the SysTick counter doesn't run, so the cycle counter is derived from the simulated time
+uint32_t GetCurrentCycles() noexcept;
+
+#else
+
 static inline uint32_t GetCurrentCycles() noexcept
 {
 	return SysTick->VAL & 0x00FFFFFF;
 }
 
+#endif
+
 /**
  * @brief Get the elapsed time in clock cycles between a start time and an end time, assuming it is below 1ms
  * @param startTime The start time, obtained by a call to GetCurrentCycles
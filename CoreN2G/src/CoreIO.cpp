@@ -31,6 +31,29 @@
 #endif
 
 
+#ifdef HOST_SIM
+
+// The simulated SysTick counter counts down from the reload value once per millisecond, like the real one
+extern "C" uint32_t GetCurrentCycles() noexcept
+{
+	const uint32_t reload = (SysTick->LOAD & 0x00FFFFFF) + 1;
+	const uint64_t cyclesSinceStart = (ullPortGetSimulatedTime() * (SystemCoreClockFreq/1000000))/1000;
+	return reload - 1 - (uint32_t)(cyclesSinceStart % reload);
+}
+
+// Busy-waiting would take real time, so advance the simulated time instead
+extern "C" uint32_t DelayCycles(uint32_t start, uint32_t cycles) noexcept
+{
+	const uint32_t elapsed = GetElapsedCycles(start);
+	if (cycles > elapsed)
+	{
+		vPortAdvanceSimulatedTime(((uint64_t)(cycles - elapsed) * 1000)/(SystemCoreClockFreq/1000000));
+	}
+	return GetCurrentCycles();
+}
+
+#else
+
 // Delay for a specified number of CPU clock cycles from the starting time. Return the time at which we actually stopped waiting.
 extern "C" uint32_t DelayCycles(uint32_t start, uint32_t cycles) noexcept
 {
@@ -81,6 +104,8 @@ extern "C" uint32_t DelayCycles(uint32_t start, uint32_t cycles) noexcept
 	}
 }
 
+#endif
+
 /**
  * @brief Set the function of an I/O pin
  *
@@ -513,6 +538,8 @@ void Reset() noexcept
 {
 #if SAME70 || SAM4E || SAM4S
 	rstc_start_software_reset(RSTC);
+#elif defined(HOST_SIM)
+	exit(0);
 #else
 	SCB->AIRCR = (0x5FA << 16) | (1u << 2);						// reset the processor
 #endif
@@ -653,7 +680,7 @@ AnalogChannelNumber PinToSdAdcChannel(Pin p) noexcept
 // Core random number generator
 extern "C" uint32_t random32() noexcept
 {
-#if SAME5x
+#if SAME5x && !defined(HOST_SIM)
 
 	// Use the true random number generator peripheral
 	while (!hri_trng_get_INTFLAG_reg(TRNG, TRNG_INTFLAG_DATARDY)) { }		// Wait until data ready
@@ -260,9 +260,11 @@ union CallbackParameter
 
 	CallbackParameter(void *pp) noexcept : vp(pp) { }
 	CallbackParameter(uint32_t pp) noexcept : u32(pp) { }
-	CallbackParameter(unsigned int p) noexcept { u32 = p; }
 	CallbackParameter(int32_t pp) noexcept : i32(pp) { }
+#ifndef HOST_SIM			// on a 64-bit host, uint32_t and int32_t are unsigned int and int
+	CallbackParameter(unsigned int p) noexcept { u32 = p; }
 	CallbackParameter(int p) noexcept { i32 = p; }
+#endif
 	CallbackParameter() noexcept : u32(0) { }
 };
 
@@ -0,0 +1,156 @@
+/*
+ * AnalogIn.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation of the analog input subsystem. Each input returns a fixed reading that the application can set by calling
+ *  HostSim::SetAnalogReading. The AIN task calls the callback functions at the requested intervals, as it does on the target.
+ */
+
+#ifdef RTOS
+
+#include <CoreIO.h>
+#include "AnalogIn.h"
+#include <HostSim.h>
+#include <RTOSIface/RTOSIface.h>
+
+constexpr size_t NumAdcs = 2;
+constexpr size_t NumAdcChannels = 32;				// number of channels per ADC including temperature sensor inputs etc.
+
+struct SimulatedChannel
+{
+	AnalogInCallbackFunction callbackFunction;
+	CallbackParameter callbackParam;
+	uint32_t ticksPerCall;
+	uint32_t ticksAtLastCall;
+	uint16_t reading;
+	bool enabled;
+};
+
+static SimulatedChannel channels[NumAdcs][NumAdcChannels];
+static uint32_t conversionsCompleted = 0;
+
+static SimulatedChannel *GetChannel(AdcInput adcin) noexcept
+{
+	const unsigned int deviceNumber = GetDeviceNumber(adcin);
+	return (deviceNumber < NumAdcs) ? &channels[deviceNumber][GetInputNumber(adcin)] : nullptr;
+}
+
+void HostSim::SetAnalogReading(AdcInput adcin, uint16_t reading) noexcept
+{
+	SimulatedChannel * const ch = GetChannel(adcin);
+	if (ch != nullptr)
+	{
+		ch->reading = reading;
+	}
+}
+
+constexpr uint32_t MaxTaskDelay = 10;				// the longest we wait before looking for callbacks, in case a channel is enabled meanwhile
+
+// Main loop executed by the AIN task. Each wakeup costs a task switch in the simulation, so we sleep until the next callback is due.
+void AnalogIn::TaskLoop(void *) noexcept
+{
+	for (;;)
+	{
+		uint32_t ticksToWait = MaxTaskDelay;
+		{
+			TaskCriticalSectionLocker lock;
+			const uint32_t now = millis();
+			for (auto& adc : channels)
+			{
+				for (SimulatedChannel& ch : adc)
+				{
+					if (ch.enabled && ch.callbackFunction != nullptr)
+					{
+						if (now - ch.ticksAtLastCall >= ch.ticksPerCall)
+						{
+							ch.ticksAtLastCall = now;
+							ch.callbackFunction(ch.callbackParam, ch.reading);
+						}
+						ticksToWait = min<uint32_t>(ticksToWait, max<uint32_t>(ch.ticksAtLastCall + ch.ticksPerCall - now, 1));
+					}
+				}
+			}
+			++conversionsCompleted;
+		}
+		delay(ticksToWait);
+	}
+}
+
+void AnalogIn::Init(NvicPriority interruptPriority) noexcept
+{
+}
+
+void AnalogIn::Exit() noexcept
+{
+}
+
+bool AnalogIn::EnableChannel(AdcInput adcin, AnalogInCallbackFunction fn, CallbackParameter param, uint32_t ticksPerCall, bool useAlternateAdc) noexcept
+{
+	SimulatedChannel * const ch = GetChannel(adcin);
+	if (ch == nullptr)
+	{
+		return false;
+	}
+
+	TaskCriticalSectionLocker lock;
+	ch->callbackFunction = fn;
+	ch->callbackParam = param;
+	ch->ticksPerCall = ticksPerCall;
+	ch->ticksAtLastCall = millis();
+	ch->enabled = true;
+	return true;
+}
+
+bool AnalogIn::SetCallback(AdcInput adcin, AnalogInCallbackFunction fn, CallbackParameter param, uint32_t ticksPerCall, bool useAlternateAdc) noexcept
+{
+	SimulatedChannel * const ch = GetChannel(adcin);
+	if (ch == nullptr || !ch->enabled)
+	{
+		return false;
+	}
+
+	TaskCriticalSectionLocker lock;
+	ch->callbackFunction = fn;
+	ch->callbackParam = param;
+	ch->ticksPerCall = ticksPerCall;
+	return true;
+}
+
+bool AnalogIn::IsChannelEnabled(AdcInput adcin, bool useAlternateAdc) noexcept
+{
+	const SimulatedChannel * const ch = GetChannel(adcin);
+	return ch != nullptr && ch->enabled;
+}
+
+void AnalogIn::DisableChannel(AdcInput adcin, bool useAlternateAdc) noexcept
+{
+	SimulatedChannel * const ch = GetChannel(adcin);
+	if (ch != nullptr)
+	{
+		ch->enabled = false;
+	}
+}
+
+uint16_t AnalogIn::ReadChannel(AdcInput adcin) noexcept
+{
+	const SimulatedChannel * const ch = GetChannel(adcin);
+	return (ch != nullptr) ? ch->reading : 0;
+}
+
+// The simulation has no MCU temperature sensors
+bool AnalogIn::EnableTemperatureSensor(unsigned int sensorNumber, AnalogInCallbackFunction fn, CallbackParameter param, uint32_t ticksPerCall, unsigned int adcnum) noexcept
+{
+	return false;
+}
+
+void AnalogIn::GetDebugInfo(uint32_t &convsStarted, uint32_t &convsCompleted, uint32_t &convTimeouts, uint32_t& errs) noexcept
+{
+	convsStarted = convsCompleted = conversionsCompleted;
+	convTimeouts = errs = 0;
+}
+
+#endif
+
+// End
@@ -0,0 +1,37 @@
+/*
+ * AnalogOut.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation of the analog output module. There are no TC or TCC peripherals to program, so we record the value last written
+ *  to each pin instead. A simulation of the device that the pin drives, for example a heater, can read it by calling HostSim::GetAnalogOutput.
+ */
+
+#include <AnalogOut.h>
+#include <HostSim.h>
+
+#include <cmath>
+
+static float outputValues[1u << (8 * sizeof(Pin))];
+
+// Initialise this module
+void AnalogOut::Init() noexcept
+{
+}
+
+// Write a PWM value to the specified pin
+void AnalogOut::Write(Pin pin, float val, PwmFrequency freq) noexcept
+{
+	if (pin != NoPin && !std::isnan(val))
+	{
+		outputValues[pin] = constrain<float>(val, 0.0, 1.0);
+	}
+}
+
+float HostSim::GetAnalogOutput(Pin pin) noexcept
+{
+	return (pin != NoPin) ? outputValues[pin] : 0.0;
+}
+
+// End
@@ -0,0 +1,44 @@
+/*
+ * Cache.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation of the cache controller. There is no cache to manage, because the simulated DMA controller never transfers data.
+ */
+
+#include <Cache.h>
+
+static bool enabled = false;
+
+void Cache::Init() noexcept
+{
+}
+
+void Cache::Enable() noexcept
+{
+	enabled = true;
+}
+
+bool Cache::Disable() noexcept
+{
+	const bool wasEnabled = enabled;
+	enabled = false;
+	return wasEnabled;
+}
+
+void Cache::Invalidate(const volatile void *start, size_t length) noexcept
+{
+}
+
+uint32_t Cache::GetHitCount() noexcept
+{
+	return 0;
+}
+
+// Entry points that can be called from ASF C code
+void CacheFlushBeforeDMAReceive(const volatile void *start, size_t length) noexcept { Cache::FlushBeforeDMAReceive(start, length); }
+void CacheInvalidateAfterDMAReceive(const volatile void *start, size_t length) noexcept { Cache::InvalidateAfterDMAReceive(start, length); }
+void CacheFlushBeforeDMASend(const volatile void *start, size_t length) noexcept { Cache::FlushBeforeDMASend(start, length); }
+
+// End
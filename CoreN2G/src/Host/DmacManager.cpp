@@ -0,0 +1,80 @@
+/*
+ * DmacManager.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation of the DMA controller. Channels can be configured and enabled but never transfer any data,
+ *  so clients that wait for a DMA transfer to complete see a timeout, as they would if the peripheral didn't respond.
+ */
+
+#include <DmacManager.h>
+
+void DmacManager::Init() noexcept
+{
+}
+
+void DmacManager::SetBtctrl(DmaChannel channel, uint16_t val) noexcept
+{
+}
+
+void DmacManager::SetSourceAddress(DmaChannel channel, const volatile void *const src) noexcept
+{
+}
+
+void DmacManager::SetDestinationAddress(DmaChannel channel, volatile void *const dst) noexcept
+{
+}
+
+void DmacManager::SetDataLength(DmaChannel channel, uint32_t amount) noexcept
+{
+}
+
+void DmacManager::SetTriggerSource(DmaChannel channel, DmaTrigSource source) noexcept
+{
+}
+
+void DmacManager::SetTriggerSourceSercomTx(DmaChannel channel, uint8_t sercomNumber) noexcept
+{
+}
+
+void DmacManager::SetTriggerSourceSercomRx(DmaChannel channel, uint8_t sercomNumber) noexcept
+{
+}
+
+void DmacManager::SetArbitrationLevel(DmaChannel channel, uint8_t level) noexcept
+{
+}
+
+void DmacManager::EnableChannel(DmaChannel channel, DmaPriority priority) noexcept
+{
+}
+
+bool DmacManager::DisableChannel(DmaChannel channel) noexcept
+{
+	return true;
+}
+
+void DmacManager::SetInterruptCallback(DmaChannel channel, DmaCallbackFunction fn, CallbackParameter param) noexcept
+{
+}
+
+void DmacManager::EnableCompletedInterrupt(DmaChannel channel) noexcept
+{
+}
+
+void DmacManager::DisableCompletedInterrupt(DmaChannel channel) noexcept
+{
+}
+
+uint8_t DmacManager::GetAndClearChannelStatus(DmaChannel channel) noexcept
+{
+	return 0;
+}
+
+uint16_t DmacManager::GetBytesTransferred(DmaChannel channel) noexcept
+{
+	return 0;
+}
+
+// End
@@ -0,0 +1,52 @@
+/*
+ * HostSim.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Interface between the host simulation port of CoreN2G and the client application.
+ *  The host port runs the SAME5x build of the application as a Linux process. Peripheral registers are ordinary memory mapped at the
+ *  addresses that the device headers use, so register writes are accepted and register reads return whatever was last written.
+ *  Peripherals whose behaviour the application depends on (the cycle counter, USB serial, analog inputs and outputs) are simulated here instead.
+ */
+
+#ifndef SRC_HOST_HOSTSIM_H_
+#define SRC_HOST_HOSTSIM_H_
+
+#include <CoreIO.h>
+
+namespace HostSim
+{
+	/**
+	 * @brief Set the reading that the simulated ADC returns for an analog input
+	 * @param adcin The analog input
+	 * @param reading The 16-bit reading
+	 */
+	void SetAnalogReading(AdcInput adcin, uint16_t reading) noexcept;
+
+	/**
+	 * @brief Get the value last written to an analog output
+	 * @param pin The output pin
+	 * @return The PWM value in the range 0.0 to 1.0, or 0.0 if nothing has been written to the pin
+	 */
+	float GetAnalogOutput(Pin pin) noexcept;
+}
+
+// Functions that the client application must provide in the host simulation
+
+/**
+ * @brief Process the command line. Called before AppInit.
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments
+ */
+extern void AppHostInit(int argc, char *argv[]) noexcept;
+
+/**
+ * @brief Get the next characters received by the simulated USB serial port
+ * @param buffer Where to put the characters
+ * @param maxBytes Maximum number of characters to fetch
+ * @return Number of characters fetched, 0 if none are available yet
+ */
+extern size_t AppHostReadUsb(uint8_t *buffer, size_t maxBytes) noexcept;
+
+#endif /* SRC_HOST_HOSTSIM_H_ */
@@ -0,0 +1,108 @@
+/*
+ * SerialCDC.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation of the USB serial port. Received characters come from the client application, which normally replays a file.
+ *  Transmitted characters go to the standard output. The port is connected from the start and never blocks the sender.
+ */
+
+#if SUPPORT_USB
+
+#include "SerialCDC.h"
+#include <HostSim.h>
+#include <cstdio>
+
+SerialCDC::SerialCDC(Pin p, size_t numTxSlots, size_t numRxSlots) noexcept : txWaitingTask(nullptr), vbusPin(p), hasConnected(false)
+{
+	txBuffer.Init(numTxSlots);
+	rxBuffer.Init(numRxSlots);
+}
+
+void SerialCDC::Start() noexcept
+{
+	hasConnected = true;
+}
+
+void SerialCDC::end() noexcept
+{
+	flush();
+}
+
+void SerialCDC::CheckIfJustConnected() noexcept
+{
+}
+
+bool SerialCDC::IsConnected() const noexcept
+{
+	return hasConnected;
+}
+
+// Overridden virtual functions
+
+// Non-blocking read, return -1 if no character available
+int SerialCDC::read() noexcept
+{
+	StartReceiving();
+	uint8_t c;
+	return (rxBuffer.GetItem(c)) ? c : -1;
+}
+
+int SerialCDC::available() noexcept
+{
+	StartReceiving();
+	return rxBuffer.ItemsPresent();
+}
+
+void SerialCDC::flush() noexcept
+{
+	fflush(stdout);
+}
+
+size_t SerialCDC::canWrite() noexcept
+{
+	return (hasConnected) ? txBuffer.GetCapacity() : 0;
+}
+
+size_t SerialCDC::write(uint8_t c) noexcept
+{
+	if (hasConnected)
+	{
+		putchar(c);
+	}
+	return 1;
+}
+
+size_t SerialCDC::write(const uint8_t *buffer, size_t buflen) noexcept
+{
+	if (hasConnected)
+	{
+		fwrite(buffer, 1, buflen, stdout);
+	}
+	return buflen;
+}
+
+void SerialCDC::StartSending() noexcept
+{
+}
+
+// Fetch more input from the application if there is room for it
+void SerialCDC::StartReceiving() noexcept
+{
+	if (hasConnected)
+	{
+		uint8_t temp[64];
+		const size_t count = AppHostReadUsb(temp, min<size_t>(rxBuffer.SpaceLeft(), sizeof(temp)));
+		rxBuffer.PutBlock(temp, count);
+	}
+}
+
+// Received data is fetched by StartReceiving, so there is nothing to do here
+void SerialCDC::DataReceived(uint32_t count) noexcept
+{
+}
+
+#endif
+
+// End
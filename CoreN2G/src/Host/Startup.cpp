@@ -0,0 +1,61 @@
+/*
+ * Startup.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation replacement for the SAME5x startup code. The device headers address the peripherals at fixed addresses,
+ *  so we map ordinary memory at those addresses before any static constructors run.
+ */
+
+#include <HostSim.h>
+
+#include <sys/mman.h>
+#include <cstdio>
+#include <cstdlib>
+
+// Address ranges that the firmware or the device headers access directly
+struct SimulatedMemoryRegion
+{
+	uintptr_t start;
+	size_t length;
+};
+
+static constexpr SimulatedMemoryRegion simulatedMemoryRegions[] =
+{
+	{ 0x00800000, 0x00010000 },		// NVM user row and calibration area
+	{ 0x40000000, 0x08000000 },		// peripherals, SmartEEPROM, SDHC and backup RAM
+	{ 0xE0000000, 0x00100000 },		// Cortex-M4 private peripherals including SysTick, NVIC and SCB
+};
+
+// SystemCoreClock is needed by FreeRTOS and by the diagnostics
+uint32_t SystemCoreClock = SystemCoreClockFreq;
+
+static void MapSimulatedMemory() noexcept __attribute__((constructor(101)));
+
+static void MapSimulatedMemory() noexcept
+{
+	for (const SimulatedMemoryRegion& r : simulatedMemoryRegions)
+	{
+		void * const p = mmap(reinterpret_cast<void*>(r.start), r.length, PROT_READ | PROT_WRITE,
+								MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED_NOREPLACE, -1, 0);
+		if (p != reinterpret_cast<void*>(r.start))
+		{
+			fprintf(stderr, "Failed to map simulated memory at 0x%08lx\n", (unsigned long)r.start);
+			exit(1);
+		}
+	}
+
+	// The firmware reads the SysTick reload value to convert cycle counts
+	SysTick->LOAD = ((SystemCoreClockFreq/1000) - 1) << SysTick_LOAD_RELOAD_Pos;
+	SysTick->CTRL = (1 << SysTick_CTRL_ENABLE_Pos) | (1 << SysTick_CTRL_CLKSOURCE_Pos);
+}
+
+int main(int argc, char *argv[])
+{
+	AppHostInit(argc, argv);
+	AppInit();
+	AppMain();
+}
+
+// End
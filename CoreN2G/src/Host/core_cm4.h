@@ -0,0 +1,97 @@
+/*
+ * core_cm4.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation replacement for the CMSIS GCC intrinsics. The device headers include core_cm4.h, which normally pulls in cmsis_gcc.h
+ *  with its ARM inline assembler. This file is found first on the host include path. It defines the compiler macros and the intrinsics
+ *  that the firmware uses in terms of the simulated interrupt state held by the FreeRTOS host port, then includes the real core_cm4.h
+ *  for the register definitions. The core peripheral registers live in the simulated peripheral memory.
+ */
+
+#ifndef SRC_HOST_CORE_CM4_H_
+#define SRC_HOST_CORE_CM4_H_
+
+#include <stdint.h>
+
+#define __CMSIS_GCC_H				// stop the real cmsis_gcc.h being included
+
+#ifndef __has_builtin
+# define __has_builtin(x) (0)
+#endif
+
+#define __ASM						__asm
+#define __INLINE					inline
+#define __STATIC_INLINE				static inline
+#define __STATIC_FORCEINLINE		__attribute__((always_inline)) static inline
+#define __NO_RETURN					__attribute__((__noreturn__))
+#define __USED						__attribute__((used))
+#define __WEAK						__attribute__((weak))
+#define __PACKED					__attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT				struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION				union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)				__attribute__((aligned(x)))
+#define __RESTRICT					__restrict
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// These are implemented by the FreeRTOS host port
+uint32_t ulPortGetPriMask(void);
+void vPortSetPriMask(uint32_t ulNewPriMask);
+uint32_t ulPortGetBasePri(void);
+void vPortClearInterruptMask(uint32_t ulNewMaskValue);
+long xPortIsInsideInterrupt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+__STATIC_FORCEINLINE void __enable_irq(void) { vPortSetPriMask(0); }
+__STATIC_FORCEINLINE void __disable_irq(void) { vPortSetPriMask(1); }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void) { return ulPortGetPriMask(); }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t priMask) { vPortSetPriMask(priMask); }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void) { return ulPortGetBasePri(); }
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t basePri) { vPortClearInterruptMask(basePri); }
+
+__STATIC_FORCEINLINE void __set_BASEPRI_MAX(uint32_t basePri)
+{
+	if (basePri != 0 && ulPortGetBasePri() == 0)
+	{
+		vPortClearInterruptMask(basePri);
+	}
+}
+
+// Exception number 16 and upwards are peripheral interrupts. We don't simulate individual exception numbers, so use the first one.
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void) { return (xPortIsInsideInterrupt()) ? 16 : 0; }
+
+__STATIC_FORCEINLINE void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __NOP(void) { }
+__STATIC_FORCEINLINE void __WFI(void) { }
+__STATIC_FORCEINLINE void __WFE(void) { }
+__STATIC_FORCEINLINE void __SEV(void) { }
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value) { return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value) { return ((value & 0x00FF00FFu) << 8) | ((value >> 8) & 0x00FF00FFu); }
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t value) { return (int16_t)__builtin_bswap16((uint16_t)value); }
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t op1, uint32_t op2) { op2 &= 31u; return (op2 == 0u) ? op1 : (op1 >> op2) | (op1 << (32u - op2)); }
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value) { return (value == 0u) ? 32u : (uint8_t)__builtin_clz(value); }
+
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+	uint32_t result = 0;
+	for (unsigned int i = 0; i < 32; ++i)
+	{
+		result = (result << 1) | (value & 1u);
+		value >>= 1;
+	}
+	return result;
+}
+
+#include_next <core_cm4.h>
+
+#endif /* SRC_HOST_CORE_CM4_H_ */
@@ -0,0 +1,36 @@
+/**
+ * @file syscalls.h
+ * Host simulation replacement for the syscalls.h file in the parent directory, which is further down the include path.
+ * The host C library provides the system calls and the heap, so this file only defines the heap variables and
+ * CoreAllocPermanent, which the firmware uses for memory statistics and permanent allocations.
+ *
+ * The client application project must #include it in exactly one .cpp file
+ */
+
+/*  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#include <cstdlib>
+#include <new>
+
+[[noreturn]] void OutOfMemoryHandler() noexcept;				// this must be provided by the client application
+
+// There is no fixed heap area or system stack in the host simulation, so the heap and stack limits are all the same
+const char *sysStackLimit = nullptr;
+const char *heapLimit = nullptr;
+char *heapTop = nullptr;
+
+/**
+ * \brief Allocate memory permanently. In multi-threaded environments, take the malloc mutex before calling this.
+ */
+void *CoreAllocPermanent(size_t sz, std::align_val_t align) noexcept
+{
+	const size_t alignment = (size_t)align;
+	void * const ret = aligned_alloc(alignment, (sz + alignment - 1) & ~(alignment - 1));
+	if (ret == nullptr)
+	{
+		OutOfMemoryHandler();
+	}
+	return ret;
+}
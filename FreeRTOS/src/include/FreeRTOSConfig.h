@@ -58,7 +58,11 @@ extern uint32_t SystemCoreClock;
 #endif
 
 #define configUSE_QUEUE_SETS					1
-#define configUSE_IDLE_HOOK						0
+#ifdef HOST_SIM
+# define configUSE_IDLE_HOOK					1	// the host port uses the idle hook to skip or sleep through idle time
+#else
+# define configUSE_IDLE_HOOK					0
+#endif
 #define configUSE_TICK_HOOK						1
 #define configCPU_CLOCK_HZ						( SystemCoreClock )
 #define configTICK_RATE_HZ						( 1000 )
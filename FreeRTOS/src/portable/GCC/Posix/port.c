@@ -0,0 +1,343 @@
+/*
+ * port.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  FreeRTOS port for running the firmware as a Linux process (host simulation). See portmacro.h for an overview.
+ *
+ *  Simulated time is the real time elapsed since the scheduler was started multiplied by a configurable scale factor, plus any time that was
+ *  skipped while all tasks were blocked. Skipping idle time makes a simulation run much faster than real time when the firmware is mostly waiting.
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Each task has one of these. A pointer to it is stored at the top of the task's stack, which is where FreeRTOS keeps the task's saved context.
+typedef struct ThreadState
+{
+	pthread_t thread;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+} ThreadState_t;
+
+// The first member of the TCB is the top of stack pointer. We only need that, so we don't need the full TCB type here.
+extern void * volatile pxCurrentTCB;
+
+static pthread_mutex_t xRunMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xRunCond = PTHREAD_COND_INITIALIZER;
+static ThreadState_t * volatile pxRunningThread = NULL;			// the thread that is allowed to run
+
+static volatile BaseType_t xSchedulerStarted = pdFALSE;
+static volatile BaseType_t xInsideInterrupt = pdFALSE;
+static volatile BaseType_t xYieldPending = pdFALSE;
+static volatile uint32_t ulPriMask = 0;							// simulated PRIMASK: nonzero if all interrupts are disabled
+static volatile uint32_t ulBasePri = 0;							// simulated BASEPRI: nonzero if interrupts are masked by FreeRTOS
+static volatile UBaseType_t uxCriticalNesting = 0;
+
+static uint64_t ullRealStartTime = 0;							// monotonic clock when time started, in nanoseconds
+static volatile uint64_t ullSkippedTime = 0;					// simulated time skipped while idle or advanced by busy-wait delays
+static uint32_t ulTimeScale = 1;
+static BaseType_t xSkipIdleTime = pdTRUE;
+static uint64_t ullNextTickTime = 0;
+
+static const uint64_t ullTickPeriod = 1000000000ULL / configTICK_RATE_HZ;
+static const size_t uxThreadStackSize = 1024 * 1024;			// task code uses more stack on the host than on the target, so be generous
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetRealTime( void )
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( uint64_t ) ts.tv_sec * 1000000000ULL + ( uint64_t ) ts.tv_nsec;
+}
+
+static ThreadState_t *prvGetCurrentThread( void )
+{
+	ThreadState_t *pxThread;
+	memcpy( &pxThread, *( StackType_t * const * ) pxCurrentTCB, sizeof( pxThread ) );
+	return pxThread;
+}
+
+// Let thread pxNext run. If pxSelf is not null, wait until pxSelf is allowed to run again.
+static void prvSwitchThread( ThreadState_t *pxNext, ThreadState_t *pxSelf )
+{
+	pthread_mutex_lock( &xRunMutex );
+	pxRunningThread = pxNext;
+	pthread_cond_broadcast( &xRunCond );
+	if( pxSelf != NULL )
+	{
+		while( pxRunningThread != pxSelf )
+		{
+			pthread_cond_wait( &xRunCond, &xRunMutex );
+		}
+	}
+	pthread_mutex_unlock( &xRunMutex );
+}
+
+static void *prvThreadEntry( void *pvThreadState )
+{
+	ThreadState_t * const pxSelf = ( ThreadState_t * ) pvThreadState;
+
+	pthread_mutex_lock( &xRunMutex );
+	while( pxRunningThread != pxSelf )
+	{
+		pthread_cond_wait( &xRunCond, &xRunMutex );
+	}
+	pthread_mutex_unlock( &xRunMutex );
+
+	pxSelf->pxCode( pxSelf->pvParameters );
+
+	// Tasks must not return from their implementing function
+	fprintf( stderr, "Task returned from its implementing function\n" );
+	vTaskDelete( NULL );
+	return NULL;
+}
+
+static BaseType_t prvInterruptsEnabled( void )
+{
+	return ( xSchedulerStarted && !xInsideInterrupt && ulPriMask == 0 && ulBasePri == 0 && uxCriticalNesting == 0 ) ? pdTRUE : pdFALSE;
+}
+
+// Select the next task to run and switch to it. Interrupts must be enabled.
+static void prvContextSwitch( void )
+{
+	ThreadState_t * const pxSelf = prvGetCurrentThread();
+	xYieldPending = pdFALSE;
+	ulBasePri = 1;
+	vTaskSwitchContext();
+	ulBasePri = 0;
+	ThreadState_t * const pxNext = prvGetCurrentThread();
+	if( pxNext != pxSelf )
+	{
+		prvSwitchThread( pxNext, pxSelf );
+	}
+}
+
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	// The thread state is never freed, because a deleted task's thread stays blocked for the rest of the simulation
+	ThreadState_t * const pxThread = ( ThreadState_t * ) malloc( sizeof( ThreadState_t ) );
+	configASSERT( pxThread != NULL );
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+
+	pthread_attr_t xAttr;
+	pthread_attr_init( &xAttr );
+	pthread_attr_setstacksize( &xAttr, uxThreadStackSize );
+	const int iError = pthread_create( &pxThread->thread, &xAttr, prvThreadEntry, pxThread );
+	pthread_attr_destroy( &xAttr );
+	configASSERT( iError == 0 );
+	( void ) iError;
+
+	pxTopOfStack -= ( sizeof( ThreadState_t * ) + sizeof( StackType_t ) - 1 ) / sizeof( StackType_t );
+	memcpy( pxTopOfStack, &pxThread, sizeof( pxThread ) );
+	return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+	ullNextTickTime = ullPortGetSimulatedTime() + ullTickPeriod;
+	uxCriticalNesting = 0;
+	ulPriMask = 0;
+	ulBasePri = 0;
+	xSchedulerStarted = pdTRUE;
+
+	// Start the first task and park the thread that started the scheduler
+	prvSwitchThread( prvGetCurrentThread(), NULL );
+	for( ;; )
+	{
+		pause();
+	}
+	return 0;
+}
+
+void vPortEndScheduler( void )
+{
+	// Not implemented, the simulation ends by terminating the process
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+	if( prvInterruptsEnabled() )
+	{
+		prvContextSwitch();
+	}
+	else
+	{
+		xYieldPending = pdTRUE;				// switch when interrupts are enabled again, as PendSV would on the target
+	}
+}
+
+void vPortYieldFromISR( void )
+{
+	vPortYield();
+}
+
+BaseType_t xPortIsInsideInterrupt( void )
+{
+	return xInsideInterrupt;
+}
+
+void vPortEnterCritical( void )
+{
+	ulBasePri = 1;
+	uxCriticalNesting++;
+}
+
+void vPortExitCritical( void )
+{
+	configASSERT( uxCriticalNesting );
+	uxCriticalNesting--;
+	if( uxCriticalNesting == 0 )
+	{
+		ulBasePri = 0;
+		vPortServiceInterrupts();
+	}
+}
+
+uint32_t ulPortSetInterruptMask( void )
+{
+	const uint32_t ulOriginal = ulBasePri;
+	ulBasePri = 1;
+	return ulOriginal;
+}
+
+void vPortClearInterruptMask( uint32_t ulNewMaskValue )
+{
+	ulBasePri = ulNewMaskValue;
+	if( ulNewMaskValue == 0 )
+	{
+		vPortServiceInterrupts();
+	}
+}
+
+void vPortDisableInterrupts( void )
+{
+	ulBasePri = 1;
+}
+
+void vPortEnableInterrupts( void )
+{
+	vPortClearInterruptMask( 0 );
+}
+
+// These are used by the CMSIS intrinsics that the host build supplies in place of the ARM ones
+uint32_t ulPortGetPriMask( void )
+{
+	return ulPriMask;
+}
+
+void vPortSetPriMask( uint32_t ulNewPriMask )
+{
+	ulPriMask = ulNewPriMask;
+	if( ulNewPriMask == 0 )
+	{
+		vPortServiceInterrupts();
+	}
+}
+
+uint32_t ulPortGetBasePri( void )
+{
+	return ulBasePri;
+}
+
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortGetSimulatedTime( void )
+{
+	const uint64_t ullNow = prvGetRealTime();
+	if( ullRealStartTime == 0 )
+	{
+		ullRealStartTime = ullNow;
+	}
+	return ( ullNow - ullRealStartTime ) * ulTimeScale + ullSkippedTime;
+}
+
+void vPortAdvanceSimulatedTime( uint64_t ullNanoseconds )
+{
+	ullSkippedTime += ullNanoseconds;
+}
+
+// Set how fast simulated time runs relative to real time, and whether to skip over the time when all tasks are blocked.
+// This must be called before the scheduler is started.
+void vPortSetTimeScale( uint32_t ulScale, BaseType_t xSkipIdle )
+{
+	ulTimeScale = ( ulScale == 0 ) ? 1 : ulScale;
+	xSkipIdleTime = xSkipIdle;
+}
+
+// Service the tick and any other simulated interrupts that are due. Interrupts must be enabled.
+// Return the simulated time at which the next interrupt is due.
+static uint64_t prvServiceInterrupts( void )
+{
+	xInsideInterrupt = pdTRUE;
+	ulBasePri = 1;
+
+	const uint64_t ullNow = ullPortGetSimulatedTime();
+	while( ullNow >= ullNextTickTime )
+	{
+		ullNextTickTime += ullTickPeriod;
+		if( xTaskIncrementTick() != pdFALSE )
+		{
+			xYieldPending = pdTRUE;
+		}
+	}
+	const uint64_t ullNextPeripheralTime = ullPortServicePeripherals( ullNow );
+
+	ulBasePri = 0;
+	xInsideInterrupt = pdFALSE;
+	return ( ullNextPeripheralTime < ullNextTickTime ) ? ullNextPeripheralTime : ullNextTickTime;
+}
+
+// Service any simulated interrupts that are due, then do any context switch that they requested.
+// This does nothing unless it is called from a task with interrupts enabled.
+void vPortServiceInterrupts( void )
+{
+	if( prvInterruptsEnabled() )
+	{
+		( void ) prvServiceInterrupts();
+		if( xYieldPending )
+		{
+			prvContextSwitch();
+		}
+	}
+}
+
+// The idle task only runs when all other tasks are blocked, so we can either skip forward to the next interrupt or sleep until it is due
+void vApplicationIdleHook( void )
+{
+	if( prvInterruptsEnabled() )
+	{
+		const uint64_t ullNextEvent = prvServiceInterrupts();
+		const uint64_t ullNow = ullPortGetSimulatedTime();
+		if( !xYieldPending && ullNextEvent > ullNow )
+		{
+			if( xSkipIdleTime )
+			{
+				ullSkippedTime += ullNextEvent - ullNow;
+			}
+			else
+			{
+				const uint64_t ullSleepTime = ( ullNextEvent - ullNow ) / ulTimeScale;
+				const struct timespec ts = { ( time_t ) ( ullSleepTime / 1000000000ULL ), ( long ) ( ullSleepTime % 1000000000ULL ) };
+				nanosleep( &ts, NULL );
+			}
+		}
+		vPortServiceInterrupts();
+	}
+}
+
+/*-----------------------------------------------------------*/
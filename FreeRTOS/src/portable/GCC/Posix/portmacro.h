@@ -0,0 +1,118 @@
+/*
+ * portmacro.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  FreeRTOS port for running the firmware as a Linux process (host simulation).
+ *  Each task runs in its own POSIX thread, but only the thread of the task that FreeRTOS considers to be running is allowed to execute,
+ *  so the kernel data structures are never accessed concurrently. Context switches happen only when the running task calls into the kernel
+ *  or re-enables interrupts. Simulated interrupts, including the tick interrupt, are serviced at those points too.
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	uint32_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE	uintptr_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+	#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT			8
+
+// Scheduler utilities
+extern void vPortYield( void );
+extern void vPortYieldFromISR( void );
+#define portYIELD()									vPortYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired )	if( xSwitchRequired != pdFALSE ) vPortYieldFromISR()
+#define portYIELD_FROM_ISR( x )						portEND_SWITCHING_ISR( x )
+
+// Critical section management. There is only one level of simulated interrupt priority, so masking interrupts masks all of them.
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+extern uint32_t ulPortSetInterruptMask( void );
+extern void vPortClearInterruptMask( uint32_t ulNewMaskValue );
+extern void vPortDisableInterrupts( void );
+extern void vPortEnableInterrupts( void );
+#define portSET_INTERRUPT_MASK_FROM_ISR()		ulPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)	vPortClearInterruptMask(x)
+#define portDISABLE_INTERRUPTS()				vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()					vPortEnableInterrupts()
+#define portENTER_CRITICAL()					vPortEnterCritical()
+#define portEXIT_CRITICAL()						vPortExitCritical()
+
+// Simulated PRIMASK and BASEPRI registers, for the host versions of the CMSIS intrinsics
+extern uint32_t ulPortGetPriMask( void );
+extern void vPortSetPriMask( uint32_t ulNewPriMask );
+extern uint32_t ulPortGetBasePri( void );
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+	#if( configMAX_PRIORITIES > 32 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.
+	#endif
+
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( uint32_t ) __builtin_clz( ( uint32_t ) ( uxReadyPriorities ) ) )
+#endif
+
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()
+
+#define portNOP()
+#define portINLINE	__inline
+
+#ifndef portFORCE_INLINE
+	#define portFORCE_INLINE inline __attribute__(( always_inline))
+#endif
+
+extern BaseType_t xPortIsInsideInterrupt( void );
+
+#define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
+
+// Simulation support. Times are in nanoseconds of simulated time since the scheduler was started.
+extern uint64_t ullPortGetSimulatedTime( void );
+extern void vPortAdvanceSimulatedTime( uint64_t ullNanoseconds );
+extern void vPortSetTimeScale( uint32_t ulScale, BaseType_t xSkipIdleTime );
+extern void vPortServiceInterrupts( void );
+
+// The simulation must provide this function. It is called with interrupts masked to service the simulated peripheral interrupts that are due.
+// It returns the simulated time at which a peripheral next needs service, or UINT64_MAX if there is nothing scheduled.
+extern uint64_t ullPortServicePeripherals( uint64_t ullNow );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
@@ -24,6 +24,7 @@
 */
 
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -690,6 +691,10 @@ int FormattedPrinter::Print(const char *format, va_list args) noexcept
 				ch = *format++;
 				flags.long64 = 1;
 			}
+			else if (sizeof(long) == sizeof(long long))
+			{
+				flags.long64 = 1;				// long is 64 bits on LP64 hosts, e.g. in the host simulation
+			}
 			else
 			{
 				flags.long32 = 1;
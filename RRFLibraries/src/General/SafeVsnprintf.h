@@ -25,7 +25,9 @@ int uprintf(PutcFunc_t putc, const char *format, ...) noexcept __attribute__ ((f
 int SafeVsnprintf(char *buffer, size_t maxLen, const char *format, va_list args) noexcept;
 int SafeSnprintf(char* buffer, size_t maxLen, const char* format, ...) noexcept __attribute__ ((format (printf, 3, 4)));
 
+#ifndef HOST_SIM		// glibc declares these noexcept, so we can't redeclare them in the host simulation
 extern "C" [[deprecated("use SafeSnprintf instead of snprintf")]] int snprintf(char * s, size_t n, const char * format, ...);
 extern "C" [[deprecated("use SafeVsnprintf instead of vsnprintf")]] int vsnprintf(char * s, size_t n, const char * format, va_list arg);
+#endif
 
 #endif /* SRC_GENERAL_SAFEVSNPRINTF_H_ */
@@ -75,7 +75,9 @@ inline unsigned int LowestSetBitNumber(unsigned int val) noexcept
 	return (unsigned int)__builtin_ctz(val);
 }
 
+#ifndef HOST_SIM				// on a 64-bit host, unsigned long is 64 bits and uint32_t uses the unsigned int overload
 static_assert(sizeof(uint32_t) == sizeof(unsigned long));
+#endif
 inline unsigned int LowestSetBitNumber(unsigned long val) noexcept
 {
 	return (unsigned int)__builtin_ctzl(val);
@@ -0,0 +1,108 @@
+/*
+ * SpscQueue.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_GENERAL_SPSCQUEUE_H_
+#define SRC_GENERAL_SPSCQUEUE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+// Lock-free queue for passing items from one producer to one consumer, e.g. from an ISR to a task, without disabling interrupts.
+// Unlike RingBuffer, the indices are atomic and are read and written with acquire/release ordering, so it is also safe between threads on a multi-core host.
+// At any time there may be at most one thread or ISR calling Put and one calling Get. Several tasks may share the consumer role if they serialise their calls.
+// The items are copied by value, so they should be small.
+
+template<class T> class SpscQueue
+{
+public:
+	SpscQueue() noexcept;
+
+	// Initialise and allocate the queue. numSlots must be a power of 2. The queue can hold one less item than the number of slots.
+	void Init(size_t numSlots) noexcept;
+
+	// Store one item returning true if successful. Only the producer may call this.
+	bool Put(const T& val) noexcept;
+
+	// Get one item returning true if successful. Only the consumer may call this.
+	bool Get(T& val) noexcept;
+
+	// Return true if there are no items in the queue
+	bool IsEmpty() const noexcept;
+
+	// Return the number of items in the queue
+	size_t ItemsPresent() const noexcept;
+
+	// Return the capacity
+	size_t GetCapacity() const noexcept { return mask; }
+
+	// Clear the queue. Neither the producer nor the consumer may be active when this is called.
+	void Clear() noexcept;
+
+private:
+	size_t mask;				// one less than the number of slots
+	std::atomic<size_t> putIndex, getIndex;
+	T *data;
+};
+
+template<class T> SpscQueue<T>::SpscQueue() noexcept
+	: mask(0), putIndex(0), getIndex(0), data(nullptr)
+{
+}
+
+template<class T> void SpscQueue<T>::Init(size_t numSlots) noexcept
+{
+	Clear();
+	if (data == nullptr && numSlots > 1)
+	{
+		mask = numSlots - 1;
+		data = new T[numSlots];
+	}
+}
+
+template<class T> inline bool SpscQueue<T>::Put(const T& val) noexcept
+{
+	const size_t oldPutIndex = putIndex.load(std::memory_order_relaxed);		// only we write putIndex
+	const size_t newPutIndex = (oldPutIndex + 1) & mask;
+	if (newPutIndex == getIndex.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+	data[oldPutIndex] = val;
+	putIndex.store(newPutIndex, std::memory_order_release);						// publish the item
+	return true;
+}
+
+template<class T> inline bool SpscQueue<T>::Get(T& val) noexcept
+{
+	const size_t oldGetIndex = getIndex.load(std::memory_order_relaxed);		// only we write getIndex
+	if (oldGetIndex == putIndex.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+	val = data[oldGetIndex];
+	getIndex.store((oldGetIndex + 1) & mask, std::memory_order_release);		// release the slot
+	return true;
+}
+
+template<class T> inline bool SpscQueue<T>::IsEmpty() const noexcept
+{
+	return getIndex.load(std::memory_order_acquire) == putIndex.load(std::memory_order_acquire);
+}
+
+template<class T> inline size_t SpscQueue<T>::ItemsPresent() const noexcept
+{
+	return (putIndex.load(std::memory_order_acquire) - getIndex.load(std::memory_order_acquire)) & mask;
+}
+
+template<class T> void SpscQueue<T>::Clear() noexcept
+{
+	putIndex.store(0, std::memory_order_relaxed);
+	getIndex.store(0, std::memory_order_relaxed);
+}
+
+#endif /* SRC_GENERAL_SPSCQUEUE_H_ */
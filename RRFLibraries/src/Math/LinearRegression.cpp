@@ -0,0 +1,60 @@
+/*
+ * LinearRegression.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#include "LinearRegression.h"
+
+LinearRegression::LinearRegression() noexcept
+{
+	Clear();
+}
+
+void LinearRegression::Clear() noexcept
+{
+	numValues = 0;
+	xOffset = sumX = sumY = sumXX = sumXY = 0.0;
+}
+
+void LinearRegression::Add(float x, float y) noexcept
+{
+	if (numValues == 0)
+	{
+		xOffset = x;
+	}
+	x -= xOffset;
+	++numValues;
+	sumX += x;
+	sumY += y;
+	sumXX += x * x;
+	sumXY += x * y;
+}
+
+float LinearRegression::GetSlope() const noexcept
+{
+	const float denominator = (float)numValues * sumXX - sumX * sumX;
+	return (numValues < 2 || denominator <= 0.0) ? 0.0 : ((float)numValues * sumXY - sumX * sumY)/denominator;
+}
+
+float LinearRegression::GetIntercept() const noexcept
+{
+	if (numValues == 0)
+	{
+		return 0.0;
+	}
+	// The best fit line passes through the mean of the points
+	const float meanX = sumX/(float)numValues + xOffset;
+	return sumY/(float)numValues - GetSlope() * meanX;
+}
+
+float LinearRegression::GetSlopeThroughOrigin() const noexcept
+{
+	// Convert the sums back to be relative to X = 0
+	const float rawSumXY = sumXY + xOffset * sumY;
+	const float rawSumXX = sumXX + 2.0 * xOffset * sumX + (float)numValues * xOffset * xOffset;
+	return (rawSumXX <= 0.0) ? 0.0 : rawSumXY/rawSumXX;
+}
+
+// End
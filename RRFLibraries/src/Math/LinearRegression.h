@@ -0,0 +1,32 @@
+/*
+ * LinearRegression.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef SRC_MATH_LINEARREGRESSION_H_
+#define SRC_MATH_LINEARREGRESSION_H_
+
+// Class to accumulate a set of points and fit a straight line to them by least squares, without storing the points.
+// The X values are accumulated relative to the first one, to reduce rounding error when they are large compared to their range.
+class LinearRegression
+{
+public:
+	LinearRegression() noexcept;
+
+	void Clear() noexcept;
+	void Add(float x, float y) noexcept;
+
+	unsigned int GetNumSamples() const noexcept { return numValues; }
+	float GetSlope() const noexcept;							// get the slope of the best fit line
+	float GetIntercept() const noexcept;						// get the value of Y where the best fit line crosses X = 0
+	float GetSlopeThroughOrigin() const noexcept;				// get the slope of the best fit line that passes through the origin
+
+private:
+	unsigned int numValues;
+	float xOffset;
+	float sumX, sumY, sumXX, sumXY;
+};
+
+#endif /* SRC_MATH_LINEARREGRESSION_H_ */
@@ -34,10 +34,17 @@ typedef TaskBase *TaskHandle;
 
   This function enables IRQ interrupts by clearing the I-bit in the CPSR.
   Can only be executed in Privileged modes.
+  When building for a host processor (e.g. using the FreeRTOS POSIX port) the port's own interrupt masking is used instead.
  */
 __attribute__( ( always_inline ) ) static inline void EnableInterrupts() noexcept
 {
+#if defined(__arm__)
   __asm volatile ("cpsie i" : : : "memory");
+#elif defined(RTOS)
+  portENABLE_INTERRUPTS();
+#else
+# error "No way to mask interrupts on this processor"
+#endif
 }
 
 
@@ -45,10 +52,17 @@ __attribute__( ( always_inline ) ) static inline void EnableInterrupts() noexcep
 
   This function disables IRQ interrupts by setting the I-bit in the CPSR.
   Can only be executed in Privileged modes.
+  When building for a host processor the port's own interrupt masking is used instead.
  */
 __attribute__( ( always_inline ) ) static inline void DisableInterrupts() noexcept
 {
+#if defined(__arm__)
   __asm volatile ("cpsid i" : : : "memory");
+#elif defined(RTOS)
+  portDISABLE_INTERRUPTS();
+#else
+# error "No way to mask interrupts on this processor"
+#endif
 }
 
 // Mutex class. This uses the FreeRTOS static semaphore type, but adds a name and links them all together in a list
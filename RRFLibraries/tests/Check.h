@@ -0,0 +1,27 @@
+/*
+ * Check.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Minimal checking macro for the host tests, so that they don't need a test framework.
+ */
+
+#ifndef TESTS_CHECK_H_
+#define TESTS_CHECK_H_
+
+#include <cstdio>
+
+static unsigned int checkFailures = 0;
+
+#define CHECK(_cond) \
+	do { if (!(_cond)) { ++checkFailures; std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #_cond); } } while (false)
+
+// Report the result and return the process exit code
+static inline int CheckResult(const char *testName) noexcept
+{
+	std::printf("%s: %s\n", testName, (checkFailures == 0) ? "passed" : "FAILED");
+	return (checkFailures == 0) ? 0 : 1;
+}
+
+#endif /* TESTS_CHECK_H_ */
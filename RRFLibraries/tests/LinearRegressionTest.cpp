@@ -0,0 +1,91 @@
+/*
+ * LinearRegressionTest.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host test for LinearRegression, using the sort of data that the fast heater tuning fits to.
+ */
+
+#include "Check.h"
+#include <Math/LinearRegression.h>
+#include <cmath>
+
+static bool Near(float a, float b, float tolerance) noexcept
+{
+	return std::fabs(a - b) <= tolerance;
+}
+
+// Points exactly on a line must give that line back, even when the X values are large compared to their range
+static void TestExactLine() noexcept
+{
+	LinearRegression lr;
+	CHECK(lr.GetNumSamples() == 0);
+	CHECK(lr.GetSlope() == 0.0f);
+	CHECK(lr.GetIntercept() == 0.0f);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		const float x = 10000.0f + 0.5f * (float)i;		// e.g. a time in seconds since power up
+		lr.Add(x, 2.5f * (x - 10000.0f) + 20.0f);
+	}
+	CHECK(lr.GetNumSamples() == 100);
+	CHECK(Near(lr.GetSlope(), 2.5f, 1.0e-4f));
+	CHECK(Near(lr.GetIntercept(), 20.0f - 2.5f * 10000.0f, 1.0f));
+
+	lr.Clear();
+	CHECK(lr.GetNumSamples() == 0);
+	CHECK(lr.GetSlope() == 0.0f);
+}
+
+// Noise that averages to zero must not bias the fit
+static void TestNoisyLine() noexcept
+{
+	LinearRegression lr;
+	for (int i = 0; i < 200; ++i)
+	{
+		const float x = (float)i;
+		const float noise = (i & 1) ? 0.3f : -0.3f;
+		lr.Add(x, -0.75f * x + 150.0f + noise);
+	}
+	CHECK(Near(lr.GetSlope(), -0.75f, 1.0e-3f));
+	CHECK(Near(lr.GetIntercept(), 150.0f, 0.1f));
+}
+
+// A line through the origin, e.g. cooling rate against temperature above ambient
+static void TestThroughOrigin() noexcept
+{
+	LinearRegression lr;
+	CHECK(lr.GetSlopeThroughOrigin() == 0.0f);
+	for (int i = 0; i < 50; ++i)
+	{
+		const float x = 50.0f + 4.0f * (float)i;
+		lr.Add(x, 0.0125f * x);
+	}
+	CHECK(Near(lr.GetSlopeThroughOrigin(), 0.0125f, 1.0e-5f));
+	CHECK(Near(lr.GetSlope(), 0.0125f, 1.0e-5f));
+	CHECK(Near(lr.GetIntercept(), 0.0f, 1.0e-3f));
+}
+
+// With fewer than two distinct X values there is no slope
+static void TestDegenerate() noexcept
+{
+	LinearRegression lr;
+	lr.Add(3.0f, 7.0f);
+	CHECK(lr.GetSlope() == 0.0f);
+	CHECK(Near(lr.GetIntercept(), 7.0f, 1.0e-6f));
+	lr.Add(3.0f, 9.0f);
+	CHECK(lr.GetSlope() == 0.0f);
+	CHECK(Near(lr.GetIntercept(), 8.0f, 1.0e-6f));
+}
+
+int main()
+{
+	TestExactLine();
+	TestNoisyLine();
+	TestThroughOrigin();
+	TestDegenerate();
+	return CheckResult("LinearRegression");
+}
+
+// End
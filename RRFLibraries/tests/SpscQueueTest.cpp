@@ -0,0 +1,118 @@
+/*
+ * SpscQueueTest.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  Host test for SpscQueue. The stress test runs the producer and the consumer in separate threads, so on a multi-core host it checks the memory ordering.
+ */
+
+#include "Check.h"
+#include <General/SpscQueue.h>
+#include <thread>
+
+struct Item
+{
+	uint32_t seq;
+	uint32_t check;								// a function of seq, so that we can detect an item that was read before it was completely written
+};
+
+// Check the capacity, ordering and wraparound in a single thread
+static void TestSingleThread() noexcept
+{
+	SpscQueue<Item> q;
+	q.Init(8);
+	CHECK(q.GetCapacity() == 7);
+	CHECK(q.IsEmpty());
+
+	Item item{0, 0};
+	CHECK(!q.Get(item));
+
+	uint32_t putSeq = 0, getSeq = 0;
+	for (unsigned int round = 0; round < 10; ++round)
+	{
+		// Fill the queue, then check that it refuses one more item
+		while (q.Put(Item{putSeq, ~putSeq}))
+		{
+			++putSeq;
+		}
+		CHECK(q.ItemsPresent() == 7);
+		CHECK(!q.IsEmpty());
+
+		// Take some of the items out, so that the indices wrap round at a different place next time
+		for (unsigned int i = 0; i < round % 7 + 1; ++i)
+		{
+			CHECK(q.Get(item));
+			CHECK(item.seq == getSeq && item.check == ~getSeq);
+			++getSeq;
+		}
+	}
+
+	while (q.Get(item))
+	{
+		CHECK(item.seq == getSeq && item.check == ~getSeq);
+		++getSeq;
+	}
+	CHECK(getSeq == putSeq);
+	CHECK(q.IsEmpty());
+	CHECK(q.ItemsPresent() == 0);
+
+	q.Clear();
+	CHECK(q.IsEmpty());
+}
+
+// Pass a lot of items from one thread to another through a small queue, so that it is often full and often empty.
+// The threads yield when they can't make progress, so that the test also completes on a single-core host.
+static void TestStress() noexcept
+{
+	constexpr uint32_t NumItems = 1000000;
+	SpscQueue<Item> q;
+	q.Init(16);
+
+	std::thread producer([&q]()
+		{
+			for (uint32_t seq = 0; seq < NumItems; )
+			{
+				if (q.Put(Item{seq, seq * 2654435761u}))
+				{
+					++seq;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+	uint32_t expected = 0;
+	unsigned int errors = 0;
+	while (expected < NumItems)
+	{
+		Item item{0, 0};
+		if (q.Get(item))
+		{
+			if (item.seq != expected || item.check != expected * 2654435761u)
+			{
+				++errors;
+			}
+			++expected;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	CHECK(errors == 0);
+	CHECK(q.IsEmpty());
+}
+
+int main()
+{
+	TestSingleThread();
+	TestStress();
+	return CheckResult("SpscQueue");
+}
+
+// End
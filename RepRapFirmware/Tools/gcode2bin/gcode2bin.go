@@ -0,0 +1,252 @@
+// gcode2bin converts a G-code file into the binary G-code format that RepRapFirmware can read from local storage.
+//
+// Usage: gcode2bin input.gcode output.gcode
+//
+// G0/G1/G2/G3 commands with plain numeric parameters are stored as pre-tokenised binary records using the
+// same CodeHeader and CodeParameter layout that the SBC uses. All other lines are copied unchanged, so meta commands,
+// comments and anything else that needs the full G-code parser still work. Lines that belong to a conditional or loop
+// block are always kept as text, because the firmware tracks block structure from the text lines.
+package main
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"math"
+	"os"
+	"strconv"
+	"strings"
+)
+
+const (
+	// These must match the definitions in GCodeInput.h
+	signature      = ";RRF binary G-code v1\n"
+	recordMarker   = 0xFF
+	inputBufSize   = 256
+	maxRecordWords = (inputBufSize - 3) / 4
+
+	// These must match the definitions in LinuxMessageFormats.h
+	flagHasMajorCommandNumber = 1
+	flagHasMinorCommandNumber = 2
+	flagHasFilePosition       = 4
+
+	dataTypeInt   = 0
+	dataTypeFloat = 2
+
+	codeHeaderSize     = 20
+	codeParameterSize  = 8
+	maxParameterLength = 32
+)
+
+type parameter struct {
+	letter  byte
+	isFloat bool
+	intVal  int32
+	fltVal  float32
+}
+
+// blockCommands are the meta commands that start an indented block
+var blockCommands = []string{"if", "elif", "else", "while"}
+
+func main() {
+	if len(os.Args) != 3 {
+		fmt.Fprintln(os.Stderr, "Usage: gcode2bin input.gcode output.gcode")
+		os.Exit(1)
+	}
+
+	in, err := os.Open(os.Args[1])
+	if err != nil {
+		panic(err)
+	}
+	defer in.Close()
+
+	out, err := os.Create(os.Args[2])
+	if err != nil {
+		panic(err)
+	}
+	defer out.Close()
+
+	w := bufio.NewWriter(out)
+	if _, err = w.WriteString(signature); err != nil {
+		panic(err)
+	}
+	position := uint32(len(signature))
+
+	r := bufio.NewReader(in)
+	lineNumber := int32(0)
+	inBlock := false
+	writingFile := false
+	numBinary, numText := 0, 0
+	for {
+		line, err := r.ReadString('\n')
+		if len(line) == 0 && err != nil {
+			break
+		}
+		lineNumber++
+
+		// Keep track of whether we may be inside a block, in which case the line must stay as text
+		trimmed := strings.TrimLeft(line, " \t")
+		indented := len(trimmed) != len(line)
+		significant := len(strings.TrimSpace(stripComment(trimmed))) != 0
+		mayBeBinary := !indented && !inBlock && !writingFile
+		if significant {
+			inBlock = indented || startsBlock(trimmed)
+			upper := strings.ToUpper(strings.TrimSpace(stripComment(trimmed)))
+			if strings.HasPrefix(upper, "M28 ") || upper == "M28" {
+				writingFile = true
+			} else if strings.HasPrefix(upper, "M29") {
+				writingFile = false
+			}
+		}
+
+		var record []byte
+		if mayBeBinary {
+			record = encode(trimmed, lineNumber, position)
+		}
+
+		if record != nil {
+			numBinary++
+			if _, err = w.Write(record); err != nil {
+				panic(err)
+			}
+			position += uint32(len(record))
+		} else {
+			if !strings.HasSuffix(line, "\n") {
+				line += "\n"
+			}
+			numText++
+			if _, err = w.WriteString(line); err != nil {
+				panic(err)
+			}
+			position += uint32(len(line))
+		}
+	}
+
+	if err = w.Flush(); err != nil {
+		panic(err)
+	}
+	fmt.Printf("%d binary records, %d text lines\n", numBinary, numText)
+}
+
+// Remove a trailing comment from a line
+func stripComment(line string) string {
+	if i := strings.IndexAny(line, ";("); i >= 0 {
+		return line[:i]
+	}
+	return line
+}
+
+// Return true if the line is a meta command that starts a block
+func startsBlock(line string) bool {
+	for _, cmd := range blockCommands {
+		if strings.HasPrefix(line, cmd) && (len(line) == len(cmd) || !isLetterOrDigit(line[len(cmd)])) {
+			return true
+		}
+	}
+	return false
+}
+
+func isLetterOrDigit(c byte) bool {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'
+}
+
+// Try to encode a line as a binary record. Return nil if it must stay as text.
+func encode(line string, lineNumber int32, position uint32) []byte {
+	// Only strip ';' comments. Lines with '(' comments or anything else we don't recognise stay as text.
+	if i := strings.IndexByte(line, ';'); i >= 0 {
+		line = line[:i]
+	}
+	fields := strings.Fields(line)
+	if len(fields) == 0 || len(fields[0]) < 2 || (fields[0][0] != 'G' && fields[0][0] != 'g') {
+		return nil
+	}
+
+	// Parse the command number
+	var major, minor int32
+	flags := byte(flagHasMajorCommandNumber | flagHasFilePosition)
+	number := fields[0][1:]
+	if i := strings.IndexByte(number, '.'); i >= 0 {
+		m, err := strconv.ParseInt(number[i+1:], 10, 32)
+		if err != nil {
+			return nil
+		}
+		minor = int32(m)
+		flags |= flagHasMinorCommandNumber
+		number = number[:i]
+	}
+	m, err := strconv.ParseInt(number, 10, 32)
+	if err != nil || m < 0 || m > 3 {
+		return nil
+	}
+	major = int32(m)
+
+	// Parse the parameters. Only plain numbers are handled here; strings, expressions and arrays stay as text.
+	params := make([]parameter, 0, len(fields)-1)
+	for _, f := range fields[1:] {
+		if len(f) < 2 || len(f) > maxParameterLength {
+			return nil
+		}
+		letter := f[0]
+		if letter >= 'a' && letter <= 'z' {
+			letter -= 'a' - 'A'
+		}
+		if letter < 'A' || letter > 'Z' || letter == 'G' || letter == 'M' || letter == 'N' || letter == 'T' {
+			return nil
+		}
+		value := f[1:]
+		if strings.ContainsAny(value, "{}\":*") {
+			return nil
+		}
+		p := parameter{letter: letter}
+		if strings.ContainsAny(value, ".eE") {
+			v, err := strconv.ParseFloat(value, 32)
+			if err != nil || math.IsNaN(v) || math.IsInf(v, 0) {
+				return nil
+			}
+			p.isFloat = true
+			p.fltVal = float32(v)
+		} else {
+			v, err := strconv.ParseInt(value, 10, 32)
+			if err != nil {
+				return nil
+			}
+			p.intVal = int32(v)
+		}
+		params = append(params, p)
+	}
+
+	numWords := (codeHeaderSize + len(params)*codeParameterSize) / 4
+	if len(params) > 255 || numWords > maxRecordWords {
+		return nil
+	}
+
+	var buf bytes.Buffer
+	buf.WriteByte(recordMarker)
+	buf.WriteByte(byte(numWords))
+
+	// CodeHeader
+	buf.WriteByte(0)                 // channel, not used for local files
+	buf.WriteByte(flags)             // flags
+	buf.WriteByte(byte(len(params))) // numParameters
+	buf.WriteByte('G')               // letter
+	binary.Write(&buf, binary.LittleEndian, major)
+	binary.Write(&buf, binary.LittleEndian, minor)
+	binary.Write(&buf, binary.LittleEndian, position)
+	binary.Write(&buf, binary.LittleEndian, lineNumber)
+
+	// CodeParameter array
+	for _, p := range params {
+		buf.WriteByte(p.letter)
+		if p.isFloat {
+			buf.WriteByte(dataTypeFloat)
+			buf.Write([]byte{0, 0})
+			binary.Write(&buf, binary.LittleEndian, p.fltVal)
+		} else {
+			buf.WriteByte(dataTypeInt)
+			buf.Write([]byte{0, 0})
+			binary.Write(&buf, binary.LittleEndian, p.intVal)
+		}
+	}
+	return buf.Bytes()
+}
@@ -66,6 +66,7 @@ static uint32_t longestWaitTime = 0;
 static uint16_t longestWaitMessageType = 0;
 
 static uint32_t peakTimeSyncTxDelay = 0;
+static uint32_t lastDiagnosticsTime = 0;
 
 // Debug
 static unsigned int goodTimeStamps = 0;
@@ -1153,6 +1154,14 @@ void CanInterface::Diagnostics(MessageType mtype) noexcept
 	}
 
 	reprap.GetPlatform().MessageF(mtype, "Tx timeouts%s\n", str.c_str());
+
+	unsigned int motionMessagesSent, segmentsBatched, bufferWaits;
+	CanMotion::GetAndClearStats(motionMessagesSent, segmentsBatched, bufferWaits);
+	const uint32_t now = millis();
+	const uint32_t interval = now - lastDiagnosticsTime;
+	lastDiagnosticsTime = now;
+	reprap.GetPlatform().MessageF(mtype, "Motion messages %u (%.1f/sec), moves batched %u, waits for buffers %u\n",
+									motionMessagesSent, (double)((float)motionMessagesSent * 1000.0/(float)max<uint32_t>(interval, 1)), segmentsBatched, bufferWaits);
 	longestWaitTime = 0;
 	longestWaitMessageType = 0;
 	peakTimeSyncTxDelay = 0;
@@ -12,8 +12,11 @@
 #include <CanMessageBuffer.h>
 #include <CanMessageFormats.h>
 #include "CanInterface.h"
+#include "ExpansionManager.h"
+#include <Movement/Move.h>
 
 static CanMessageBuffer *movementBufferList = nullptr;
+static CanMessageBuffer *batchBufferList = nullptr;				// batches of moves waiting to be sent, at most one per board
 static CanMessageBuffer *urgentMessageBuffer = nullptr;
 static uint32_t currentMoveClocks;
 
@@ -30,9 +33,14 @@ static bool doingStopAll = false;
 static LargeBitmap<CanId::MaxCanAddress + 1> boardsActiveInLastMove;
 static uint8_t nextSeq[CanId::MaxCanAddress + 1] = { 0 };
 
+static unsigned int motionMessagesSent = 0;
+static unsigned int segmentsBatched = 0;						// how many moves were sent as part of a batch
+static unsigned int bufferWaits = 0;							// how many times we couldn't prepare a move because there were too few free CAN buffers
+
 void CanMotion::Init() noexcept
 {
 	movementBufferList = nullptr;
+	batchBufferList = nullptr;
 	urgentMessageBuffer = CanMessageBuffer::Allocate();
 	boardsActiveInLastMove.ClearAll();
 }
@@ -101,7 +109,9 @@ void CanMotion::AddMovement(const PrepParams& params, DriverId canDriver, int32_
 			move->finalSpeedFraction = params.finalSpeedFraction;
 			move->pressureAdvanceDrives = 0;
 			move->numDrivers = canDriver.localDriver + 1;
-			move->zero = 0;
+			move->smoothingClocksDiv32 = params.smoothingClocks/Move::SmoothingClockUnit;
+			move->smoothAccel = params.smoothAccel;
+			move->smoothDecel = params.smoothDecel;
 
 			// Clear out the per-drive fields. Can't use a range-based FOR loop on a packed struct.
 			for (size_t drive = 0; drive < ARRAY_SIZE(move->perDrive); ++drive)
@@ -122,6 +132,75 @@ void CanMotion::AddMovement(const PrepParams& params, DriverId canDriver, int32_
 	}
 }
 
+// Send a movement or batch message, giving it the next sequence number for its board
+static void SendMovementMessage(CanMessageBuffer *buf) noexcept
+{
+	uint8_t& seq = nextSeq[buf->id.Dst()];
+	if (buf->id.MsgType() == CanMessageType::movementLinearBatch)
+	{
+		buf->msg.moveLinearBatch.seq = seq;
+		buf->dataLength = buf->msg.moveLinearBatch.GetActualDataLength();
+	}
+	else
+	{
+		buf->msg.moveLinear.seq = seq;
+		buf->dataLength = buf->msg.moveLinear.GetActualDataLength();
+	}
+	seq = (seq + 1) & 0x7F;
+	CanInterface::SendMotion(buf);										// queues the buffer for sending and frees it when done
+	++motionMessagesSent;
+}
+
+// Add a move for a board that accepts batched moves to the batch for that board. Start a new batch if it can't be added to the existing one.
+static void AddToBatch(CanMessageBuffer *buf) noexcept
+{
+	const CanAddress board = buf->id.Dst();
+	CanMessageBuffer *prev = nullptr;
+	CanMessageBuffer *batchBuf = batchBufferList;
+	while (batchBuf != nullptr && batchBuf->id.Dst() != board)
+	{
+		prev = batchBuf;
+		batchBuf = batchBuf->next;
+	}
+
+	if (batchBuf != nullptr)
+	{
+		if (batchBuf->msg.moveLinearBatch.AddSegment(buf->msg.moveLinear))
+		{
+			CanMessageBuffer::Free(buf);
+			++segmentsBatched;
+			return;
+		}
+
+		// The move doesn't fit in the existing batch, so send that batch now
+		if (prev == nullptr)
+		{
+			batchBufferList = batchBuf->next;
+		}
+		else
+		{
+			prev->next = batchBuf->next;
+		}
+		SendMovementMessage(batchBuf);
+	}
+
+	CanMessageMovementLinearBatch batch;
+	batch.Init(buf->msg.moveLinear);
+	if (batch.AddSegment(buf->msg.moveLinear))
+	{
+		// Reuse the buffer for the new batch
+		buf->SetupRequestMessage<CanMessageMovementLinearBatch>(0, CanId::MasterAddress, board);
+		buf->msg.moveLinearBatch = batch;
+		buf->next = batchBufferList;
+		batchBufferList = buf;
+		++segmentsBatched;
+	}
+	else
+	{
+		SendMovementMessage(buf);										// this move can't be batched, so send it on its own
+	}
+}
+
 // This is called by DDA::Prepare when all DMs for CAN drives have been processed. Return the calculated move time in steps, or 0 if there are no CAN moves
 uint32_t CanMotion::FinishMovement(uint32_t moveStartTime) noexcept
 {
@@ -139,12 +218,16 @@ uint32_t CanMotion::FinishMovement(uint32_t moveStartTime) noexcept
 	{
 		boardsActiveInLastMove.SetBit(buf->id.Dst());					//TODO should we set this if there were no steps for drives on the board, just drives to be enabled?
 		buf->msg.moveLinear.whenToExecute = moveStartTime;
-		uint8_t& seq = nextSeq[buf->id.Dst()];
-		buf->msg.moveLinear.seq = seq;
-		seq = (seq + 1) & 0x7F;
-		buf->dataLength = buf->msg.moveLinear.GetActualDataLength();
 		CanMessageBuffer * const nextBuffer = buf->next;				// must get this before sending the buffer, because sending the buffer releases it
-		CanInterface::SendMotion(buf);									// queues the buffer for sending and frees it when done
+		const ExpansionBoardData * const boardData = reprap.GetExpansion().GetBoardDetails(buf->id.Dst());
+		if (boardData != nullptr && boardData->acceptsMoveBatches)
+		{
+			AddToBatch(buf);
+		}
+		else
+		{
+			SendMovementMessage(buf);
+		}
 #if 0
 		++numMotionMessagesSentLast;
 #endif
@@ -155,9 +238,33 @@ uint32_t CanMotion::FinishMovement(uint32_t moveStartTime) noexcept
 	return currentMoveClocks;
 }
 
+// This is called by DDARing::PrepareMoves when it has prepared all the moves it is going to for now, so that batched moves don't wait any longer
+void CanMotion::FlushMoveBatches() noexcept
+{
+	while (batchBufferList != nullptr)
+	{
+		CanMessageBuffer * const buf = batchBufferList;
+		batchBufferList = buf->next;
+		SendMovementMessage(buf);
+	}
+}
+
 bool CanMotion::CanPrepareMove() noexcept
 {
-	return CanMessageBuffer::GetFreeBuffers() >= MaxCanBoards;
+	if (CanMessageBuffer::GetFreeBuffers() >= MaxCanBoards)
+	{
+		return true;
+	}
+	++bufferWaits;
+	return false;
+}
+
+void CanMotion::GetAndClearStats(unsigned int& p_messagesSent, unsigned int& p_segmentsBatched, unsigned int& p_bufferWaits) noexcept
+{
+	p_messagesSent = motionMessagesSent;
+	p_segmentsBatched = segmentsBatched;
+	p_bufferWaits = bufferWaits;
+	motionMessagesSent = segmentsBatched = bufferWaits = 0;
 }
 
 // This is called by the CanSender task to check if we have any urgent messages to send
@@ -20,7 +20,9 @@ namespace CanMotion
 	void StartMovement() noexcept;
 	void AddMovement(const PrepParams& params, DriverId canDriver, int32_t steps, bool usePressureAdvance) noexcept;
 	uint32_t FinishMovement(uint32_t moveStartTime) noexcept;
+	void FlushMoveBatches() noexcept;
 	bool CanPrepareMove() noexcept;
+	void GetAndClearStats(unsigned int& messagesSent, unsigned int& segmentsBatched, unsigned int& bufferWaits) noexcept;
 	CanMessageBuffer *GetUrgentMessage() noexcept;
 
 	// The next 4 functions may be called from the step ISR, so they can't send CAN messages directly
@@ -14,7 +14,7 @@
 #include <Platform/Platform.h>
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 
-ExpansionBoardData::ExpansionBoardData() noexcept : typeName(nullptr), state(BoardState::unknown), numDrivers(0)
+ExpansionBoardData::ExpansionBoardData() noexcept : typeName(nullptr), state(BoardState::unknown), numDrivers(0), acceptsMoveBatches(false)
 {
 	mcuTemp.min = mcuTemp.max = mcuTemp.current = vin.max = vin.min = vin.current = v12.max = v12.min = v12.current = 0.0;
 }
@@ -139,6 +139,7 @@ void ExpansionManager::ProcessAnnouncement(CanMessageBuffer *buf) noexcept
 			board.typeName = newTypeName;
 			board.numDrivers = buf->msg.announce.numDrivers;
 		}
+		board.acceptsMoveBatches = buf->msg.announce.acceptsMoveBatches;
 		UpdateBoardState(src, BoardState::running);
 	}
 	buf->SetupResponseMessage<CanMessageAcknowledgeAnnounce>(0, CanInterface::GetCanAddress(), src);
@@ -27,6 +27,7 @@ struct ExpansionBoardData
 	MinMaxCurrent mcuTemp, vin, v12;
 	BoardState state;
 	uint8_t numDrivers;
+	bool acceptsMoveBatches;
 };
 
 class ExpansionManager INHERIT_OBJECT_MODEL
@@ -342,6 +342,9 @@ constexpr size_t MAX_FILES = 10;						// Must be large enough to handle the max
 
 constexpr size_t FILE_BUFFER_SIZE = 128;
 
+constexpr size_t FilePrefetchBlocks = 8;				// Number of 512-byte blocks to read ahead of the file being printed
+constexpr uint32_t FilePrefetchMinFileSize = 65536;		// Don't bother reading ahead from files smaller than this, which are probably macros
+
 // Webserver stuff
 #define DEFAULT_PASSWORD		"reprap"				// Default machine password
 #define DEFAULT_MACHINE_NAME	"My Duet"				// Default machine name
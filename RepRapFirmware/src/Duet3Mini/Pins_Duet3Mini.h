@@ -38,15 +38,26 @@ constexpr uint32_t IAP_IMAGE_START = 0x20038000;
 #define WIFI_FIRMWARE_FILE		"DuetWiFiServer.bin"
 
 // Features definition
-#define HAS_LWIP_NETWORKING		1
-#define HAS_WIFI_NETWORKING		1
+#ifdef HOST_SIM
+// The host simulation (see Hardware/Host) has no network interface and no SBC interface
+# define HAS_LWIP_NETWORKING	0
+# define HAS_WIFI_NETWORKING	0
+# define HAS_LINUX_INTERFACE	0
+#else
+# define HAS_LWIP_NETWORKING	1
+# define HAS_WIFI_NETWORKING	1
+# define HAS_LINUX_INTERFACE	1
+#endif
 #define HAS_W5500_NETWORKING	0
-#define HAS_LINUX_INTERFACE		1
 
 #define HAS_MASS_STORAGE		1
 #define HAS_HIGH_SPEED_SD		1
 //#define HAS_CPU_TEMP_SENSOR	0					// according to the SAME5x errata doc, the temperature sensors don't work in revision A or D chips (revision D is latest as at 2020-06-28)
-#define HAS_CPU_TEMP_SENSOR		1					// enable this as an experiment - it may be better than nothing
+#ifdef HOST_SIM
+# define HAS_CPU_TEMP_SENSOR	0
+#else
+# define HAS_CPU_TEMP_SENSOR	1					// enable this as an experiment - it may be better than nothing
+#endif
 
 #define SUPPORT_TMC22xx			1
 #define TMC22xx_HAS_MUX			1
@@ -56,7 +67,7 @@ constexpr uint32_t IAP_IMAGE_START = 0x20038000;
 #define ENFORCE_MAX_VIN			0
 #define HAS_VREF_MONITOR		1
 
-#ifdef DUET3MINI_V04
+#if defined(DUET3MINI_V04) && !defined(HOST_SIM)
 #define SUPPORT_CAN_EXPANSION	1
 #else
 #define SUPPORT_CAN_EXPANSION	0
@@ -73,8 +84,14 @@ constexpr uint32_t IAP_IMAGE_START = 0x20038000;
 #define SUPPORT_12864_LCD		1					// set nonzero to support 12864 LCD and rotary encoder
 #define SUPPORT_ACCELEROMETERS	1
 #define SUPPORT_OBJECT_MODEL	1
-#define SUPPORT_FTP				1
-#define SUPPORT_TELNET			1
+#ifdef HOST_SIM
+# define SUPPORT_FTP			0
+# define SUPPORT_TELNET		0
+# define SUPPORT_BINARY_OBJECT_MODEL	1			// there is no SBC, but the host tests compare the binary encoding with JSON
+#else
+# define SUPPORT_FTP			1
+# define SUPPORT_TELNET		1
+#endif
 #define SUPPORT_ASYNC_MOVES		1
 #define ALLOCATE_DEFAULT_PORTS	0
 #define TRACK_OBJECT_NAMES		1
@@ -0,0 +1,171 @@
+/*
+ * CompiledExpression.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#include "CompiledExpression.h"
+
+#if SUPPORT_EXPRESSION_CACHE
+
+CompiledExpression::CompiledExpression(FilePosition p_filePos, size_t p_bufferOffset) noexcept
+	: next(nullptr), filePos(p_filePos), textChecksum(0), bufferOffset((uint8_t)p_bufferOffset), textLength(0),
+	  codeLength(0), stackDepth(0), maxStackDepth(0), overflowed(false)
+{
+}
+
+// Simple Fletcher-16 checksum
+/*static*/ uint16_t CompiledExpression::Checksum(const char *text, size_t length) noexcept
+{
+	uint16_t sum1 = 0, sum2 = 0;
+	for (size_t i = 0; i < length; ++i)
+	{
+		sum1 = (sum1 + (uint8_t)text[i]) % 255;
+		sum2 = (sum2 + sum1) % 255;
+	}
+	return (sum2 << 8) | sum1;
+}
+
+// Record the text that this expression was compiled from
+void CompiledExpression::SetText(const char *text, size_t length) noexcept
+{
+	if (length > 255)
+	{
+		overflowed = true;
+	}
+	else
+	{
+		textLength = (uint8_t)length;
+		textChecksum = Checksum(text, length);
+	}
+}
+
+// Return true if this is the compiled code for the expression that starts at 'text'.
+// An expression that couldn't be compiled may not have a valid text length, so we match it on its position alone.
+bool CompiledExpression::Matches(FilePosition p_filePos, size_t p_bufferOffset, const char *text) const noexcept
+{
+	return filePos == p_filePos && bufferOffset == p_bufferOffset && (overflowed || Checksum(text, textLength) == textChecksum);
+}
+
+void CompiledExpression::Emit(ExpressionOpcode op, size_t textOffset) noexcept
+{
+	EmitByte((uint8_t)op);
+	EmitByte((uint8_t)textOffset);
+}
+
+void CompiledExpression::EmitByte(uint8_t b) noexcept
+{
+	if (codeLength < MaxCodeLength)
+	{
+		code[codeLength++] = b;
+	}
+	else
+	{
+		overflowed = true;
+	}
+}
+
+void CompiledExpression::EmitBytes(const void *p, size_t len) noexcept
+{
+	if (codeLength + len <= MaxCodeLength)
+	{
+		memcpy(code + codeLength, p, len);
+		codeLength += len;
+	}
+	else
+	{
+		overflowed = true;
+	}
+}
+
+// Emit a null-terminated string
+void CompiledExpression::EmitString(const char *s) noexcept
+{
+	EmitBytes(s, strlen(s) + 1);
+}
+
+// Emit a jump instruction with the target to be filled in later, returning the index of the target
+size_t CompiledExpression::EmitJump(ExpressionOpcode op, size_t textOffset) noexcept
+{
+	Emit(op, textOffset);
+	const size_t index = codeLength;
+	EmitByte(0);
+	return index;
+}
+
+// Set the target of a jump instruction to the current end of the code
+void CompiledExpression::PatchJump(size_t jumpOperandIndex) noexcept
+{
+	if (jumpOperandIndex < codeLength)
+	{
+		code[jumpOperandIndex] = codeLength;
+	}
+}
+
+// Keep track of how many values the generated code will have on the stack
+void CompiledExpression::AdjustStackDepth(int change) noexcept
+{
+	stackDepth += change;
+	if (stackDepth > maxStackDepth)
+	{
+		maxStackDepth = stackDepth;
+		if (maxStackDepth > MaxStackDepth)
+		{
+			overflowed = true;
+		}
+	}
+}
+
+// Look for the compiled code for an expression, moving it to the front of the list if we find it
+CompiledExpression *ExpressionCache::Find(FilePosition filePos, size_t bufferOffset, const char *text) noexcept
+{
+	CompiledExpression *prev = nullptr;
+	for (CompiledExpression *ce = head; ce != nullptr; ce = ce->next)
+	{
+		if (ce->Matches(filePos, bufferOffset, text))
+		{
+			if (prev != nullptr)
+			{
+				prev->next = ce->next;
+				ce->next = head;
+				head = ce;
+			}
+			return ce;
+		}
+		prev = ce;
+	}
+	return nullptr;
+}
+
+// Add a newly-compiled expression, discarding the least recently used one if the cache is full
+void ExpressionCache::Add(CompiledExpression *ce) noexcept
+{
+	ce->next = head;
+	head = ce;
+
+	size_t count = 1;
+	for (CompiledExpression *p = head; p->next != nullptr; p = p->next)
+	{
+		if (++count > MaxEntries)
+		{
+			delete p->next;
+			p->next = nullptr;
+			break;
+		}
+	}
+}
+
+void ExpressionCache::Clear() noexcept
+{
+	while (head != nullptr)
+	{
+		CompiledExpression * const ce = head;
+		head = ce->next;
+		delete ce;
+	}
+}
+
+#endif
+
+// End
@@ -0,0 +1,113 @@
+/*
+ * CompiledExpression.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  A CompiledExpression holds the bytecode that ExpressionParser generates from the text of an expression, so that an expression that is evaluated
+ *  repeatedly (e.g. inside a 'while' loop in a macro file) need only be parsed once. Numbers are stored already converted, object model paths
+ *  have the table entry for their first element already looked up, and the operators and functions are stored in postfix order.
+ *  The compiled expressions for a file are cached in the GCodeMachineState for that file and discarded when the file is closed.
+ */
+
+#ifndef SRC_GCODES_GCODEBUFFER_COMPILEDEXPRESSION_H_
+#define SRC_GCODES_GCODEBUFFER_COMPILEDEXPRESSION_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_EXPRESSION_CACHE
+
+#include <General/FreelistManager.h>
+
+class ObjectModelTableEntry;
+struct ObjectModelClassDescriptor;
+
+// Operation codes. Each opcode is followed by the offset of the corresponding text from the start of the expression, so that we can report errors
+// at the correct column, and then by its operands. Multi-byte operands are not aligned.
+enum class ExpressionOpcode : uint8_t
+{
+	end,						// end of the expression, the result is on top of the stack
+	pushInt,					// int32_t value
+	pushFloat,					// float value, uint8_t number of decimal digits
+	pushString,					// null-terminated string
+	pushConstant,				// uint8_t NamedConstant
+	pushVariable,				// uint8_t VariableKind, uint8_t flags, uint8_t number of indices to pop, null-terminated name
+	pushObjectValue,			// uint8_t flags, uint8_t number of indices to pop, table entry pointer or null, class descriptor pointer, null-terminated ID
+	unaryOperator,				// char operator
+	binaryOperator,				// char operator, uint8_t invert flag
+	function,					// uint8_t Function, uint8_t number of arguments
+	toBool,						// convert the value on top of the stack to Boolean
+	andThen,					// uint8_t target: convert top of stack to Boolean; if false then jump to target, else pop it
+	orElse,						// uint8_t target: convert top of stack to Boolean; if true then jump to target, else pop it
+	jumpIfFalse,				// uint8_t target: convert top of stack to Boolean and pop it; if it was false then jump to target
+	jump						// uint8_t target
+};
+
+class CompiledExpression
+{
+public:
+	static constexpr size_t MaxCodeLength = 160;			// jump targets are 8 bits, so this must not exceed 255
+	static constexpr size_t MaxStackDepth = 8;
+
+	static constexpr uint8_t FlagWantLength = 0x01;			// flags for pushVariable and pushObjectValue
+	static constexpr uint8_t FlagWantExists = 0x02;
+
+	enum VariableKind : uint8_t { parameter = 0, global, local };
+
+	void* operator new(size_t sz) noexcept { return FreelistManager::Allocate<CompiledExpression>(); }
+	void operator delete(void* p) noexcept { FreelistManager::Release<CompiledExpression>(p); }
+
+	CompiledExpression(FilePosition p_filePos, size_t p_bufferOffset) noexcept;
+
+	bool Matches(FilePosition p_filePos, size_t p_bufferOffset, const char *text) const noexcept;
+	void SetText(const char *text, size_t length) noexcept;
+	size_t GetTextLength() const noexcept { return textLength; }
+	const uint8_t *GetCode() const noexcept { return code; }
+
+	// Functions used by ExpressionParser to generate the code
+	bool IsValid() const noexcept { return !overflowed; }
+	void Invalidate() noexcept { overflowed = true; }
+	void Emit(ExpressionOpcode op, size_t textOffset) noexcept;
+	void EmitByte(uint8_t b) noexcept;
+	void EmitBytes(const void *p, size_t len) noexcept;
+	void EmitString(const char *s) noexcept;
+	size_t EmitJump(ExpressionOpcode op, size_t textOffset) noexcept;
+	void PatchJump(size_t jumpOperandIndex) noexcept;
+	void AdjustStackDepth(int change) noexcept;
+
+	CompiledExpression *next;								// next in the cache list
+
+private:
+	static uint16_t Checksum(const char *text, size_t length) noexcept;
+
+	FilePosition filePos;									// file position of the command that contains the expression
+	uint16_t textChecksum;									// checksum of the text, so that we don't use stale code if the file has been changed
+	uint8_t bufferOffset;									// offset of the expression in the GCodeBuffer
+	uint8_t textLength;										// length of the text that was compiled
+	uint8_t codeLength;
+	uint8_t stackDepth;
+	uint8_t maxStackDepth;
+	bool overflowed;										// true if the code or text was too long, or the expression couldn't be compiled for another reason
+	uint8_t code[MaxCodeLength];
+};
+
+// Cache of compiled expressions belonging to one file
+class ExpressionCache
+{
+public:
+	ExpressionCache() noexcept : head(nullptr) { }
+	~ExpressionCache() noexcept { Clear(); }
+
+	CompiledExpression *Find(FilePosition filePos, size_t bufferOffset, const char *text) noexcept;
+	void Add(CompiledExpression *ce) noexcept;
+	void Clear() noexcept;
+
+private:
+	static constexpr size_t MaxEntries = 8;
+
+	CompiledExpression *head;								// most recently used first
+};
+
+#endif
+
+#endif /* SRC_GCODES_GCODEBUFFER_COMPILEDEXPRESSION_H_ */
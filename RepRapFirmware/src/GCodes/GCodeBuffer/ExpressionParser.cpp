@@ -38,6 +38,9 @@ const char * const InvalidExistsMessage = "invalid 'exists' expression";
 
 ExpressionParser::ExpressionParser(const GCodeBuffer& p_gb, const char *text, const char *textLimit, int p_column) noexcept
 	: currentp(text), startp(text), endp(textLimit), gb(p_gb), column(p_column)
+#if SUPPORT_EXPRESSION_CACHE
+	  , compiling(nullptr)
+#endif
 {
 }
 
@@ -58,7 +61,12 @@ ExpressionValue ExpressionParser::Parse(bool evaluate) THROWS(GCodeException)
 {
 	obsoleteField.Clear();
 	ExpressionValue result;
-	ParseInternal(result, evaluate, 0);
+#if SUPPORT_EXPRESSION_CACHE
+	if (!evaluate || !ParseCompiled(result))
+#endif
+	{
+		ParseInternal(result, evaluate, 0);
+	}
 	if (!obsoleteField.IsEmpty())
 	{
 		reprap.GetPlatform().MessageF(WarningMessage, "obsolete object model field %s queried\n", obsoleteField.c_str());
@@ -68,6 +76,7 @@ ExpressionValue ExpressionParser::Parse(bool evaluate) THROWS(GCodeException)
 
 // Evaluate an expression internally, stopping before any binary operators with priority 'priority' or lower
 // This is recursive, so avoid allocating large amounts of data on the stack
+// If we are compiling the expression then 'evaluate' is false, and instead of applying operators to the values we generate code to do so
 void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_t priority) THROWS(GCodeException)
 {
 	// Lists of binary operators and their priorities
@@ -79,50 +88,36 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 	// Start by looking for a unary operator or opening bracket
 	SkipWhiteSpace();
 	const char c = CurrentCharacter();
+#if SUPPORT_EXPRESSION_CACHE
+	const size_t textOffset = currentp - startp;
+#endif
 	switch (c)
 	{
 	case '"':
 		ParseQuotedString(val);
-		break;
-
-	case '-':
-		AdvancePointer();
-		CheckStack(StackUsage::ParseInternal);
-		ParseInternal(val, evaluate, UnaryPriority);
-		switch (val.GetType())
+#if SUPPORT_EXPRESSION_CACHE
+		if (compiling != nullptr)
 		{
-		case TypeCode::Int32:
-			val.iVal = -val.iVal;		//TODO overflow check
-			break;
-
-		case TypeCode::Float:
-			val.fVal = -val.fVal;
-			break;
-
-		default:
-			ThrowParseException("expected numeric value after '-'");
+			EmitLiteral(val, textOffset);
 		}
+#endif
 		break;
 
+	case '-':
 	case '+':
+	case '!':
 		AdvancePointer();
 		CheckStack(StackUsage::ParseInternal);
 		ParseInternal(val, evaluate, UnaryPriority);
-		switch (val.GetType())
+#if SUPPORT_EXPRESSION_CACHE
+		if (compiling != nullptr)
 		{
-		case TypeCode::Uint32:
-			// Convert enumeration to integer
-			val.iVal = (int32_t)val.uVal;
-			val.SetType(TypeCode::Int32);
-			break;
-
-		case TypeCode::Int32:
-		case TypeCode::Float:
+			compiling->Emit(ExpressionOpcode::unaryOperator, textOffset);
+			compiling->EmitByte(c);
 			break;
-
-		default:
-			ThrowParseException("expected numeric or enumeration value after '+'");
 		}
+#endif
+		ApplyUnaryOperator(c, val, evaluate);
 		break;
 
 	case '#':
@@ -138,18 +133,15 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 		{
 			CheckStack(StackUsage::ParseInternal);
 			ParseInternal(val, evaluate, UnaryPriority);
-			if (val.GetType() == TypeCode::CString)
-			{
-				val.Set((int32_t)strlen(val.sVal));
-			}
-			else if (val.GetType() == TypeCode::HeapString)
+#if SUPPORT_EXPRESSION_CACHE
+			if (compiling != nullptr)
 			{
-				val.Set((int32_t)val.shVal.GetLength());
-			}
-			else
-			{
-				ThrowParseException("expected object model value or string after '#");
+				compiling->Emit(ExpressionOpcode::unaryOperator, textOffset);
+				compiling->EmitByte(c);
+				break;
 			}
+#endif
+			ApplyUnaryOperator(c, val, evaluate);
 		}
 		break;
 
@@ -163,18 +155,16 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 		ParseExpectKet(val, evaluate, ')');
 		break;
 
-	case '!':
-		AdvancePointer();
-		CheckStack(StackUsage::ParseInternal);
-		ParseInternal(val, evaluate, UnaryPriority);
-		ConvertToBool(val, evaluate);
-		val.bVal = !val.bVal;
-		break;
-
 	default:
 		if (isdigit(c))						// looks like a number
 		{
 			ParseNumber(val);
+#if SUPPORT_EXPRESSION_CACHE
+			if (compiling != nullptr)
+			{
+				EmitLiteral(val, textOffset);
+			}
+#endif
 		}
 		else if (isalpha(c))				// looks like a variable name
 		{
@@ -210,6 +200,9 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 			return;
 		}
 
+#if SUPPORT_EXPRESSION_CACHE
+		const size_t opTextOffset = currentp - startp;
+#endif
 		AdvancePointer();								// skip the [first] operator character
 
 		// Handle >= and <= and !=
@@ -237,6 +230,55 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 			AdvancePointer();
 		}
 
+#if SUPPORT_EXPRESSION_CACHE
+		if (compiling != nullptr)
+		{
+			// Generate code for the operator. The first operand is already on the stack.
+			ExpressionValue val2;
+			CheckStack(StackUsage::ParseInternal);
+			switch (opChar)
+			{
+			case '&':
+			case '|':
+				{
+					const size_t jumpIndex = compiling->EmitJump((opChar == '&') ? ExpressionOpcode::andThen : ExpressionOpcode::orElse, opTextOffset);
+					compiling->AdjustStackDepth(-1);
+					ParseInternal(val2, false, opPrio);								// generate code for the next operand
+					compiling->Emit(ExpressionOpcode::toBool, opTextOffset);
+					compiling->PatchJump(jumpIndex);
+				}
+				break;
+
+			case '?':
+				{
+					const size_t elseJumpIndex = compiling->EmitJump(ExpressionOpcode::jumpIfFalse, opTextOffset);
+					compiling->AdjustStackDepth(-1);
+					ParseInternal(val2, false, opPrio);								// generate code for the second operand
+					if (CurrentCharacter() != ':')
+					{
+						ThrowParseException("expected ':'");
+					}
+					AdvancePointer();
+					const size_t endJumpIndex = compiling->EmitJump(ExpressionOpcode::jump, opTextOffset);
+					compiling->AdjustStackDepth(-1);								// only one of the second and third operands gets pushed
+					compiling->PatchJump(elseJumpIndex);
+					ParseInternal(val2, false, opPrio - 1);							// generate code for the third operand
+					compiling->PatchJump(endJumpIndex);
+				}
+				return;
+
+			default:
+				ParseInternal(val2, false, opPrio);									// generate code for the next operand
+				compiling->Emit(ExpressionOpcode::binaryOperator, opTextOffset);
+				compiling->EmitByte(opChar);
+				compiling->EmitByte((uint8_t)invert);
+				compiling->AdjustStackDepth(-1);
+				break;
+			}
+			continue;
+		}
+#endif
+
 		// Handle operators that do not always evaluate their second operand
 		switch (opChar)
 		{
@@ -291,288 +333,361 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 				ExpressionValue val2;
 				CheckStack(StackUsage::ParseInternal);
 				ParseInternal(val2, evaluate, opPrio);	// get the next operand
-				switch(opChar)
-				{
-				case '+':
-					if (val.GetType() == TypeCode::DateTime)
-					{
-						if (val2.GetType() == TypeCode::Uint32)
-						{
-							val.Set56BitValue(val.Get56BitValue() + val2.uVal);
-						}
-						else if (val2.GetType() == TypeCode::Int32)
-						{
-							val.Set56BitValue((int64_t)val.Get56BitValue() + val2.iVal);
-						}
-						else
-						{
-							ThrowParseException("invalid operand types");
-						}
-					}
-					else
-					{
-						BalanceNumericTypes(val, val2, evaluate);
-						if (val.GetType() == TypeCode::Float)
-						{
-							val.fVal += val2.fVal;
-							val.param = max(val.param, val2.param);
-						}
-						else
-						{
-							val.iVal += val2.iVal;
-						}
-					}
-					break;
-
-				case '-':
-					if (val.GetType() == TypeCode::DateTime)
-					{
-						if (val2.GetType() == TypeCode::DateTime)
-						{
-							// Difference of two data/times
-							val.SetType(TypeCode::Int32);
-							val.iVal = (int32_t)(val.Get56BitValue() - val2.Get56BitValue());
-						}
-						if (val2.GetType() == TypeCode::Uint32)
-						{
-							val.Set56BitValue(val.Get56BitValue() - val2.uVal);
-						}
-						else if (val2.GetType() == TypeCode::Int32)
-						{
-							val.Set56BitValue((int64_t)val.Get56BitValue() - val2.iVal);
-						}
-						else
-						{
-							ThrowParseException("invalid operand types");
-						}
-					}
-					else
-					{
-						BalanceNumericTypes(val, val2, evaluate);
-						if (val.GetType() == TypeCode::Float)
-						{
-							val.fVal -= val2.fVal;
-							val.param = max(val.param, val2.param);
-						}
-						else
-						{
-							val.iVal -= val2.iVal;
-						}
-					}
-					break;
-
-				case '*':
-					BalanceNumericTypes(val, val2, evaluate);
-					if (val.GetType() == TypeCode::Float)
-					{
-						val.fVal *= val2.fVal;
-						val.param = max(val.param, val2.param);
-					}
-					else
-					{
-						val.iVal *= val2.iVal;
-					}
-					break;
-
-				case '/':
-					ConvertToFloat(val, evaluate);
-					ConvertToFloat(val2, evaluate);
-					val.fVal /= val2.fVal;
-					val.param = 0;
-					break;
-
-				case '>':
-					BalanceTypes(val, val2, evaluate);
-					switch (val.GetType())
-					{
-					case TypeCode::Int32:
-						val.bVal = (val.iVal > val2.iVal);
-						break;
-
-					case TypeCode::Float:
-						val.bVal = (val.fVal > val2.fVal);
-						break;
-
-					case TypeCode::Bool:
-						val.bVal = (val.bVal && !val2.bVal);
-						break;
-
-					default:
-						ThrowParseException("expected numeric or Boolean operands to comparison operator");
-					}
-					val.SetType(TypeCode::Bool);
-					if (invert)
-					{
-						val.bVal = !val.bVal;
-					}
-					break;
-
-				case '<':
-					BalanceTypes(val, val2, evaluate);
-					switch (val.GetType())
-					{
-					case TypeCode::Int32:
-						val.bVal = (val.iVal < val2.iVal);
-						break;
-
-					case TypeCode::Float:
-						val.bVal = (val.fVal < val2.fVal);
-						break;
-
-					case TypeCode::Bool:
-						val.bVal = (!val.bVal && val2.bVal);
-						break;
-
-					default:
-						ThrowParseException("expected numeric or Boolean operands to comparison operator");
-					}
-					val.SetType(TypeCode::Bool);
-					if (invert)
-					{
-						val.bVal = !val.bVal;
-					}
-					break;
-
-				case '=':
-					// Before balancing, handle comparisons with null
-					if (val.GetType() == TypeCode::None)
-					{
-						val.bVal = (val2.GetType() == TypeCode::None);
-					}
-					else if (val2.GetType() == TypeCode::None)
-					{
-						val.bVal = false;
-					}
-					else
-					{
-						BalanceTypes(val, val2, evaluate);
-						switch (val.GetType())
-						{
-						case TypeCode::ObjectModel:
-							ThrowParseException("cannot compare objects");
-
-						case TypeCode::Int32:
-							val.bVal = (val.iVal == val2.iVal);
-							break;
-
-						case TypeCode::Uint32:
-							val.bVal = (val.uVal == val2.uVal);
-							break;
-
-						case TypeCode::Float:
-							val.bVal = (val.fVal == val2.fVal);
-							break;
-
-						case TypeCode::Bool:
-							val.bVal = (val.bVal == val2.bVal);
-							break;
-
-						case TypeCode::CString:
-							val.bVal = (strcmp(val.sVal, (val2.GetType() == TypeCode::HeapString) ? val2.shVal.Get().Ptr() : val2.sVal) == 0);
-							break;
-
-						case TypeCode::HeapString:
-							val.bVal = (strcmp(val.shVal.Get().Ptr(), (val2.GetType() == TypeCode::HeapString) ? val2.shVal.Get().Ptr() : val2.sVal) == 0);
-							break;
-
-						default:
-							ThrowParseException("unexpected operand type to equality operator");
-						}
-					}
-					val.SetType(TypeCode::Bool);
-					if (invert)
-					{
-						val.bVal = !val.bVal;
-					}
-					break;
-
-				case '^':
-					StringConcat(val, val2);
-					break;
-				}
+				ApplyBinaryOperator(opChar, invert, val, val2, evaluate);
 			}
 		}
 	} while (true);
 }
 
-// Concatenate val1 and val2 and assign the result to val1
-// This is written as a separate function because it needs a temporary string buffer, and its caller is recursive. Its declaration must be declared 'noinline'.
-/*static*/ void  ExpressionParser::StringConcat(ExpressionValue &val, ExpressionValue &val2) noexcept
-{
-    String<MaxStringExpressionLength> str;
-    val.AppendAsString(str.GetRef());
-    val2.AppendAsString(str.GetRef());
-    StringHandle sh(str.c_str());
-    val.Set(sh);
-}
-
-bool ExpressionParser::ParseBoolean() THROWS(GCodeException)
+// Apply a unary operator to a value
+void ExpressionParser::ApplyUnaryOperator(char op, ExpressionValue& val, bool evaluate) THROWS(GCodeException)
 {
-	ExpressionValue val = Parse();
-	ConvertToBool(val, true);
-	return val.bVal;
-}
+	switch (op)
+	{
+	case '-':
+		switch (val.GetType())
+		{
+		case TypeCode::Int32:
+			val.iVal = -val.iVal;		//TODO overflow check
+			break;
 
-float ExpressionParser::ParseFloat() THROWS(GCodeException)
-{
-	ExpressionValue val = Parse();
-	ConvertToFloat(val, true);
-	return val.fVal;
-}
+		case TypeCode::Float:
+			val.fVal = -val.fVal;
+			break;
 
-int32_t ExpressionParser::ParseInteger() THROWS(GCodeException)
-{
-	ExpressionValue val = Parse();
-	switch (val.GetType())
-	{
-	case TypeCode::Int32:
-		return val.iVal;
+		default:
+			ThrowParseException("expected numeric value after '-'");
+		}
+		break;
 
-	case TypeCode::Uint32:
-		if (val.uVal > (uint32_t)std::numeric_limits<int32_t>::max())
+	case '+':
+		switch (val.GetType())
 		{
-			ThrowParseException("unsigned integer too large");
-		}
-		return (int32_t)val.uVal;
+		case TypeCode::Uint32:
+			// Convert enumeration to integer
+			val.iVal = (int32_t)val.uVal;
+			val.SetType(TypeCode::Int32);
+			break;
 
-	default:
-		ThrowParseException("expected integer value");
-	}
-}
+		case TypeCode::Int32:
+		case TypeCode::Float:
+			break;
 
-uint32_t ExpressionParser::ParseUnsigned() THROWS(GCodeException)
-{
-	ExpressionValue val = Parse();
-	switch (val.GetType())
-	{
-	case TypeCode::Uint32:
-		return val.uVal;
+		default:
+			ThrowParseException("expected numeric or enumeration value after '+'");
+		}
+		break;
 
-	case TypeCode::Int32:
-		if (val.iVal >= 0)
+	case '#':
+		if (val.GetType() == TypeCode::CString)
 		{
-			return (uint32_t)val.iVal;
+			val.Set((int32_t)strlen(val.sVal));
 		}
-		ThrowParseException("value must be non-negative");
+		else if (val.GetType() == TypeCode::HeapString)
+		{
+			val.Set((int32_t)val.shVal.GetLength());
+		}
+		else
+		{
+			ThrowParseException("expected object model value or string after '#");
+		}
+		break;
+
+	case '!':
+		ConvertToBool(val, evaluate);
+		val.bVal = !val.bVal;
+		break;
 
 	default:
-		ThrowParseException("expected non-negative integer value");
+		THROW_INTERNAL_ERROR;
 	}
 }
 
-void ExpressionParser::BalanceNumericTypes(ExpressionValue& val1, ExpressionValue& val2, bool evaluate) const THROWS(GCodeException)
+// Apply a binary operator that always evaluates both its operands, leaving the result in 'val'
+void ExpressionParser::ApplyBinaryOperator(char op, bool invert, ExpressionValue& val, ExpressionValue& val2, bool evaluate) THROWS(GCodeException)
 {
-	// First convert any Uint64 or Uint32 operands to float
-	if (val1.GetType() == TypeCode::Uint64 || val1.GetType() == TypeCode::Uint32)
+	switch (op)
 	{
-		ConvertToFloat(val1, evaluate);
-	}
-	if (val2.GetType() == TypeCode::Uint64 || val2.GetType() == TypeCode::Uint32)
-	{
-		ConvertToFloat(val2, evaluate);
-	}
-
-	if (val1.GetType() == TypeCode::Float)
+	case '+':
+		if (val.GetType() == TypeCode::DateTime)
+		{
+			if (val2.GetType() == TypeCode::Uint32)
+			{
+				val.Set56BitValue(val.Get56BitValue() + val2.uVal);
+			}
+			else if (val2.GetType() == TypeCode::Int32)
+			{
+				val.Set56BitValue((int64_t)val.Get56BitValue() + val2.iVal);
+			}
+			else
+			{
+				ThrowParseException("invalid operand types");
+			}
+		}
+		else
+		{
+			BalanceNumericTypes(val, val2, evaluate);
+			if (val.GetType() == TypeCode::Float)
+			{
+				val.fVal += val2.fVal;
+				val.param = max(val.param, val2.param);
+			}
+			else
+			{
+				val.iVal += val2.iVal;
+			}
+		}
+		break;
+
+	case '-':
+		if (val.GetType() == TypeCode::DateTime)
+		{
+			if (val2.GetType() == TypeCode::DateTime)
+			{
+				// Difference of two data/times
+				val.SetType(TypeCode::Int32);
+				val.iVal = (int32_t)(val.Get56BitValue() - val2.Get56BitValue());
+			}
+			if (val2.GetType() == TypeCode::Uint32)
+			{
+				val.Set56BitValue(val.Get56BitValue() - val2.uVal);
+			}
+			else if (val2.GetType() == TypeCode::Int32)
+			{
+				val.Set56BitValue((int64_t)val.Get56BitValue() - val2.iVal);
+			}
+			else
+			{
+				ThrowParseException("invalid operand types");
+			}
+		}
+		else
+		{
+			BalanceNumericTypes(val, val2, evaluate);
+			if (val.GetType() == TypeCode::Float)
+			{
+				val.fVal -= val2.fVal;
+				val.param = max(val.param, val2.param);
+			}
+			else
+			{
+				val.iVal -= val2.iVal;
+			}
+		}
+		break;
+
+	case '*':
+		BalanceNumericTypes(val, val2, evaluate);
+		if (val.GetType() == TypeCode::Float)
+		{
+			val.fVal *= val2.fVal;
+			val.param = max(val.param, val2.param);
+		}
+		else
+		{
+			val.iVal *= val2.iVal;
+		}
+		break;
+
+	case '/':
+		ConvertToFloat(val, evaluate);
+		ConvertToFloat(val2, evaluate);
+		val.fVal /= val2.fVal;
+		val.param = 0;
+		break;
+
+	case '>':
+		BalanceTypes(val, val2, evaluate);
+		switch (val.GetType())
+		{
+		case TypeCode::Int32:
+			val.bVal = (val.iVal > val2.iVal);
+			break;
+
+		case TypeCode::Float:
+			val.bVal = (val.fVal > val2.fVal);
+			break;
+
+		case TypeCode::Bool:
+			val.bVal = (val.bVal && !val2.bVal);
+			break;
+
+		default:
+			ThrowParseException("expected numeric or Boolean operands to comparison operator");
+		}
+		val.SetType(TypeCode::Bool);
+		if (invert)
+		{
+			val.bVal = !val.bVal;
+		}
+		break;
+
+	case '<':
+		BalanceTypes(val, val2, evaluate);
+		switch (val.GetType())
+		{
+		case TypeCode::Int32:
+			val.bVal = (val.iVal < val2.iVal);
+			break;
+
+		case TypeCode::Float:
+			val.bVal = (val.fVal < val2.fVal);
+			break;
+
+		case TypeCode::Bool:
+			val.bVal = (!val.bVal && val2.bVal);
+			break;
+
+		default:
+			ThrowParseException("expected numeric or Boolean operands to comparison operator");
+		}
+		val.SetType(TypeCode::Bool);
+		if (invert)
+		{
+			val.bVal = !val.bVal;
+		}
+		break;
+
+	case '=':
+		// Before balancing, handle comparisons with null
+		if (val.GetType() == TypeCode::None)
+		{
+			val.bVal = (val2.GetType() == TypeCode::None);
+		}
+		else if (val2.GetType() == TypeCode::None)
+		{
+			val.bVal = false;
+		}
+		else
+		{
+			BalanceTypes(val, val2, evaluate);
+			switch (val.GetType())
+			{
+			case TypeCode::ObjectModel:
+				ThrowParseException("cannot compare objects");
+
+			case TypeCode::Int32:
+				val.bVal = (val.iVal == val2.iVal);
+				break;
+
+			case TypeCode::Uint32:
+				val.bVal = (val.uVal == val2.uVal);
+				break;
+
+			case TypeCode::Float:
+				val.bVal = (val.fVal == val2.fVal);
+				break;
+
+			case TypeCode::Bool:
+				val.bVal = (val.bVal == val2.bVal);
+				break;
+
+			case TypeCode::CString:
+				val.bVal = (strcmp(val.sVal, (val2.GetType() == TypeCode::HeapString) ? val2.shVal.Get().Ptr() : val2.sVal) == 0);
+				break;
+
+			case TypeCode::HeapString:
+				val.bVal = (strcmp(val.shVal.Get().Ptr(), (val2.GetType() == TypeCode::HeapString) ? val2.shVal.Get().Ptr() : val2.sVal) == 0);
+				break;
+
+			default:
+				ThrowParseException("unexpected operand type to equality operator");
+			}
+		}
+		val.SetType(TypeCode::Bool);
+		if (invert)
+		{
+			val.bVal = !val.bVal;
+		}
+		break;
+
+	case '^':
+		StringConcat(val, val2);
+		break;
+
+	default:
+		THROW_INTERNAL_ERROR;
+	}
+}
+
+// Concatenate val1 and val2 and assign the result to val1
+// This is written as a separate function because it needs a temporary string buffer, and its caller is recursive. Its declaration must be declared 'noinline'.
+/*static*/ void  ExpressionParser::StringConcat(ExpressionValue &val, ExpressionValue &val2) noexcept
+{
+    String<MaxStringExpressionLength> str;
+    val.AppendAsString(str.GetRef());
+    val2.AppendAsString(str.GetRef());
+    StringHandle sh(str.c_str());
+    val.Set(sh);
+}
+
+bool ExpressionParser::ParseBoolean() THROWS(GCodeException)
+{
+	ExpressionValue val = Parse();
+	ConvertToBool(val, true);
+	return val.bVal;
+}
+
+float ExpressionParser::ParseFloat() THROWS(GCodeException)
+{
+	ExpressionValue val = Parse();
+	ConvertToFloat(val, true);
+	return val.fVal;
+}
+
+int32_t ExpressionParser::ParseInteger() THROWS(GCodeException)
+{
+	ExpressionValue val = Parse();
+	switch (val.GetType())
+	{
+	case TypeCode::Int32:
+		return val.iVal;
+
+	case TypeCode::Uint32:
+		if (val.uVal > (uint32_t)std::numeric_limits<int32_t>::max())
+		{
+			ThrowParseException("unsigned integer too large");
+		}
+		return (int32_t)val.uVal;
+
+	default:
+		ThrowParseException("expected integer value");
+	}
+}
+
+uint32_t ExpressionParser::ParseUnsigned() THROWS(GCodeException)
+{
+	ExpressionValue val = Parse();
+	switch (val.GetType())
+	{
+	case TypeCode::Uint32:
+		return val.uVal;
+
+	case TypeCode::Int32:
+		if (val.iVal >= 0)
+		{
+			return (uint32_t)val.iVal;
+		}
+		ThrowParseException("value must be non-negative");
+
+	default:
+		ThrowParseException("expected non-negative integer value");
+	}
+}
+
+void ExpressionParser::BalanceNumericTypes(ExpressionValue& val1, ExpressionValue& val2, bool evaluate) const THROWS(GCodeException)
+{
+	// First convert any Uint64 or Uint32 operands to float
+	if (val1.GetType() == TypeCode::Uint64 || val1.GetType() == TypeCode::Uint32)
+	{
+		ConvertToFloat(val1, evaluate);
+	}
+	if (val2.GetType() == TypeCode::Uint64 || val2.GetType() == TypeCode::Uint32)
+	{
+		ConvertToFloat(val2, evaluate);
+	}
+
+	if (val1.GetType() == TypeCode::Float)
 	{
 		ConvertToFloat(val2, evaluate);						// both are now float
 	}
@@ -750,6 +865,10 @@ void ExpressionParser::ParseIdentifierExpression(ExpressionValue& rslt, bool eva
 
 	String<MaxVariableNameLength> id;
 	ObjectExplorationContext context(applyLengthOperator, applyExists, gb.GetLineNumber(), GetColumn());
+#if SUPPORT_EXPRESSION_CACHE
+	const size_t idTextOffset = currentp - startp;
+	unsigned int numIndices = 0;
+#endif
 
 	// Loop parsing identifiers and index expressions
 	// When we come across an index expression, evaluate it, add it to the context, and place a marker in the identifier string.
@@ -766,6 +885,13 @@ void ExpressionParser::ParseIdentifierExpression(ExpressionValue& rslt, bool eva
 			{
 				ThrowParseException("expected ']'");
 			}
+#if SUPPORT_EXPRESSION_CACHE
+			if (compiling != nullptr)
+			{
+				index.Set((int32_t)0);							// the compiled code checks the type of the index when it is executed
+				++numIndices;
+			}
+#endif
 			if (index.GetType() != TypeCode::Int32)
 			{
 				ThrowParseException("expected integer expression");
@@ -789,64 +915,17 @@ void ExpressionParser::ParseIdentifierExpression(ExpressionValue& rslt, bool eva
 			ThrowParseException(InvalidExistsMessage);
 		}
 
-		switch (whichConstant.RawValue())
+#if SUPPORT_EXPRESSION_CACHE
+		if (compiling != nullptr)
 		{
-		case NamedConstant::_true:
-			rslt.Set(true);
-			return;
-
-		case NamedConstant::_false:
-			rslt.Set(false);
-			return;
-
-		case NamedConstant::_null:
-			rslt.Set(nullptr);
-			return;
-
-		case NamedConstant::pi:
-			rslt.Set(Pi);
-			return;
-
-		case NamedConstant::iterations:
-			{
-				const int32_t v = gb.CurrentFileMachineState().GetIterations();
-				if (v < 0)
-				{
-					ThrowParseException("'iterations' used when not inside a loop");
-				}
-				rslt.Set(v);
-			}
-			return;
-
-		case NamedConstant::_result:
-			{
-				int32_t res;
-				switch (gb.GetLastResult())
-				{
-				case GCodeResult::ok:
-					res = 0;
-					break;
-
-				case GCodeResult::warning:
-				case GCodeResult::warningNotSupported:
-					res = 1;
-					break;
-
-				default:
-					res = 2;
-					break;
-				}
-				rslt.Set(res);
-			}
-			return;
-
-		case NamedConstant::line:
-			rslt.Set((int32_t)gb.GetLineNumber());
+			compiling->Emit(ExpressionOpcode::pushConstant, idTextOffset);
+			compiling->EmitByte(whichConstant.RawValue());
+			compiling->AdjustStackDepth(1);
 			return;
-
-		default:
-			THROW_INTERNAL_ERROR;
 		}
+#endif
+		GetNamedConstantValue(whichConstant.RawValue(), rslt);
+		return;
 	}
 
 	// Check whether it is a function call
@@ -875,226 +954,64 @@ void ExpressionParser::ParseIdentifierExpression(ExpressionValue& rslt, bool eva
 		{
 			CheckStack(StackUsage::ParseInternal);
 			ParseInternal(rslt, evaluate, 0);					// evaluate the first operand
+			unsigned int numArguments = 1;
 
 			switch (func.RawValue())
 			{
-			case Function::abs:
-				switch (rslt.GetType())
-				{
-				case TypeCode::Int32:
-					rslt.iVal = labs(rslt.iVal);
-					break;
-
-				case TypeCode::Float:
-					rslt.fVal = fabsf(rslt.fVal);
-					break;
-
-				default:
-					if (evaluate)
-					{
-						ThrowParseException("expected numeric operand");
-					}
-					rslt.Set((int32_t)0);
-				}
-				break;
-
-			case Function::sin:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = sinf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::cos:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = cosf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::tan:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = tanf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::asin:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = asinf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::acos:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = acosf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::atan:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = atanf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
 			case Function::atan2:
+			case Function::mod:
+			case Function::max:
+			case Function::min:
+				// atan2 and mod take exactly two arguments, max and min take one or more
+				for (;;)
 				{
-					ConvertToFloat(rslt, evaluate);
 					SkipWhiteSpace();
 					if (CurrentCharacter() != ',')
 					{
-						ThrowParseException("expected ','");
+						if (numArguments == 1 && (func == Function::atan2 || func == Function::mod))
+						{
+							ThrowParseException("expected ','");
+						}
+						break;
 					}
 					AdvancePointer();
 					SkipWhiteSpace();
 					ExpressionValue nextOperand;
 					// We recently checked the stack for a call to ParseInternal, no need to do it again
 					ParseInternal(nextOperand, evaluate, 0);
-					ConvertToFloat(nextOperand, evaluate);
-					rslt.fVal = atan2f(rslt.fVal, nextOperand.fVal);
-					rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				}
-				break;
-
-			case Function::degrees:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = rslt.fVal * RadiansToDegrees;
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::radians:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = rslt.fVal * DegreesToRadians;
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::sqrt:
-				ConvertToFloat(rslt, evaluate);
-				rslt.fVal = fastSqrtf(rslt.fVal);
-				rslt.param = MaxFloatDigitsDisplayedAfterPoint;
-				break;
-
-			case Function::isnan:
-				ConvertToFloat(rslt, evaluate);
-				rslt.SetType(TypeCode::Bool);
-				rslt.bVal = (std::isnan(rslt.fVal) != 0);
-				break;
-
-			case Function::floor:
-				{
-					ConvertToFloat(rslt, evaluate);
-					const float f = floorf(rslt.fVal);
-					if (f <= (float)std::numeric_limits<int32_t>::max() && f >= (float)std::numeric_limits<int32_t>::min())
-					{
-						rslt.SetType(TypeCode::Int32);
-						rslt.iVal = (int32_t)f;
-					}
-					else
-					{
-						rslt.fVal = f;
-					}
-				}
-				break;
-
-			case Function::mod:
-				{
-					SkipWhiteSpace();
-					if (CurrentCharacter() != ',')
-					{
-						ThrowParseException("expected ','");
-					}
-					AdvancePointer();
-					SkipWhiteSpace();
-					ExpressionValue nextOperand;
-					// We recently checked the stack for a call to ParseInternal, no need to do it again
-					ParseInternal(nextOperand, evaluate, 0);
-					BalanceNumericTypes(rslt, nextOperand, evaluate);
-					if (rslt.GetType() == TypeCode::Float)
-					{
-						rslt.fVal = fmod(rslt.fVal, nextOperand.fVal);
-					}
-					else if (nextOperand.iVal == 0)
-					{
-						rslt.iVal = 0;
-					}
-					else
-					{
-						rslt.iVal %= nextOperand.iVal;
-					}
-				}
-				break;
-
-			case Function::max:
-				for (;;)
-				{
-					SkipWhiteSpace();
-					if (CurrentCharacter() != ',')
-					{
-						break;
-					}
-					AdvancePointer();
-					SkipWhiteSpace();
-					ExpressionValue nextOperand;
-					// We recently checked the stack for a call to ParseInternal, no need to do it again
-					ParseInternal(nextOperand, evaluate, 0);
-					BalanceNumericTypes(rslt, nextOperand, evaluate);
-					if (rslt.GetType() == TypeCode::Float)
-					{
-						rslt.fVal = max<float>(rslt.fVal, nextOperand.fVal);
-						rslt.param = max(rslt.param, nextOperand.param);
-					}
-					else
+					++numArguments;
+#if SUPPORT_EXPRESSION_CACHE
+					if (compiling == nullptr)
+#endif
 					{
-						rslt.iVal = max<int32_t>(rslt.iVal, nextOperand.iVal);
+						ApplyFunction(func.RawValue(), rslt, nextOperand, evaluate);
 					}
-				}
-				break;
-
-			case Function::min:
-				for (;;)
-				{
-					SkipWhiteSpace();
-					if (CurrentCharacter() != ',')
+					if (func == Function::atan2 || func == Function::mod)
 					{
 						break;
 					}
-					AdvancePointer();
-					SkipWhiteSpace();
-					ExpressionValue nextOperand;
-					// We recently checked the stack for a call to ParseInternal, no need to do it again
-					ParseInternal(nextOperand, evaluate, 0);
-					BalanceNumericTypes(rslt, nextOperand, evaluate);
-					if (rslt.GetType() == TypeCode::Float)
-					{
-						rslt.fVal = min<float>(rslt.fVal, nextOperand.fVal);
-						rslt.param = max(rslt.param, nextOperand.param);
-					}
-					else
-					{
-						rslt.iVal = min<int32_t>(rslt.iVal, nextOperand.iVal);
-					}
 				}
 				break;
 
-			case Function::random:
+			default:
+#if SUPPORT_EXPRESSION_CACHE
+				if (compiling == nullptr)
+#endif
 				{
-					uint32_t limit;
-					if (rslt.GetType() == TypeCode::Uint32)
-					{
-						limit = rslt.uVal;
-					}
-					else if (rslt.GetType() == TypeCode::Int32 && rslt.iVal > 0)
-					{
-						limit = rslt.iVal;
-					}
-					else
-					{
-						ThrowParseException("expected positive integer");
-					}
-					rslt.Set((int32_t)random(limit));
+					ApplyFunction(func.RawValue(), rslt, evaluate);
 				}
 				break;
+			}
 
-			default:
-				THROW_INTERNAL_ERROR;
+#if SUPPORT_EXPRESSION_CACHE
+			if (compiling != nullptr)
+			{
+				compiling->Emit(ExpressionOpcode::function, idTextOffset);
+				compiling->EmitByte(func.RawValue());
+				compiling->EmitByte(numArguments);
+				compiling->AdjustStackDepth(1 - (int)numArguments);
 			}
+#endif
 		}
 
 		SkipWhiteSpace();
@@ -1106,6 +1023,14 @@ void ExpressionParser::ParseIdentifierExpression(ExpressionValue& rslt, bool eva
 		return;
 	}
 
+#if SUPPORT_EXPRESSION_CACHE
+	if (compiling != nullptr)
+	{
+		EmitIdentifier(id.c_str(), numIndices, applyLengthOperator, applyExists, idTextOffset);
+		return;
+	}
+#endif
+
 	// If we are not evaluating then the object expression doesn't have to exist, so don't retrieve it because that might throw an error
 	if (evaluate)
 	{
@@ -1149,6 +1074,257 @@ void ExpressionParser::ParseIdentifierExpression(ExpressionValue& rslt, bool eva
 	rslt.Set(nullptr);
 }
 
+// Get the value of a named constant
+void ExpressionParser::GetNamedConstantValue(unsigned int whichConstant, ExpressionValue& rslt) const THROWS(GCodeException)
+{
+	switch (whichConstant)
+	{
+	case NamedConstant::_true:
+		rslt.Set(true);
+		return;
+
+	case NamedConstant::_false:
+		rslt.Set(false);
+		return;
+
+	case NamedConstant::_null:
+		rslt.Set(nullptr);
+		return;
+
+	case NamedConstant::pi:
+		rslt.Set(Pi);
+		return;
+
+	case NamedConstant::iterations:
+		{
+			const int32_t v = gb.CurrentFileMachineState().GetIterations();
+			if (v < 0)
+			{
+				ThrowParseException("'iterations' used when not inside a loop");
+			}
+			rslt.Set(v);
+		}
+		return;
+
+	case NamedConstant::_result:
+		{
+			int32_t res;
+			switch (gb.GetLastResult())
+			{
+			case GCodeResult::ok:
+				res = 0;
+				break;
+
+			case GCodeResult::warning:
+			case GCodeResult::warningNotSupported:
+				res = 1;
+				break;
+
+			default:
+				res = 2;
+				break;
+			}
+			rslt.Set(res);
+		}
+		return;
+
+	case NamedConstant::line:
+		rslt.Set((int32_t)gb.GetLineNumber());
+		return;
+
+	default:
+		THROW_INTERNAL_ERROR;
+	}
+}
+
+// Apply a function that takes a single argument
+void ExpressionParser::ApplyFunction(unsigned int func, ExpressionValue& rslt, bool evaluate) THROWS(GCodeException)
+{
+	switch (func)
+	{
+	case Function::abs:
+		switch (rslt.GetType())
+		{
+		case TypeCode::Int32:
+			rslt.iVal = labs(rslt.iVal);
+			break;
+
+		case TypeCode::Float:
+			rslt.fVal = fabsf(rslt.fVal);
+			break;
+
+		default:
+			if (evaluate)
+			{
+				ThrowParseException("expected numeric operand");
+			}
+			rslt.Set((int32_t)0);
+		}
+		break;
+
+	case Function::sin:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = sinf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::cos:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = cosf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::tan:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = tanf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::asin:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = asinf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::acos:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = acosf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::atan:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = atanf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::degrees:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = rslt.fVal * RadiansToDegrees;
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::radians:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = rslt.fVal * DegreesToRadians;
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::sqrt:
+		ConvertToFloat(rslt, evaluate);
+		rslt.fVal = fastSqrtf(rslt.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::isnan:
+		ConvertToFloat(rslt, evaluate);
+		rslt.SetType(TypeCode::Bool);
+		rslt.bVal = (std::isnan(rslt.fVal) != 0);
+		break;
+
+	case Function::floor:
+		{
+			ConvertToFloat(rslt, evaluate);
+			const float f = floorf(rslt.fVal);
+			if (f <= (float)std::numeric_limits<int32_t>::max() && f >= (float)std::numeric_limits<int32_t>::min())
+			{
+				rslt.SetType(TypeCode::Int32);
+				rslt.iVal = (int32_t)f;
+			}
+			else
+			{
+				rslt.fVal = f;
+			}
+		}
+		break;
+
+	case Function::max:
+	case Function::min:
+		break;												// max or min of a single value is that value
+
+	case Function::random:
+		{
+			uint32_t limit;
+			if (rslt.GetType() == TypeCode::Uint32)
+			{
+				limit = rslt.uVal;
+			}
+			else if (rslt.GetType() == TypeCode::Int32 && rslt.iVal > 0)
+			{
+				limit = rslt.iVal;
+			}
+			else
+			{
+				ThrowParseException("expected positive integer");
+			}
+			rslt.Set((int32_t)random(limit));
+		}
+		break;
+
+	default:
+		THROW_INTERNAL_ERROR;
+	}
+}
+
+// Apply a function that takes two or more arguments to the result so far and the next argument
+void ExpressionParser::ApplyFunction(unsigned int func, ExpressionValue& rslt, ExpressionValue& nextOperand, bool evaluate) THROWS(GCodeException)
+{
+	switch (func)
+	{
+	case Function::atan2:
+		ConvertToFloat(rslt, evaluate);
+		ConvertToFloat(nextOperand, evaluate);
+		rslt.fVal = atan2f(rslt.fVal, nextOperand.fVal);
+		rslt.param = MaxFloatDigitsDisplayedAfterPoint;
+		break;
+
+	case Function::mod:
+		BalanceNumericTypes(rslt, nextOperand, evaluate);
+		if (rslt.GetType() == TypeCode::Float)
+		{
+			rslt.fVal = fmod(rslt.fVal, nextOperand.fVal);
+		}
+		else if (nextOperand.iVal == 0)
+		{
+			rslt.iVal = 0;
+		}
+		else
+		{
+			rslt.iVal %= nextOperand.iVal;
+		}
+		break;
+
+	case Function::max:
+		BalanceNumericTypes(rslt, nextOperand, evaluate);
+		if (rslt.GetType() == TypeCode::Float)
+		{
+			rslt.fVal = max<float>(rslt.fVal, nextOperand.fVal);
+			rslt.param = max(rslt.param, nextOperand.param);
+		}
+		else
+		{
+			rslt.iVal = max<int32_t>(rslt.iVal, nextOperand.iVal);
+		}
+		break;
+
+	case Function::min:
+		BalanceNumericTypes(rslt, nextOperand, evaluate);
+		if (rslt.GetType() == TypeCode::Float)
+		{
+			rslt.fVal = min<float>(rslt.fVal, nextOperand.fVal);
+			rslt.param = max(rslt.param, nextOperand.param);
+		}
+		else
+		{
+			rslt.iVal = min<int32_t>(rslt.iVal, nextOperand.iVal);
+		}
+		break;
+
+	default:
+		THROW_INTERNAL_ERROR;
+	}
+}
+
 // Get the value of a variable
 void ExpressionParser::GetVariableValue(ExpressionValue& rslt, const VariableSet *vars, const char *name, bool parameter, bool wantExists) THROWS(GCodeException)
 {
@@ -1239,10 +1415,335 @@ void ExpressionParser::ThrowParseException(const char *str, uint32_t param) cons
 	throw GCodeException(gb.GetLineNumber(), GetColumn(), str, param);
 }
 
+#if SUPPORT_EXPRESSION_CACHE
+
+// If the expression is inside a loop in a file then execute the compiled version of it, compiling it first if necessary.
+// Return true if we did that, false if the expression needs to be parsed and evaluated in the usual way.
+bool ExpressionParser::ParseCompiled(ExpressionValue& rslt) THROWS(GCodeException)
+{
+	if (startp < gb.buffer || startp >= gb.buffer + ARRAY_SIZE(gb.buffer))
+	{
+		return false;
+	}
+
+	GCodeMachineState& ms = gb.CurrentFileMachineState();
+	if (ms.GetIterations() < 0)
+	{
+		return false;											// not in a loop so it probably isn't worth compiling
+	}
+
+	const FilePosition filePos = gb.GetFilePosition();
+	if (filePos == noFilePosition)
+	{
+		return false;
+	}
+
+	const size_t bufferOffset = startp - gb.buffer;
+	const CompiledExpression *ce = ms.expressionCache.Find(filePos, bufferOffset, startp);
+	if (ce == nullptr)
+	{
+		CompiledExpression * const newCe = Compile(filePos, bufferOffset);
+		ms.expressionCache.Add(newCe);							// cache it even if it isn't valid, so that we don't try to compile it again
+		ce = newCe;
+	}
+
+	if (!ce->IsValid())
+	{
+		return false;											// too complicated, or a syntax error that the parser will report
+	}
+	Execute(*ce, rslt);
+	return true;
+}
+
+// Generate code for the expression. Return the compiled expression, which is marked invalid if it couldn't be compiled.
+CompiledExpression *ExpressionParser::Compile(FilePosition filePos, size_t bufferOffset) noexcept
+{
+	CompiledExpression * const ce = new CompiledExpression(filePos, bufferOffset);
+	compiling = ce;
+	bool ok;
+	try
+	{
+		ExpressionValue dummy;
+		ParseInternal(dummy, false, 0);
+		ce->Emit(ExpressionOpcode::end, currentp - startp);
+		ce->SetText(startp, currentp - startp);
+		ok = ce->IsValid();
+	}
+	catch (const GCodeException&)
+	{
+		ok = false;
+	}
+
+	compiling = nullptr;
+	currentp = startp;
+	if (!ok)
+	{
+		ce->Invalidate();
+	}
+	return ce;
+}
+
+// Generate code to push a literal string or number
+void ExpressionParser::EmitLiteral(const ExpressionValue& val, size_t textOffset) noexcept
+{
+	switch (val.GetType())
+	{
+	case TypeCode::Int32:
+		compiling->Emit(ExpressionOpcode::pushInt, textOffset);
+		compiling->EmitBytes(&val.iVal, sizeof(val.iVal));
+		break;
+
+	case TypeCode::Float:
+		compiling->Emit(ExpressionOpcode::pushFloat, textOffset);
+		compiling->EmitBytes(&val.fVal, sizeof(val.fVal));
+		compiling->EmitByte(val.param);
+		break;
+
+	case TypeCode::HeapString:
+		compiling->Emit(ExpressionOpcode::pushString, textOffset);
+		compiling->EmitString(val.shVal.Get().Ptr());
+		break;
+
+	default:
+		compiling->Invalidate();							// not expected
+		break;
+	}
+	compiling->AdjustStackDepth(1);
+}
+
+// Generate code to push the value of a variable or object model value, given the identifier with '^' marking each index
+void ExpressionParser::EmitIdentifier(const char *id, unsigned int numIndices, bool applyLengthOperator, bool applyExists, size_t textOffset) noexcept
+{
+	const uint8_t flags = ((applyLengthOperator) ? CompiledExpression::FlagWantLength : 0) | ((applyExists) ? CompiledExpression::FlagWantExists : 0);
+	const char *name = nullptr;
+	CompiledExpression::VariableKind kind = CompiledExpression::local;
+	if (StringStartsWith(id, "param."))
+	{
+		kind = CompiledExpression::parameter;
+		name = id + strlen("param.");
+	}
+	else if (StringStartsWith(id, "global."))
+	{
+		kind = CompiledExpression::global;
+		name = id + strlen("global.");
+	}
+	else if (StringStartsWith(id, "var."))
+	{
+		kind = CompiledExpression::local;
+		name = id + strlen("var.");
+	}
+
+	if (name != nullptr)
+	{
+		compiling->Emit(ExpressionOpcode::pushVariable, textOffset);
+		compiling->EmitByte(kind);
+		compiling->EmitByte(flags);
+		compiling->EmitByte(numIndices);
+		compiling->EmitString(name);
+	}
+	else if (applyExists && (strcmp(id, "param") == 0 || strcmp(id, "var") == 0))
+	{
+		compiling->Emit(ExpressionOpcode::pushConstant, textOffset);
+		compiling->EmitByte(NamedConstant::_true);
+	}
+	else
+	{
+		// Look up the first element of the object model path now, so that we don't have to do it each time the expression is evaluated
+		const ObjectModelClassDescriptor *classDescriptor = nullptr;
+		const ObjectModelTableEntry * const entry = reprap.FindTopLevelEntry(id, classDescriptor);
+		compiling->Emit(ExpressionOpcode::pushObjectValue, textOffset);
+		compiling->EmitByte(flags);
+		compiling->EmitByte(numIndices);
+		compiling->EmitBytes(&entry, sizeof(entry));
+		compiling->EmitBytes(&classDescriptor, sizeof(classDescriptor));
+		compiling->EmitString(id);
+	}
+	compiling->AdjustStackDepth(1 - (int)numIndices);
+}
+
+// Execute a compiled expression
+void ExpressionParser::Execute(const CompiledExpression& ce, ExpressionValue& rslt) THROWS(GCodeException)
+{
+	ExpressionValue stack[CompiledExpression::MaxStackDepth];
+	size_t sp = 0;
+	const uint8_t * const code = ce.GetCode();
+	const uint8_t *pc = code;
+	for (;;)
+	{
+		const ExpressionOpcode op = (ExpressionOpcode)pc[0];
+		currentp = startp + pc[1];								// so that any error is reported at the right column
+		pc += 2;
+		switch (op)
+		{
+		case ExpressionOpcode::end:
+			rslt = stack[0];
+			currentp = startp + ce.GetTextLength();
+			return;
+
+		case ExpressionOpcode::pushInt:
+			{
+				int32_t i;
+				memcpy(&i, pc, sizeof(i));
+				pc += sizeof(i);
+				stack[sp++].Set(i);
+			}
+			break;
+
+		case ExpressionOpcode::pushFloat:
+			{
+				float f;
+				memcpy(&f, pc, sizeof(f));
+				stack[sp++].Set(f, pc[sizeof(f)]);
+				pc += sizeof(f) + 1;
+			}
+			break;
+
+		case ExpressionOpcode::pushString:
+			{
+				const char * const s = reinterpret_cast<const char*>(pc);
+				StringHandle sh(s);
+				stack[sp++].Set(sh);
+				pc += strlen(s) + 1;
+			}
+			break;
+
+		case ExpressionOpcode::pushConstant:
+			GetNamedConstantValue(*pc++, stack[sp++]);
+			break;
+
+		case ExpressionOpcode::pushVariable:
+		case ExpressionOpcode::pushObjectValue:
+			{
+				const size_t numIndices = (op == ExpressionOpcode::pushVariable) ? pc[2] : pc[1];
+				sp -= numIndices;
+				pc = ExecuteIdentifier(stack[sp], pc, &stack[sp], op == ExpressionOpcode::pushVariable);
+				++sp;
+			}
+			break;
+
+		case ExpressionOpcode::unaryOperator:
+			ApplyUnaryOperator((char)*pc++, stack[sp - 1], true);
+			break;
+
+		case ExpressionOpcode::binaryOperator:
+			--sp;
+			ApplyBinaryOperator((char)pc[0], pc[1] != 0, stack[sp - 1], stack[sp], true);
+			pc += 2;
+			break;
+
+		case ExpressionOpcode::function:
+			{
+				const unsigned int func = pc[0];
+				const size_t numArguments = pc[1];
+				pc += 2;
+				sp -= numArguments;
+				if (numArguments == 1)
+				{
+					ApplyFunction(func, stack[sp], true);
+				}
+				else
+				{
+					for (size_t i = 1; i < numArguments; ++i)
+					{
+						ApplyFunction(func, stack[sp], stack[sp + i], true);
+					}
+				}
+				++sp;
+			}
+			break;
+
+		case ExpressionOpcode::toBool:
+			ConvertToBool(stack[sp - 1], true);
+			break;
+
+		case ExpressionOpcode::andThen:
+		case ExpressionOpcode::orElse:
+			ConvertToBool(stack[sp - 1], true);
+			if (stack[sp - 1].bVal == (op == ExpressionOpcode::orElse))
+			{
+				pc = code + *pc;								// the result is the first operand
+			}
+			else
+			{
+				--sp;											// the result is the second operand
+				++pc;
+			}
+			break;
+
+		case ExpressionOpcode::jumpIfFalse:
+			--sp;
+			ConvertToBool(stack[sp], true);
+			pc = (stack[sp].bVal) ? pc + 1 : code + *pc;
+			break;
+
+		case ExpressionOpcode::jump:
+			pc = code + *pc;
+			break;
+
+		default:
+			THROW_INTERNAL_ERROR;
+		}
+	}
+}
+
+// Execute a pushVariable or pushObjectValue instruction, returning a pointer to the next instruction
+// The indices are popped from the stack by the caller and the result may overwrite the first index
+const uint8_t *ExpressionParser::ExecuteIdentifier(ExpressionValue& rslt, const uint8_t *pc, const ExpressionValue *indices, bool isVariable) THROWS(GCodeException)
+{
+	const uint8_t kind = (isVariable) ? *pc++ : 0;
+	const uint8_t flags = *pc++;
+	const size_t numIndices = *pc++;
+	ObjectExplorationContext context((flags & CompiledExpression::FlagWantLength) != 0, (flags & CompiledExpression::FlagWantExists) != 0, gb.GetLineNumber(), GetColumn());
+	for (size_t i = 0; i < numIndices; ++i)
+	{
+		if (indices[i].GetType() != TypeCode::Int32)
+		{
+			ThrowParseException("expected integer expression");
+		}
+		context.ProvideIndex(indices[i].iVal);
+	}
+
+	if (isVariable)
+	{
+		const char * const name = reinterpret_cast<const char*>(pc);
+		if (kind == CompiledExpression::global)
+		{
+			auto vars = reprap.GetGlobalVariablesForReading();
+			GetVariableValue(rslt, vars.Ptr(), name, false, context.WantExists());
+		}
+		else
+		{
+			GetVariableValue(rslt, &gb.GetVariables(), name, kind == CompiledExpression::parameter, context.WantExists());
+		}
+		return pc + strlen(name) + 1;
+	}
+
+	const ObjectModelTableEntry *entry;
+	memcpy(&entry, pc, sizeof(entry));
+	pc += sizeof(entry);
+	const ObjectModelClassDescriptor *classDescriptor;
+	memcpy(&classDescriptor, pc, sizeof(classDescriptor));
+	pc += sizeof(classDescriptor);
+	const char * const id = reinterpret_cast<const char*>(pc);
+
+	CheckStack(StackUsage::GetObjectValue_withTable);
+	rslt = (entry != nullptr) ? reprap.GetObjectValueUsingEntry(context, classDescriptor, entry, id) : reprap.GetObjectValue(context, nullptr, id, 0);
+	if (context.ObsoleteFieldQueried() && obsoleteField.IsEmpty())
+	{
+		obsoleteField.copy(id);
+	}
+	return pc + strlen(id) + 1;
+}
+
+#endif
 // Call this before making a recursive call, or before calling a function that needs a lot of stack from a recursive function
 void ExpressionParser::CheckStack(uint32_t calledFunctionStackUsage) const THROWS(GCodeException)
 {
+#ifdef HOST_SIM
+	const char * const stackPtr = static_cast<const char*>(__builtin_frame_address(0));
+#else
 	register const char * stackPtr asm ("sp");
+#endif
 	const char *stackLimit = (const char*)TaskBase::GetCallerTaskHandle() + sizeof(TaskBase);
 	//debugPrintf("Margin: %u\n", stackPtr - stackLimit);
 	if (stackLimit + calledFunctionStackUsage + (StackUsage::Throw + StackUsage::Margin) <= stackPtr)
@@ -11,6 +11,7 @@
 #include <RepRapFirmware.h>
 #include <ObjectModel/ObjectModel.h>
 #include <GCodes/GCodeException.h>
+#include "CompiledExpression.h"
 
 class VariableSet;
 
@@ -35,6 +36,14 @@ private:
 	[[noreturn]] void __attribute__((noinline)) ThrowParseException(const char *str, uint32_t param) const THROWS(GCodeException);
 
 	void ParseInternal(ExpressionValue& val, bool evaluate, uint8_t priority) THROWS(GCodeException);
+#if SUPPORT_EXPRESSION_CACHE
+	bool ParseCompiled(ExpressionValue& rslt) THROWS(GCodeException);
+	CompiledExpression *Compile(FilePosition filePos, size_t bufferOffset) noexcept;
+	void Execute(const CompiledExpression& ce, ExpressionValue& rslt) THROWS(GCodeException);
+	void EmitLiteral(const ExpressionValue& val, size_t textOffset) noexcept;
+	void EmitIdentifier(const char *id, unsigned int numIndices, bool applyLengthOperator, bool applyExists, size_t textOffset) noexcept;
+	const uint8_t *__attribute__((noinline)) ExecuteIdentifier(ExpressionValue& rslt, const uint8_t *pc, const ExpressionValue *indices, bool isVariable) THROWS(GCodeException);
+#endif
 	void ParseExpectKet(ExpressionValue& rslt, bool evaluate, char expectedKet) THROWS(GCodeException);
 	void __attribute__((noinline)) ParseNumber(ExpressionValue& rslt) noexcept
 		pre(readPointer >= 0; isdigit(gb.buffer[readPointer]));
@@ -43,6 +52,13 @@ private:
 	void __attribute__((noinline)) ParseQuotedString(ExpressionValue& rslt) THROWS(GCodeException);
 	void GetVariableValue(ExpressionValue& rslt, const VariableSet *vars, const char *name, bool parameter, bool wantExists) THROWS(GCodeException);
 
+	// Functions that apply operators and functions to values that have already been evaluated, shared by the parser and the compiled expression interpreter
+	void ApplyUnaryOperator(char op, ExpressionValue& val, bool evaluate) THROWS(GCodeException);
+	void ApplyBinaryOperator(char op, bool invert, ExpressionValue& val, ExpressionValue& val2, bool evaluate) THROWS(GCodeException);
+	void ApplyFunction(unsigned int func, ExpressionValue& rslt, bool evaluate) THROWS(GCodeException);
+	void ApplyFunction(unsigned int func, ExpressionValue& rslt, ExpressionValue& nextOperand, bool evaluate) THROWS(GCodeException);
+	void GetNamedConstantValue(unsigned int whichConstant, ExpressionValue& rslt) const THROWS(GCodeException);
+
 	void ConvertToFloat(ExpressionValue& val, bool evaluate) const THROWS(GCodeException);
 	void ConvertToBool(ExpressionValue& val, bool evaluate) const THROWS(GCodeException);
 	void ConvertToString(ExpressionValue& val, bool evaluate) noexcept;
@@ -66,6 +82,9 @@ private:
 	const GCodeBuffer& gb;
 	int column;
 	String<MaxVariableNameLength> obsoleteField;
+#if SUPPORT_EXPRESSION_CACHE
+	CompiledExpression *compiling;						// if this is not null then we are generating code instead of evaluating the expression
+#endif
 };
 
 #endif /* SRC_GCODES_GCODEBUFFER_EXPRESSIONPARSER_H_ */
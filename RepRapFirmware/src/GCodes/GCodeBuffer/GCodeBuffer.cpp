@@ -98,6 +98,9 @@ GCodeBuffer::GCodeBuffer(GCodeChannel::RawType channel, GCodeInput *normalIn, Fi
 	  machineState(new GCodeMachineState()), whenReportDueTimerStarted(millis()),
 #if HAS_LINUX_INTERFACE
 	  isBinaryBuffer(false),
+#endif
+#if SUPPORT_BINARY_GCODE_FILES
+	  binaryCodeFromFile(false),
 #endif
 	  timerRunning(false), motionCommanded(false)
 #if HAS_LINUX_INTERFACE
@@ -260,12 +263,27 @@ void GCodeBuffer::PutBinary(const uint32_t *data, size_t len) noexcept
 {
 	machineState->lastCodeFromSbc = true;
 	isBinaryBuffer = true;
+#if SUPPORT_BINARY_GCODE_FILES
+	binaryCodeFromFile = false;
+#endif
 	macroJustStarted = false;
 	binaryParser.Put(data, len);
 }
 
 #endif
 
+#if SUPPORT_BINARY_GCODE_FILES
+
+// Add an entire pre-tokenised G-Code read from a binary G-code file on local storage, overwriting any existing content
+void GCodeBuffer::PutBinaryFromFile(const uint32_t *data, size_t len) noexcept
+{
+	machineState->lastCodeFromSbc = false;
+	isBinaryBuffer = binaryCodeFromFile = true;
+	binaryParser.Put(data, len);
+}
+
+#endif
+
 // Add an entire G-Code, overwriting any existing content
 void GCodeBuffer::PutAndDecode(const char *str, size_t len) noexcept
 {
@@ -292,6 +310,9 @@ void GCodeBuffer::StartNewFile() noexcept
 	machineState->SetFileExecuting();
 #endif
 	machineState->lineNumber = 0;						// reset line numbering when M32 is run
+#if SUPPORT_EXPRESSION_CACHE
+	machineState->expressionCache.Clear();				// in case we were executing a different file at this stack level
+#endif
 	IF_NOT_BINARY(stringParser.StartNewFile());
 }
 
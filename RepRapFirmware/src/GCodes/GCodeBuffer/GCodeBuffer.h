@@ -41,6 +41,7 @@ class GCodeBuffer INHERIT_OBJECT_MODEL
 public:
 	friend class BinaryParser;
 	friend class StringParser;
+	friend class ExpressionParser;
 
 	GCodeBuffer(GCodeChannel::RawType channel, GCodeInput *normalIn, FileGCodeInput *fileIn, MessageType mt, Compatibility::RawType c = Compatibility::RepRapFirmware) noexcept;
 	void Reset() noexcept;														// Reset it to its state after start-up
@@ -50,6 +51,9 @@ public:
 	bool Put(char c) noexcept SPEED_CRITICAL;									// Add a character to the end
 #if HAS_LINUX_INTERFACE
 	void PutBinary(const uint32_t *data, size_t len) noexcept;					// Add an entire binary G-Code, overwriting any existing content
+#endif
+#if SUPPORT_BINARY_GCODE_FILES
+	void PutBinaryFromFile(const uint32_t *data, size_t len) noexcept;			// Add an entire binary G-Code read from a local file
 #endif
 	void PutAndDecode(const char *data, size_t len) noexcept;					// Add an entire G-Code, overwriting any existing content
 	void PutAndDecode(const char *str) noexcept;								// Add a null-terminated string, overwriting any existing content
@@ -144,7 +148,12 @@ public:
 	void WaitForAcknowledgement() noexcept;						// Flag that we are waiting for acknowledgement
 
 #if HAS_LINUX_INTERFACE
+#if SUPPORT_BINARY_GCODE_FILES
+	bool IsBinary() const noexcept { return isBinaryBuffer && !binaryCodeFromFile; }	// Return true if the code is in binary format and came from the SBC
+	bool IsBinaryFromFile() const noexcept { return isBinaryBuffer && binaryCodeFromFile; }	// Return true if the code is a binary record from a local file
+#else
 	bool IsBinary() const noexcept { return isBinaryBuffer; }	// Return true if the code is in binary format
+#endif
 
 	bool IsFileFinished() const noexcept;						// Return true if this source has finished execution of a file
 	void SetFileFinished() noexcept;							// Mark the current file as finished
@@ -268,6 +277,9 @@ private:
 
 #if HAS_LINUX_INTERFACE
 	bool isBinaryBuffer;
+#endif
+#if SUPPORT_BINARY_GCODE_FILES
+	bool binaryCodeFromFile;							// true if the binary code came from a local binary G-code file rather than from the SBC
 #endif
 	bool timerRunning;									// True if we are waiting
 	bool motionCommanded;								// true if this GCode stream has commanded motion since it last waited for motion to stop
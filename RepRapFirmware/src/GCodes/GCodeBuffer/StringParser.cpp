@@ -22,6 +22,10 @@
 
 #if HAS_MASS_STORAGE
 static constexpr char eofString[] = EOF_STRING;		// What's at the end of an HTML file?
+
+#ifdef HOST_SIM
+bool StringParser::useParameterIndex = true;
+#endif
 #endif
 
 StringParser::StringParser(GCodeBuffer& gcodeBuffer) noexcept
@@ -810,6 +814,64 @@ bool StringParser::EvaluateCondition()
 	return b;
 }
 
+// Find where the end of the command is, which parameters it has, and where the first occurrence of each parameter letter is so that Seen() needn't search for it.
+// We assume that a G or M not inside quotes or { } and not preceded by ' is the start of a new command.
+// This isn't true if the command has an unquoted string argument, but we deal with that later.
+void StringParser::FindParameters() noexcept
+{
+	bool inQuotes = false;
+	bool escaped = false;
+	unsigned int localBraceCount = 0;
+	parametersPresent.Clear();
+	for (commandEnd = parameterStart; commandEnd < gcodeLineEnd; ++commandEnd)
+	{
+		const char c = gb.buffer[commandEnd];
+		if (c == '"')
+		{
+			inQuotes = !inQuotes;
+		}
+		else if (!inQuotes)
+		{
+			const bool wasEscaped = escaped;
+			escaped = (c == '\'' && !wasEscaped);
+			if (c == '{')
+			{
+				++localBraceCount;
+			}
+			else if (localBraceCount != 0)
+			{
+				if (c == '}')
+				{
+					--localBraceCount;
+				}
+			}
+			else
+			{
+				const char c2 = toupper(c);
+				if ((c2  == 'G' || c2 == 'M') && gb.buffer[commandEnd - 1] != '\'')
+				{
+					break;
+				}
+				if (c2 >= 'A' && c2 <= 'Z' && (c2 != 'E' || commandEnd == parameterStart || !isdigit(gb.buffer[commandEnd - 1])))
+				{
+					parametersPresent.SetBit(c2 - 'A');
+					if (!wasEscaped && parameterOffsets[c2 - 'A'] == NoParameterOffset && commandEnd < NoParameterOffset)
+					{
+						parameterOffsets[c2 - 'A'] = (uint8_t)commandEnd;
+					}
+				}
+			}
+		}
+	}
+
+#ifdef HOST_SIM
+	if (!useParameterIndex)
+	{
+		memset(parameterOffsets, NoParameterOffset, sizeof(parameterOffsets));
+	}
+#endif
+}
+
 // Decode this command and find the start of the next one on the same line.
 // On entry, 'commandStart' has already been set to the address the start of where the command should be
 // and 'commandIndent' is the number of leading whitespace characters at the start of the current line.
@@ -819,6 +881,7 @@ void StringParser::DecodeCommand() noexcept
 	// Check for a valid command letter at the start
 	const char cl = toupper(gb.buffer[commandStart]);
 	commandFraction = -1;
+	memset(parameterOffsets, NoParameterOffset, sizeof(parameterOffsets));
 	if (cl == 'G' || cl == 'M' || cl == 'T'  || cl == 'S')
 	{
 		commandLetter = cl;
@@ -874,45 +937,7 @@ void StringParser::DecodeCommand() noexcept
 			++parameterStart;
 		}
 
-		// Find where the end of the command is. We assume that a G or M not inside quotes or { } and not preceded by ' is the start of a new command.
-		// This isn't true if the command has an unquoted string argument, but we deal with that later.
-		bool inQuotes = false;
-		unsigned int localBraceCount = 0;
-		parametersPresent.Clear();
-		for (commandEnd = parameterStart; commandEnd < gcodeLineEnd; ++commandEnd)
-		{
-			const char c = gb.buffer[commandEnd];
-			if (c == '"')
-			{
-				inQuotes = !inQuotes;
-			}
-			else if (!inQuotes)
-			{
-				if (c == '{')
-				{
-					++localBraceCount;
-				}
-				else if (localBraceCount != 0)
-				{
-					if (c == '}')
-					{
-						--localBraceCount;
-					}
-				}
-				else
-				{
-					const char c2 = toupper(c);
-					if ((c2  == 'G' || c2 == 'M') && gb.buffer[commandEnd - 1] != '\'')
-					{
-						break;
-					}
-					if (c2 >= 'A' && c2 <= 'Z' && (c2 != 'E' || commandEnd == parameterStart || !isdigit(gb.buffer[commandEnd - 1])))
-					{
-						parametersPresent.SetBit(c2 - 'A');
-					}
-				}
-			}
-		}
+		FindParameters();
 	}
 	else if (cl == 'X' || cl == 'Y' || cl == 'Z' || cl == 'U' || cl == 'V' ||
 		cl == 'W' || cl == 'A' || cl == 'B' || cl == 'C' || cl == 'D'){
@@ -974,45 +999,7 @@ void StringParser::DecodeCommand() noexcept
 			++parameterStart;
 		}
 
-		// Find where the end of the command is. We assume that a G or M not inside quotes or { } and not preceded by ' is the start of a new command.
-		// This isn't true if the command has an unquoted string argument, but we deal with that later.
-		bool inQuotes = false;
-		unsigned int localBraceCount = 0;
-		parametersPresent.Clear();
-		for (commandEnd = parameterStart; commandEnd < gcodeLineEnd; ++commandEnd)
-		{
-			const char c = gb.buffer[commandEnd];
-			if (c == '"')
-			{
-				inQuotes = !inQuotes;
-			}
-			else if (!inQuotes)
-			{
-				if (c == '{')
-				{
-					++localBraceCount;
-				}
-				else if (localBraceCount != 0)
-				{
-					if (c == '}')
-					{
-						--localBraceCount;
-					}
-				}
-				else
-				{
-					const char c2 = toupper(c);
-					if ((c2  == 'G' || c2 == 'M') && gb.buffer[commandEnd - 1] != '\'')
-					{
-						break;
-					}
-					if (c2 >= 'A' && c2 <= 'Z' && (c2 != 'E' || commandEnd == parameterStart || !isdigit(gb.buffer[commandEnd - 1])))
-					{
-						parametersPresent.SetBit(c2 - 'A');
-					}
-				}
-			}
-		}
+		FindParameters();
 	}
 	else if (cl == ';'	|| cl == '%' || cl == '(')
 	{
@@ -1034,7 +1021,8 @@ void StringParser::DecodeCommand() noexcept
 			 && !isalpha(gb.buffer[commandStart + 1])								// make sure it isn't an if-command or other meta command
 			)
 	{
-		// Fanuc or LaserWeb-style GCode, repeat the existing G0/G1/G2/G3 command with the new parameters
+		// Fanuc or LaserWeb-style GCode, repeat the existing G0/G1/G2/G3 command with the new parameters.
+		// We don't call FindParameters here, so parameterOffsets stays empty and Seen() scans for each parameter.
 		parameterStart = commandStart;
 		commandEnd = gcodeLineEnd;
 	}
@@ -1110,7 +1098,7 @@ FilePosition StringParser::GetFilePosition() const noexcept
 # endif
 	   )
 	{
-		return gb.LatestMachineState().fileState.GetPosition() - gb.fileInput->BytesCached() - commandLength + commandStart;
+		return gb.fileInput->GetPosition(gb.LatestMachineState().fileState) - commandLength + commandStart;
 	}
 #endif
 	return noFilePosition;
@@ -1145,6 +1133,11 @@ bool StringParser::Seen(char c) noexcept
 	{
 		return false;
 	}
+	else if (parameterOffsets[c - 'A'] != NoParameterOffset)
+	{
+		readPointer = parameterOffsets[c - 'A'] + 1;					// DecodeCommand found it already
+		return true;
+	}
 
 	bool inQuotes = false;
 	bool escaped = false;
@@ -89,6 +89,10 @@ public:
 	GCodeException ConstructParseException(const char *str, const char *param) const noexcept;
 	GCodeException ConstructParseException(const char *str, uint32_t param) const noexcept;
 
+#ifdef HOST_SIM
+	static bool useParameterIndex;											// the host parser benchmark clears this to time Seen() scanning for each parameter
+#endif
+
 private:
 	GCodeBuffer& gb;
 
@@ -122,6 +126,7 @@ private:
 
 	bool EvaluateCondition() THROWS(GCodeException);
 
+	void FindParameters() noexcept;
 	void SkipWhiteSpace() noexcept;
 
 	unsigned int commandStart;							// Index in the buffer of the command letter of this command
@@ -131,6 +136,8 @@ private:
 	unsigned int braceCount;							// how many nested { } we are inside
 	unsigned int gcodeLineEnd;							// Number of characters in the entire line of gcode
 	Bitmap<uint32_t> parametersPresent;					// which parameters are present in this command
+	uint8_t parameterOffsets[26];						// index in the buffer of the first unescaped occurrence of each parameter letter, or NoParameterOffset
+	static constexpr uint8_t NoParameterOffset = 0xFF;	// if Seen() finds this for a letter that is present then it searches for it
 	int readPointer;									// Where in the buffer to read next, or -1
 
 	FileStore *fileBeingWritten;						// If we are copying GCodes to a file, which file it is
@@ -11,6 +11,10 @@
 #include "GCodes.h"
 #include "GCodeBuffer/GCodeBuffer.h"
 
+#if SUPPORT_BINARY_GCODE_FILES
+# include <Linux/LinuxMessageFormats.h>
+#endif
+
 const size_t GCodeInputFileReadThreshold = 128;		// How many free bytes must be available before data is read from the file
 const size_t GCodeInputUSBReadThreshold = 128;		// How many free bytes must be available before we read more data from USB
 
@@ -253,7 +257,13 @@ bool NetworkGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept /*override*/
 // Reset this input. Should be called when the associated file is being closed
 void FileGCodeInput::Reset() noexcept
 {
+#if SUPPORT_FILE_PREFETCH
+	prefetcher.Stop();
+#endif
 	lastFile = nullptr;
+#if SUPPORT_BINARY_GCODE_FILES
+	readingBinaryFile = incompleteRecord = badRecord = false;
+#endif
 	RegularGCodeInput::Reset();
 }
 
@@ -274,6 +284,9 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 	// Keep track of the last file we read from
 	if (lastFile != nullptr && lastFile != file.f)
 	{
+#if SUPPORT_FILE_PREFETCH
+		prefetcher.Stop();							// this puts the file position back to the end of the data in our buffer
+#endif
 		if (bytesCached > 0)
 		{
 			// Rewind back to the right position so we can resume at the right position later.
@@ -282,11 +295,44 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 		}
 
 		RegularGCodeInput::Reset();
+#if SUPPORT_BINARY_GCODE_FILES
+		incompleteRecord = false;
+#endif
 	}
 	lastFile = file.f;
 
+#if SUPPORT_BINARY_GCODE_FILES
+	if (file.gcodeFormat == FileData::GCodeFormat::unknown)
+	{
+		CheckFormat(file);
+	}
+	readingBinaryFile = (file.gcodeFormat == FileData::GCodeFormat::binary);
+	if (badRecord)
+	{
+		badRecord = false;
+		return GCodeInputReadResult::error;
+	}
+#endif
+
+#if SUPPORT_FILE_PREFETCH
+	// Read ahead from large files, so that a slow SD card read is less likely to hold us up
+	if (   !prefetcher.IsActiveOn(file.f)
+# if HAS_LINUX_INTERFACE
+		&& !reprap.UsingLinuxInterface()
+# endif
+		&& file.Length() >= FilePrefetchMinFileSize
+	   )
+	{
+		prefetcher.Start(file.f);
+	}
+#endif
+
 	// Read more from the file
-	if (bytesCached < GCodeInputFileReadThreshold)
+	if (   bytesCached < GCodeInputFileReadThreshold
+#if SUPPORT_BINARY_GCODE_FILES
+		|| incompleteRecord									// the buffer may be too full for the usual threshold, but we can't make progress without more data
+#endif
+	   )
 	{
 		// Reset the read+write pointers for better performance if possible
 		if (readingPointer == writingPointer)
@@ -297,7 +343,12 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 		// The code here used to read into a local buffer in blocks that are multiples of 4 bytes.
 		// However, unless we can use a buffer of at least 512 bytes then that is redundant,
 		// because the data will be copied via the sector buffer in FatFS anyway. So we don't do that any more.
-		const int bytesRead = file.Read(buffer + writingPointer, min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer));
+		const size_t bytesToRead = min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer);
+#if SUPPORT_FILE_PREFETCH
+		const int bytesRead = (prefetcher.IsActiveOn(file.f)) ? prefetcher.Read(buffer + writingPointer, bytesToRead) : file.Read(buffer + writingPointer, bytesToRead);
+#else
+		const int bytesRead = file.Read(buffer + writingPointer, bytesToRead);
+#endif
 		if (bytesRead < 0)
 		{
 			return GCodeInputReadResult::error;
@@ -312,6 +363,96 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 	return (bytesCached > 0) ? GCodeInputReadResult::haveData : GCodeInputReadResult::noData;
 }
 
+// Get the file position of the first byte that we have cached
+FilePosition FileGCodeInput::GetPosition(const FileData &file) noexcept
+{
+#if SUPPORT_FILE_PREFETCH
+	const FilePosition pos = (prefetcher.IsActiveOn(file.f)) ? prefetcher.Position() : file.GetPosition();
+#else
+	const FilePosition pos = file.GetPosition();
+#endif
+	return pos - BytesCached();
+}
+
+#if SUPPORT_BINARY_GCODE_FILES
+
+// Check the signature at the start of the file. We may be asked to read a file that has already been positioned, e.g. when resuming a print.
+/*static*/ void FileGCodeInput::CheckFormat(FileData &file) noexcept
+{
+	constexpr size_t signatureLength = sizeof(BinaryGCodeFileSignature) - 1;
+	char signature[signatureLength];
+	const FilePosition pos = file.GetPosition();
+	const bool isBinary = file.Seek(0)
+						&& file.Read(signature, signatureLength) == (int)signatureLength
+						&& memcmp(signature, BinaryGCodeFileSignature, signatureLength) == 0;
+	file.Seek(pos);
+	file.gcodeFormat = (isBinary) ? FileData::GCodeFormat::binary : FileData::GCodeFormat::text;
+}
+
+// Fill a GCodeBuffer from a binary G-code file. Lines of text are passed character by character as usual, but binary records
+// are passed to the binary parser in one go, which saves us from having to parse the parameters.
+bool FileGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
+{
+	if (!readingBinaryFile)
+	{
+		return RegularGCodeInput::FillBuffer(gb);
+	}
+
+	incompleteRecord = false;
+	size_t bytesToPass = BytesCached();
+	while (bytesToPass != 0)
+	{
+		if ((uint8_t)buffer[readingPointer] == BinaryGCodeRecordMarker)
+		{
+			if (bytesToPass < 2)
+			{
+				incompleteRecord = true;
+				break;
+			}
+
+			const size_t numWords = (uint8_t)buffer[(readingPointer + 1) % GCodeInputBufferSize];
+			if (numWords * sizeof(uint32_t) < sizeof(CodeHeader) || numWords > MaxBinaryGCodeRecordWords)
+			{
+				badRecord = true;
+				break;
+			}
+			if (bytesToPass < numWords * sizeof(uint32_t) + 2)
+			{
+				incompleteRecord = true;
+				break;
+			}
+
+			(void)ReadByte();
+			(void)ReadByte();
+			uint32_t record[MaxBinaryGCodeRecordWords];
+			char * const p = reinterpret_cast<char*>(record);
+			for (size_t i = 0; i < numWords * sizeof(uint32_t); ++i)
+			{
+				p[i] = ReadByte();
+			}
+			gb->PutBinaryFromFile(record, numWords);
+			return true;
+		}
+
+		--bytesToPass;
+		if (gb->Put(ReadByte()))				// process a character, returns true if a line of GCode is complete
+		{
+			if (gb->IsWritingFile())
+			{
+				gb->WriteToFile();
+			}
+			else
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+#endif
+
 #endif
 
 // End
@@ -10,6 +10,7 @@
 
 #include <RepRapFirmware.h>
 #include <Storage/FileData.h>
+#include <Storage/FilePrefetcher.h>
 #include <RTOSIface/RTOSIface.h>
 
 #include <Stream.h>
@@ -103,21 +104,50 @@ enum class GCodeInputReadResult : uint8_t { haveData, noData, error };
 
 #if HAS_MASS_STORAGE
 
+#if SUPPORT_BINARY_GCODE_FILES
+
+// A binary G-code file starts with this comment line. After it, ordinary lines of text may be interleaved with binary records.
+// Each binary record is introduced by a byte that never occurs in UTF-8 text, followed by a byte giving the length in 32-bit words
+// of the CodeHeader and CodeParameter data that follows, in the same format that the SBC uses. A record must fit in the input buffer.
+constexpr char BinaryGCodeFileSignature[] = ";RRF binary G-code v1\n";
+constexpr uint8_t BinaryGCodeRecordMarker = 0xFF;
+constexpr size_t MaxBinaryGCodeRecordWords = (GCodeInputBufferSize - 3)/sizeof(uint32_t);
+
+#endif
+
 // This class is an expansion of the RegularGCodeInput class to buffer G-codes and to rewind file positions when
 // nested G-code files are started. However buffered codes are not explicitly checked for M112.
 class FileGCodeInput : public RegularGCodeInput
 {
 public:
 
+#if SUPPORT_BINARY_GCODE_FILES
+	FileGCodeInput() noexcept : RegularGCodeInput(), readingBinaryFile(false), incompleteRecord(false), badRecord(false), lastFile(nullptr) { }
+#else
 	FileGCodeInput() noexcept : RegularGCodeInput(), lastFile(nullptr) { }
+#endif
 
 	void Reset() noexcept override;								// Clears the buffer. Should be called when the associated file is being closed
+#if SUPPORT_BINARY_GCODE_FILES
+	bool FillBuffer(GCodeBuffer *gb) noexcept override;			// Fill a GCodeBuffer with the next G-code, which may be a binary record
+#endif
 	void Reset(const FileData &file) noexcept;					// Clears the buffer of a specific file. Should be called when it is closed or re-opened outside the reading context
 
 	GCodeInputReadResult ReadFromFile(FileData &file) noexcept;	// Read another chunk of G-codes from the file and return true if more data is available
+	FilePosition GetPosition(const FileData &file) noexcept;	// Get the file position of the first byte that we have cached
 
 private:
+#if SUPPORT_BINARY_GCODE_FILES
+	static void CheckFormat(FileData &file) noexcept;			// Find out whether the file is a binary G-code file
+
+	bool readingBinaryFile;										// true if the last file we read from is a binary G-code file
+	bool incompleteRecord;										// true if the buffer ends with part of a binary record
+	bool badRecord;												// true if we found a corrupt binary record
+#endif
 	FileStore *lastFile;
+#if SUPPORT_FILE_PREFETCH
+	FilePrefetcher prefetcher;									// reads ahead from the last file we read from if it is large enough
+#endif
 };
 
 #endif
@@ -133,6 +133,9 @@ void GCodeMachineState::CloseFile() noexcept
 		fileState.Close();
 #endif
 	}
+#if SUPPORT_EXPRESSION_CACHE
+	expressionCache.Clear();
+#endif
 }
 
 void GCodeMachineState::WaitForAcknowledgement() noexcept
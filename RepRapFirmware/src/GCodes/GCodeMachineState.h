@@ -13,6 +13,7 @@
 #include <General/FreelistManager.h>
 #include <General/NamedEnum.h>
 #include <ObjectModel/Variable.h>
+#include <GCodes/GCodeBuffer/CompiledExpression.h>
 
 // Enumeration to list all the possible states that the Gcode processing machine may be in
 enum class GCodeState : uint8_t
@@ -205,6 +206,9 @@ public:
 	ResourceBitmap lockedResources;
 	BlockState blockStates[MaxBlockIndent];
 	uint32_t lineNumber;
+#if SUPPORT_EXPRESSION_CACHE
+	ExpressionCache expressionCache;								// compiled expressions from loops in the file we are executing
+#endif
 
 	uint32_t
 		selectedPlane : 2,
@@ -247,6 +247,9 @@ void QueuedCode::AssignFrom(GCodeBuffer &gb) noexcept
 {
 #if HAS_LINUX_INTERFACE
 	isBinary = gb.IsBinary();
+# if SUPPORT_BINARY_GCODE_FILES
+	isBinaryFromFile = gb.IsBinaryFromFile();
+# endif
 #endif
 	memcpy(data, gb.DataStart(), gb.DataLength());
 	dataLength = gb.DataLength();
@@ -261,6 +264,13 @@ void QueuedCode::AssignTo(GCodeBuffer *gb) noexcept
 		gb->PutBinary(reinterpret_cast<const uint32_t *>(data), dataLength / sizeof(uint32_t));
 	}
 	else
+#endif
+#if SUPPORT_BINARY_GCODE_FILES
+	if (isBinaryFromFile)
+	{
+		gb->PutBinaryFromFile(reinterpret_cast<const uint32_t *>(data), dataLength / sizeof(uint32_t));
+	}
+	else
 #endif
 	{
 		gb->PutAndDecode(data, dataLength);
@@ -50,6 +50,9 @@ private:
 
 #if HAS_LINUX_INTERFACE
 	bool isBinary;
+# if SUPPORT_BINARY_GCODE_FILES
+	bool isBinaryFromFile;
+# endif
 	alignas(4) char data[BufferSizePerQueueItem];
 #else
 	char data[BufferSizePerQueueItem];
@@ -2188,6 +2188,7 @@ bool GCodes::DoStraightMove(GCodeBuffer& gb, bool isCoordinated, const char *& e
 		}
 	}
 	moveBuffer.doingArcMove = false;
+	moveBuffer.isNativeArc = false;
 	FinaliseMove(gb);
 	UnlockAll(gb);			// allow pause
 	err = nullptr;
@@ -2572,6 +2573,16 @@ bool GCodes::DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)
 		}
 	}
 
+	if (SetUpNativeArc(axis0Mapping, axis1Mapping, totalArc, clockwise))
+	{
+		// The Move subsystem will execute the arc as a single move, so we don't need to divide it into segments
+		moveBuffer.totalSegments = 1;
+		moveBuffer.doingArcMove = false;
+		FinaliseMove(gb);
+		UnlockAll(gb);			// allow pause
+		return true;
+	}
+
 	// Compute how many segments to use
 	// For the arc to deviate up to MaxArcDeviation from the ideal, the segment length should be sqrtf(8 * arcRadius * MaxArcDeviation + fsquare(MaxArcDeviation))
 	// We leave out the square term because it is very small
@@ -2604,6 +2615,52 @@ bool GCodes::DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)
 	return true;
 }
 
+// Check whether the arc that has been set up in the move buffer can be executed by the Move subsystem as a single move instead of as a sequence
+// of straight line segments. If it can, set up the native arc parameters and return true; otherwise return false.
+// We don't use a native arc when resuming part way through the arc, because the segmentation code handles that.
+bool GCodes::SetUpNativeArc(AxesBitmap axis0Mapping, AxesBitmap axis1Mapping, float totalArc, bool clockwise) noexcept
+{
+	// Each arc axis must be mapped to just one machine axis, and that axis must not be scaled because that would turn the arc into an ellipse
+	if (moveFractionToSkip > 0.0 || axis0Mapping.CountSetBits() != 1 || axis1Mapping.CountSetBits() != 1)
+	{
+		return false;
+	}
+	const size_t machineAxis0 = axis0Mapping.LowestSetBit();
+	const size_t machineAxis1 = axis1Mapping.LowestSetBit();
+	if (axisScaleFactors[machineAxis0] != 1.0 || axisScaleFactors[machineAxis1] != 1.0 || !reprap.GetMove().CanUseNativeArc(machineAxis0, machineAxis1))
+	{
+		return false;
+	}
+
+	// The end points have already been checked against the machine limits, but the arc may go further than them along either axis.
+	// Check each point on the arc at which it reaches its furthest extent along one of the arc axes.
+	for (unsigned int quadrant = 0; quadrant < 4; ++quadrant)
+	{
+		const float angle = (float)quadrant * (Pi/2);
+		float angleFromStart = (clockwise) ? moveBuffer.arcCurrentAngle - angle : angle - moveBuffer.arcCurrentAngle;
+		angleFromStart -= TwoPi * floorf(angleFromStart/TwoPi);
+		if (angleFromStart < totalArc)
+		{
+			float extremeCoords[MaxAxes];
+			memcpyf(extremeCoords, moveBuffer.coords, numVisibleAxes);
+			extremeCoords[machineAxis0] = moveBuffer.arcCentre[machineAxis0] + moveBuffer.arcRadius * cosf(angle);
+			extremeCoords[machineAxis1] = moveBuffer.arcCentre[machineAxis1] + moveBuffer.arcRadius * sinf(angle);
+			if (reprap.GetMove().GetKinematics().LimitPosition(extremeCoords, nullptr, numVisibleAxes, axesVirtuallyHomed, true, limitAxes) != LimitPositionResult::ok)
+			{
+				return false;
+			}
+		}
+	}
+
+	moveBuffer.isNativeArc = true;
+	moveBuffer.arcAxes[0] = machineAxis0;
+	moveBuffer.arcAxes[1] = machineAxis1;
+	moveBuffer.arcCentreCoords[0] = moveBuffer.arcCentre[machineAxis0];
+	moveBuffer.arcCentreCoords[1] = moveBuffer.arcCentre[machineAxis1];
+	moveBuffer.arcAngle = (clockwise) ? -totalArc : totalArc;
+	return true;
+}
+
 // Adjust the move parameters to account for segmentation and/or part of the move having been done already
 void GCodes::FinaliseMove(GCodeBuffer& gb) noexcept
 {
@@ -2810,6 +2867,7 @@ void GCodes::ClearMove() noexcept
 	moveBuffer.segmentsLeft = 0;
 	moveBuffer.segMoveState = SegmentedMoveState::inactive;
 	moveBuffer.doingArcMove = false;
+	moveBuffer.isNativeArc = false;
 	moveBuffer.checkEndstops = false;
 	moveBuffer.reduceAcceleration = false;
 	moveBuffer.moveType = 0;
@@ -4617,6 +4617,12 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 					reprap.GetMove().SetJerkPolicy(gb.GetUIValue());
 				}
 
+				if (gb.Seen('J'))
+				{
+					seenAxis = true;
+					reprap.GetMove().SetJunctionDeviation(max<float>(gb.GetDistance(), 0.0));
+				}
+
 				if (seenAxis)
 				{
 					reprap.MoveUpdated();
@@ -4640,6 +4646,11 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 					{
 						reply.catf(", jerk policy: %u", reprap.GetMove().GetJerkPolicy());
 					}
+					const float jd = reprap.GetMove().GetJunctionDeviation();
+					if (jd > 0.0)
+					{
+						reply.catf(", junction deviation: %.3fmm", (double)jd);
+					}
 				}
 			}
 			break;
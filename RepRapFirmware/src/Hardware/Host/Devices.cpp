@@ -0,0 +1,100 @@
+/*
+ * Devices.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Devices of the host simulation, the service routine that the FreeRTOS host port calls to run the simulated interrupts, and the
+ *  application entry points that CoreN2G calls during startup.
+ */
+
+#include "Devices.h"
+#include <RepRapFirmware.h>
+#include <AnalogIn.h>
+#include <AnalogOut.h>
+#include <HostSim.h>
+#include <Platform/TaskPriorities.h>
+#include <Movement/StepTimer.h>
+
+constexpr float SimulatedVinVoltage = 24.0;							// the VIN voltage that the simulated power monitor reads
+constexpr uint32_t SdhcClockFreq = 90000000;						// same as the Duet 3 Mini, although the simulated SD card doesn't use it
+
+// Analog input support
+constexpr size_t AnalogInTaskStackWords = 300;
+static Task<AnalogInTaskStackWords> analogInTask;
+
+// Serial device support. The UARTs are not connected to anything in the simulation.
+void Serial0PortInit(AsyncSerial *) noexcept
+{
+	SetPinFunction(Serial0TxPin, Serial0PinFunction);
+	SetPinFunction(Serial0RxPin, Serial0PinFunction);
+}
+
+void Serial0PortDeinit(AsyncSerial *) noexcept
+{
+	pinMode(Serial0TxPin, INPUT_PULLUP);
+	pinMode(Serial0RxPin, INPUT_PULLUP);
+}
+
+void Serial1PortInit(AsyncSerial *) noexcept
+{
+	SetPinFunction(Serial1TxPin, Serial1PinFunction);
+	SetPinFunction(Serial1RxPin, Serial1PinFunction);
+}
+
+void Serial1PortDeinit(AsyncSerial *) noexcept
+{
+	pinMode(Serial1TxPin, INPUT_PULLUP);
+	pinMode(Serial1RxPin, INPUT_PULLUP);
+}
+
+AsyncSerial serialUart0(Serial0SercomNumber, Sercom0RxPad, 512, 512, Serial0PortInit, Serial0PortDeinit);
+AsyncSerial serialUart1(Serial1SercomNumber, Sercom1RxPad, 512, 512, Serial1PortInit, Serial1PortDeinit);
+
+SerialCDC serialUSB(UsbVBusPin, 512, 512);
+
+void DeviceInit() noexcept
+{
+	AnalogIn::Init(NvicPriorityAdc);
+	AnalogOut::Init();
+	HostSim::SetAnalogReading(PinToAdcChannel(PowerMonitorVinDetectPin), (uint16_t)(SimulatedVinVoltage * ((1u << AnalogIn::AdcBits)/PowerMonitorVoltageRange)));
+	analogInTask.Create(AnalogIn::TaskLoop, "AIN", nullptr, TaskPriority::AinPriority);
+}
+
+void StopAnalogTask() noexcept
+{
+	AnalogIn::Exit();
+	analogInTask.TerminateAndUnlink();
+}
+
+// Called by the FreeRTOS host port with interrupts masked to run the simulated peripheral interrupts that are due.
+// The step timer is the only peripheral that generates interrupts in the simulation.
+extern "C" uint64_t ullPortServicePeripherals(uint64_t ullNow)
+{
+	return StepTimer::HostServiceInterrupt(ullNow);
+}
+
+void AppInit() noexcept
+{
+}
+
+// Return the XOSC frequency in MHz
+unsigned int AppGetXoscFrequency() noexcept
+{
+	return 25;
+}
+
+// Return the XOSC number
+unsigned int AppGetXoscNumber() noexcept
+{
+	return 1;
+}
+
+// Return get the SDHC peripheral clock speed in Hz
+uint32_t AppGetSdhcClockSpeed() noexcept
+{
+	return SdhcClockFreq;
+}
+
+// End
@@ -0,0 +1,34 @@
+/*
+ * Devices.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Devices of the host simulation. This replaces Hardware/SAME5x/Devices.h, which is further down the include path.
+ */
+
+#ifndef SRC_HARDWARE_HOST_DEVICES_H_
+#define SRC_HARDWARE_HOST_DEVICES_H_
+
+#include <AsyncSerial.h>
+typedef AsyncSerial UARTClass;
+
+extern AsyncSerial serialUart0, serialUart1;
+
+#define SUPPORT_USB		1		// needed by SerialCDC.h
+#include "SerialCDC.h"
+
+extern SerialCDC serialUSB;
+
+void DeviceInit() noexcept;
+void StopAnalogTask() noexcept;
+
+// Load the simulated SD card from a disk image file. Without an image the simulation has no SD card.
+bool LoadSdCardImage(const char *fileName) noexcept;
+
+// GCLK numbers not defined in the core
+constexpr unsigned int GclkNum25MHz = 2;		// for Ethernet PHY
+constexpr unsigned int GclkNum90MHz = 5;		// for SDHC
+
+#endif /* SRC_HARDWARE_HOST_DEVICES_H_ */
@@ -0,0 +1,52 @@
+/*
+ * ExceptionHandlers.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host simulation replacement for Hardware/ExceptionHandlers.cpp. A software reset ends the simulation. The exit status is 0 if the reset
+ *  was requested by M999, which is how the replay driver ends a run, otherwise it is 1.
+ */
+
+#include <Hardware/ExceptionHandlers.h>
+#include <Platform/RepRap.h>
+#include <Platform/Platform.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+[[noreturn]] void SoftwareReset(SoftwareResetReason initialReason, const uint32_t *stk) noexcept
+{
+	IrqDisable();
+	const uint16_t fullReason = (uint16_t)initialReason | (uint8_t)reprap.GetSpinningModule();
+	fflush(stdout);
+	fprintf(stderr, "Software reset code 0x%04x after %.3f seconds of simulated time\n", fullReason, (double)ullPortGetSimulatedTime() * 1.0e-9);
+	fflush(stderr);
+	_exit((initialReason == SoftwareResetReason::user) ? 0 : 1);
+}
+
+[[noreturn]] void OutOfMemoryHandler() noexcept
+{
+	SoftwareReset(SoftwareResetReason::outOfMemory);
+}
+
+extern "C" [[noreturn]] void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) noexcept
+{
+	fprintf(stderr, "Stack overflow in task %s\n", pcTaskName);
+	SoftwareReset(SoftwareResetReason::stackOverflow);
+}
+
+extern "C" [[noreturn]] void vAssertCalled(uint32_t line, const char *file) noexcept
+{
+	fprintf(stderr, "Assertion failed in %s at line %u\n", file, (unsigned int)line);
+	SoftwareReset(SoftwareResetReason::assertCalled);
+}
+
+extern "C" [[noreturn]] void __cxa_deleted_virtual() noexcept
+{
+	SoftwareReset(SoftwareResetReason::pureOrDeletedVirtual);
+}
+
+// End
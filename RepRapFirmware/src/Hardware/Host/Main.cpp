@@ -0,0 +1,119 @@
+/*
+ * Main.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  G-code replay driver for the host simulation. The host tests in RepRapFirmware/tests replace this file with their own driver.
+ *
+ *  Usage: rrfsim [-r] [-x scale] [-s sdcard.img] [file.g ...]
+ *  The files are sent to the simulated USB port one after another, or the standard input is sent if no files are given.
+ *  When all input has been sent we send M400 to wait for the moves to finish and then M999. The host version of SoftwareReset
+ *  ends the simulation when it executes M999. The firmware's responses are written to the standard output.
+ *  -r runs in real time instead of skipping the time during which all tasks are waiting; -x makes simulated time run the given
+ *  number of times faster than real time while tasks are busy; -s loads the simulated SD card from a FAT disk image.
+ *  Replaying captured SBC or HTTP traffic is not supported, because the simulation is built without networking and SBC support.
+ */
+
+#include "Devices.h"
+#include <HostSim.h>
+#include <FreeRTOS.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+static char **inputFiles = nullptr;
+static int numInputFiles = 0;
+static int nextInputFile = 0;
+static FILE *currentInput = nullptr;
+static const char *trailer = nullptr;								// what we send when all input files have been sent
+
+static constexpr const char *EndOfInputCommands = "\nM400\nM999\n";
+
+void AppHostInit(int argc, char *argv[]) noexcept
+{
+	bool skipIdleTime = true;
+	uint32_t timeScale = 1;
+	int opt;
+	while ((opt = getopt(argc, argv, "rx:s:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'r':
+			skipIdleTime = false;
+			break;
+
+		case 'x':
+			timeScale = strtoul(optarg, nullptr, 10);
+			break;
+
+		case 's':
+			if (!LoadSdCardImage(optarg))
+			{
+				fprintf(stderr, "Can't load SD card image %s\n", optarg);
+				exit(2);
+			}
+			break;
+
+		default:
+			fprintf(stderr, "Usage: %s [-r] [-x scale] [-s sdcard.img] [file.g ...]\n", argv[0]);
+			exit(2);
+		}
+	}
+
+	vPortSetTimeScale(timeScale, (skipIdleTime) ? pdTRUE : pdFALSE);
+	inputFiles = argv + optind;
+	numInputFiles = argc - optind;
+	if (numInputFiles == 0)
+	{
+		currentInput = stdin;
+	}
+}
+
+// Return the next input characters for the USB port
+size_t AppHostReadUsb(uint8_t *buffer, size_t maxBytes) noexcept
+{
+	while (maxBytes != 0)
+	{
+		if (currentInput != nullptr)
+		{
+			const size_t count = fread(buffer, 1, maxBytes, currentInput);
+			if (count != 0)
+			{
+				return count;
+			}
+			if (currentInput != stdin)
+			{
+				fclose(currentInput);
+			}
+			currentInput = nullptr;
+		}
+		else if (nextInputFile < numInputFiles)
+		{
+			const char * const fileName = inputFiles[nextInputFile++];
+			currentInput = fopen(fileName, "rb");
+			if (currentInput == nullptr)
+			{
+				fprintf(stderr, "Can't open input file %s\n", fileName);
+				exit(2);
+			}
+		}
+		else
+		{
+			if (trailer == nullptr)
+			{
+				trailer = EndOfInputCommands;
+			}
+			const size_t count = min<size_t>(strlen(trailer), maxBytes);
+			memcpy(buffer, trailer, count);
+			trailer += count;
+			return count;
+		}
+	}
+	return 0;
+}
+
+// End
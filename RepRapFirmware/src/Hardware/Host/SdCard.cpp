@@ -0,0 +1,143 @@
+/*
+ * SdCard.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host simulation of the SD card, replacing the sd_mmc driver. The card is a RAM disk loaded from an image file, or there is no card.
+ *  Writes change only the RAM disk, not the image file.
+ */
+
+#include "Devices.h"
+#include <Libraries/sd_mmc/sd_mmc.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static uint8_t *cardData = nullptr;
+static uint32_t cardBlocks = 0;
+static uint32_t transferBlock = 0;
+static bool mounted = false;
+
+constexpr uint32_t SimulatedInterfaceSpeed = 22500000;				// same as the Duet 3 Mini, in bytes/sec
+
+bool LoadSdCardImage(const char *fileName) noexcept
+{
+	FILE * const f = fopen(fileName, "rb");
+	if (f == nullptr)
+	{
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	const long length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	cardBlocks = (uint32_t)(length/SD_MMC_BLOCK_SIZE);
+	cardData = static_cast<uint8_t*>(malloc((size_t)cardBlocks * SD_MMC_BLOCK_SIZE));
+	const bool ok = cardData != nullptr && fread(cardData, SD_MMC_BLOCK_SIZE, cardBlocks, f) == cardBlocks;
+	fclose(f);
+	return ok;
+}
+
+void sd_mmc_init(const Pin wpPins[], const Pin spiCsPins[]) noexcept
+{
+}
+
+uint8_t sd_mmc_nb_slot(void) noexcept
+{
+	return 1;
+}
+
+sd_mmc_err_t sd_mmc_check(uint8_t slot) noexcept
+{
+	if (slot != 0)
+	{
+		return SD_MMC_ERR_SLOT;
+	}
+	if (cardData == nullptr)
+	{
+		return SD_MMC_ERR_NO_CARD;
+	}
+	mounted = true;
+	return SD_MMC_OK;
+}
+
+card_type_t sd_mmc_get_type(uint8_t slot) noexcept
+{
+	return (slot == 0 && mounted) ? CARD_TYPE_SD | CARD_TYPE_HC : CARD_TYPE_UNKNOWN;
+}
+
+card_version_t sd_mmc_get_version(uint8_t slot) noexcept
+{
+	return (slot == 0 && mounted) ? CARD_VER_SD_3_0 : CARD_VER_UNKNOWN;
+}
+
+// Return the capacity in KB
+uint32_t sd_mmc_get_capacity(uint8_t slot) noexcept
+{
+	return (slot == 0 && mounted) ? cardBlocks/(1024/SD_MMC_BLOCK_SIZE) : 0;
+}
+
+bool sd_mmc_is_write_protected(uint8_t slot) noexcept
+{
+	return false;
+}
+
+void sd_mmc_unmount(uint8_t slot) noexcept
+{
+	if (slot == 0)
+	{
+		mounted = false;
+	}
+}
+
+uint32_t sd_mmc_get_interface_speed(uint8_t slot) noexcept
+{
+	return (slot == 0 && mounted) ? SimulatedInterfaceSpeed : 0;
+}
+
+sd_mmc_err_t sd_mmc_init_read_blocks(uint8_t slot, uint32_t start, uint16_t nb_block, void *dmaAddr) noexcept
+{
+	if (slot != 0 || !mounted)
+	{
+		return SD_MMC_ERR_NO_CARD;
+	}
+	if (start >= cardBlocks || nb_block > cardBlocks - start)
+	{
+		return SD_MMC_ERR_PARAM;
+	}
+	transferBlock = start;
+	return SD_MMC_OK;
+}
+
+sd_mmc_err_t sd_mmc_start_read_blocks(void *dest, uint16_t nb_block, uint8_t slot) noexcept
+{
+	memcpy(dest, cardData + (size_t)transferBlock * SD_MMC_BLOCK_SIZE, (size_t)nb_block * SD_MMC_BLOCK_SIZE);
+	transferBlock += nb_block;
+	return SD_MMC_OK;
+}
+
+sd_mmc_err_t sd_mmc_wait_end_of_read_blocks(bool abort, uint8_t slot) noexcept
+{
+	return SD_MMC_OK;
+}
+
+sd_mmc_err_t sd_mmc_init_write_blocks(uint8_t slot, uint32_t start, uint16_t nb_block, const void *dmaAddr) noexcept
+{
+	return sd_mmc_init_read_blocks(slot, start, nb_block, nullptr);
+}
+
+sd_mmc_err_t sd_mmc_start_write_blocks(const void *src, uint16_t nb_block, uint8_t slot) noexcept
+{
+	memcpy(cardData + (size_t)transferBlock * SD_MMC_BLOCK_SIZE, src, (size_t)nb_block * SD_MMC_BLOCK_SIZE);
+	transferBlock += nb_block;
+	return SD_MMC_OK;
+}
+
+sd_mmc_err_t sd_mmc_wait_end_of_write_blocks(bool abort, uint8_t slot) noexcept
+{
+	return SD_MMC_OK;
+}
+
+// End
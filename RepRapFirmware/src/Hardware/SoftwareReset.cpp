@@ -82,7 +82,7 @@ void SoftwareResetData::Populate(uint16_t reason, const uint32_t *stk) noexcept
 	const TaskHandle_t currentTask = xTaskGetCurrentTaskHandle();
 	taskName = (currentTask == nullptr) ? 0x656e6f6e : LoadLE32(pcTaskGetName(currentTask));
 
-	sp = reinterpret_cast<uint32_t>(stk);
+	sp = (uint32_t)reinterpret_cast<uintptr_t>(stk);
 	if (stk == nullptr)
 	{
 		stackOffset = 0;
@@ -61,7 +61,7 @@ FopDt::FopDt() noexcept
 }
 
 // Check the model parameters are sensible, if they are then save them and return true.
-bool FopDt::SetParameters(float phr, float pcrFanOff, float pcrFanOn, float pdt, float pMaxPwm, float temperatureLimit, float pVoltage, bool pUsePid, bool pInverted) noexcept
+bool FopDt::SetParameters(float phr, float pcrFanOff, float pcrFanOn, float pdt, float pMaxPwm, float temperatureLimit, float pVoltage, bool pUsePid, bool pUsePredictive, bool pInverted) noexcept
 {
 	// DC 2017-06-20: allow S down to 0.01 for one of our OEMs (use > 0.0099 because >= 0.01 doesn't work due to rounding error)
 	const float maxTempIncrease = max<float>(1500.0, temperatureLimit + 500.0);
@@ -81,6 +81,7 @@ bool FopDt::SetParameters(float phr, float pcrFanOff, float pcrFanOn, float pdt,
 		maxPwm = pMaxPwm;
 		standardVoltage = pVoltage;
 		usePid = pUsePid;
+		usePredictive = pUsePredictive;
 		inverted = pInverted;
 		enabled = true;
 		CalcPidConstants();
@@ -105,6 +106,7 @@ void FopDt::SetDefaultToolParameters() noexcept
 	maxPwm = 1.0;
 	standardVoltage = 0.0;
 	usePid = true;
+	usePredictive = false;
 	inverted = false;
 	enabled = true;
 	CalcPidConstants();
@@ -120,6 +122,7 @@ void FopDt::SetDefaultBedOrChamberParameters() noexcept
 	maxPwm = 1.0;
 	standardVoltage = 0.0;
 	usePid = false;
+	usePredictive = false;
 	inverted = false;
 	enabled = true;
 	CalcPidConstants();
@@ -160,7 +163,7 @@ bool FopDt::WriteParameters(FileStore *f, size_t heater) const noexcept
 							(double)deadTime,
 							(double)maxPwm,
 							(double)standardVoltage,
-							(usePid) ? 0 : 1,
+							(!usePid) ? 1 : (usePredictive) ? 2 : 0,
 							(inverted) ? 1 : 0);
 	bool ok = f->Write(scratchString.c_str());
 	if (ok && pidParametersOverridden)
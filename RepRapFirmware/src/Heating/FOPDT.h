@@ -43,7 +43,7 @@ public:
 	FopDt() noexcept;
 
 	void Clear() noexcept;
-	bool SetParameters(float phr, float pcrFanOff, float pcrFanOn, float pdt, float pMaxPwm, float temperatureLimit, float pVoltage, bool pUsePid, bool pInverted) noexcept;
+	bool SetParameters(float phr, float pcrFanOff, float pcrFanOn, float pdt, float pMaxPwm, float temperatureLimit, float pVoltage, bool pUsePid, bool pUsePredictive, bool pInverted) noexcept;
 	void SetDefaultToolParameters() noexcept;
 	void SetDefaultBedOrChamberParameters() noexcept;
 
@@ -56,6 +56,7 @@ public:
 	float GetMaxPwm() const noexcept { return maxPwm; }
 	float GetVoltage() const noexcept { return standardVoltage; }
 	bool UsePid() const noexcept { return usePid; }
+	bool UsePredictive() const noexcept { return usePid && usePredictive; }
 	bool IsInverted() const noexcept { return inverted; }
 	bool IsEnabled() const noexcept { return enabled; }
 
@@ -94,6 +95,7 @@ private:
 	float standardVoltage;					// power voltage reading at which tuning was done, or 0 if unknown
 	bool enabled;
 	bool usePid;
+	bool usePredictive;						// true to use model-predictive control instead of PID. Only relevant if usePid is true.
 	bool inverted;
 	bool pidParametersOverridden;
 
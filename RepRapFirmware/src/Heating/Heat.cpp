@@ -28,6 +28,7 @@ Licence: GPL
 #include <Tools/Tool.h>
 #include <Platform/TaskPriorities.h>
 #include <General/Portability.h>
+#include <Movement/StepTimer.h>
 
 #if SUPPORT_DHT_SENSOR
 # include "Sensors/DhtSensor.h"
@@ -62,7 +63,7 @@ extern "C" [[noreturn]] void HeaterTaskStart(void * pvParameters) noexcept
 	reprap.GetHeat().HeaterTask();
 }
 
-static constexpr uint16_t SensorsTaskStackWords = 150;		// task stack size in dwords. 80 was not enough. Use 300 if debugging is enabled.
+static constexpr uint16_t SensorsTaskStackWords = 200;		// task stack size in dwords. 80 was not enough, 150 was enough before SPI sensors were read by this task. Use 300 if debugging is enabled.
 static Task<SensorsTaskStackWords> *sensorsTask = nullptr;
 
 extern "C" [[noreturn]] void SensorsTaskStart(void * pvParameters) noexcept
@@ -191,6 +192,10 @@ GCodeResult Heat::SetPidParameters(unsigned int heater, GCodeBuffer& gb, const S
 		{
 			reply.printf("Heater %d is in bang-bang mode", heater);
 		}
+		else if (model.UsePredictive())
+		{
+			reply.printf("Heater %d uses model-predictive control", heater);
+		}
 		else if (model.ArePidParametersOverridden())
 		{
 			reply.printf("Heater %d P:%.1f I:%.3f D:%.1f", heater, (double)pp.kP, (double)pp.kI, (double)pp.kD);
@@ -374,6 +379,7 @@ void Heat::Exit() noexcept
 
 // Code executed by the SensorsTask.
 // This is run at the same priority as the Heat task, so it must not sit in any spin loops.
+// Each sensor that is polled by this task is polled at the interval it asks for. Sensors that do not need a delay after polling them, such as SPI sensors, are polled one after another.
 /*static*/ [[noreturn]] void Heat::SensorsTask() noexcept
 {
 	auto lastWakeTime = xTaskGetTickCount();
@@ -399,10 +405,17 @@ void Heat::Exit() noexcept
 				++sensorCountSinceLastDelay;
 				sensorNumber = sensor->GetSensorNumber() + 1;
 
-				if (sensor->PollInTask())
+				const uint32_t now = millis();
+				if (sensor->GetTaskPollInterval() != 0 && sensor->IsTaskPollDue(now))
 				{
-					// Coming here sensorCount cannot be 0 since we got at least one sensor returning true
-					delay = ((SensorsTaskTotalDelay/sensorCount)*sensorCountSinceLastDelay);
+					const uint32_t startTicks = StepTimer::GetTimerTicks();
+					const bool wantDelay = sensor->PollInTask();
+					sensor->RecordTaskPoll(now, StepTimer::GetTimerTicks() - startTicks);
+					if (wantDelay)
+					{
+						// Coming here sensorCount cannot be 0 since we got at least one sensor returning true
+						delay = ((SensorsTaskTotalDelay/sensorCount)*sensorCountSinceLastDelay);
+					}
 				}
 			}
 
@@ -453,6 +466,16 @@ void Heat::Diagnostics(MessageType mtype) noexcept
 			platform.MessageF(mtype, "Heater %u is on, I-accum = %.1f\n", heater, (double)acc);
 		}
 	}
+
+	// Report the statistics for sensors that are polled by the sensors task
+	ReadLocker lock(sensorsLock);
+	for (TemperatureSensor *sensor = sensorsRoot; sensor != nullptr; sensor = sensor->GetNext())
+	{
+		if (sensor->GetTaskPollInterval() != 0)
+		{
+			sensor->ReportTaskPollStatistics(mtype);
+		}
+	}
 }
 
 // Configure a heater. Invoked by M950.
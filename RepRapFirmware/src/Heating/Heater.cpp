@@ -91,6 +91,14 @@ uint8_t Heater::idleCyclesDone;
 
 Heater::HeaterParameters Heater::fanOffParams, Heater::fanOnParams;
 
+bool Heater::fastTuning = false;
+LinearRegression Heater::tuningFit;
+float Heater::maxHeatingSlope;
+float Heater::maxSlopeTemp;
+uint32_t Heater::maxSlopeTime;
+unsigned int Heater::fanLevel;
+float Heater::fanLevelCoolingRates[NumFastTuningFanLevels];
+
 // Clear all the counters except tuning voltage and start temperature
 /*static*/ void Heater::ClearCounters() noexcept
 {
@@ -133,7 +141,7 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 		maxPwm = model.GetMaxPwm(),
 		voltage = model.GetVoltage();
 	float coolingRates[2] = { model.GetCoolingRateFanOff(), model.GetCoolingRateFanOn() };
-	int32_t dontUsePid = model.UsePid() ? 0 : 1;
+	int32_t controlMode = (!model.UsePid()) ? 1 : (model.UsePredictive()) ? 2 : 0;		// 0 = PID, 1 = bang-bang, 2 = model-predictive
 	int32_t inversionParameter = 0;
 
 	// Get the cooling time constant(s) first
@@ -163,7 +171,7 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 		heatingRate = gain * coolingRates[0];
 	}
 	gb.TryGetFValue('D', td, seen);
-	gb.TryGetIValue('B', dontUsePid, seen);
+	gb.TryGetIValue('B', controlMode, seen);
 	gb.TryGetFValue('S', maxPwm, seen);
 	gb.TryGetFValue('V', voltage, seen);
 	gb.TryGetIValue('I', inversionParameter, seen);
@@ -171,8 +179,21 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 	if (seen)
 	{
 		// Set the model
+		if (controlMode < 0 || controlMode > 2)
+		{
+			reply.copy("B parameter must be 0, 1 or 2");
+			return GCodeResult::error;
+		}
+#if SUPPORT_CAN_EXPANSION
+		if (controlMode == 2 && !IsLocal())
+		{
+			reply.printf("Heater %u is on an expansion board, which does not support model-predictive control", heater);
+			return GCodeResult::error;
+		}
+#endif
+
 		const bool inverseTemperatureControl = (inversionParameter == 1 || inversionParameter == 3);
-		const GCodeResult rslt = SetModel(heatingRate, coolingRates[0], coolingRates[1], td, maxPwm, voltage, dontUsePid == 0, inverseTemperatureControl, reply);
+		const GCodeResult rslt = SetModel(heatingRate, coolingRates[0], coolingRates[1], td, maxPwm, voltage, controlMode != 1, controlMode == 2, inverseTemperatureControl, reply);
 		if (rslt <= GCodeResult::warning)
 		{
 			modelSetByUser = true;
@@ -188,6 +209,7 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 	else
 	{
 		const char* const mode = (!model.UsePid()) ? "bang-bang"
+									: (model.UsePredictive()) ? "model-predictive"
 									: (model.ArePidParametersOverridden()) ? "custom PID"
 										: "PID";
 		reply.printf("Heater %u model: heating rate %.3f, cooling time constant %.1f", heater, (double)model.GetHeatingRate(), (double)model.GetTimeConstantFanOff());
@@ -200,7 +222,7 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 		{
 			reply.cat(", inverted control");
 		}
-		if (model.UsePid())
+		if (model.UsePid() && !model.UsePredictive())
 		{
 			M301PidParameters params = model.GetM301PidParameters(false);
 			reply.catf("\nComputed PID parameters: setpoint change: P%.1f, I%.3f, D%.1f", (double)params.kP, (double)params.kI, (double)params.kD);
@@ -212,10 +234,10 @@ GCodeResult Heater::SetOrReportModel(unsigned int heater, GCodeBuffer& gb, const
 }
 
 // Set the process model returning true if successful
-GCodeResult Heater::SetModel(float hr, float coolingRateFanOff, float coolingRateFanOn, float td, float maxPwm, float voltage, bool usePid, bool inverted, const StringRef& reply) noexcept
+GCodeResult Heater::SetModel(float hr, float coolingRateFanOff, float coolingRateFanOn, float td, float maxPwm, float voltage, bool usePid, bool usePredictive, bool inverted, const StringRef& reply) noexcept
 {
 	GCodeResult rslt;
-	if (model.SetParameters(hr, coolingRateFanOff, coolingRateFanOn, td, maxPwm, GetHighestTemperatureLimit(), voltage, usePid, inverted))
+	if (model.SetParameters(hr, coolingRateFanOff, coolingRateFanOn, td, maxPwm, GetHighestTemperatureLimit(), voltage, usePid, usePredictive, inverted))
 	{
 		if (model.IsEnabled())
 		{
@@ -289,12 +311,17 @@ GCodeResult Heater::StartAutoTune(GCodeBuffer& gb, const StringRef& reply, FansB
 	tuningPwm = (gb.Seen('P')) ? gb.GetLimitedFValue('P', 0.1, 1.0) : GetModel().GetMaxPwm();
 	tuningHysteresis = (gb.Seen('Y')) ? gb.GetLimitedFValue('Y', 1.0, 20.0) : DefaultTuningHysteresis;
 	tuningFanPwm = (gb.Seen('F')) ? gb.GetLimitedFValue('F', 0.1, 1.0) : 1.0;
+	fastTuning = (gb.Seen('Q') && gb.GetUIValue() != 0);
+	tuningFit.Clear();
+	maxHeatingSlope = 0.0;
+	fanLevel = 0;
+	tuningVoltage.Clear();
 
 	const GCodeResult rslt = StartAutoTune(reply, seenA, ambientTemp);
 	if (rslt == GCodeResult::ok)
 	{
-		reply.printf("Auto tuning heater %u using target temperature %.1f" DEGREE_SYMBOL "C and PWM %.2f - do not leave printer unattended",
-						GetHeaterNumber(), (double)targetTemp, (double)tuningPwm);
+		reply.printf("%s heater %u using target temperature %.1f" DEGREE_SYMBOL "C and PWM %.2f - do not leave printer unattended",
+						(fastTuning) ? "Fast auto tuning" : "Auto tuning", GetHeaterNumber(), (double)targetTemp, (double)tuningPwm);
 	}
 	return rslt;
 }
@@ -403,17 +430,17 @@ void Heater::SetAndReportModel(bool usingFans) noexcept
 #else
 										0.0,
 #endif
-										true, false, str.GetRef());
+										true, model.UsePredictive(), false, str.GetRef());
 	if (rslt == GCodeResult::ok || rslt == GCodeResult::warning)
 	{
 		tuned = true;
 		str.printf("Auto tuning heater %u completed after %u idle and %u tuning cycles in %" PRIu32 " seconds. This heater needs the following M307 command:\n"
-					" M307 H%u B0 R%.3f C%.1f",
+					" M307 H%u B%u R%.3f C%.1f",
 					GetHeaterNumber(),
 					idleCyclesDone,
 					(usingFans) ? fanOffParams.numCycles + fanOnParams.numCycles : fanOffParams.numCycles,
 					(millis() - tuningBeginTime)/(uint32_t)SecondsToMillis,
-					GetHeaterNumber(), (double)GetModel().GetHeatingRate(), (double)(1.0/GetModel().GetCoolingRateFanOff())
+					GetHeaterNumber(), (GetModel().UsePredictive()) ? 2u : 0u, (double)GetModel().GetHeatingRate(), (double)(1.0/GetModel().GetCoolingRateFanOff())
 				  );
 		if (usingFans)
 		{
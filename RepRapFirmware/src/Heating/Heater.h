@@ -14,6 +14,7 @@
 #include "HeaterMonitor.h"
 #include <ObjectModel/ObjectModel.h>
 #include <Math/DeviationAccumulator.h>
+#include <Math/LinearRegression.h>
 
 #if SUPPORT_CAN_EXPANSION
 # include "CanId.h"
@@ -133,7 +134,7 @@ protected:
 	float GetMaxTemperatureExcursion() const noexcept { return maxTempExcursion; }
 	float GetMaxHeatingFaultTime() const noexcept { return maxHeatingFaultTime; }
 	float GetTargetTemperature() const noexcept { return (active) ? activeTemperature : standbyTemperature; }
-	GCodeResult SetModel(float hr, float coolingRateFanOff, float coolingRateFanOn, float td, float maxPwm, float voltage, bool usePid, bool inverted, const StringRef& reply) noexcept;
+	GCodeResult SetModel(float hr, float coolingRateFanOff, float coolingRateFanOn, float td, float maxPwm, float voltage, bool usePid, bool usePredictive, bool inverted, const StringRef& reply) noexcept;
 															// set the process model
 	void ReportTuningUpdate() noexcept;						// tell the user what's happening
 	void CalculateModel(HeaterParameters& params) noexcept;	// calculate G, td and tc from the accumulated readings
@@ -152,6 +153,11 @@ protected:
 	static constexpr float TuningPeakTempDrop = 2.0;		// must be well below TuningHysteresis
 	static constexpr float FeedForwardMultiplier = 1.3;		// how much we over-compensate feedforward to allow for heat reservoirs during tuning
 	static constexpr float HeaterSettledCoolingTimeRatio = 0.93;
+	static constexpr unsigned int TuningPhaseFanOff = 3;				// index of the "tuning with fan off" phase in TuningPhaseText
+	static constexpr unsigned int TuningPhaseFanOn = 4 + TUNE_WITH_HALF_FAN;	// index of the "tuning with fan on" phase in TuningPhaseText
+	static constexpr unsigned int NumFastTuningFanLevels = 4;		// number of fan speeds at which fast tuning measures the cooling rate, including fan off
+	static constexpr float FastTuningMinRise = 3.0;					// how much the temperature must rise before fast tuning starts fitting the heating curve
+	static constexpr float FastTuningCoolingDropFactor = 3.0;		// fast tuning measures cooling until the temperature has dropped this many times the hysteresis below the target
 
 	// Variables used during heater tuning
 	static float tuningPwm;									// the PWM to use, 0..1
@@ -182,6 +188,15 @@ protected:
 
 	static HeaterParameters fanOffParams, fanOnParams;
 
+	// Variables used only during fast tuning
+	static bool fastTuning;									// true if we are fitting the model to the step response instead of cycling the heater
+	static LinearRegression tuningFit;						// the rate of change of temperature against the temperature rise above ambient
+	static float maxHeatingSlope;							// the highest rate of temperature rise seen while heating
+	static float maxSlopeTemp;								// the temperature at which we saw it
+	static uint32_t maxSlopeTime;							// the time at which we saw it
+	static unsigned int fanLevel;							// which fan speed we are measuring the cooling rate at
+	static float fanLevelCoolingRates[NumFastTuningFanLevels];
+
 	static void ClearCounters() noexcept;
 
 private:
@@ -53,8 +53,11 @@ void LocalHeater::ResetHeater() noexcept
 	previousTemperaturesGood = 0;
 	previousTemperatureIndex = 0;
 	iAccumulator = 0.0;
+	modelTemperature = BadErrorTemperature;
 	badTemperatureCount = 0;
 	averagePWM = lastPwm = 0.0;
+	memset(previousPwms, 0, sizeof(previousPwms));
+	previousPwmIndex = 0;
 	heatingFaultCount = 0;
 	temperature = BadErrorTemperature;
 }
@@ -157,6 +160,7 @@ void LocalHeater::SwitchOff() noexcept
 // This is called when the heater model has been updated. Returns true if successful.
 GCodeResult LocalHeater::UpdateModel(const StringRef& reply) noexcept
 {
+	modelTemperature = BadErrorTemperature;				// restart the predictive model from the current temperature
 	return GCodeResult::ok;
 }
 
@@ -198,6 +202,14 @@ void LocalHeater::Spin() noexcept
 				gotDerivative = true;
 			}
 		}
+		if (GetModel().UsePredictive())
+		{
+			UpdatePredictiveModel((previousTemperaturesGood & 1) != 0);
+		}
+		else
+		{
+			modelTemperature = BadErrorTemperature;		// so that the model is restarted if predictive control is selected
+		}
 		previousTemperatures[previousTemperatureIndex] = temperature;
 		previousTemperaturesGood = (previousTemperaturesGood << 1) | 1;
 
@@ -279,7 +291,17 @@ void LocalHeater::Spin() noexcept
 			// Calculate the PWM
 			if (mode >= HeaterMode::tuning0)
 			{
-				DoTuningStep();
+				if (fastTuning && mode > HeaterMode::tuning0)
+				{
+					if (!DoFastTuningStep(derivative, gotDerivative))
+					{
+						SwitchOff();
+					}
+				}
+				else
+				{
+					DoTuningStep();
+				}
 			}
 			else
 			{
@@ -290,7 +312,11 @@ void LocalHeater::Spin() noexcept
 				else
 				{
 					// Performing normal temperature control
-					if (GetModel().UsePid())
+					if (GetModel().UsePredictive())
+					{
+						lastPwm = CalcPredictivePwm(targetTemperature);
+					}
+					else if (GetModel().UsePid())
 					{
 						// Using PID mode. Determine the PID parameters to use.
 						const bool inLoadMode = (mode == HeaterMode::stable) || fabsf(error) < 3.0;		// use standard PID when maintaining temperature
@@ -387,8 +413,10 @@ void LocalHeater::Spin() noexcept
 			lastPwm = 0.0;
 		}
 
-		// Set the heater power and update the average PWM
+		// Set the heater power, record it for model-predictive control and update the average PWM
 		SetHeater(lastPwm);
+		previousPwms[previousPwmIndex] = (uint8_t)lrintf(((GetModel().IsInverted()) ? GetModel().GetMaxPwm() - lastPwm : lastPwm) * 255.0);
+		previousPwmIndex = (previousPwmIndex + 1) % NumPreviousPwms;
 		averagePWM = averagePWM * (1.0 - HeatSampleIntervalMillis/(HeatPwmAverageTime * SecondsToMillis)) + lastPwm;
 		previousTemperatureIndex = (previousTemperatureIndex + 1) % NumPreviousTemperatures;
 
@@ -404,6 +432,88 @@ void LocalHeater::Spin() noexcept
 	}
 }
 
+/* Model-predictive control
+ * The heater model tells us that the rate of change of temperature is heatingRate * (pwm - correction) - coolingRate * (temperature - ambient),
+ * where the correction accounts for differences between the model and the real heater, for example because a fan is on.
+ * We run the model alongside the heater, driven by the PWM we applied one dead time ago, and adjust the correction until the model matches the measured temperature.
+ * The PWM applied during the last dead time has not affected the temperature reading yet, so to calculate the new PWM we use the model to predict what
+ * the temperature will be when it has, then we choose the PWM that makes the predicted temperature approach the target with a time constant equal to the dead time.
+ */
+
+// Get the heating rate to use, allowing for the supply voltage
+float LocalHeater::GetPredictiveHeatingRate() const noexcept
+{
+	const FopDt& model = GetModel();
+	float heatingRate = model.GetHeatingRate();
+#if HAS_VOLTAGE_MONITOR
+	// The heating rate is proportional to the square of the voltage
+	if (model.GetVoltage() >= 10.0 && !reprap.GetHeat().IsBedOrChamberHeater(GetHeaterNumber()))
+	{
+		const float currentVoltage = reprap.GetPlatform().GetCurrentPowerVoltage();
+		if (currentVoltage >= 10.0)
+		{
+			heatingRate *= fsquare(currentVoltage/model.GetVoltage());
+		}
+	}
+#endif
+	return heatingRate;
+}
+
+// Get the number of samples that the dead time corresponds to
+size_t LocalHeater::GetPredictionHorizon() const noexcept
+{
+	return min<size_t>(lrintf(GetModel().GetDeadTime() * (SecondsToMillis/(float)HeatSampleIntervalMillis)), NumPreviousPwms);
+}
+
+// Update the modelled temperature and the correction. Called on every good temperature reading.
+void LocalHeater::UpdatePredictiveModel(bool previousReadingGood) noexcept
+{
+	if (modelTemperature == BadErrorTemperature)
+	{
+		// We have just switched to predictive control, so any value in the accumulator belongs to a different control mode
+		modelTemperature = temperature;
+		iAccumulator = 0.0;
+	}
+	else if (!previousReadingGood)
+	{
+		modelTemperature = temperature;							// start the model from the current temperature
+	}
+
+	const FopDt& model = GetModel();
+	const float difference = temperature - modelTemperature;
+	iAccumulator = constrain<float>(iAccumulator - difference * ModelCorrectionGain, -model.GetMaxPwm(), model.GetMaxPwm());
+	modelTemperature += difference * ModelTrackingGain;
+
+	const float pwm = (float)previousPwms[(previousPwmIndex + NumPreviousPwms - GetPredictionHorizon()) % NumPreviousPwms] * (1.0/255.0);
+	modelTemperature += (GetPredictiveHeatingRate() * (pwm - iAccumulator) - model.GetCoolingRateFanOff() * (modelTemperature - NormalAmbientTemperature))
+						* (HeatSampleIntervalMillis * MillisToSeconds);
+}
+
+// Calculate the PWM using model-predictive control
+float LocalHeater::CalcPredictivePwm(float targetTemperature) const noexcept
+{
+	const FopDt& model = GetModel();
+	constexpr float SampleInterval = HeatSampleIntervalMillis * MillisToSeconds;
+	const float heatingRate = GetPredictiveHeatingRate();
+	const float coolingRate = model.GetCoolingRateFanOff();
+
+	// Predict the temperature at the end of the dead time, using the PWM values that have not taken effect yet
+	const size_t horizon = GetPredictionHorizon();
+	float predictedTemperature = temperature;
+	size_t index = (previousPwmIndex + NumPreviousPwms - horizon) % NumPreviousPwms;
+	for (size_t i = 0; i < horizon; ++i)
+	{
+		const float pwm = (float)previousPwms[index] * (1.0/255.0);
+		predictedTemperature += (heatingRate * (pwm - iAccumulator) - coolingRate * (predictedTemperature - NormalAmbientTemperature)) * SampleInterval;
+		index = (index + 1) % NumPreviousPwms;
+	}
+
+	// Choose the PWM that will move the predicted temperature towards the target at the required rate
+	const float requiredRate = (targetTemperature - predictedTemperature)/max<float>(model.GetDeadTime(), SampleInterval);
+	const float pwm = iAccumulator + (requiredRate + coolingRate * (predictedTemperature - NormalAmbientTemperature))/heatingRate;
+	return constrain<float>(pwm, 0.0, model.GetMaxPwm());
+}
+
 GCodeResult LocalHeater::ResetFault(const StringRef& reply) noexcept
 {
 	badTemperatureCount = 0;
@@ -720,6 +830,164 @@ void LocalHeater::DoTuningStep() noexcept
 	SwitchOff();										// sets mode and lastPWM, also deletes tuningTempReadings
 }
 
+/* Notes on the fast auto tune algorithm
+ *
+ * Instead of cycling the heater around the target temperature many times, we fit the heater model to the step response.
+ * While the heater is on at the tuning PWM, the model says that dT/dt = heatingRate * pwm - coolingRate * (T - ambient), so we fit a straight line
+ * to the rate of rise against the temperature rise by least squares. Where that line crosses zero temperature rise gives us the heating rate.
+ * The dead time comes from the tangent at the point of fastest rise: it is where that tangent crosses the starting temperature.
+ * Then we turn the heater off and fit dT/dt = -coolingRate * (T - ambient) to the cooling curve, which gives the cooling rate.
+ * We repeat the cooling measurement at several fan speeds, reheating to the target temperature in between, and fit a straight line
+ * to the cooling rates to get the change in cooling rate with the fan on.
+ * This takes a few minutes instead of many, but the result is less accurate for heaters with large heat reservoirs.
+ */
+
+// This is called on each temperature sample when fast tuning, once the starting temperature has been established.
+// It must set lastPWM to the required PWM before returning, unless it is the same as last time. Returns false if tuning has finished or failed.
+bool LocalHeater::DoFastTuningStep(float derivative, bool gotDerivative) noexcept
+{
+	const uint32_t now = millis();
+	const bool isBedOrChamberHeater = reprap.GetHeat().IsBedOrChamberHeater(GetHeaterNumber());
+	const uint32_t timeoutMillis = ((isBedOrChamberHeater) ? 30 : 7) * 60 * (uint32_t)SecondsToMillis;
+	const float ambientTemp = tuningStartTemp.GetMean();
+
+	switch (mode)
+	{
+	case HeaterMode::tuning1:		// Heating up from ambient, fit the heating curve
+		tuningPhase = 1;
+		{
+			const uint32_t heatingTime = now - timeSetHeating;
+			const float extraTimeAllowed = (isBedOrChamberHeater) ? 120.0 : 30.0;
+			if (heatingTime > (uint32_t)((GetModel().GetDeadTime() + extraTimeAllowed) * SecondsToMillis) && (temperature - ambientTemp) < 3.0)
+			{
+				reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because temperature is not increasing\n");
+				return false;
+			}
+
+			if (heatingTime >= timeoutMillis)
+			{
+				reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because target temperature was not reached\n");
+				return false;
+			}
+
+#if HAS_VOLTAGE_MONITOR
+			tuningVoltage.Add(reprap.GetPlatform().GetCurrentPowerVoltage());
+#endif
+			if (gotDerivative)
+			{
+				if (derivative > maxHeatingSlope)
+				{
+					maxHeatingSlope = derivative;
+					maxSlopeTemp = temperature;
+					maxSlopeTime = now;
+				}
+				if (temperature - ambientTemp >= FastTuningMinRise)
+				{
+					tuningFit.Add(temperature - ambientTemp, derivative);
+				}
+			}
+
+			if (temperature >= tuningTargetTemp)
+			{
+				if (tuningFit.GetNumSamples() < 2 || maxHeatingSlope <= 0.0)
+				{
+					reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because the heating curve could not be measured\n");
+					return false;
+				}
+
+				// The derivative lags the temperature, but the tangent at the point of maximum slope crosses the starting temperature at the same time regardless
+				fanOffParams.heatingRate = fanOnParams.heatingRate = tuningFit.GetIntercept()/tuningPwm;
+				fanOffParams.deadTime = fanOnParams.deadTime
+					= max<float>((float)(maxSlopeTime - timeSetHeating) * MillisToSeconds - (maxSlopeTemp - ambientTemp)/maxHeatingSlope, HeatSampleIntervalMillis * MillisToSeconds);
+				fanOffParams.numCycles = 1;
+				fanOnParams.numCycles = 0;
+
+				// Turn the heater off and start measuring the cooling rate with the fans off
+				lastPwm = 0.0;
+				peakTemp = temperature;
+				peakTime = now;
+				tuningFit.Clear();
+				mode = HeaterMode::tuning2;
+				tuningPhase = TuningPhaseFanOff;
+				ReportTuningUpdate();
+			}
+		}
+		return true;
+
+	case HeaterMode::tuning2:		// Heater off, fit the cooling curve at the current fan speed
+		if (temperature > peakTemp)
+		{
+			peakTemp = temperature;					// still overshooting because of the dead time
+		}
+		else if (gotDerivative && temperature <= peakTemp - TuningPeakTempDrop)
+		{
+			tuningFit.Add(temperature - ambientTemp, derivative);
+		}
+
+		if (now - peakTime >= timeoutMillis)
+		{
+			reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because the temperature did not fall\n");
+			return false;
+		}
+
+		if (temperature <= tuningTargetTemp - FastTuningCoolingDropFactor * tuningHysteresis)
+		{
+			const float fanPwm = tuningFanPwm * (float)fanLevel/(float)(NumFastTuningFanLevels - 1);
+			fanLevelCoolingRates[fanLevel] = -tuningFit.GetSlopeThroughOrigin();
+			reprap.GetPlatform().MessageF(GenericMessage, "Cooling rate with fan at %d%% is %.4f/sec\n", (int)lrintf(fanPwm * 100.0), (double)fanLevelCoolingRates[fanLevel]);
+			++fanLevel;
+
+			if (tuningFans.IsEmpty() || fanLevel == NumFastTuningFanLevels)
+			{
+				reprap.GetFansManager().SetFansValue(tuningFans, 0.0);
+				fanOffParams.coolingRate = fanLevelCoolingRates[0];
+				if (fanLevel > 1)
+				{
+					// Fit a straight line to the cooling rate against fan PWM and use it to get the cooling rate at the tuning fan PWM
+					tuningFit.Clear();
+					for (unsigned int i = 0; i < fanLevel; ++i)
+					{
+						tuningFit.Add(tuningFanPwm * (float)i/(float)(NumFastTuningFanLevels - 1), fanLevelCoolingRates[i]);
+					}
+					fanOnParams.coolingRate = fanOffParams.coolingRate + tuningFit.GetSlope() * tuningFanPwm;
+					fanOnParams.numCycles = fanLevel - 1;
+				}
+				idleCyclesDone = 0;
+				SetAndReportModel(fanLevel > 1);
+				return false;
+			}
+
+			// Set the next fan speed and heat up to the target temperature again
+			reprap.GetFansManager().SetFansValue(tuningFans, tuningFanPwm * (float)fanLevel/(float)(NumFastTuningFanLevels - 1));
+			lastPwm = tuningPwm;
+			mode = HeaterMode::tuning3;
+			tuningPhase = TuningPhaseFanOn;
+		}
+		return true;
+
+	case HeaterMode::tuning3:		// Heater on, reheating to the target temperature before measuring cooling at the next fan speed
+		if (temperature >= tuningTargetTemp)
+		{
+			lastPwm = 0.0;
+			peakTemp = temperature;
+			peakTime = now;
+			tuningFit.Clear();
+			mode = HeaterMode::tuning2;
+			ReportTuningUpdate();
+		}
+		else if (now - peakTime >= 2 * timeoutMillis)
+		{
+			reprap.GetPlatform().Message(GenericMessage, "Auto tune cancelled because target temperature was not reached\n");
+			return false;
+		}
+		return true;
+
+	default:
+		// Should not happen, but if it does then quit
+		return false;
+	}
+}
+
 // Calculate the heater model from the accumulated heater parameters
 // Suspend the heater, or resume it
 void LocalHeater::Suspend(bool sus) noexcept
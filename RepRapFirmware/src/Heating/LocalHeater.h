@@ -22,6 +22,9 @@ class HeaterMonitor;
 class LocalHeater : public Heater
 {
 	static const size_t NumPreviousTemperatures = 4;		// How many samples we average the temperature derivative over
+	static const size_t NumPreviousPwms = 40;				// How many PWM samples we keep for model-predictive control, which limits the dead time it can compensate for
+	static constexpr float ModelTrackingGain = 0.1;			// How much of the difference between the measured and modelled temperatures we correct the model by on each sample
+	static constexpr float ModelCorrectionGain = 0.005;		// How much the PWM correction changes per degree of difference between the measured and modelled temperatures
 
 public:
 	LocalHeater(unsigned int heaterNum) noexcept;
@@ -59,14 +62,20 @@ private:
 	void SetHeater(float power) const noexcept;				// Power is a fraction in [0,1]
 	TemperatureError ReadTemperature() noexcept;			// Read and store the temperature of this heater
 	void DoTuningStep() noexcept;							// Called on each temperature sample when auto tuning
+	bool DoFastTuningStep(float derivative, bool gotDerivative) noexcept;	// Called on each temperature sample after the initial temperature has settled when fast tuning
 	float GetExpectedHeatingRate() const noexcept;			// Get the minimum heating rate we expect
+	void UpdatePredictiveModel(bool previousReadingGood) noexcept;		// Update the model used by model-predictive control
+	float CalcPredictivePwm(float targetTemperature) const noexcept;	// Calculate the PWM using model-predictive control
+	float GetPredictiveHeatingRate() const noexcept;
+	size_t GetPredictionHorizon() const noexcept;
 	void RaiseHeaterFault(const char *format, ...) noexcept;
 
 	PwmPort port;											// The port that drives the heater
 	float temperature;										// The current temperature
 	float previousTemperatures[NumPreviousTemperatures]; 	// The temperatures of the previous NumDerivativeSamples measurements, used for calculating the derivative
 	size_t previousTemperatureIndex;						// Which slot in previousTemperature we fill in next
-	float iAccumulator;										// The integral LocalHeater component
+	float iAccumulator;										// The integral LocalHeater component, or the PWM correction when using model-predictive control
+	float modelTemperature;									// The temperature predicted by the model, when using model-predictive control
 	float lastPwm;											// The last PWM value we output, before scaling by kS
 	float averagePWM;										// The running average of the PWM, after scaling.
 	uint32_t timeSetHeating;								// When we turned on the heater
@@ -74,6 +83,8 @@ private:
 
 	uint16_t heatingFaultCount;								// Count of questionable heating behaviours
 
+	uint8_t previousPwms[NumPreviousPwms];					// The PWM applied in recent samples, scaled to 0..255, used for model-predictive control
+	uint8_t previousPwmIndex;								// Which slot in previousPwms we fill in next
 	uint8_t previousTemperaturesGood;						// Bitmap indicating which previous temperature were good readings
 	HeaterMode mode;										// Current state of the heater
 	uint8_t badTemperatureCount;							// Count of sequential dud readings
@@ -289,6 +289,12 @@ float RemoteHeater::GetAccumulator() const noexcept
 // Auto tune this heater. The caller has already checked that no other heater is being tuned and has set up tuningTargetTemp, tuningPwm, tuningFans, tuningHysteresis and tuningFanPwm.
 GCodeResult RemoteHeater::StartAutoTune(const StringRef& reply, bool seenA, float ambientTemp) noexcept
 {
+	if (fastTuning)
+	{
+		reply.printf("heater %u is on an expansion board, so it does not support fast tuning", GetHeaterNumber());
+		return GCodeResult::error;
+	}
+
 	CanMessageBuffer * const buf = CanMessageBuffer::Allocate();
 	if (buf == nullptr)
 	{
@@ -16,7 +16,7 @@ public:
 	CurrentLoopTemperatureSensor(unsigned int sensorNum) noexcept;
 	GCodeResult Configure(GCodeBuffer& gb, const StringRef& reply, bool& changed) override THROWS(GCodeException);
 	const char *GetShortSensorType() const noexcept override { return TypeName; }
-	void Poll() noexcept override;
+	void TakeReading() noexcept override;
 
 	static constexpr const char *TypeName = "currentloop";
 
@@ -35,6 +35,7 @@ public:
 	const uint8_t GetNumAdditionalOutputs() const noexcept override { return 1; }
 	void Poll() noexcept override;
 	bool PollInTask() noexcept override;
+	uint32_t GetTaskPollInterval() const noexcept override { return SensorsTaskTotalDelay; }
 	const char *GetShortSensorType() const noexcept override;
 
 	void Interrupt() noexcept;
@@ -21,7 +21,7 @@ public:
 	GCodeResult Configure(const CanMessageGenericParser& parser, const StringRef& reply) noexcept override; // configure the sensor from M308 parameters
 #endif
 
-	void Poll() noexcept override;
+	void TakeReading() noexcept override;
 	const char *GetShortSensorType() const noexcept override { return TypeName; }
 
 	static constexpr const char *TypeName = "rtdmax31865";
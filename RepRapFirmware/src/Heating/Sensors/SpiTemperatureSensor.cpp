@@ -8,6 +8,13 @@
 #include "SpiTemperatureSensor.h"
 #include <Platform/Tasks.h>
 #include <Hardware/SharedSpi/SharedSpiDevice.h>
+#include <Platform/RepRap.h>
+#include <Heating/Heat.h>
+#include <GCodes/GCodeBuffer/GCodeBuffer.h>
+
+#if SUPPORT_REMOTE_COMMANDS
+# include <CanMessageGenericParser.h>
+#endif
 
 SpiTemperatureSensor::SpiTemperatureSensor(unsigned int sensorNum, const char *name, SpiMode spiMode, uint32_t clockFrequency) noexcept
 	: SensorWithPort(sensorNum, name), device(SharedSpiDevice::GetMainSharedSpiDevice(), clockFrequency, spiMode, NoPin, false)
@@ -17,12 +24,31 @@ SpiTemperatureSensor::SpiTemperatureSensor(unsigned int sensorNum, const char *n
 #endif
 	lastTemperature = 0.0;
 	lastResult = TemperatureError::notInitialised;
+	taskPollInterval = SensorsTaskTotalDelay;
+}
+
+// Set the read interval. The sensors task runs every SensorsTaskTotalDelay milliseconds, so shorter intervals can't be honoured
+// and we round longer ones to the nearest multiple of it. Otherwise the interval would alternate between two multiples of it.
+bool SpiTemperatureSensor::SetTaskPollInterval(uint32_t interval, const StringRef& reply) noexcept
+{
+	if (interval < SensorsTaskTotalDelay || interval > MaxTaskPollInterval)
+	{
+		reply.printf("Read interval must be between %u and %" PRIu32 "ms", (unsigned int)SensorsTaskTotalDelay, MaxTaskPollInterval);
+		return false;
+	}
+	taskPollInterval = ((interval + SensorsTaskTotalDelay/2)/SensorsTaskTotalDelay) * SensorsTaskTotalDelay;
+	return true;
 }
 
 bool SpiTemperatureSensor::ConfigurePort(GCodeBuffer& gb, const StringRef& reply, bool& seen)
 {
 	const bool ret = SensorWithPort::ConfigurePort(gb, reply, PinAccess::write1, seen);
 	device.SetCsPin(port.GetPin());
+	if (ret && gb.Seen('I'))
+	{
+		seen = true;
+		return SetTaskPollInterval(gb.GetUIValue(), reply);
+	}
 	return ret;
 }
 
@@ -32,6 +58,12 @@ bool SpiTemperatureSensor::ConfigurePort(const CanMessageGenericParser& parser,
 {
 	const bool ret = SensorWithPort::ConfigurePort(parser, reply, PinAccess::write1, seen);
 	device.SetCsPin(port.GetPin());
+	uint16_t interval;
+	if (ret && parser.GetUintParam('I', interval))
+	{
+		seen = true;
+		return SetTaskPollInterval(interval, reply);
+	}
 	return ret;
 }
 
@@ -40,6 +72,14 @@ bool SpiTemperatureSensor::ConfigurePort(const CanMessageGenericParser& parser,
 void SpiTemperatureSensor::InitSpi() noexcept
 {
 	lastReadingTime = millis();
+	reprap.GetHeat().EnsureSensorsTask();
+}
+
+// Read the sensor. Called by the sensors task. We don't ask the task to delay afterwards, so that all the SPI sensors get read together.
+bool SpiTemperatureSensor::PollInTask() noexcept
+{
+	TakeReading();
+	return false;
 }
 
 // Send and receive 1 to 8 bytes of data and return the result as a single 32-bit word
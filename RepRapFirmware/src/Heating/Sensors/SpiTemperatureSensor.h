@@ -11,8 +11,14 @@
 #include "SensorWithPort.h"
 #include <Hardware/SharedSpi/SharedSpiClient.h>
 
+// SPI sensors are read by the sensors task, so that the heater task does not wait for the shared SPI bus and the sensors on the bus are read one after another
 class SpiTemperatureSensor : public SensorWithPort
 {
+public:
+	void Poll() noexcept override { }													// the reading is taken by the sensors task
+	bool PollInTask() noexcept override;
+	uint32_t GetTaskPollInterval() const noexcept override { return taskPollInterval; }
+
 protected:
 	SpiTemperatureSensor(unsigned int sensorNum, const char *name, SpiMode spiMode, uint32_t clockFrequency) noexcept;
 
@@ -23,13 +29,21 @@ protected:
 #endif
 
 	void InitSpi() noexcept;
+	virtual void TakeReading() noexcept = 0;
 	TemperatureError DoSpiTransaction(const uint8_t dataOut[], size_t nbytes, uint32_t& rslt) const noexcept
 		pre(nbytes <= 8);
 
+	static constexpr uint32_t MaxTaskPollInterval = 10000;							// longest read interval in milliseconds that M308 accepts
+
 	SharedSpiClient device;
 	uint32_t lastReadingTime;
 	float lastTemperature;
 	TemperatureError lastResult;
+
+private:
+	bool SetTaskPollInterval(uint32_t interval, const StringRef& reply) noexcept;
+
+	uint32_t taskPollInterval;														// how often the sensors task reads this sensor in milliseconds, a multiple of SensorsTaskTotalDelay
 };
 
 #endif /* SRC_HEATING_SPITEMPERATURESENSOR_H_ */
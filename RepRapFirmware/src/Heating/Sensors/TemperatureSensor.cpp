@@ -7,6 +7,9 @@
 #include "LinearAnalogSensor.h"
 #include "RemoteSensor.h"
 #include "GCodes/GCodeBuffer/GCodeBuffer.h"
+#include <Platform/RepRap.h>
+#include <Platform/Platform.h>
+#include <Movement/StepTimer.h>
 
 #if SUPPORT_REMOTE_COMMANDS
 # include <CanMessageGenericParser.h>
@@ -55,7 +58,8 @@ DEFINE_GET_OBJECT_MODEL_TABLE(TemperatureSensor)
 // Constructor
 TemperatureSensor::TemperatureSensor(unsigned int sensorNum, const char *t) noexcept
 	: next(nullptr), sensorNumber(sensorNum), sensorType(t), sensorName(nullptr),
-	  lastTemperature(0.0), whenLastRead(0), lastResult(TemperatureError::notReady), lastRealError(TemperatureError::success) {}
+	  lastTemperature(0.0), whenLastRead(0), whenTaskPollDue(millis()), maxTaskPollTicks(0), maxTaskPollJitter(0),
+	  lastResult(TemperatureError::notReady), lastRealError(TemperatureError::success) {}
 
 // Virtual destructor
 TemperatureSensor::~TemperatureSensor() noexcept
@@ -75,6 +79,37 @@ TemperatureError TemperatureSensor::GetLatestTemperature(float& t, uint8_t outpu
 	return lastResult;
 }
 
+// Record that the sensors task has polled this sensor and schedule the next poll
+void TemperatureSensor::RecordTaskPoll(uint32_t now, uint32_t readTicks) noexcept
+{
+	if (readTicks > maxTaskPollTicks)
+	{
+		maxTaskPollTicks = readTicks;
+	}
+
+	const uint32_t jitter = ((int32_t)(now - whenTaskPollDue) >= 0) ? now - whenTaskPollDue : whenTaskPollDue - now;
+	if (jitter > maxTaskPollJitter)
+	{
+		maxTaskPollJitter = jitter;
+	}
+
+	// Keep to the schedule unless we are more than a whole interval late, in which case start again from now
+	const uint32_t interval = GetTaskPollInterval();
+	whenTaskPollDue += interval;
+	if ((int32_t)(now - whenTaskPollDue) >= 0)
+	{
+		whenTaskPollDue = now + interval;
+	}
+}
+
+// Report the sensors task statistics for this sensor and reset them
+void TemperatureSensor::ReportTaskPollStatistics(MessageType mt) noexcept
+{
+	reprap.GetPlatform().MessageF(mt, "Sensor %u: read interval %" PRIu32 "ms, max read time %" PRIu32 "us, max jitter %" PRIu32 "ms\n",
+									sensorNumber, GetTaskPollInterval(), (uint32_t)(((uint64_t)maxTaskPollTicks * 1000000u)/StepTimer::GetTickRate()), maxTaskPollJitter);
+	maxTaskPollTicks = maxTaskPollJitter = 0;
+}
+
 // Set the name - normally called only once, so we allow heap memory to be allocated
 void TemperatureSensor::SetSensorName(const char *newName) noexcept
 {
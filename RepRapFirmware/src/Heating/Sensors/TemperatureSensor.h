@@ -93,6 +93,14 @@ public:
 	virtual void Poll() noexcept = 0;
 	virtual bool PollInTask() noexcept { return false; };		// Classes implementing this method need to also call Heat::EnsureSensorsTask() after successful configuration
 
+	// Return the interval in milliseconds at which the sensors task should call PollInTask, or zero if this sensor is not polled by the sensors task
+	virtual uint32_t GetTaskPollInterval() const noexcept { return 0; }
+
+	// Functions used by the sensors task to schedule polling and to collect statistics
+	bool IsTaskPollDue(uint32_t now) const noexcept { return (int32_t)(now + TaskPollTolerance - whenTaskPollDue) >= 0; }
+	void RecordTaskPoll(uint32_t now, uint32_t readTicks) noexcept;
+	void ReportTaskPollStatistics(MessageType mt) noexcept;
+
 	static TemperatureError GetPT100Temperature(float& t, uint16_t ohmsx100) noexcept;		// shared function used by two derived classes and the ATE
 
 protected:
@@ -103,6 +111,7 @@ protected:
 
 private:
 	static constexpr uint32_t TemperatureReadingTimeout = 2000;			// any reading older than this number of milliseconds is considered unreliable
+	static constexpr uint32_t TaskPollTolerance = 10;					// how many milliseconds early the sensors task may poll a sensor
 
 	TemperatureSensor *next;
 	unsigned int sensorNumber;											// the number of this sensor
@@ -110,6 +119,9 @@ private:
 	const char *sensorName;
 	float lastTemperature;
 	uint32_t whenLastRead;
+	uint32_t whenTaskPollDue;											// when the sensors task should next poll this sensor
+	uint32_t maxTaskPollTicks;											// the longest time that PollInTask took, in step clocks
+	uint32_t maxTaskPollJitter;											// the largest difference between when PollInTask was due and when it was called, in milliseconds
 	TemperatureError lastResult, lastRealError;
 };
 
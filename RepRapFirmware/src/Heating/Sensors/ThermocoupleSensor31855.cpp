@@ -112,7 +112,7 @@ GCodeResult ThermocoupleSensor31855::FinishConfiguring(bool changed, const Strin
 	return GCodeResult::ok;
 }
 
-void ThermocoupleSensor31855::Poll() noexcept
+void ThermocoupleSensor31855::TakeReading() noexcept
 {
 	uint32_t rawVal;
 	TemperatureError sts = DoSpiTransaction(nullptr, 4, rawVal);
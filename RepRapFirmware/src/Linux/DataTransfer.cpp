@@ -978,7 +978,7 @@ void DataTransfer::StartNextTransfer() noexcept
 	ExchangeHeader();
 }
 
-bool DataTransfer::WriteObjectModel(OutputBuffer *data) noexcept
+bool DataTransfer::WriteObjectModel(OutputBuffer *data, bool binary) noexcept
 {
 	// Try to write the packet header. This packet type cannot deal with truncated messages
 	if (!CanWritePacket(data->Length()))
@@ -987,17 +987,18 @@ bool DataTransfer::WriteObjectModel(OutputBuffer *data) noexcept
 	}
 
 	// Write packet header
-	(void)WritePacketHeader(FirmwareRequest::ObjectModel, sizeof(StringHeader) + data->Length());
+	(void)WritePacketHeader((binary) ? FirmwareRequest::BinaryObjectModel : FirmwareRequest::ObjectModel, sizeof(StringHeader) + data->Length());
 
 	// Write header
 	StringHeader *header = WriteDataHeader<StringHeader>();
 	header->length = data->Length();
 	header->padding = 0;
 
-	// Write data
+	// Write data. The transfer buffer is sent in a single DMA transfer and checksummed as a whole, so we copy the output buffers into it.
 	while (data != nullptr)
 	{
 		WriteData(data->UnreadData(), data->BytesLeft());
+		OutputBuffer::RecordBytesCopied(data->BytesLeft());
 		data = OutputBuffer::Release(data);
 	}
 	return true;
@@ -1052,6 +1053,7 @@ bool DataTransfer::WriteCodeReply(MessageType type, OutputBuffer *&response) noe
 			}
 
 			WriteData(response->UnreadData(), bytesToCopy);
+			OutputBuffer::RecordBytesCopied(bytesToCopy);
 			bytesWritten += bytesToCopy;
 
 			response->Taken(bytesToCopy);
@@ -55,7 +55,7 @@ public:
 	GCodeChannel ReadDeleteLocalVariable(const StringRef& varName) noexcept;				// Read a variable deletion request
 
 	void ResendPacket(const PacketHeader *packet) noexcept;
-	bool WriteObjectModel(OutputBuffer *data) noexcept;
+	bool WriteObjectModel(OutputBuffer *data, bool binary = false) noexcept;
 	bool WriteCodeBufferUpdate(uint16_t bufferSpace) noexcept;
 	bool WriteCodeReply(MessageType type, OutputBuffer *&response) noexcept;
 	bool WriteMacroRequest(GCodeChannel channel, const char *filename, bool fromCode) noexcept;
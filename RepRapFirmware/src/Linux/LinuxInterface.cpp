@@ -14,6 +14,7 @@
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Heating/Heat.h>
 #include <Movement/Move.h>
+#include <Movement/StepTimer.h>
 #include <Platform/Platform.h>
 #include <PrintMonitor/PrintMonitor.h>
 #include <Tools/Filament.h>
@@ -55,6 +56,12 @@ LinuxInterface::LinuxInterface() noexcept : isConnected(false), numDisconnects(0
 	, fileCodesRead(0), fileCodesHandled(0), fileMacrosRunning(0), fileMacrosClosing(0)
 #endif
 {
+#if SUPPORT_BINARY_OBJECT_MODEL
+	for (size_t i = 0; i < 2; ++i)
+	{
+		numModelResponses[i] = modelResponseBytes[i] = modelResponseTicks[i] = 0;
+	}
+#endif
 }
 
 void LinuxInterface::Init() noexcept
@@ -214,8 +221,23 @@ void LinuxInterface::Init() noexcept
 
 					try
 					{
+#if SUPPORT_BINARY_OBJECT_MODEL
+						// DSF asks for the binary encoding by including 'b' in the flags. We fall back to JSON if the key is too complicated.
+						const bool binary = ObjectModel::CanReportAsBinary(key.c_str(), flags.c_str());
+						const uint32_t startTicks = StepTimer::GetTimerTicks();
+						OutputBuffer *outBuf = (binary) ? reprap.GetBinaryModelResponse(binaryModelWriter, key.c_str(), flags.c_str())
+											: reprap.GetModelResponse(key.c_str(), flags.c_str());
+						if (outBuf != nullptr)
+						{
+							modelResponseTicks[binary] += StepTimer::GetTimerTicks() - startTicks;
+							modelResponseBytes[binary] += outBuf->Length();
+							++numModelResponses[binary];
+						}
+						if (outBuf == nullptr || !transfer.WriteObjectModel(outBuf, binary))
+#else
 						OutputBuffer *outBuf = reprap.GetModelResponse(key.c_str(), flags.c_str());
 						if (outBuf == nullptr || !transfer.WriteObjectModel(outBuf))
+#endif
 						{
 							// Failed to write the whole object model, try again later
 							packetAcknowledged = false;
@@ -969,6 +991,17 @@ void LinuxInterface::Diagnostics(MessageType mtype) noexcept
 	transfer.Diagnostics(mtype);
 	reprap.GetPlatform().MessageF(mtype, "Disconnects: %" PRIu32 ", timeouts: %" PRIu32 ", IAP RAM available 0x%05" PRIx32 "\n", numDisconnects, numTimeouts, iapRamAvailable);
 	reprap.GetPlatform().MessageF(mtype, "Buffer RX/TX: %d/%d-%d\n", (int)rxPointer, (int)txPointer, (int)txEnd);
+#if SUPPORT_BINARY_OBJECT_MODEL
+	for (size_t binary = 0; binary < 2; ++binary)
+	{
+		const uint32_t num = numModelResponses[binary];
+		reprap.GetPlatform().MessageF(mtype, "%s model responses: %" PRIu32 ", average %" PRIu32 " bytes, %" PRIu32 "us\n",
+										(binary) ? "Binary" : "JSON", num,
+										(num == 0) ? 0 : modelResponseBytes[binary]/num,
+										(num == 0) ? 0 : (uint32_t)(((uint64_t)modelResponseTicks[binary] * 1000000u)/(StepTimer::GetTickRate() * num)));
+		numModelResponses[binary] = modelResponseBytes[binary] = modelResponseTicks[binary] = 0;
+	}
+#endif
 #ifdef TRACK_FILE_CODES
 	reprap.GetPlatform().MessageF(mtype, "File codes read/handled: %d/%d, file macros open/closing: %d %d\n", (int)fileCodesRead, (int)fileCodesHandled, (int)fileMacrosRunning, (int)fileMacrosClosing);
 #endif
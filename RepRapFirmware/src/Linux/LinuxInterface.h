@@ -19,6 +19,7 @@
 #include "GCodes/GCodeFileInfo.h"
 #include "LinuxMessageFormats.h"
 #include "DataTransfer.h"
+#include <ObjectModel/BinaryObjectModelWriter.h>
 
 class Platform;
 
@@ -88,6 +89,13 @@ private:
 	volatile size_t fileCodesRead, fileCodesHandled, fileMacrosRunning, fileMacrosClosing;
 #endif
 
+#if SUPPORT_BINARY_OBJECT_MODEL
+	BinaryObjectModelWriter binaryModelWriter;
+
+	// Statistics for comparing the JSON and binary object model encodings, indexed by whether the response was binary
+	uint32_t numModelResponses[2], modelResponseBytes[2], modelResponseTicks[2];
+#endif
+
 	void InvalidateBufferChannel(GCodeChannel channel) noexcept;            // Invalidate every buffered G-code of the corresponding channel from the buffer ring
 };
 
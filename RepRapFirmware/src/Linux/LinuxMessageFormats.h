@@ -180,7 +180,29 @@ enum class FirmwareRequest : uint16_t
 	WaitForMessageAcknowledgment = 13,	// Wait for a message to be acknowledged
 	MacroFileClosed = 14,				// Last macro file has been closed
 	MessageAcknowledged = 15,			// Pending message prompt has been acknowledged
-	VariableResult = 16					// Result of a variable get or set request
+	VariableResult = 16,				// Result of a variable get or set request
+	BinaryObjectModel = 17				// Response to an object model request that included the 'b' flag, encoded as described by BinaryObjectModelTag
+};
+
+// Tags used in the binary encoding of the object model. Each value starts with a tag, followed by its data in little-endian order without padding.
+// The top level value is an object holding the same fields as the JSON response: key, flags, result, and next and seq if applicable.
+enum class BinaryObjectModelTag : uint8_t
+{
+	nullValue = 0,
+	boolFalse = 1,
+	boolTrue = 2,
+	int32 = 3,							// followed by int32_t
+	uint32 = 4,							// followed by uint32_t
+	uint64 = 5,							// followed by uint64_t
+	float32 = 6,						// followed by uint8_t number of decimal digits to display, then float
+	string = 7,							// followed by uint16_t length, then the characters without a null terminator
+	objectStart = 8,					// followed by pairs of key and value, then objectEnd
+	objectEnd = 9,
+	arrayStart = 10,					// followed by the element values, then arrayEnd
+	arrayEnd = 11,
+	newKey = 12,						// followed by uint8_t length and the characters of the key. The key is given the next key number, starting at 0.
+	literalKey = 13,					// followed by uint8_t length and the characters of a key that does not get a key number
+	key = 14							// followed by uint8_t number of a key that was sent earlier in the same response
 };
 
 enum class PrintPausedReason : uint8_t
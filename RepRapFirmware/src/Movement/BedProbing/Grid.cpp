@@ -327,7 +327,11 @@ void GridDefinition::PrintError(float originalAxis0range, float originalAxis1ran
 // Adding more fields to the header row can be handled in GridDefinition::ReadParameters(), though.
 const char * const HeightMap::HeightMapComment = "RepRapFirmware height map file v2";
 
-HeightMap::HeightMap() noexcept : useMap(false) { }
+HeightMap::HeightMap() noexcept : useMap(false)
+#if HEIGHTMAP_CACHE_CELLS
+	, cellCoefficientsValid(false)
+#endif
+{ }
 
 void HeightMap::SetGrid(const GridDefinition& gd) noexcept
 {
@@ -338,6 +342,9 @@ void HeightMap::SetGrid(const GridDefinition& gd) noexcept
 
 void HeightMap::ClearGridHeights() noexcept
 {
+#if HEIGHTMAP_CACHE_CELLS
+	cellCoefficientsValid = false;
+#endif
 	gridHeightSet.ClearAll();
 #if HAS_MASS_STORAGE
 	fileName.Clear();
@@ -354,6 +361,9 @@ void HeightMap::SetGridHeight(size_t index, float height) noexcept
 {
 	if (index < MaxGridProbePoints)
 	{
+#if HEIGHTMAP_CACHE_CELLS
+		cellCoefficientsValid = false;
+#endif
 		gridHeights[index] = height;
 		gridHeightSet.SetBit(index);
 	}
@@ -585,6 +595,12 @@ unsigned int HeightMap::GetStatistics(Deviation& deviation, float& minError, flo
 // Try to turn mesh compensation on or off and report the state achieved
 bool HeightMap::UseHeightMap(bool b) noexcept
 {
+#if HEIGHTMAP_CACHE_CELLS
+	if (b && def.IsValid() && !cellCoefficientsValid)
+	{
+		CalculateCellCoefficients();
+	}
+#endif
 	useMap = b && def.IsValid();
 	return useMap;
 }
@@ -616,6 +632,17 @@ float HeightMap::GetInterpolatedHeightError(float axis0, float axis1) const noex
 	const float yFloor = floor(yf);
 	const int32_t yIndex = (int32_t)yFloor;
 
+#if HEIGHTMAP_CACHE_CELLS
+	if (cellCoefficientsValid)
+	{
+		// Fast path using the precomputed coefficients, which we can fetch in a single block
+		const CellCoefficients& cell = cellCoefficients[GetMapIndex(xIndex, yIndex)];
+		const float xFrac = xf - xFloor;
+		const float yFrac = yf - yFloor;
+		return cell.z00 + (xFrac * (cell.dz0 + yFrac * cell.dz01)) + (yFrac * cell.dz1);
+	}
+#endif
+
 	return InterpolateAxis0Axis1(xIndex, yIndex, xf - xFloor, yf - yFloor);
 }
 
@@ -633,6 +660,32 @@ float HeightMap::InterpolateAxis0Axis1(uint32_t axis0Index, uint32_t axis1Index,
 			+ (gridHeights[indexX1Y1] * xyFrac);
 }
 
+#if HEIGHTMAP_CACHE_CELLS
+
+// Calculate the bilinear interpolation coefficients of every grid cell from the grid heights
+void HeightMap::CalculateCellCoefficients() noexcept
+{
+	for (uint32_t iAxis1 = 0; iAxis1 + 1 < def.nums[1]; ++iAxis1)
+	{
+		for (uint32_t iAxis0 = 0; iAxis0 + 1 < def.nums[0]; ++iAxis0)
+		{
+			const uint32_t index = GetMapIndex(iAxis0, iAxis1);
+			const float z00 = gridHeights[index];
+			const float z10 = gridHeights[index + 1];
+			const float z01 = gridHeights[index + def.nums[0]];
+			const float z11 = gridHeights[index + def.nums[0] + 1];
+			CellCoefficients& cell = cellCoefficients[index];
+			cell.z00 = z00;
+			cell.dz0 = z10 - z00;
+			cell.dz1 = z01 - z00;
+			cell.dz01 = z11 - z10 - z01 + z00;
+		}
+	}
+	cellCoefficientsValid = true;
+}
+
+#endif
+
 void HeightMap::ExtrapolateMissing() noexcept
 {
 	//1: calculating the bed plane by least squares fit
@@ -708,6 +761,9 @@ void HeightMap::ExtrapolateMissing() noexcept
 	const float d = centAxis0*a + centAxis1*b + centZ*c;
 
 	// Fill in the blanks
+#if HEIGHTMAP_CACHE_CELLS
+	cellCoefficientsValid = false;
+#endif
 	for (uint32_t iAxis1 = 0; iAxis1 < def.nums[1]; iAxis1++)
 	{
 		for (uint32_t iAxis0 = 0; iAxis0 < def.nums[0]; iAxis0++)
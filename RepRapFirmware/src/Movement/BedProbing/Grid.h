@@ -67,6 +67,9 @@ private:
 	bool isValid;
 };
 
+// Precomputing the bilinear interpolation coefficients of each grid cell costs 16 bytes of RAM per grid point, so we only do it on processors with plenty of RAM
+#define HEIGHTMAP_CACHE_CELLS	(SAME70 || SAME5x)
+
 // Class to represent the height map
 class HeightMap
 {
@@ -116,10 +119,23 @@ private:
 	String<MaxFilenameLength> fileName;								// The name of the file that this height map was loaded from or saved to
 #endif
 	bool useMap;													// True to do bed compensation
+#if HEIGHTMAP_CACHE_CELLS
+	bool cellCoefficientsValid;										// True if cellCoefficients is consistent with gridHeights
+
+	// Bilinear interpolation coefficients for a grid cell. The height error at fractional position (u, v) in the cell is z00 + u * dz0 + v * dz1 + u * v * dz01.
+	struct CellCoefficients
+	{
+		float z00, dz0, dz1, dz01;
+	};
+	CellCoefficients cellCoefficients[MaxGridProbePoints];			// The coefficients of each cell, indexed by the map index of its corner with the lowest coordinates
+#endif
 
 	uint32_t GetMapIndex(uint32_t axis0Index, uint32_t axis1Index) const noexcept { return (axis1Index * def.NumAxisPoints(0)) + axis0Index; }
 
 	float InterpolateAxis0Axis1(uint32_t axis0Index, uint32_t axis1Index, float axis0Frac, float axis1Frac) const noexcept;
+#if HEIGHTMAP_CACHE_CELLS
+	void CalculateCellCoefficients() noexcept;
+#endif
 };
 
 #endif /* SRC_MOVEMENT_GRID_H_ */
@@ -10,6 +10,7 @@
 #include <Platform/Platform.h>
 #include "Move.h"
 #include "StepTimer.h"
+#include "MoveSegment.h"
 #include <Endstops/EndstopsManager.h>
 #include "Kinematics/LinearDeltaKinematics.h"
 #include <Tools/Tool.h>
@@ -118,6 +119,7 @@ void DDA::LogProbePosition() noexcept
 DDA::DDA(DDA* n) noexcept : next(n), prev(nullptr), state(empty)
 {
 	activeDMs = completedDMs = nullptr;
+	segments = nullptr;
 	tool = nullptr;						// needed in case we pause before any moves have been done
 
 	// Set the endpoints to zero, because Move will ask for them.
@@ -226,6 +228,13 @@ void DDA::DebugPrint(const char *tag) const noexcept
 
 	debugPrintf(" s=%f", (double)totalDistance);
 	DebugPrintVector(" vec", directionVector, 5);
+#if DM_USE_ARCS
+	if (flags.isArcMove)
+	{
+		debugPrintf(" arc axes=%u,%u c=[%f %f] r=%f a0=%f da=%f",
+					arcAxes[0], arcAxes[1], (double)arcCentre[0], (double)arcCentre[1], (double)arcRadius, (double)arcStartAngle, (double)arcAngle);
+	}
+#endif
 	debugPrintf("\n"
 				"a=%f d=%f reqv=%f startv=%f topv=%f endv=%f\n"
 				"cks=%" PRIu32 " sstcda=%" PRIu32 " tstcddpdsc=%" PRIu32 " exac=%" PRIi32 "\n",
@@ -245,6 +254,10 @@ void DDA::DebugPrintAll(const char *tag) const noexcept
 	{
 		dm->DebugPrint();
 	}
+	for (const MoveSegment *seg = segments; seg != nullptr; seg = seg->GetNext())
+	{
+		seg->DebugPrint();
+	}
 }
 
 // Set up a real move. Return true if it represents real movement, else false.
@@ -275,6 +288,33 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 							&& (endPoint[X_AXIS] != positionNow[X_AXIS] || endPoint[Y_AXIS] != positionNow[Y_AXIS] || endPoint[Z_AXIS] != positionNow[Z_AXIS]);
 	}
 
+#if DM_USE_ARCS
+	// If this is an arc that we are to execute as a single move, find the radius and start angle from the start position.
+	// The direction vector along the arc axes is set to the direction of travel at the start of the move, scaled so that its length is the length of the arc.
+	float arcStartDirection[2];
+	float arcPlaneFraction = 0.0;
+	if (nextMove.isNativeArc && doMotorMapping)
+	{
+		arcAxes[0] = nextMove.arcAxes[0];
+		arcAxes[1] = nextMove.arcAxes[1];
+		arcCentre[0] = nextMove.arcCentreCoords[0];
+		arcCentre[1] = nextMove.arcCentreCoords[1];
+		arcAngle = nextMove.arcAngle;
+		const float startOffset0 = prev->GetEndCoordinate(arcAxes[0], false) - arcCentre[0];
+		const float startOffset1 = prev->GetEndCoordinate(arcAxes[1], false) - arcCentre[1];
+		arcRadius = fastSqrtf(fsquare(startOffset0) + fsquare(startOffset1));
+		arcStartAngle = atan2f(startOffset1, startOffset0);
+		flags.isArcMove = (arcRadius > 0.0 && arcAngle != 0.0);
+		const float arcLength = arcRadius * fabsf(arcAngle);
+		const float sign = (arcAngle < 0.0) ? -1.0 : 1.0;
+		arcStartDirection[0] = -sign * arcLength * sinf(arcStartAngle);
+		arcStartDirection[1] = sign * arcLength * cosf(arcStartAngle);
+		const float endAngle = arcStartAngle + arcAngle;
+		arcEndDirection[0] = -sign * sinf(endAngle);				// this is scaled later when we know the total distance
+		arcEndDirection[1] = sign * cosf(endAngle);
+	}
+#endif
+
 	bool linearAxesMoving = false;
 	bool rotationalAxesMoving = false;
 	bool extrudersMoving = false;
@@ -289,7 +329,20 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 
 		if (drive < numVisibleAxes)
 		{
-			const float positionDelta = endCoordinates[drive] - prev->GetEndCoordinate(drive, false);
+			float positionDelta = endCoordinates[drive] - prev->GetEndCoordinate(drive, false);
+#if DM_USE_ARCS
+			if (flags.isArcMove)
+			{
+				if (drive == arcAxes[0])
+				{
+					positionDelta = arcStartDirection[0];
+				}
+				else if (drive == arcAxes[1])
+				{
+					positionDelta = arcStartDirection[1];
+				}
+			}
+#endif
 			if (positionDelta != 0.0)
 			{
 				if (reprap.GetPlatform().IsAxisRotational(drive))
@@ -419,6 +472,15 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 		// First do the bed tilt compensation for deltas.
 		directionVector[Z_AXIS] += (directionVector[X_AXIS] * k.GetTiltCorrection(X_AXIS)) + (directionVector[Y_AXIS] * k.GetTiltCorrection(Y_AXIS));
 		totalDistance = NormaliseLinearMotion(reprap.GetPlatform().GetLinearAxes());
+#if DM_USE_ARCS
+		if (flags.isArcMove)
+		{
+			// Find the fraction of the total distance that is in the plane of the arc and scale the end direction to match the start direction
+			arcPlaneFraction = (arcRadius * fabsf(arcAngle))/totalDistance;
+			arcEndDirection[0] *= arcPlaneFraction;
+			arcEndDirection[1] *= arcPlaneFraction;
+		}
+#endif
 	}
 	else if (rotationalAxesMoving)
 	{
@@ -443,6 +505,13 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 	float normalisedDirectionVector[MaxAxesPlusExtruders];			// used to hold a unit-length vector in the direction of motion
 	memcpyf(normalisedDirectionVector, directionVector, ARRAY_SIZE(normalisedDirectionVector));
 	Absolute(normalisedDirectionVector, MaxAxesPlusExtruders);
+#if DM_USE_ARCS
+	if (flags.isArcMove)
+	{
+		// The direction of travel in the plane of the arc changes during the move, so allow for all of that motion being along either arc axis
+		normalisedDirectionVector[arcAxes[0]] = normalisedDirectionVector[arcAxes[1]] = arcPlaneFraction;
+	}
+#endif
 	acceleration = beforePrepare.maxAcceleration = VectorBoxIntersection(normalisedDirectionVector, accelerations);
 	if (flags.xyMoving)											// apply M204 acceleration limits to XY moves
 	{
@@ -484,15 +553,46 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 		k.LimitSpeedAndAcceleration(*this, normalisedDirectionVector, numVisibleAxes, flags.continuousRotationShortcut);	// give the kinematics the chance to further restrict the speed and acceleration
 	}
 
+#if DM_USE_ARCS
+	if (flags.isArcMove)
+	{
+		// Limit the speed so that the centripetal acceleration in the plane of the arc doesn't exceed the acceleration limit
+		const float maxArcSpeed = fastSqrtf(acceleration * arcRadius)/arcPlaneFraction;
+		if (requestedSpeed > maxArcSpeed)
+		{
+			requestedSpeed = maxArcSpeed;
+		}
+	}
+#endif
+
 	// 7. Calculate the provisional accelerate and decelerate distances and the top speed
 	endSpeed = 0.0;							// until the next move asks us to adjust it
+	beforePrepare.maxJunctionSpeed = 0.0;	// until the next move melds with this one
 
 	if (prev->state == provisional && (move.GetJerkPolicy() != 0 || (flags.isPrintingMove == prev->flags.isPrintingMove && flags.xyMoving == prev->flags.xyMoving)))
 	{
 		// Try to meld this move to the previous move to avoid stop/start
-		// Assuming that this move ends with zero speed, calculate the maximum possible starting speed: u^2 = v^2 - 2as
-		prev->beforePrepare.targetNextSpeed = min<float>(fastSqrtf(deceleration * totalDistance * 2.0), requestedSpeed);
-		DoLookahead(ring, prev);
+		const uint32_t lookaheadStartTime = StepTimer::GetTimerTicks();
+		unsigned int laDepth;
+		if (ring.UsingBulkLookahead())
+		{
+			// Work out the highest speed we can pass from the previous move to this one at, limited by the requested speeds and the jerk limits.
+			// We only need to do this once per move, which saves the bulk planner from calling MatchSpeeds each time it passes over the move.
+			prev->beforePrepare.targetNextSpeed = min<float>(prev->requestedSpeed, requestedSpeed);
+			prev->MatchSpeeds();
+			prev->beforePrepare.maxJunctionSpeed = prev->beforePrepare.targetNextSpeed;
+
+			// Assuming that this move ends with zero speed, calculate the maximum possible starting speed: u^2 = v^2 - 2as
+			prev->beforePrepare.targetNextSpeed = min<float>(fastSqrtf(deceleration * totalDistance * 2.0), prev->beforePrepare.maxJunctionSpeed);
+			laDepth = DoBulkLookahead(ring, prev);
+		}
+		else
+		{
+			// Assuming that this move ends with zero speed, calculate the maximum possible starting speed: u^2 = v^2 - 2as
+			prev->beforePrepare.targetNextSpeed = min<float>(fastSqrtf(deceleration * totalDistance * 2.0), requestedSpeed);
+			laDepth = DoLookahead(ring, prev);
+		}
+		ring.RecordLookahead(StepTimer::GetTimerTicks() - lookaheadStartTime, laDepth);
 		startSpeed = prev->endSpeed;
 	}
 	else
@@ -568,6 +668,7 @@ bool DDA::InitLeadscrewMove(DDARing& ring, float feedrate, const float adjustmen
 
 	// 7. Calculate the provisional accelerate and decelerate distances and the top speed
 	startSpeed = endSpeed = 0.0;
+	beforePrepare.maxJunctionSpeed = 0.0;
 
 	RecalculateMove(ring);
 	state = provisional;
@@ -624,6 +725,7 @@ bool DDA::InitAsyncMove(DDARing& ring, const AsyncMove& nextMove) noexcept
 
 	// Currently we normalise the vector sum of all motor movements to unit length.
 	totalDistance = Normalise(directionVector);
+	beforePrepare.maxJunctionSpeed = 0.0;
 
 	RecalculateMove(ring);
 	state = provisional;
@@ -669,6 +771,16 @@ bool DDA::InitFromRemote(const CanMessageMovementLinear& msg) noexcept
 	afterPrepare.extraAccelerationClocks = msg.accelerationClocks - roundS32(params.accelDistance/topSpeed);
 	params.accelCompFactor = (topSpeed - startSpeed)/topSpeed;
 
+#if DM_USE_FPU
+	// If the main board smoothed the acceleration, build the segments in the same way that it did so that we stay in step with its drivers.
+	// Main boards running older firmware leave these fields zero.
+	if (msg.smoothingClocksDiv32 != 0)
+	{
+		segments = reprap.GetMove().GetShaper().GetRemoteSegments(params.accelDistance, params.decelDistance, startSpeed, topSpeed, endSpeed, acceleration, deceleration,
+																	msg.smoothingClocksDiv32 * Move::SmoothingClockUnit, msg.smoothAccel, msg.smoothDecel, clocksNeeded);
+	}
+#endif
+
 	activeDMs = nullptr;
 
 	const size_t numDrivers = min<size_t>(msg.numDrivers, min<size_t>(NumDirectDrivers, MaxLinearDriversPerCanSlave));
@@ -691,14 +803,24 @@ bool DDA::InitFromRemote(const CanMessageMovementLinear& msg) noexcept
 			{
 				pdm->directionChanged = false;
 				InsertDM(pdm);
-				const uint32_t netSteps = (pdm->reverseStartStep < pdm->totalSteps) ? (2 * pdm->reverseStartStep) - pdm->totalSteps : pdm->totalSteps;
-				if (pdm->direction)
+#if DM_USE_FPU
+				if (pdm->isShaped)
 				{
-					endPoint[drive] += netSteps;
+					// PrepareShaped replaced totalSteps by an upper bound on the number of steps, so use the final position instead
+					endPoint[drive] += pdm->mp.shaped.finalPosition;
 				}
 				else
+#endif
 				{
-					endPoint[drive] -= netSteps;
+					const uint32_t netSteps = (pdm->reverseStartStep < pdm->totalSteps) ? (2 * pdm->reverseStartStep) - pdm->totalSteps : pdm->totalSteps;
+					if (pdm->direction)
+					{
+						endPoint[drive] += netSteps;
+					}
+					else
+					{
+						endPoint[drive] -= netSteps;
+					}
 				}
 
 				// Check for sensible values, print them if they look dubious
@@ -752,6 +874,17 @@ inline bool DDA::IsAccelerationMove() const noexcept
 			   );
 }
 
+// Return true if the lookahead is allowed to adjust the end speed of the previous move to suit this one
+inline bool DDA::CanMeldWithPrevious() const noexcept
+{
+	return reprap.GetMove().GetJerkPolicy() != 0
+		|| (   prev->flags.xyMoving == flags.xyMoving
+			&& (   prev->flags.isPrintingMove == flags.isPrintingMove
+				|| (prev->flags.isPrintingMove && prev->requestedSpeed == requestedSpeed)	// special case to support coast-to-end
+			   )
+		   );
+}
+
 #if 0
 #define LA_DEBUG	do { if (fabsf(fsquare(laDDA->endSpeed) - fsquare(laDDA->startSpeed)) > 2.02 * laDDA->acceleration * laDDA->totalDistance \
 								|| laDDA->topSpeed > laDDA->requestedSpeed) { \
@@ -765,11 +898,12 @@ inline bool DDA::IsAccelerationMove() const noexcept
 
 // Try to increase the ending speed of this move to allow the next move to start at targetNextSpeed.
 // Only called if this move and the next one are both printing moves.
-/*static*/ void DDA::DoLookahead(DDARing& ring, DDA *laDDA) noexcept
+// Return the number of moves before this one that we had to adjust.
+/*static*/ unsigned int DDA::DoLookahead(DDARing& ring, DDA *laDDA) noexcept
 pre(state == provisional)
 {
 //	if (reprap.Debug(moduleDda)) debugPrintf("Adjusting, %f\n", laDDA->targetNextSpeed);
-	unsigned int laDepth = 0;
+	unsigned int laDepth = 0, maxDepth = 0;
 	bool goingUp = true;
 
 	for(;;)					// this loop is used to nest lookahead without making recursive calls
@@ -855,6 +989,7 @@ pre(state == provisional)
 			// Still going up
 			laDDA = laDDA->prev;
 			++laDepth;
+			maxDepth = laDepth;
 #if 0
 			if (reprap.Debug(moduleDda))
 			{
@@ -895,7 +1030,7 @@ LA_DEBUG;
 					debugPrintf("Complete, %f\n", laDDA->targetNextSpeed);
 				}
 #endif
-				return;
+				return maxDepth;
 			}
 
 			laDDA = laDDA->next;
@@ -904,6 +1039,91 @@ LA_DEBUG;
 	}
 }
 
+// Try to increase the ending speed of this move to allow the next move to start at targetNextSpeed, using a single backward pass followed by a single forward pass.
+// The backward pass raises the maximum exit speed of each move in turn, stopping as soon as a move's start speed can't be increased.
+// So the cost depends on how many moves need to change, not on the length of the ring, and each move is recalculated only once.
+// This relies on beforePrepare.maxJunctionSpeed having been set up for every provisional move, so the lookahead mode must only be changed when the ring is empty.
+// Return the number of moves before this one that we had to adjust.
+/*static*/ unsigned int DDA::DoBulkLookahead(DDARing& ring, DDA *laDDA) noexcept
+pre(state == provisional)
+{
+	// Backward pass
+	DDA *firstDDA = laDDA;
+	unsigned int laDepth = 0;
+	for (;;)
+	{
+		DDA * const dda = firstDDA;
+		if (dda->beforePrepare.targetNextSpeed > dda->beforePrepare.maxJunctionSpeed)
+		{
+			dda->beforePrepare.targetNextSpeed = dda->beforePrepare.maxJunctionSpeed;
+		}
+		if (dda->beforePrepare.targetNextSpeed <= dda->endSpeed || dda->topSpeed >= dda->requestedSpeed)
+		{
+			break;						// the start speed of this move doesn't depend on its end speed, or the end speed isn't increasing
+		}
+
+		const float maxStartSpeed = min<float>(fastSqrtf(fsquare(dda->beforePrepare.targetNextSpeed) + (2 * dda->deceleration * dda->totalDistance)), dda->requestedSpeed);
+		if (maxStartSpeed <= dda->startSpeed)
+		{
+			break;						// this move can't start any faster
+		}
+
+		DDA * const prevDDA = dda->prev;
+		const DDAState st = prevDDA->state;
+		if (st != provisional || prevDDA->beforePrepare.decelDistance <= 0.0 || !dda->CanMeldWithPrevious())
+		{
+			if ((st == frozen || st == executing) && dda->IsDecelerationMove())
+			{
+				dda->flags.hadLookaheadUnderrun = true;
+			}
+			break;
+		}
+
+		prevDDA->beforePrepare.targetNextSpeed = maxStartSpeed;
+		firstDDA = prevDDA;
+		++laDepth;
+	}
+
+	// Forward pass
+	for (DDA *dda = firstDDA; ; dda = dda->next)
+	{
+		if (dda != firstDDA)
+		{
+			dda->startSpeed = dda->prev->endSpeed;
+		}
+		const float maxEndSpeed = fastSqrtf(fsquare(dda->startSpeed) + (2 * dda->acceleration * dda->totalDistance));
+		if (maxEndSpeed < dda->beforePrepare.targetNextSpeed)
+		{
+			dda->beforePrepare.targetNextSpeed = maxEndSpeed;
+		}
+
+		if (dda->beforePrepare.targetNextSpeed < dda->endSpeed)
+		{
+			// This situation should not normally happen except by a small amount because of rounding error.
+			// Don't reduce the end speed of the current move, because that may make the move infeasible.
+			if (dda->beforePrepare.targetNextSpeed < dda->endSpeed * 0.99)
+			{
+				ring.RecordLookaheadError();
+				if (reprap.Debug(moduleMove))
+				{
+					debugPrintf("DDA.cpp(%d) tn=%f ", __LINE__, (double)dda->beforePrepare.targetNextSpeed);
+					dda->DebugPrint("bla");
+				}
+			}
+		}
+		else
+		{
+			dda->endSpeed = dda->beforePrepare.targetNextSpeed;
+		}
+		dda->RecalculateMove(ring);
+
+		if (dda == laDDA)
+		{
+			return laDepth;
+		}
+	}
+}
+
 // Try to push babystepping earlier in the move queue, returning the amount we pushed
 //TODO this won't work for CoreXZ, rotary delta, Kappa, or SCARA with Z crosstalk
 float DDA::AdvanceBabyStepping(DDARing& ring, size_t axis, float amount) noexcept
@@ -925,7 +1145,7 @@ float DDA::AdvanceBabyStepping(DDARing& ring, size_t axis, float amount) noexcep
 	while(cdda != this)
 	{
 		float babySteppingToDo = 0.0;
-		if (amount != 0.0 && cdda->flags.xyMoving)
+		if (amount != 0.0 && cdda->flags.xyMoving && !cdda->flags.isArcMove)		// we can't add Z movement to an arc move because Z may be an arc axis
 		{
 			// Limit the babystepping Z speed to the lower of 0.1 times the original XYZ speed and 0.5 times the Z jerk
 			Platform& platform = reprap.GetPlatform();
@@ -1037,7 +1257,7 @@ void DDA::RecalculateMove(DDARing& ring) noexcept
 		const Platform& p = reprap.GetPlatform();
 		for (size_t drive = 0; drive < MaxAxesPlusExtruders; ++drive)
 		{
-			if (endSpeed * fabsf(directionVector[drive]) > p.GetInstantDv(drive))
+			if (endSpeed * fabsf(GetEndDirection(drive)) > p.GetInstantDv(drive))
 			{
 				flags.canPauseAfter = false;
 				break;
@@ -1055,15 +1275,53 @@ void DDA::RecalculateMove(DDARing& ring) noexcept
 // Decide what speed we would really like this move to end at.
 // On entry, targetNextSpeed is the speed we would like the next move after this one to start at and this one to end at
 // On return, targetNextSpeed is the actual speed we can achieve without exceeding the jerk limits.
+// If a junction deviation has been configured and both moves include XY movement, it limits the speed of the linear axes through the corner instead of their jerk limits.
 void DDA::MatchSpeeds() noexcept
 {
+	const Platform& platform = reprap.GetPlatform();
+	const float junctionDeviation = reprap.GetMove().GetJunctionDeviation();
+	const bool useJunctionDeviation = junctionDeviation > 0.0 && flags.xyMoving && next->flags.xyMoving;
+	const AxesBitmap linearAxes = platform.GetLinearAxes();
+	if (useJunctionDeviation)
+	{
+		// Treat the corner as an arc that deviates from the corner point by at most junctionDeviation, and limit the speed so that the centripetal acceleration doesn't exceed the acceleration limit.
+		float dotProduct = 0.0, thisMagnitudeSquared = 0.0, nextMagnitudeSquared = 0.0;
+		linearAxes.Iterate([this, &dotProduct, &thisMagnitudeSquared, &nextMagnitudeSquared](unsigned int axis, unsigned int count) noexcept
+							{
+								const float thisDirection = GetEndDirection(axis);
+								dotProduct += thisDirection * next->directionVector[axis];
+								thisMagnitudeSquared += fsquare(thisDirection);
+								nextMagnitudeSquared += fsquare(next->directionVector[axis]);
+							}
+						  );
+		const float magnitudeProduct = fastSqrtf(thisMagnitudeSquared * nextMagnitudeSquared);
+		if (magnitudeProduct > 0.0)
+		{
+			const float cosTheta = -dotProduct/magnitudeProduct;		// cosine of the angle between the two moves, -1 if they are in a straight line
+			if (cosTheta > -0.999999)									// if it's a straight line then there is no limit
+			{
+				const float sinThetaDiv2 = fastSqrtf(0.5 * (1.0 - min<float>(cosTheta, 1.0)));
+				const float maxJunctionSpeedSquared = (min<float>(acceleration, next->acceleration) * junctionDeviation * sinThetaDiv2)/(1.0 - sinThetaDiv2);
+				if (fsquare(beforePrepare.targetNextSpeed) > maxJunctionSpeedSquared)
+				{
+					beforePrepare.targetNextSpeed = fastSqrtf(maxJunctionSpeedSquared);
+				}
+			}
+		}
+	}
+
 	for (size_t drive = 0; drive < MaxAxesPlusExtruders; ++drive)
 	{
-		if (directionVector[drive] != 0.0 || next->directionVector[drive] != 0.0)
+		if (useJunctionDeviation && drive < MaxAxes && linearAxes.IsBitSet(drive))
+		{
+			continue;													// the junction deviation takes care of this axis
+		}
+		const float thisDirection = GetEndDirection(drive);
+		if (thisDirection != 0.0 || next->directionVector[drive] != 0.0)
 		{
-			const float totalFraction = fabsf(directionVector[drive] - next->directionVector[drive]);
+			const float totalFraction = fabsf(thisDirection - next->directionVector[drive]);
 			const float jerk = totalFraction * beforePrepare.targetNextSpeed;
-			const float allowedJerk = reprap.GetPlatform().GetInstantDv(drive);
+			const float allowedJerk = platform.GetInstantDv(drive);
 			if (jerk > allowedJerk)
 			{
 				beforePrepare.targetNextSpeed = allowedJerk/totalFraction;
@@ -1285,6 +1543,42 @@ void DDA::Prepare(uint8_t simMode, float extrusionPending[]) noexcept
 
 	if (simMode == 0)
 	{
+#if SUPPORT_CAN_EXPANSION
+		params.smoothingClocks = 0;
+		params.smoothAccel = params.smoothDecel = false;
+#endif
+		InputShaper& shaper = reprap.GetMove().GetShaper();
+		const uint32_t smoothingClocks = (flags.xyMoving) ? reprap.GetMove().GetSmoothingClocks() : 0;
+		if (flags.xyMoving && (shaper.UsesImpulses() || smoothingClocks != 0))
+		{
+			// Input shaping and acceleration smoothing are not yet supported for delta kinematics, leadscrew adjustment moves, native arc moves or moves that check endstops.
+			// Expansion boards support acceleration smoothing but not input shaping, so we don't shape moves that use remote drivers.
+			const bool applyShaping = shaper.UsesImpulses()
+#if SUPPORT_CAN_EXPANSION
+										&& !HasRemoteDrivers()
+#endif
+										;
+			if (!flags.isDeltaMovement && !flags.isLeadscrewAdjustmentMove && !flags.checkEndstops && !flags.isArcMove && (applyShaping || smoothingClocks != 0))
+			{
+				bool shapedAccel, shapedDecel;
+				segments = shaper.GetSegments(totalDistance, beforePrepare.accelDistance, beforePrepare.decelDistance,
+												startSpeed, topSpeed, endSpeed, acceleration, deceleration, applyShaping, smoothingClocks, clocksNeeded, shapedAccel, shapedDecel);
+#if SUPPORT_CAN_EXPANSION
+				if (segments != nullptr)
+				{
+					// Pass the smoothing decision to expansion boards so that they build the same segments
+					params.smoothingClocks = smoothingClocks;
+					params.smoothAccel = shapedAccel;
+					params.smoothDecel = shapedDecel;
+				}
+#endif
+			}
+			if (shaper.UsesImpulses() && (!applyShaping || flags.isDeltaMovement || flags.isLeadscrewAdjustmentMove || flags.checkEndstops || flags.isArcMove))
+			{
+				shaper.RecordUnshapedMove();
+			}
+		}
+
 		if (flags.isDeltaMovement)
 		{
 			// This code assumes that the previous move in the DDA ring is the previously-executed move, because it fetches the X and Y end coordinates from that move.
@@ -1435,6 +1729,35 @@ void DDA::Prepare(uint8_t simMode, float extrusionPending[]) noexcept
 #endif
 				axisMotorsEnabled.SetBit(drive);
 			}
+#if DM_USE_ARCS
+			else if (flags.isArcMove && (drive == arcAxes[0] || drive == arcAxes[1]))
+			{
+				// It's one of the axes of a native arc move. We always need a DM because the axis may move even if its start and end positions are the same.
+				// Move::CanUseNativeArc has already checked that all the drivers for this axis are local.
+				platform.EnableDrivers(drive);
+				DriveMovement* const pdm = DriveMovement::Allocate(drive, DMState::arc);
+				if (pdm->PrepareArcAxis(*this, params, drive == arcAxes[1]))
+				{
+					pdm->directionChanged = false;
+					// Check for sensible values, print them if they look dubious
+					if (reprap.Debug(moduleDda) && pdm->totalSteps > 1000000)
+					{
+						DebugPrintAll("pa");
+					}
+					InsertDM(pdm);
+				}
+				else
+				{
+					pdm->state = DMState::idle;
+					pdm->nextDM = completedDMs;
+					completedDMs = pdm;
+				}
+#if SUPPORT_CAN_EXPANSION
+				afterPrepare.drivesMoving.SetBit(drive);
+#endif
+				axisMotorsEnabled.SetBit(drive);
+			}
+#endif
 			else if (drive < reprap.GetGCodes().GetTotalAxes())
 			{
 				// It's a linear drive
@@ -1541,6 +1864,9 @@ void DDA::Prepare(uint8_t simMode, float extrusionPending[]) noexcept
 							pdm->directionChanged = false;
 							// Check for sensible values, print them if they look dubious
 							if (   reprap.Debug(moduleDda)
+#if DM_USE_FPU
+								&& !pdm->isShaped
+#endif
 								&& (   pdm->totalSteps > 1000000
 									|| pdm->reverseStartStep < pdm->mp.cart.decelStartStep
 									|| (   pdm->reverseStartStep <= pdm->totalSteps
@@ -1973,7 +2299,8 @@ uint32_t maxDelayIncrease;
 
 // Generate the step pulses of internal drivers used by this DDA
 // Sets the status to 'completed' if the move is complete and the next move should be started
-void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
+// Returns the number of DMs that we generated a step for, for the timing statistics
+unsigned int DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 {
 	// Check endstop switches and Z probe if asked. This is not speed critical because fast moves do not use endstops or the Z probe.
 	if (flags.checkEndstops)		// if any homing switches or the Z probe is enabled in this move
@@ -1981,10 +2308,11 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 		CheckEndstops(p);			// call out to a separate function because this may help cache usage in the more common and time-critical case where we don't call it
 		if (state == completed)		// we may have completed the move due to triggering an endstop switch or Z probe
 		{
-			return;
+			return 0;
 		}
 	}
 
+	unsigned int numSteppingDMs = 0;
 	uint32_t driversStepping = 0;
 	DriveMovement* dm = activeDMs;
 	const uint32_t elapsedTime = (now - afterPrepare.moveStartTime) + StepTimer::MinInterruptInterval;
@@ -2006,6 +2334,7 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 #if 0	// debug only
 		++stepsDone[dm->drive];
 #endif
+		++numSteppingDMs;
 		dm = dm->nextDM;
 	}
 
@@ -2083,6 +2412,7 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 			state = completed;
 		}
 	}
+	return numSteppingDMs;
 }
 
 // Stop a drive and re-calculate the corresponding endpoint.
@@ -2188,6 +2518,8 @@ bool DDA::HasStepError() const noexcept
 bool DDA::Free() noexcept
 {
 	ReleaseDMs();
+	MoveSegment::ReleaseAll(segments);
+	segments = nullptr;
 	state = empty;
 	return flags.hadLookaheadUnderrun;
 }
@@ -2263,6 +2595,35 @@ int32_t DDA::PrepareRemoteExtruder(size_t drive, float& extrusionPending, float
 	return originalSteps;
 }
 
+// Return true if any of the drivers that take part in this move are remote
+bool DDA::HasRemoteDrivers() const noexcept
+{
+	const Platform& platform = reprap.GetPlatform();
+	const size_t numTotalAxes = reprap.GetGCodes().GetTotalAxes();
+	for (size_t drive = 0; drive < numTotalAxes; ++drive)
+	{
+		if (endPoint[drive] != prev->endPoint[drive])
+		{
+			const AxisDriversConfig& config = platform.GetAxisDriversConfig(drive);
+			for (size_t i = 0; i < config.numDrivers; ++i)
+			{
+				if (config.driverNumbers[i].IsRemote())
+				{
+					return true;
+				}
+			}
+		}
+	}
+	for (size_t drive = MaxAxesPlusExtruders - reprap.GetGCodes().GetNumExtruders(); drive < MaxAxesPlusExtruders; ++drive)
+	{
+		if (directionVector[drive] != 0.0 && platform.GetExtruderDriver(LogicalDriveToExtruder(drive)).IsRemote())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 #endif
 
 #if SUPPORT_LASER
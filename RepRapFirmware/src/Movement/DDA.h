@@ -21,6 +21,7 @@
 #endif
 
 class DDARing;
+class MoveSegment;
 
 // This defines a single coordinated movement of one or several motors
 class DDA
@@ -52,7 +53,7 @@ public:
 #endif
 
 	void Start(Platform& p, uint32_t tim) noexcept SPEED_CRITICAL;					// Start executing the DDA, i.e. move the move.
-	void StepDrivers(Platform& p, uint32_t now) noexcept SPEED_CRITICAL;			// Take one step of the DDA, called by timer interrupt.
+	unsigned int StepDrivers(Platform& p, uint32_t now) noexcept SPEED_CRITICAL;	// Take one step of the DDA, called by timer interrupt. Return the number of DMs stepped.
 	bool ScheduleNextStepInterrupt(StepTimer& timer) const noexcept SPEED_CRITICAL;	// Schedule the next interrupt, returning true if we can't because it is already due
 
 	void SetNext(DDA *n) noexcept { next = n; }
@@ -191,16 +192,20 @@ private:
 	void InsertDM(DriveMovement *dm) noexcept SPEED_CRITICAL;
 	void DeactivateDM(size_t drive) noexcept;
 	void ReleaseDMs() noexcept;
+	bool CanMeldWithPrevious() const noexcept;								// return true if the lookahead is allowed to adjust the end speed of the previous move to match this one
 	bool IsDecelerationMove() const noexcept;								// return true if this move is or have been might have been intended to be a deceleration-only move
 	bool IsAccelerationMove() const noexcept;								// return true if this move is or have been might have been intended to be an acceleration-only move
 	void DebugPrintVector(const char *name, const float *vec, size_t len) const noexcept;
+	float GetEndDirection(size_t drive) const noexcept;						// return the component of the direction of travel at the end of the move for a drive
 	void AdjustAcceleration() noexcept;										// Adjust the acceleration and deceleration to reduce ringing
 
 #if SUPPORT_CAN_EXPANSION
 	int32_t PrepareRemoteExtruder(size_t drive, float& extrusionPending, float speedChange) const noexcept;
+	bool HasRemoteDrivers() const noexcept;									// return true if any drivers that move in this move are remote
 #endif
 
-	static void DoLookahead(DDARing& ring, DDA *laDDA) noexcept SPEED_CRITICAL;	// Try to smooth out moves in the queue
+	static unsigned int DoLookahead(DDARing& ring, DDA *laDDA) noexcept SPEED_CRITICAL;		// Try to smooth out moves in the queue, returning how many moves we went back
+	static unsigned int DoBulkLookahead(DDARing& ring, DDA *laDDA) noexcept SPEED_CRITICAL;	// Same but using a single backward pass and a single forward pass
     static float Normalise(float v[], AxesBitmap unitLengthAxes) noexcept;  // Normalise a vector to unit length over the specified axes
     static float Normalise(float v[]) noexcept; 							// Normalise a vector to unit length over all axes
 	float NormaliseLinearMotion(AxesBitmap linearAxes) noexcept;			// Make the direction vector unit-normal in XYZ
@@ -220,7 +225,7 @@ private:
 	{
 		struct
 		{
-			uint16_t endCoordinatesValid : 1,		// True if endCoordinates can be relied on
+			uint32_t endCoordinatesValid : 1,		// True if endCoordinates can be relied on
 					 isDeltaMovement : 1,			// True if this is a delta printer movement
 					 canPauseAfter : 1,				// True if we can pause at the end of this move
 					 isPrintingMove : 1,			// True if this move includes XY movement and extrusion
@@ -235,9 +240,10 @@ private:
 					 controlLaser : 1,				// True if this move controls the laser or iobits
 					 hadHiccup : 1,	 	 	 		// True if we had a hiccup while executing a move from a remote master
 					 isRemote : 1,					// True if this move was commanded from a remote
-					 wasAccelOnlyMove : 1;			// set by Prepare if this was an acceleration-only move, for the next move to look at
+					 wasAccelOnlyMove : 1,			// set by Prepare if this was an acceleration-only move, for the next move to look at
+					 isArcMove : 1;					// True if this is a G2 or G3 arc that is executed as a single move
 		};
-		uint16_t all;								// so that we can print all the flags at once for debugging
+		uint32_t all;								// so that we can print all the flags at once for debugging
 	} flags;
 
 #if SUPPORT_LASER || SUPPORT_IOBITS
@@ -266,6 +272,16 @@ private:
 	float initialUserC0, initialUserC1;				// if this is a segment of an arc move, the user X and Y coordinates at the start
 	uint32_t clocksNeeded;
 
+#if DM_USE_ARCS
+	// Parameters of a native arc move, only valid if flags.isArcMove is set
+	float arcCentre[2];								// the machine coordinates of the arc centre on the two arc axes
+	float arcRadius;								// the radius of the arc
+	float arcStartAngle;							// the angle of the start point from the centre, measured anticlockwise from the direction of the first arc axis
+	float arcAngle;									// the angle that the arc turns through, positive if anticlockwise
+	float arcEndDirection[2];						// the components of the normalised direction vector along the two arc axes at the end of the move
+	uint8_t arcAxes[2];								// the two axes that the arc is in
+#endif
+
 	union
 	{
 		// Values that are needed only before Prepare is called
@@ -275,6 +291,7 @@ private:
 			float decelDistance;
 			float targetNextSpeed;					// The speed that the next move would like to start at, used to keep track of the lookahead without making recursive calls
 			float maxAcceleration;					// the maximum allowed acceleration for this move according to the limits set by M201
+			float maxJunctionSpeed;					// the highest speed at which we can go from this move to the next one, used by the bulk lookahead planner
 		} beforePrepare;
 
 		// Values that are not set or accessed before Prepare is called
@@ -306,6 +323,7 @@ private:
 
 	DriveMovement* activeDMs;					// list of associated DMs that need steps, in step time order
 	DriveMovement* completedDMs;				// list of associated DMs that don't need any more steps
+	MoveSegment* segments;						// list of constant-acceleration segments if input shaping has been applied to this move, else nullptr
 };
 
 // Find the DriveMovement record for a given drive even if it is completed, or return nullptr if there isn't one
@@ -416,6 +434,25 @@ inline __attribute__((always_inline)) void DDA::InsertHiccup(uint32_t whenNextIn
 
 #endif
 
+// Return the component of the direction of travel at the end of the move for a drive. This differs from the direction vector only for native arc moves.
+inline float DDA::GetEndDirection(size_t drive) const noexcept
+{
+#if DM_USE_ARCS
+	if (flags.isArcMove)
+	{
+		if (drive == arcAxes[0])
+		{
+			return arcEndDirection[0];
+		}
+		if (drive == arcAxes[1])
+		{
+			return arcEndDirection[1];
+		}
+	}
+#endif
+	return directionVector[drive];
+}
+
 #if HAS_SMART_DRIVERS
 
 // Get the current full step interval for this axis or extruder
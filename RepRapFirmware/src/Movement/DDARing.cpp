@@ -35,7 +35,7 @@ constexpr uint8_t DDARing::objectModelTableDescriptor[] = { 1, 2 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(DDARing)
 
-DDARing::DDARing() noexcept : gracePeriod(DefaultGracePeriod), scheduledMoves(0), completedMoves(0), numHiccups(0)
+DDARing::DDARing() noexcept : gracePeriod(DefaultGracePeriod), scheduledMoves(0), completedMoves(0), numHiccups(0), bulkLookahead(false)
 {
 }
 
@@ -59,6 +59,14 @@ void DDARing::Init1(unsigned int numDdas) noexcept
 	getPointer = checkPointer = addPointer;
 	currentDda = nullptr;
 
+	// Completed DDAs are not reused until RecycleDDAs has fetched their end positions, so the queue never needs to hold more than the number of DDAs
+	size_t numSlots = 2;
+	while (numSlots <= numDdas)
+	{
+		numSlots <<= 1;
+	}
+	completedMovesQueue.Init(numSlots);
+
 	timer.SetCallback(DDARing::TimerCallback, static_cast<void*>(this));
 }
 
@@ -67,6 +75,12 @@ void DDARing::Init2() noexcept
 {
 	stepErrors = 0;
 	numLookaheadUnderruns = numPrepareUnderruns = numNoMoveUnderruns = numLookaheadErrors = 0;
+	maxPrepareTime = totalPrepareTime = numMovesPrepared = 0;
+	maxLookaheadTime = totalLookaheadTime = numLookaheads = totalLookaheadDepth = maxLookaheadDepth = 0;
+	maxIsrTime = totalIsrTime = numStepInterrupts = numStepsGenerated = 0;
+#if DM_USE_STEP_BATCH
+	unbatchedStepRate = 0.0;
+#endif
 	waitingForRingToEmpty = false;
 
 	// Put the origin on the lookahead ring with default velocity in the previous position to the first one that will be used.
@@ -117,6 +131,18 @@ GCodeResult DDARing::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& re
 	gb.TryGetUIValue('P', numDdasWanted, seen);
 	gb.TryGetUIValue('S', numDMsWanted, seen);
 	gb.TryGetUIValue('R', gracePeriod, seen);
+	uint32_t lookaheadMode = (bulkLookahead) ? 1 : 0;
+	gb.TryGetLimitedUIValue('L', lookaheadMode, seen, 2);
+#if DM_USE_STEP_BATCH
+	if (gb.Seen('B'))
+	{
+		DriveMovement::SetStepBatching(gb.GetUIValue() != 0);
+		if (!seen)
+		{
+			return GCodeResult::ok;
+		}
+	}
+#endif
 	if (seen)
 	{
 		if (!reprap.GetGCodes().LockMovementAndWaitForStandstill(gb))
@@ -158,10 +184,16 @@ GCodeResult DDARing::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& re
 			// Allocate the extra DMs
 			DriveMovement::InitialAllocate(numDMsWanted);		// this will only create any extra ones wanted
 		}
+
+		// We only change the lookahead mode when the ring is empty, because the bulk planner relies on values that the standard one doesn't set up
+		bulkLookahead = (lookaheadMode != 0);
 	}
 	else
 	{
-		reply.printf("DDAs %u, DMs %u, GracePeriod %" PRIu32, numDdasInRing, DriveMovement::NumCreated(), gracePeriod);
+		reply.printf("DDAs %u, DMs %u, GracePeriod %" PRIu32 ", %s lookahead", numDdasInRing, DriveMovement::NumCreated(), gracePeriod, (bulkLookahead) ? "bulk" : "standard");
+#if DM_USE_STEP_BATCH
+		reply.catf(", step batching %s", (DriveMovement::IsStepBatchingEnabled()) ? "on" : "off");
+#endif
 	}
 	return GCodeResult::ok;
 }
@@ -189,6 +221,31 @@ void DDARing::RecycleDDAs() noexcept
 		}
 		checkPointer = checkPointer->GetNext();
 	}
+
+	// Fetch the end positions of the moves we just recycled before any of them can be reused.
+	// The ISR queues a move in the same interrupt that marks it completed, so every move we recycled is already in the queue.
+	TaskCriticalSectionLocker lock;
+	ProcessCompletedMoves();
+}
+
+// Update the live coordinates from the moves that the step ISR has completed since we last did this.
+// Must be called with task switching disabled, because several tasks may fetch or change the live coordinates.
+void DDARing::ProcessCompletedMoves() noexcept
+{
+	DDA *dda;
+	while (completedMovesQueue.Get(dda))
+	{
+		liveCoordinatesValid = dda->FetchEndPosition(liveEndPoints, liveCoordinates);
+		liveCoordinatesChanged = true;
+	}
+}
+
+// Get the current position of a motor, including the moves that the step ISR has completed but no task has processed yet
+int32_t DDARing::GetEndPoint(size_t drive) noexcept
+{
+	TaskCriticalSectionLocker lock;
+	ProcessCompletedMoves();
+	return liveEndPoints[drive];
 }
 
 bool DDARing::CanAddMove() const noexcept
@@ -362,11 +419,22 @@ void DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsig
 #endif
 		  )
 	{
+		const uint32_t startTime = StepTimer::GetTimerTicks();
 		firstUnpreparedMove->Prepare(simulationMode, extrusionPending);
+		const uint32_t timeTaken = StepTimer::GetTimerTicks() - startTime;
+		if (timeTaken > maxPrepareTime)
+		{
+			maxPrepareTime = timeTaken;
+		}
+		totalPrepareTime += timeTaken;
+		++numMovesPrepared;
 		moveTimeLeft += firstUnpreparedMove->GetTimeLeft();
 		++alreadyPrepared;
 		firstUnpreparedMove = firstUnpreparedMove->GetNext();
 	}
+#if SUPPORT_CAN_EXPANSION
+	CanMotion::FlushMoveBatches();
+#endif
 }
 
 // Return true if this DDA ring is idle
@@ -392,7 +460,8 @@ void DDARing::Interrupt(Platform& p) noexcept
 		for (;;)
 		{
 			// Generate a step for the current move
-			cdda->StepDrivers(p, now);						// check endstops if necessary and step the drivers
+			numStepsGenerated += cdda->StepDrivers(p, now);	// check endstops if necessary and step the drivers
+			++numStepInterrupts;
 			if (cdda->GetState() == DDA::completed)
 			{
 				OnMoveCompleted(cdda, p);
@@ -432,6 +501,7 @@ void DDARing::Interrupt(Platform& p) noexcept
 #if SUPPORT_CAN_EXPANSION
 						CanMotion::InsertHiccup(cumulativeHiccupTime);
 #endif
+						RecordIsrTime(StepTimer::GetTimerTicks() - isrStartTime);
 						return;
 					}
 					// We probably had an interrupt that delayed us further. Recalculate the hiccup length, also we increase the hiccup time on each iteration.
@@ -439,6 +509,7 @@ void DDARing::Interrupt(Platform& p) noexcept
 				}
 			}
 		}
+		RecordIsrTime(StepTimer::GetTimerTicks() - isrStartTime);
 	}
 }
 
@@ -471,6 +542,7 @@ void DDARing::OnMoveCompleted(DDA *cdda, Platform& p) noexcept
 	}
 	else
 	{
+		Move::WakeMoveTaskFromISR();				// we have run out of moves, so get the Move task to fetch the final position promptly
 		if (st == DDA::provisional)
 		{
 			++numPrepareUnderruns;					// there are more moves available, but they are not prepared yet. Signal an underrun.
@@ -494,9 +566,8 @@ void DDARing::OnMoveCompleted(DDA *cdda, Platform& p) noexcept
 void DDARing::CurrentMoveCompleted() noexcept
 {
 	DDA * const cdda = currentDda;					// capture volatile variable
-	// Save the current motor coordinates, and the machine Cartesian coordinates if known
-	liveCoordinatesValid = cdda->FetchEndPosition(const_cast<int32_t*>(liveEndPoints), const_cast<float *>(liveCoordinates));
-	liveCoordinatesChanged = true;
+	// Pass the move to the tasks so that they can fetch the end position. This can't fail because the queue has room for all the DDAs in the ring.
+	(void)completedMovesQueue.Put(cdda);
 	const size_t numExtruders = reprap.GetGCodes().GetNumExtruders();
 	for (size_t extruder = 0; extruder < numExtruders; ++extruder)
 	{
@@ -576,6 +647,8 @@ void DDARing::AdjustMotorPositions(const float adjustment[], size_t numMotors) n
 	const int32_t * const endCoordinates = lastQueuedMove->DriveCoordinates();
 	const float * const driveStepsPerUnit = reprap.GetPlatform().GetDriveStepsPerUnit();
 
+	TaskCriticalSectionLocker lock;
+	ProcessCompletedMoves();
 	for (size_t drive = 0; drive < numMotors; ++drive)
 	{
 		const int32_t ep = endCoordinates[drive] + lrintf(adjustment[drive] * driveStepsPerUnit[drive]);
@@ -588,44 +661,42 @@ void DDARing::AdjustMotorPositions(const float adjustment[], size_t numMotors) n
 }
 
 // Fetch the current live XYZ and extruder coordinates if they have changed since this was lass called
-// Interrupts are assumed enabled on entry
+// The step ISR doesn't touch the live coordinates, so we only need to stop other tasks changing them while we take a self-consistent copy
 bool DDARing::LiveCoordinates(float m[MaxAxesPlusExtruders]) noexcept
 {
-	if (!liveCoordinatesChanged)
+	if (!HaveLiveCoordinatesChanged())
 	{
 		return false;
 	}
 
-	// The live coordinates and live endpoints are modified by the ISR, so be careful to get a self-consistent set of them
-	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();		// do this before we disable interrupts
-	const size_t numTotalAxes = reprap.GetGCodes().GetTotalAxes();			// do this before we disable interrupts
-	IrqDisable();
-	if (liveCoordinatesValid)
-	{
-		// All coordinates are valid, so copy them across
-		memcpyf(m, const_cast<const float *>(liveCoordinates), MaxAxesPlusExtruders);
-		liveCoordinatesChanged = false;
-		IrqEnable();
-	}
-	else
+	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();		// do this before we disable task switching
+	const size_t numTotalAxes = reprap.GetGCodes().GetTotalAxes();			// do this before we disable task switching
+	int32_t tempEndPoints[MaxAxes];
 	{
+		TaskCriticalSectionLocker lock;
+		ProcessCompletedMoves();
+		if (liveCoordinatesValid)
+		{
+			// All coordinates are valid, so copy them across
+			memcpyf(m, const_cast<const float *>(liveCoordinates), MaxAxesPlusExtruders);
+			liveCoordinatesChanged = false;
+			return true;
+		}
+
 		// Only the extruder coordinates are valid, so we need to convert the motor endpoints to coordinates
 		memcpyf(m + numTotalAxes, const_cast<const float *>(liveCoordinates + numTotalAxes), MaxAxesPlusExtruders - numTotalAxes);
-		int32_t tempEndPoints[MaxAxes];
 		memcpyi32(tempEndPoints, const_cast<const int32_t*>(liveEndPoints), ARRAY_SIZE(tempEndPoints));
-		IrqEnable();
+	}
 
-		reprap.GetMove().MotorStepsToCartesian(tempEndPoints, numVisibleAxes, numTotalAxes, m);		// this is slow, so do it with interrupts enabled
+	reprap.GetMove().MotorStepsToCartesian(tempEndPoints, numVisibleAxes, numTotalAxes, m);		// this is slow, so do it with task switching enabled
 
-		// If the ISR has not updated the endpoints, store the live coordinates back so that we don't need to do it again
-		IrqDisable();
-		if (memcmp(tempEndPoints, const_cast<const int32_t*>(liveEndPoints), sizeof(tempEndPoints)) == 0)
-		{
-			memcpyf(const_cast<float *>(liveCoordinates), m, numVisibleAxes);
-			liveCoordinatesValid = true;
-			liveCoordinatesChanged = false;
-		}
-		IrqEnable();
+	// If no more moves have completed, store the live coordinates back so that we don't need to do it again
+	TaskCriticalSectionLocker lock;
+	if (completedMovesQueue.IsEmpty() && memcmp(tempEndPoints, const_cast<const int32_t*>(liveEndPoints), sizeof(tempEndPoints)) == 0)
+	{
+		memcpyf(const_cast<float *>(liveCoordinates), m, numVisibleAxes);
+		liveCoordinatesValid = true;
+		liveCoordinatesChanged = false;
 	}
 	return true;
 }
@@ -635,6 +706,8 @@ bool DDARing::LiveCoordinates(float m[MaxAxesPlusExtruders]) noexcept
 void DDARing::SetLiveCoordinates(const float coords[MaxAxesPlusExtruders]) noexcept
 {
 	const size_t numAxes = reprap.GetGCodes().GetVisibleAxes();
+	TaskCriticalSectionLocker lock;
+	ProcessCompletedMoves();
 	for (size_t drive = 0; drive < numAxes; drive++)
 	{
 		liveCoordinates[drive] = coords[drive];
@@ -646,12 +719,13 @@ void DDARing::SetLiveCoordinates(const float coords[MaxAxesPlusExtruders]) noexc
 
 void DDARing::ResetExtruderPositions() noexcept
 {
-	IrqDisable();
-	for (size_t eDrive = reprap.GetGCodes().GetTotalAxes(); eDrive < MaxAxesPlusExtruders; eDrive++)
+	const size_t numTotalAxes = reprap.GetGCodes().GetTotalAxes();
+	TaskCriticalSectionLocker lock;
+	ProcessCompletedMoves();										// apply any extrusion that has already been done before we reset it
+	for (size_t eDrive = numTotalAxes; eDrive < MaxAxesPlusExtruders; eDrive++)
 	{
 		liveCoordinates[eDrive] = 0.0;
 	}
-	IrqEnable();
 	liveCoordinatesChanged = true;
 }
 
@@ -872,14 +946,72 @@ bool DDARing::LowPowerOrStallPause(RestorePoint& rp) noexcept
 
 #endif
 
+// Record how long a lookahead pass took and how many earlier moves it adjusted
+void DDARing::RecordLookahead(uint32_t clocks, unsigned int depth) noexcept
+{
+	if (clocks > maxLookaheadTime)
+	{
+		maxLookaheadTime = clocks;
+	}
+	totalLookaheadTime += clocks;
+	++numLookaheads;
+	if (depth > maxLookaheadDepth)
+	{
+		maxLookaheadDepth = depth;
+	}
+	totalLookaheadDepth += depth;
+}
+
 void DDARing::Diagnostics(MessageType mtype, const char *prefix) noexcept
 {
 	const DDA * const cdda = currentDda;
-	reprap.GetPlatform().MessageF(mtype,
-									"=== %sDDARing ===\nScheduled moves %" PRIu32 ", completed moves %" PRIu32 ", hiccups %" PRIu32 ", stepErrors %u, LaErrors %u, Underruns [%u, %u, %u], CDDA state %d\n",
-									prefix, scheduledMoves, completedMoves, numHiccups, stepErrors, numLookaheadErrors, numLookaheadUnderruns, numPrepareUnderruns, numNoMoveUnderruns,
-									(cdda == nullptr) ? -1 : (int)cdda->GetState());
+	Platform& p = reprap.GetPlatform();
+	p.MessageF(mtype,
+				"=== %sDDARing ===\nScheduled moves %" PRIu32 ", completed moves %" PRIu32 ", hiccups %" PRIu32 ", stepErrors %u, LaErrors %u, Underruns [%u, %u, %u], CDDA state %d\n",
+				prefix, scheduledMoves, completedMoves, numHiccups, stepErrors, numLookaheadErrors, numLookaheadUnderruns, numPrepareUnderruns, numNoMoveUnderruns,
+				(cdda == nullptr) ? -1 : (int)cdda->GetState());
 	numHiccups = stepErrors = numLookaheadUnderruns = numPrepareUnderruns = numNoMoveUnderruns = numLookaheadErrors = 0;
+
+	// Report the timing statistics. Take a consistent copy of the ISR statistics first.
+	const uint32_t basepri = ChangeBasePriority(NvicPriorityStep);
+	const uint32_t lMaxIsrTime = maxIsrTime, lNumStepInterrupts = numStepInterrupts, lNumStepsGenerated = numStepsGenerated;
+	const uint64_t lTotalIsrTime = totalIsrTime;
+	maxIsrTime = totalIsrTime = numStepInterrupts = numStepsGenerated = 0;
+	RestoreBasePriority(basepri);
+
+	constexpr float StepClocksToMicros = 1000000.0/(float)StepTimer::StepClockRate;
+	p.MessageF(mtype,
+				"Prepare: %" PRIu32 " moves, max %.1fus, avg %.1fus; %s lookahead: %" PRIu32 " passes, max %.1fus, avg %.1fus, max depth %u, avg depth %.1f\n"
+				"Step ISR: %" PRIu32 " calls, %" PRIu32 " steps, max %.1fus, avg %.2fus/call, %.2fus/step",
+				numMovesPrepared, (double)(maxPrepareTime * StepClocksToMicros),
+				(double)((numMovesPrepared == 0) ? 0.0 : (float)totalPrepareTime * StepClocksToMicros/numMovesPrepared),
+				(bulkLookahead) ? "bulk" : "standard", numLookaheads, (double)(maxLookaheadTime * StepClocksToMicros),
+				(double)((numLookaheads == 0) ? 0.0 : (float)totalLookaheadTime * StepClocksToMicros/numLookaheads),
+				maxLookaheadDepth, (double)((numLookaheads == 0) ? 0.0 : (float)totalLookaheadDepth/numLookaheads),
+				lNumStepInterrupts, lNumStepsGenerated, (double)(lMaxIsrTime * StepClocksToMicros),
+				(double)((lNumStepInterrupts == 0) ? 0.0 : (float)lTotalIsrTime * StepClocksToMicros/lNumStepInterrupts),
+				(double)((lNumStepsGenerated == 0) ? 0.0 : (float)lTotalIsrTime * StepClocksToMicros/lNumStepsGenerated));
+	maxPrepareTime = totalPrepareTime = numMovesPrepared = 0;
+	maxLookaheadTime = totalLookaheadTime = numLookaheads = totalLookaheadDepth = maxLookaheadDepth = 0;
+
+	// Report the step rate that the ISR could sustain at the measured cost per step.
+	// Remember the figure measured with step batching disabled, so that we can report the gain when it is enabled.
+	if (lNumStepsGenerated != 0 && lTotalIsrTime != 0)
+	{
+		const float stepRate = ((float)lNumStepsGenerated * (float)StepTimer::StepClockRate)/(float)lTotalIsrTime;
+		p.MessageF(mtype, ", max %.0f steps/sec", (double)stepRate);
+#if DM_USE_STEP_BATCH
+		if (!DriveMovement::IsStepBatchingEnabled())
+		{
+			unbatchedStepRate = stepRate;
+		}
+		else if (unbatchedStepRate != 0.0)
+		{
+			p.MessageF(mtype, " (%+.1f%% from step batching)", (double)((stepRate - unbatchedStepRate) * 100.0/unbatchedStepRate));
+		}
+#endif
+	}
+	p.Message(mtype, "\n");
 }
 
 #if SUPPORT_LASER
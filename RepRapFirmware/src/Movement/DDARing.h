@@ -11,6 +11,7 @@
 #define SRC_MOVEMENT_DDARING_H_
 
 #include "DDA.h"
+#include <General/SpscQueue.h>
 
 class DDARing INHERIT_OBJECT_MODEL
 {
@@ -61,13 +62,13 @@ public:
 	float GetAcceleration() const noexcept;
 	float GetDeceleration() const noexcept;
 
-	int32_t GetEndPoint(size_t drive) const noexcept { return liveEndPoints[drive]; } 	// Get the current position of a motor
+	int32_t GetEndPoint(size_t drive) noexcept;											// Get the current position of a motor
 	void GetCurrentMachinePosition(float m[MaxAxes], bool disableMotorMapping) const noexcept; // Get the current position in untransformed coords
 	void SetPositions(const float move[MaxAxesPlusExtruders]) noexcept;					// Force the machine coordinates to be these
 	void AdjustMotorPositions(const float adjustment[], size_t numMotors) noexcept;		// Perform motor endpoint adjustment
 	bool LiveCoordinates(float m[MaxAxesPlusExtruders]) noexcept;						// Fetch the last point at the end of the last completed DDA if it has changed since we last called this
 	void SetLiveCoordinates(const float coords[MaxAxesPlusExtruders]) noexcept;			// Force the live coordinates (see above) to be these
-	bool HaveLiveCoordinatesChanged() const noexcept { return liveCoordinatesChanged; }
+	bool HaveLiveCoordinatesChanged() const noexcept { return liveCoordinatesChanged || !completedMovesQueue.IsEmpty(); }
 	void ResetExtruderPositions() noexcept;												// Resets the extrusion amounts of the live coordinates
 
 	bool PauseMoves(RestorePoint& rp) noexcept;											// Pause the print as soon as we can, returning true if we were able to skip any
@@ -80,6 +81,8 @@ public:
 #endif
 
 	void RecordLookaheadError() noexcept { ++numLookaheadErrors; }						// Record a lookahead error
+	void RecordLookahead(uint32_t clocks, unsigned int depth) noexcept;					// Record how long a lookahead pass took and how many moves it went back
+	bool UsingBulkLookahead() const noexcept { return bulkLookahead; }					// Return true if we plan moves using a single backward and forward pass
 	void Diagnostics(MessageType mtype, const char *prefix) noexcept;
 
 	bool SetWaitingToEmpty() noexcept;
@@ -96,6 +99,8 @@ protected:
 private:
 	bool StartNextMove(Platform& p, uint32_t startTime) noexcept SPEED_CRITICAL;		// Start the next move, returning true if laser or IObits need to be controlled
 	void PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsigned int alreadyPrepared, uint8_t simulationMode) noexcept;
+	void RecordIsrTime(uint32_t clocks) noexcept SPEED_CRITICAL;						// Record how long the step ISR took
+	void ProcessCompletedMoves() noexcept;												// Update the live coordinates from the moves that the ISR has completed
 
 	static void TimerCallback(CallbackParameter p) noexcept;
 
@@ -106,8 +111,10 @@ private:
 
 	StepTimer timer;															// Timer object to control getting step interrupts
 
+	// The live coordinates are only accessed by tasks, with task switching disabled. The step ISR passes completed moves to them through completedMovesQueue.
 	volatile float liveCoordinates[MaxAxesPlusExtruders];						// The endpoint that the machine moved to in the last completed move
 	volatile int32_t liveEndPoints[MaxAxesPlusExtruders];						// The XYZ endpoints of the last completed move in motor coordinates
+	SpscQueue<DDA*> completedMovesQueue;										// Moves completed by the step ISR whose end positions haven't been fetched yet
 
 	unsigned int numDdasInRing;
 	uint32_t gracePeriod;														// The minimum idle time in milliseconds, before we should start a move. Better to have a few moves in the queue so that we can do lookahead
@@ -122,6 +129,23 @@ private:
 	unsigned int numLookaheadErrors;											// How many times our lookahead algorithm failed
 	unsigned int stepErrors;													// count of step errors, for diagnostics
 
+	// Timing statistics for the movement pipeline, all in step clocks. These are reset when we report diagnostics.
+	uint32_t maxPrepareTime;													// The longest time that DDA::Prepare took
+	uint64_t totalPrepareTime;													// The total time spent in DDA::Prepare, 64 bits so that it can't wrap between reports
+	uint32_t numMovesPrepared;													// The number of moves prepared
+	uint32_t maxLookaheadTime;													// The longest time that a lookahead pass took
+	uint64_t totalLookaheadTime;												// The total time spent doing lookahead
+	uint32_t numLookaheads;														// The number of lookahead passes
+	uint32_t totalLookaheadDepth;												// The total number of earlier moves adjusted by lookahead passes
+	unsigned int maxLookaheadDepth;												// The largest number of earlier moves adjusted by one lookahead pass
+	volatile uint32_t maxIsrTime;												// The longest time we spent in one step interrupt
+	volatile uint64_t totalIsrTime;												// The total time spent in step interrupts
+	volatile uint32_t numStepInterrupts;										// The number of times DDA::StepDrivers was called
+	volatile uint32_t numStepsGenerated;										// The number of DM steps generated by those calls
+#if DM_USE_STEP_BATCH
+	float unbatchedStepRate;													// The step rate that the ISR could sustain when we last measured it with step batching disabled
+#endif
+
 	float simulationTime;														// Print time since we started simulating
 	float extrusionPending[MaxExtruders];										// Extrusion not done due to rounding to nearest step
 	volatile int32_t extrusionAccumulators[MaxExtruders]; 						// Accumulated extruder motor steps
@@ -131,6 +155,7 @@ private:
 	volatile bool liveCoordinatesValid;											// True if the XYZ live coordinates in liveCoordinates are reliable (the extruder ones always are)
 	volatile bool liveCoordinatesChanged;										// True if the live coordinates have changed since LiveCoordinates was last called
 	volatile bool waitingForRingToEmpty;										// True if Move has signalled that we are waiting for this ring to empty
+	bool bulkLookahead;															// True if we use the bulk lookahead planner
 };
 
 // Start the next move. Return true if laser or IO bits need to be active
@@ -165,6 +190,16 @@ inline uint32_t DDARing::GetStepInterval(size_t axis, uint32_t microstepShift) c
 }
 #endif
 
+// Record how long the step ISR took. Called from the step ISR only.
+inline void DDARing::RecordIsrTime(uint32_t clocks) noexcept
+{
+	if (clocks > maxIsrTime)
+	{
+		maxIsrTime = clocks;
+	}
+	totalIsrTime += clocks;
+}
+
 // Schedule the next step interrupt for this DDA ring
 // Base priority must be >= NvicPriorityStep when calling this
 inline bool DDARing::ScheduleNextStepInterrupt() noexcept
@@ -9,6 +9,7 @@
 #include "DDA.h"
 #include "Move.h"
 #include "StepTimer.h"
+#include "MoveSegment.h"
 #include <Platform/RepRap.h>
 #include <Math/Isqrt.h>
 #include "Kinematics/LinearDeltaKinematics.h"
@@ -17,6 +18,9 @@
 
 DriveMovement *DriveMovement::freeList = nullptr;
 unsigned int DriveMovement::numCreated = 0;
+#if DM_USE_STEP_BATCH
+bool DriveMovement::stepBatching = false;						// off by default, M595 B1 enables it
+#endif
 
 void DriveMovement::InitialAllocate(unsigned int num) noexcept
 {
@@ -56,6 +60,14 @@ DriveMovement::DriveMovement(DriveMovement *next) noexcept : nextDM(next)
 // Prepare this DM for a Cartesian axis move, returning true if there are steps to do
 bool DriveMovement::PrepareCartesianAxis(const DDA& dda, const PrepParams& params) noexcept
 {
+#if DM_USE_FPU
+	if (dda.segments != nullptr)
+	{
+		const int32_t netSteps = (direction) ? (int32_t)totalSteps : -(int32_t)totalSteps;
+		return PrepareShaped(dda, (float)netSteps/dda.totalDistance, netSteps, 0.0);
+	}
+#endif
+
 	const float stepsPerMm = (float)totalSteps/dda.totalDistance;
 #if DM_USE_FPU
 	fTwoCsquaredTimesMmPerStepDivA = (float)((double)(StepTimer::StepClockRateSquared * 2)/((double)stepsPerMm * (double)dda.acceleration));
@@ -111,6 +123,12 @@ bool DriveMovement::PrepareCartesianAxis(const DDA& dda, const PrepParams& param
 	stepInterval = 999999;							// initialise to a large value so that we will calculate the time for just one step
 	stepsTillRecalc = 0;							// so that we don't skip the calculation
 	isDelta = false;
+	isShaped = false;
+	isArc = false;
+	isBatched = false;
+#if DM_USE_STEP_BATCH
+	mp.cart.batchState = DMState::idle;			// no saved square root yet
+#endif
 	state = (mp.cart.accelStopStep > 1) ? DMState::accel0
 				: (mp.cart.decelStartStep > 1) ? DMState::steady
 				  : DMState::decel0;
@@ -232,6 +250,9 @@ bool DriveMovement::PrepareDeltaAxis(const DDA& dda, const PrepParams& params) n
 	stepsTillRecalc = 0;							// so that we don't skip the calculation
 	//TODO input shaping for delta motion
 	isDelta = true;
+	isShaped = false;
+	isArc = false;
+	isBatched = false;
 	return CalcNextStepTime(dda);
 }
 
@@ -298,6 +319,16 @@ bool DriveMovement::PrepareExtruder(const DDA& dda, const PrepParams& params, fl
 		mp.cart.accelStopStep = (uint32_t)(params.accelDistance * effectiveStepsPerMm) + 1;
 	}
 
+#if DM_USE_FPU
+	if (dda.segments != nullptr)
+	{
+		// The step generator for shaped moves follows the position in steps down to the nearest whole step, so it ends up at the floor of the required extrusion
+		const int32_t finalPosition = (int32_t)floorf(extrusionRequired * rawStepsPerMm);
+		extrusionPending = extrusionRequired - (float)finalPosition/rawStepsPerMm;
+		return PrepareShaped(dda, dv * rawStepsPerMm, finalPosition, compensationTime * (float)StepTimer::StepClockRate);
+	}
+#endif
+
 	int32_t netSteps = lrintf(extrusionRequired * rawStepsPerMm);
 	extrusionPending = extrusionRequired - (float)netSteps/rawStepsPerMm;
 
@@ -398,6 +429,12 @@ bool DriveMovement::PrepareExtruder(const DDA& dda, const PrepParams& params, fl
 					: (reverseStartStep > 1) ? DMState::decel0
 						: DMState::reversing;
 	isDelta = false;
+	isShaped = false;
+	isArc = false;
+	isBatched = false;
+#if DM_USE_STEP_BATCH
+	mp.cart.batchState = DMState::idle;			// no saved square root yet
+#endif
 	return CalcNextStepTime(dda);
 }
 
@@ -417,6 +454,15 @@ bool DriveMovement::PrepareRemoteExtruder(const DDA& dda, const PrepParams& para
 	const float compensationDistance = (dda.endSpeed - dda.startSpeed) * compensationTime;
 	int32_t netSteps = lrintf((1.0 + compensationDistance) * totalSteps);
 
+#if DM_USE_FPU
+	if (dda.segments != nullptr)
+	{
+		// The move uses acceleration smoothing. The move has been normalised to unit distance, so the steps per unit distance is the net step count.
+		const float stepsPerUnit = (direction) ? (float)totalSteps : -(float)totalSteps;
+		return PrepareShaped(dda, stepsPerUnit, lrintf(stepsPerUnit * (1.0 + compensationDistance)), compensationClocks);
+	}
+#endif
+
 	// Calculate the acceleration phase parameters
 	const float accelCompensationDistance = compensationTime * (dda.topSpeed - dda.startSpeed);
 	mp.cart.accelStopStep = (uint32_t)((params.accelDistance + accelCompensationDistance) * totalSteps) + 1;
@@ -510,9 +556,204 @@ bool DriveMovement::PrepareRemoteExtruder(const DDA& dda, const PrepParams& para
 					: (reverseStartStep > 1) ? DMState::decel0
 						: DMState::reversing;
 	isDelta = false;
+	isShaped = false;
+	isArc = false;
+	isBatched = false;
+#if DM_USE_STEP_BATCH
+	mp.cart.batchState = DMState::idle;			// no saved square root yet
+#endif
+	return CalcNextStepTime(dda);
+}
+
+#endif
+
+#if DM_USE_FPU
+
+// Prepare this DM for a move that has input shaping applied, returning true if there are steps to do.
+// stepsPerMm is the number of steps per unit distance along the move and is negative if the drive moves backwards.
+// finalPosition is the net number of steps that the drive must move by the end of the move.
+// pressureAdvanceClocks is the pressure advance time in step clocks, or zero if pressure advance doesn't apply.
+bool DriveMovement::PrepareShaped(const DDA& dda, float stepsPerMm, int32_t finalPosition, float pressureAdvanceClocks) noexcept
+{
+	mp.shaped.stepsPerMm = stepsPerMm;
+	mp.shaped.pressureAdvanceClocks = pressureAdvanceClocks;
+	mp.shaped.startOffset = stepsPerMm * pressureAdvanceClocks * dda.segments->GetStartSpeed();
+	mp.shaped.position = 0;
+	mp.shaped.finalPosition = finalPosition;
+	mp.shaped.batchEndStep = 0;
+
+	// Work out an upper bound on the number of steps. Pressure advance may make the drive reverse direction more than once.
+	float totalMovement = 2.0;
+	for (const MoveSegment *seg = dda.segments; seg != nullptr; seg = seg->GetNext())
+	{
+		SetShapedSegment(seg);
+		const float duration = seg->GetDuration();
+		const float fEnd = mp.shaped.f0 + (mp.shaped.fB + 0.5 * mp.shaped.fA * duration) * duration;
+		if (mp.shaped.fB * (mp.shaped.fB + mp.shaped.fA * duration) < 0.0)
+		{
+			// The drive reverses direction during this segment
+			const float fTurn = mp.shaped.f0 - (0.5 * fsquare(mp.shaped.fB))/mp.shaped.fA;
+			totalMovement += fabsf(fTurn - mp.shaped.f0) + fabsf(fEnd - fTurn) + 2.0;
+		}
+		else
+		{
+			totalMovement += fabsf(fEnd - mp.shaped.f0) + 1.0;
+		}
+	}
+	totalSteps = (uint32_t)totalMovement;
+
+	SetShapedSegment(dda.segments);
+	direction = (mp.shaped.fB != 0.0) ? mp.shaped.fB > 0.0
+				: (mp.shaped.fA != 0.0) ? mp.shaped.fA > 0.0
+					: finalPosition >= 0;
+	SetShapedLimit();
+
+	// Prepare for the first step
+	nextStep = 0;
+	nextStepTime = 0;
+	stepInterval = 999999;							// initialise to a large value so that we will calculate the time for just one step
+	stepsTillRecalc = 0;							// so that we don't skip the calculation
+	reverseStartStep = totalSteps + 1;				// not used, but keeps DebugPrint meaningful
+	state = DMState::shaped;
+	isDelta = false;
+	isShaped = true;
+	isArc = false;
+	isBatched = false;
 	return CalcNextStepTime(dda);
 }
 
+// Make the specified segment current and set up the coefficients of the position in steps during it
+inline void DriveMovement::SetShapedSegment(const MoveSegment *seg) noexcept
+{
+	mp.shaped.currentSegment = seg;
+	const float k = mp.shaped.pressureAdvanceClocks;
+	mp.shaped.f0 = mp.shaped.stepsPerMm * (seg->GetStartDistance() + k * seg->GetStartSpeed()) - mp.shaped.startOffset;
+	mp.shaped.fB = mp.shaped.stepsPerMm * (seg->GetStartSpeed() + k * seg->GetAcceleration());
+	mp.shaped.fA = mp.shaped.stepsPerMm * seg->GetAcceleration();
+}
+
+// Calculate the position at which the part of the current segment in which we keep moving in the current direction ends
+inline void DriveMovement::SetShapedLimit() noexcept
+{
+	float t = mp.shaped.currentSegment->GetDuration();
+	if ((direction) ? mp.shaped.fA < 0.0 : mp.shaped.fA > 0.0)
+	{
+		// We are slowing down in the current direction, so we may reach a turning point before the end of the segment
+		const float tTurn = -mp.shaped.fB/mp.shaped.fA;
+		if (tTurn < t)
+		{
+			t = max<float>(tTurn, 0.0);
+		}
+	}
+	mp.shaped.limit = mp.shaped.f0 + (mp.shaped.fB + 0.5 * mp.shaped.fA * t) * t;
+}
+
+#endif
+
+#if DM_USE_ARCS
+
+// Prepare this DM for moving one of the two axes of a native arc move, returning true if there are steps to do.
+// We work in units of distance along the path rather than steps, so the timing constants are set up using a steps/mm of 1.
+bool DriveMovement::PrepareArcAxis(const DDA& dda, const PrepParams& params, bool isSecondArcAxis) noexcept
+{
+	const float stepsPerMm = reprap.GetPlatform().DriveStepsPerUnit(drive);
+	const int32_t startPosition = dda.prev->endPoint[drive];
+	mp.arc.offset = dda.arcCentre[(isSecondArcAxis) ? 1 : 0] * stepsPerMm - (float)startPosition;
+	mp.arc.radius = dda.arcRadius * stepsPerMm;
+
+	// The position of the second axis is proportional to the sine of the arc angle, which is the cosine of that angle less pi/2.
+	// For a clockwise arc we negate the angles so that the angle increases during the move. This doesn't change the cosine.
+	float angle = (isSecondArcAxis) ? dda.arcStartAngle - Pi/2 : dda.arcStartAngle;
+	if (dda.arcAngle < 0.0)
+	{
+		angle = -angle;
+	}
+	angle -= TwoPi * floorf(angle/TwoPi);			// reduce the start angle to the range 0 to 2pi
+	mp.arc.startAngle = angle;
+	mp.arc.endAngle = angle + fabsf(dda.arcAngle);
+	mp.arc.distancePerRadian = dda.totalDistance/fabsf(dda.arcAngle);
+	mp.arc.finalPosition = dda.endPoint[drive] - startPosition;
+
+	// Walk through the pieces to find the total number of steps and the initial direction
+	const int32_t firstPiece = (int32_t)(mp.arc.startAngle * (1.0/Pi));
+	int32_t position = 0;
+	uint32_t steps = 0;
+	bool haveDirection = false;
+	SetArcPiece(firstPiece);
+	for (;;)
+	{
+		if (mp.arc.pieceEndPosition != position)
+		{
+			if (!haveDirection)
+			{
+				direction = (mp.arc.pieceEndPosition > position);
+				haveDirection = true;
+			}
+			steps += (uint32_t)labs(mp.arc.pieceEndPosition - position);
+			position = mp.arc.pieceEndPosition;
+		}
+		if ((float)(mp.arc.pieceNumber + 1) * Pi >= mp.arc.endAngle)
+		{
+			break;
+		}
+		SetArcPiece(mp.arc.pieceNumber + 1);
+	}
+
+	if (steps == 0)
+	{
+		return false;
+	}
+	totalSteps = steps;
+	SetArcPiece(firstPiece);
+	mp.arc.position = 0;
+	mp.arc.batchEndStep = 0;
+
+	// Acceleration phase parameters
+	mp.arc.accelStopDistance = params.accelDistance;
+	fTwoCsquaredTimesMmPerStepDivA = (float)((double)(2 * StepTimer::StepClockRateSquared)/(double)dda.acceleration);
+	fTwoCsquaredTimesMmPerStepDivD = (float)((double)(2 * StepTimer::StepClockRateSquared)/(double)dda.deceleration);
+
+	// Constant speed phase parameters
+	fMmPerStepTimesCdivtopSpeed = (float)StepTimer::StepClockRate/dda.topSpeed;
+
+	// Deceleration phase parameters
+	// First check whether there is any deceleration at all, otherwise we may get strange results because of rounding errors
+	if (params.decelDistance * stepsPerMm < 0.5)
+	{
+		mp.arc.decelStartDistance = std::numeric_limits<float>::max();
+		fTwoDistanceToStopTimesCsquaredDivD = 0.0;
+	}
+	else
+	{
+		mp.arc.decelStartDistance = params.decelStartDistance;
+		fTwoDistanceToStopTimesCsquaredDivD = fsquare(params.fTopSpeedTimesCdivD) + (params.decelStartDistance * (StepTimer::StepClockRateSquared * 2))/dda.deceleration;
+	}
+
+	// Prepare for the first step
+	nextStep = 0;
+	nextStepTime = 0;
+	stepInterval = 999999;							// initialise to a large value so that we will calculate the time for just one step
+	stepsTillRecalc = 0;							// so that we don't skip the calculation
+	reverseStartStep = totalSteps + 1;				// not used, but keeps DebugPrint meaningful
+	state = DMState::arc;
+	isDelta = false;
+	isShaped = false;
+	isArc = true;
+	isBatched = false;
+	return CalcNextStepTime(dda);
+}
+
+// Make the specified piece of the arc current. The axis position rises during odd-numbered pieces and falls during even-numbered ones.
+// The final piece ends at the final position. Other pieces end at the extreme position, rounded towards the arc centre so that we never overshoot it.
+inline void DriveMovement::SetArcPiece(int32_t pieceNumber) noexcept
+{
+	mp.arc.pieceNumber = pieceNumber;
+	mp.arc.pieceStartDistance = ((float)pieceNumber * Pi - mp.arc.startAngle) * mp.arc.distancePerRadian;
+	mp.arc.pieceEndPosition = ((float)(pieceNumber + 1) * Pi >= mp.arc.endAngle) ? mp.arc.finalPosition
+								: (pieceNumber & 1) ? (int32_t)floorf(mp.arc.offset + mp.arc.radius)
+									: (int32_t)ceilf(mp.arc.offset - mp.arc.radius);
+}
+
 #endif
 
 void DriveMovement::DebugPrint() const noexcept
@@ -530,6 +771,24 @@ void DriveMovement::DebugPrint() const noexcept
 					" 2dtstc2diva=%" PRIu64 "\n",
 					c, (state == DMState::stepError) ? " ERR:" : ":", (direction) ? 'F' : 'B', totalSteps, nextStep, reverseStartStep, stepInterval,
 					twoDistanceToStopTimesCsquaredDivD);
+#endif
+#if DM_USE_FPU
+		if (isShaped)
+		{
+			debugPrintf("shaped spm=%.3f pac=%.1f pos=%" PRIi32 " final=%" PRIi32 " f0=%.2f fB=%.4e fA=%.4e limit=%.2f\n",
+						(double)mp.shaped.stepsPerMm, (double)mp.shaped.pressureAdvanceClocks, mp.shaped.position, mp.shaped.finalPosition,
+						(double)mp.shaped.f0, (double)mp.shaped.fB, (double)mp.shaped.fA, (double)mp.shaped.limit);
+		}
+		else
+#endif
+#if DM_USE_ARCS
+		if (isArc)
+		{
+			debugPrintf("arc off=%.2f r=%.2f a0=%.4f a1=%.4f dpr=%.4f piece=%" PRIi32 " pos=%" PRIi32 " pend=%" PRIi32 " final=%" PRIi32 "\n",
+						(double)mp.arc.offset, (double)mp.arc.radius, (double)mp.arc.startAngle, (double)mp.arc.endAngle, (double)mp.arc.distancePerRadian,
+						mp.arc.pieceNumber, mp.arc.position, mp.arc.pieceEndPosition, mp.arc.finalPosition);
+		}
+		else
 #endif
 		if (isDelta)
 		{
@@ -579,6 +838,9 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	// Work out how many steps to calculate at a time.
 	uint32_t shiftFactor = 0;		// assume single stepping
 	uint32_t nextCalcStepTime;
+#if DM_USE_STEP_BATCH
+	bool batch = false;				// assume we are not calculating a batch of steps using forward differences
+#endif
 	switch (state)
 	{
 	case DMState::accel0:	// acceleration phase
@@ -591,6 +853,13 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 						: (reverseStartStep > mp.cart.accelStopStep) ? DMState::decel0
 							: DMState::reversing;
 			}
+#if DM_USE_STEP_BATCH
+			else if (stepBatching && stepInterval < DDA::MinCalcIntervalCartesian && stepsToLimit > 2)
+			{
+				shiftFactor = GetBatchShiftFactor(stepsToLimit);
+				batch = true;
+			}
+#endif
 			else if (stepInterval < DDA::MinCalcIntervalCartesian)
 			{
 				if (stepInterval < DDA::MinCalcIntervalCartesian/4 && stepsToLimit > 8)
@@ -611,7 +880,16 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 			const uint32_t nextCalcStep = nextStep + stepsTillRecalc;
 #if DM_USE_FPU
 			const float adjustedStartSpeedTimesCdivA = (float)(dda.afterPrepare.startSpeedTimesCdivA + mp.cart.compensationClocks);
-			nextCalcStepTime = (uint32_t)(fastSqrtf(fsquare(adjustedStartSpeedTimesCdivA) + (fTwoCsquaredTimesMmPerStepDivA * nextCalcStep)) - adjustedStartSpeedTimesCdivA);
+# if DM_USE_STEP_BATCH
+			if (batch)
+			{
+				nextCalcStepTime = CalcStepBatch(fsquare(adjustedStartSpeedTimesCdivA), fTwoCsquaredTimesMmPerStepDivA, -adjustedStartSpeedTimesCdivA, false, shiftFactor);
+			}
+			else
+# endif
+			{
+				nextCalcStepTime = (uint32_t)(fastSqrtf(fsquare(adjustedStartSpeedTimesCdivA) + (fTwoCsquaredTimesMmPerStepDivA * nextCalcStep)) - adjustedStartSpeedTimesCdivA);
+			}
 #else
 			const uint32_t adjustedStartSpeedTimesCdivA = dda.afterPrepare.startSpeedTimesCdivA + mp.cart.compensationClocks;
 			nextCalcStepTime = isqrt64(isquare64(adjustedStartSpeedTimesCdivA) + (twoCsquaredTimesMmPerStepDivA * nextCalcStep)) - adjustedStartSpeedTimesCdivA;
@@ -667,6 +945,13 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 			{
 				state = DMState::reversing;
 			}
+#if DM_USE_STEP_BATCH
+			else if (stepBatching && stepInterval < DDA::MinCalcIntervalCartesian && stepsToLimit > 2)
+			{
+				shiftFactor = GetBatchShiftFactor(stepsToLimit);
+				batch = true;
+			}
+#endif
 			else if (stepInterval < DDA::MinCalcIntervalCartesian)
 			{
 				if (stepInterval < DDA::MinCalcIntervalCartesian/4 && stepsToLimit > 8)
@@ -687,11 +972,20 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 			const uint32_t nextCalcStep = nextStep + stepsTillRecalc;
 			const uint32_t adjustedTopSpeedTimesCdivDPlusDecelStartClocks = dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - mp.cart.compensationClocks;
 #if DM_USE_FPU
-			const float temp = fTwoCsquaredTimesMmPerStepDivD * nextCalcStep;
-			// Allow for possible rounding error when the end speed is zero or very small
-			nextCalcStepTime = (temp < fTwoDistanceToStopTimesCsquaredDivD)
-							? adjustedTopSpeedTimesCdivDPlusDecelStartClocks - (uint32_t)(fastSqrtf(fTwoDistanceToStopTimesCsquaredDivD - temp))
-							: adjustedTopSpeedTimesCdivDPlusDecelStartClocks;
+# if DM_USE_STEP_BATCH
+			if (batch)
+			{
+				nextCalcStepTime = CalcStepBatch(fTwoDistanceToStopTimesCsquaredDivD, -fTwoCsquaredTimesMmPerStepDivD, (float)adjustedTopSpeedTimesCdivDPlusDecelStartClocks, true, shiftFactor);
+			}
+			else
+# endif
+			{
+				const float temp = fTwoCsquaredTimesMmPerStepDivD * nextCalcStep;
+				// Allow for possible rounding error when the end speed is zero or very small
+				nextCalcStepTime = (temp < fTwoDistanceToStopTimesCsquaredDivD)
+								? adjustedTopSpeedTimesCdivDPlusDecelStartClocks - (uint32_t)(fastSqrtf(fTwoDistanceToStopTimesCsquaredDivD - temp))
+								: adjustedTopSpeedTimesCdivDPlusDecelStartClocks;
+			}
 #else
 			const uint64_t temp = twoCsquaredTimesMmPerStepDivD * nextCalcStep;
 			// Allow for possible rounding error when the end speed is zero or very small
@@ -710,6 +1004,14 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	case DMState::reverse:	// reverse phase
 		{
 			const uint32_t stepsToLimit = totalSteps + 1 - nextStep;
+#if DM_USE_STEP_BATCH
+			if (stepBatching && stepInterval < DDA::MinCalcIntervalCartesian && stepsToLimit > 2)
+			{
+				shiftFactor = GetBatchShiftFactor(stepsToLimit);
+				batch = true;
+			}
+			else
+#endif
 			if (stepInterval < DDA::MinCalcIntervalCartesian)
 			{
 				if (stepInterval < DDA::MinCalcIntervalCartesian/4 && stepsToLimit > 8)
@@ -729,12 +1031,21 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 			stepsTillRecalc = (1u << shiftFactor) - 1u;					// store number of additional steps to generate
 			const uint32_t nextCalcStep = nextStep + stepsTillRecalc;
 			const uint32_t adjustedTopSpeedTimesCdivDPlusDecelStartClocks = dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - mp.cart.compensationClocks;
-			nextCalcStepTime = adjustedTopSpeedTimesCdivDPlusDecelStartClocks
+#if DM_USE_STEP_BATCH
+			if (batch)
+			{
+				nextCalcStepTime = CalcStepBatch(-mp.cart.fFourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD, fTwoCsquaredTimesMmPerStepDivD, (float)adjustedTopSpeedTimesCdivDPlusDecelStartClocks, false, shiftFactor);
+			}
+			else
+#endif
+			{
+				nextCalcStepTime = adjustedTopSpeedTimesCdivDPlusDecelStartClocks
 #if DM_USE_FPU
-								+ (uint32_t)(fastSqrtf((fTwoCsquaredTimesMmPerStepDivD * nextCalcStep) - mp.cart.fFourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD));
+									+ (uint32_t)(fastSqrtf((fTwoCsquaredTimesMmPerStepDivD * nextCalcStep) - mp.cart.fFourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD));
 #else
-								+ isqrt64((int64_t)(twoCsquaredTimesMmPerStepDivD * nextCalcStep) - mp.cart.fourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD);
+									+ isqrt64((int64_t)(twoCsquaredTimesMmPerStepDivD * nextCalcStep) - mp.cart.fourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD);
 #endif
+			}
 		}
 		break;
 
@@ -746,11 +1057,21 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	stepInterval = (nextCalcStepTime > nextStepTime)
 					? (nextCalcStepTime - nextStepTime) >> shiftFactor	// calculate the time per step, ready for next time
 					: 0;
+#if DM_USE_STEP_BATCH
+	isBatched = batch;
+	if (batch)
+	{
+		nextStepTime = mp.cart.batchStartTime + (uint32_t)mp.cart.fBatchTime;
+	}
+	else
+#endif
+	{
 #if EVEN_STEPS
-	nextStepTime = nextCalcStepTime - (stepsTillRecalc * stepInterval);
+		nextStepTime = nextCalcStepTime - (stepsTillRecalc * stepInterval);
 #else
-	nextStepTime = nextCalcStepTime;
+		nextStepTime = nextCalcStepTime;
 #endif
+	}
 
 	if (nextCalcStepTime > dda.clocksNeeded)
 	{
@@ -773,6 +1094,79 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	return true;
 }
 
+#if DM_USE_STEP_BATCH
+
+// Return the shift factor to use when calculating step times in batches.
+// Because the step times within a batch follow a quadratic instead of being evenly spaced, we can use larger batches than when doing double/quad/octal stepping.
+inline uint32_t DriveMovement::GetBatchShiftFactor(uint32_t stepsToLimit) const noexcept
+{
+	return (stepInterval < DDA::MinCalcIntervalCartesian/4 && stepsToLimit > 16) ? 4
+			: (stepInterval < DDA::MinCalcIntervalCartesian/2 && stepsToLimit > 8) ? 3
+				: (stepsToLimit > 4) ? 2
+					: 1;
+}
+
+// Set up a batch of (1 << shiftFactor) steps starting at nextStep, where the time of step n is tBase + sqrt(p + q * n), or tBase - sqrt(p + q * n) if negate is true.
+// We calculate the square root only for the last step of the batch, because we saved the one for the step before the batch when we set up the previous batch.
+// Within the batch we approximate the step time by a quadratic in the step number that matches the start and end times and the step rate at the start,
+// so that CalcNextStepTime only needs to add forward differences to generate the remaining steps.
+// Return the time of the last step in the batch.
+uint32_t DriveMovement::CalcStepBatch(float p, float q, float tBase, bool negate, uint32_t shiftFactor) noexcept
+{
+	const uint32_t numSteps = 1u << shiftFactor;
+	const uint32_t lastStep = nextStep + numSteps - 1;
+	const float s0 = (mp.cart.batchState == state && mp.cart.batchSqrtStep == nextStep - 1)
+						? mp.cart.fBatchSqrt
+						: fastSqrtf(max<float>(p + q * (float)(nextStep - 1), 0.0));
+	const float s1 = fastSqrtf(max<float>(p + q * (float)lastStep, 0.0));
+	mp.cart.fBatchSqrt = s1;
+	mp.cart.batchSqrtStep = lastStep;
+	mp.cart.batchState = state;
+
+	const float t0 = max<float>((negate) ? tBase - s0 : tBase + s0, 0.0);
+	const float t1 = max<float>((negate) ? tBase - s1 : tBase + s1, t0);
+
+	// Work out the step interval at the start of the batch. Limit it to twice the average interval so that the step interval never goes negative.
+	const float averageInterval = (t1 - t0)/(float)numSteps;
+	const float d0 = (s0 > 0.0) ? min<float>(fabsf(q)/(2 * s0), 2 * averageInterval) : 2 * averageInterval;
+	const float c = (averageInterval - d0)/(float)numSteps;
+
+	mp.cart.batchStartTime = (uint32_t)t0;
+	mp.cart.fBatchTime = (t0 - (float)mp.cart.batchStartTime) + d0 + c;
+	mp.cart.fBatchInterval = d0 + 3 * c;
+	mp.cart.fBatchIntervalDelta = 2 * c;
+	return (uint32_t)t1;
+}
+
+#endif
+
+#if DM_USE_FPU
+
+// Calculate the time since the start of the move at which the distance travelled along the path, multiplied by the scaling factor that was used to set up
+// fTwoCsquaredTimesMmPerStepDivA and the other timing constants, reaches ds. This is used by the delta and arc step generators.
+inline uint32_t DriveMovement::CalcStepTimeFromDistance(const DDA &dda, float ds, float accelStopDs, float decelStartDs) const noexcept
+{
+	if (ds < accelStopDs)
+	{
+		// Acceleration phase
+		return (uint32_t)(fastSqrtf(fsquare((float)dda.afterPrepare.startSpeedTimesCdivA) + (fTwoCsquaredTimesMmPerStepDivA * ds))) - dda.afterPrepare.startSpeedTimesCdivA;
+	}
+
+	if (ds < decelStartDs)
+	{
+		// Steady speed phase
+		return (uint32_t)(fMmPerStepTimesCdivtopSpeed * ds) + dda.afterPrepare.extraAccelerationClocks;
+	}
+
+	const float temp = fTwoCsquaredTimesMmPerStepDivD * ds;
+	// Because of possible rounding error when the end speed is zero or very small, we need to check that the square root will work OK
+	return (temp < fTwoDistanceToStopTimesCsquaredDivD)
+			? dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - lrintf(fastSqrtf(fTwoDistanceToStopTimesCsquaredDivD - temp))
+			: dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks;
+}
+
+#endif
+
 // Calculate the time since the start of the move when the next step for the specified DriveMovement is due
 // Return true if there are more steps to do
 bool DriveMovement::CalcNextStepTimeDeltaFull(const DDA &dda) noexcept
@@ -864,27 +1258,10 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 		return false;
 	}
 
-	uint32_t nextCalcStepTime;
 #if DM_USE_FPU
-	if (ds < mp.delta.fAccelStopDs)
-	{
-		// Acceleration phase
-		nextCalcStepTime = (uint32_t)(fastSqrtf(fsquare((float)dda.afterPrepare.startSpeedTimesCdivA) + (fTwoCsquaredTimesMmPerStepDivA * ds))) - dda.afterPrepare.startSpeedTimesCdivA;
-	}
-	else if (ds < mp.delta.fDecelStartDs)
-	{
-		// Steady speed phase
-		nextCalcStepTime = (uint32_t)(fMmPerStepTimesCdivtopSpeed * ds) + dda.afterPrepare.extraAccelerationClocks;
-	}
-	else
-	{
-		const float temp = fTwoCsquaredTimesMmPerStepDivD * ds;
-		// Because of possible rounding error when the end speed is zero or very small, we need to check that the square root will work OK
-		nextCalcStepTime = (temp < fTwoDistanceToStopTimesCsquaredDivD)
-						? dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - lrintf(fastSqrtf(fTwoDistanceToStopTimesCsquaredDivD - temp))
-						: dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks;
-	}
+	const uint32_t nextCalcStepTime = CalcStepTimeFromDistance(dda, ds, mp.delta.fAccelStopDs, mp.delta.fDecelStartDs);
 #else
+	uint32_t nextCalcStepTime;
 	if ((uint32_t)dsK < mp.delta.accelStopDsK)
 	{
 		// Acceleration phase
@@ -938,4 +1315,237 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	return true;
 }
 
+#if DM_USE_FPU
+
+// Calculate the time since the start of the move when the next step for the specified DriveMovement is due, for a move that has input shaping applied.
+// Return true if there are more steps to do.
+// The drive follows the position in steps given by the current segment. When moving forwards we step when the position reaches the next whole step,
+// and when moving backwards we step when it falls to the current whole step. Pressure advance may make the direction change during a segment.
+bool DriveMovement::CalcNextStepTimeShapedFull(const DDA &dda) noexcept
+pre(stepsTillRecalc == 0)
+{
+	for (;;)
+	{
+		// Work out how many steps to calculate at a time
+		uint32_t shiftFactor = 0;		// assume single stepping
+		if (stepInterval < DDA::MinCalcIntervalCartesian)
+		{
+			const float stepsToLimit = (direction) ? mp.shaped.limit - (float)mp.shaped.position : (float)mp.shaped.position - mp.shaped.limit;
+			if (stepInterval < DDA::MinCalcIntervalCartesian/4 && stepsToLimit > 8.0)
+			{
+				shiftFactor = 3;		// octal stepping
+			}
+			else if (stepInterval < DDA::MinCalcIntervalCartesian/2 && stepsToLimit > 4.0)
+			{
+				shiftFactor = 2;		// quad stepping
+			}
+			else if (stepsToLimit > 2.0)
+			{
+				shiftFactor = 1;		// double stepping
+			}
+		}
+
+		const int32_t stepsToDo = (int32_t)1 << shiftFactor;
+		const int32_t newPosition = (direction) ? mp.shaped.position + stepsToDo : mp.shaped.position - stepsToDo;
+		const float distanceToTarget = ((direction) ? (float)newPosition : (float)(newPosition + 1)) - mp.shaped.f0;
+		const float duration = mp.shaped.currentSegment->GetDuration();
+		const float disc = fsquare(mp.shaped.fB) + 2 * mp.shaped.fA * distanceToTarget;
+		if (disc >= 0.0)
+		{
+			// Solve f0 + fB * t + 0.5 * fA * t^2 = target for the root at which we are moving in the current direction.
+			// Use whichever form of the solution avoids subtracting nearly-equal quantities.
+			const float sq = fastSqrtf(disc);
+			const float denom = (direction) ? mp.shaped.fB + sq : sq - mp.shaped.fB;
+			float t = (denom > 0.0) ? (2 * ((direction) ? distanceToTarget : -distanceToTarget))/denom
+						: (mp.shaped.fA != 0.0) ? (((direction) ? sq : -sq) - mp.shaped.fB)/mp.shaped.fA
+							: duration + 1.0;						// not moving, so we can't reach the target in this segment
+			if (t <= duration)
+			{
+				if (t < 0.0)
+				{
+					t = 0.0;										// allow for rounding error
+				}
+				const uint32_t nextCalcStepTime = (uint32_t)(mp.shaped.currentSegment->GetStartTime() + t);
+				mp.shaped.position = newPosition;
+				stepsTillRecalc = (uint8_t)(stepsToDo - 1);			// store number of additional steps to generate
+				mp.shaped.batchEndStep = nextStep + stepsTillRecalc;
+
+				// When crossing between segments with high microstepping, due to rounding errors the next step may appear to be due before the last one
+				stepInterval = (nextCalcStepTime > nextStepTime)
+								? (nextCalcStepTime - nextStepTime) >> shiftFactor	// calculate the time per step, ready for next time
+								: 0;
+#if EVEN_STEPS
+				nextStepTime = nextCalcStepTime - (stepsTillRecalc * stepInterval);
+#else
+				nextStepTime = nextCalcStepTime;
+#endif
+				if (nextCalcStepTime > dda.clocksNeeded)
+				{
+					// The calculation makes this step late. Allow for rounding error in the last segment.
+					if (mp.shaped.currentSegment->GetNext() == nullptr)
+					{
+						nextStepTime = dda.clocksNeeded;
+					}
+					else
+					{
+						// We don't expect any step except those in the last segment to be late
+						state = DMState::stepError;
+						stepInterval = 10000000 + nextStepTime;		// so we can tell what happened in the debug print
+						return false;
+					}
+				}
+				return true;
+			}
+		}
+		else if ((direction) ? mp.shaped.fA < 0.0 : mp.shaped.fA > 0.0)
+		{
+			// We don't reach the target because we come to a halt first. If that happens during this segment, reverse direction and try again.
+			if (-mp.shaped.fB/mp.shaped.fA < duration)
+			{
+				direction = !direction;
+				directionChanged = true;
+				SetShapedLimit();
+				continue;
+			}
+		}
+
+		// There are no more steps in this direction during this segment, so move on to the next segment
+		const MoveSegment * const nextSegment = mp.shaped.currentSegment->GetNext();
+		if (nextSegment == nullptr)
+		{
+			const int32_t stepsShort = mp.shaped.finalPosition - mp.shaped.position;
+			if (stepsShort == 0)
+			{
+				state = DMState::idle;
+				return false;
+			}
+
+			// Rounding error has left us one step short of the final position, so do that step at the end of the move
+			if (stepsShort > 1 || stepsShort < -1)
+			{
+				state = DMState::stepError;
+				stepInterval = 20000000 + nextStepTime;				// so we can tell what happened in the debug print
+				return false;
+			}
+			if ((stepsShort > 0) != (bool)direction)
+			{
+				direction = !direction;
+				directionChanged = true;
+			}
+			mp.shaped.position = mp.shaped.finalPosition;
+			mp.shaped.batchEndStep = nextStep;
+			stepInterval = 0;
+			nextStepTime = dda.clocksNeeded;
+			return true;
+		}
+
+		SetShapedSegment(nextSegment);
+		const bool newDirection = (mp.shaped.fB != 0.0) ? mp.shaped.fB > 0.0
+									: (mp.shaped.fA != 0.0) ? mp.shaped.fA > 0.0
+										: (bool)direction;
+		if (newDirection != (bool)direction)
+		{
+			direction = newDirection;
+			directionChanged = true;
+		}
+		SetShapedLimit();
+	}
+}
+
+#endif
+
+#if DM_USE_ARCS
+
+// Calculate the time since the start of the move when the next step for the specified DriveMovement is due, for an axis of a native arc move.
+// Return true if there are more steps to do.
+// We find the angle at which the axis reaches the position of the step from its cosine, then convert that to distance along the path and then to time.
+bool DriveMovement::CalcNextStepTimeArcFull(const DDA &dda) noexcept
+pre(nextStep <= totalSteps; stepsTillRecalc == 0)
+{
+	// Move on to the next piece that has steps to do. There must be one, because we haven't done all the steps yet.
+	while (mp.arc.position == mp.arc.pieceEndPosition)
+	{
+		if ((float)(mp.arc.pieceNumber + 1) * Pi >= mp.arc.endAngle)
+		{
+			state = DMState::stepError;
+			nextStep += 1000000;									// so that we can tell what happened in the debug print
+			return false;
+		}
+		SetArcPiece(mp.arc.pieceNumber + 1);
+	}
+
+	const bool forwards = (mp.arc.pieceEndPosition > mp.arc.position);
+	if (forwards != (bool)direction)
+	{
+		direction = forwards;
+		directionChanged = true;
+	}
+
+	// Work out how many steps to calculate at a time. We mustn't go past the end of the current piece.
+	uint32_t shiftFactor = 0;		// assume single stepping
+	if (stepInterval < DDA::MinCalcIntervalDelta)
+	{
+		const uint32_t stepsToLimit = (uint32_t)labs(mp.arc.pieceEndPosition - mp.arc.position);
+		if (stepInterval < DDA::MinCalcIntervalDelta/8 && stepsToLimit > 16)
+		{
+			shiftFactor = 4;		// hexadecimal stepping
+		}
+		else if (stepInterval < DDA::MinCalcIntervalDelta/4 && stepsToLimit > 8)
+		{
+			shiftFactor = 3;		// octal stepping
+		}
+		else if (stepInterval < DDA::MinCalcIntervalDelta/2 && stepsToLimit > 4)
+		{
+			shiftFactor = 2;		// quad stepping
+		}
+		else if (stepsToLimit > 2)
+		{
+			shiftFactor = 1;		// double stepping
+		}
+	}
+
+	stepsTillRecalc = (1u << shiftFactor) - 1;					// store number of additional steps to generate
+	mp.arc.batchEndStep = nextStep + stepsTillRecalc;
+	const int32_t stepsToDo = (int32_t)1 << shiftFactor;
+	mp.arc.position += (forwards) ? stepsToDo : -stepsToDo;
+
+	// Find the angle within the current piece at which we reach the new position. Allow for rounding error taking the cosine out of range.
+	const float cosine = ((float)mp.arc.position - mp.arc.offset)/mp.arc.radius;
+	const float acosine = (cosine >= 1.0) ? 0.0 : (cosine <= -1.0) ? Pi : acosf(cosine);
+	const float angleInPiece = (mp.arc.pieceNumber & 1) ? Pi - acosine : acosine;
+
+	// Convert the angle to distance along the path. The first and last pieces may be partial, so clamp the distance to the extent of the move.
+	float ds = mp.arc.pieceStartDistance + angleInPiece * mp.arc.distancePerRadian;
+	if (ds < 0.0)
+	{
+		ds = 0.0;
+	}
+	else if (ds > dda.totalDistance)
+	{
+		ds = dda.totalDistance;
+	}
+
+	const uint32_t nextCalcStepTime = CalcStepTimeFromDistance(dda, ds, mp.arc.accelStopDistance, mp.arc.decelStartDistance);
+
+	// When crossing between movement phases with high microstepping, due to rounding errors the next step may appear to be due before the last one.
+	stepInterval = (nextCalcStepTime > nextStepTime)
+					? (nextCalcStepTime - nextStepTime) >> shiftFactor	// calculate the time per step, ready for next time
+					: 0;
+#if EVEN_STEPS
+	nextStepTime = nextCalcStepTime - (stepsTillRecalc * stepInterval);
+#else
+	nextStepTime = nextCalcStepTime;
+#endif
+
+	if (nextCalcStepTime > dda.clocksNeeded)
+	{
+		// The calculation makes this step late. Because we clamp the distance to the length of the move, this can only be due to rounding error,
+		// so bring it forward to the expected finish time.
+		nextStepTime = dda.clocksNeeded;
+	}
+	return true;
+}
+
+#endif
+
 // End
@@ -12,9 +12,16 @@
 #include <Platform/Tasks.h>
 
 class LinearDeltaKinematics;
+class MoveSegment;
 
-#define DM_USE_FPU			(__FPU_USED)
+#if defined(HOST_SIM)
+# define DM_USE_FPU			(1)			// the host has hardware floating point, so simulate the same move code as the SAME5x
+#else
+# define DM_USE_FPU			(__FPU_USED)
+#endif
 #define EVEN_STEPS			(1)			// 1 to generate steps at even intervals when doing double/quad/octal stepping
+#define DM_USE_STEP_BATCH	(DM_USE_FPU)	// 1 to support calculating the step times of Cartesian moves in batches using forward differences
+#define DM_USE_ARCS			(DM_USE_FPU)	// 1 to support executing G2/G3 arcs as single moves instead of dividing them into straight line segments
 #define ROUND_TO_NEAREST	(0)			// 1 for round to nearest (as used in 1.20beta10), 0 for round down (as used prior to 1.20beta10)
 
 // Rounding functions, to improve code clarity. Also allows a quick switch between round-to-nearest and round down in the movement code.
@@ -113,6 +120,8 @@ struct PrepParams
 	// Parameters used by CAN expansion
 	float accelTime, steadyTime, decelTime;
 	float initialSpeedFraction, finalSpeedFraction;
+	uint32_t smoothingClocks;					// the acceleration smoothing time in step clocks, or zero if the move isn't smoothed
+	bool smoothAccel, smoothDecel;				// which phases of the move were smoothed
 #endif
 
 	// Parameters used only for delta moves
@@ -148,7 +157,9 @@ enum class DMState : uint8_t
 	decel6,
 	decel7,
 	reversing,
-	reverse
+	reverse,
+	shaped,						// executing the list of MoveSegments of a move that has input shaping applied
+	arc							// moving an axis that is part of a native arc move
 };
 
 // This class describes a single movement of one drive
@@ -172,6 +183,9 @@ public:
 #if SUPPORT_REMOTE_COMMANDS
 	bool PrepareRemoteExtruder(const DDA& dda, const PrepParams& params) noexcept;
 #endif
+#if DM_USE_ARCS
+	bool PrepareArcAxis(const DDA& dda, const PrepParams& params, bool isSecondArcAxis) noexcept SPEED_CRITICAL;
+#endif
 
 	void DebugPrint() const noexcept;
 	int32_t GetNetStepsLeft() const noexcept;
@@ -190,12 +204,37 @@ public:
 	static DriveMovement *Allocate(size_t p_drive, DMState st) noexcept;
 	static void Release(DriveMovement *item) noexcept;
 
+#if DM_USE_STEP_BATCH
+	static bool IsStepBatchingEnabled() noexcept { return stepBatching; }
+	static void SetStepBatching(bool enable) noexcept { stepBatching = enable; }
+#endif
+
 private:
 	bool CalcNextStepTimeCartesianFull(const DDA &dda) noexcept SPEED_CRITICAL;
 	bool CalcNextStepTimeDeltaFull(const DDA &dda) noexcept SPEED_CRITICAL;
+#if DM_USE_FPU
+	bool CalcNextStepTimeShapedFull(const DDA &dda) noexcept SPEED_CRITICAL;
+	bool PrepareShaped(const DDA& dda, float stepsPerMm, int32_t finalPosition, float pressureAdvanceClocks) noexcept SPEED_CRITICAL;
+	void SetShapedSegment(const MoveSegment *seg) noexcept SPEED_CRITICAL;
+	void SetShapedLimit() noexcept SPEED_CRITICAL;
+#endif
+#if DM_USE_ARCS
+	bool CalcNextStepTimeArcFull(const DDA &dda) noexcept SPEED_CRITICAL;
+	void SetArcPiece(int32_t pieceNumber) noexcept SPEED_CRITICAL;
+#endif
+#if DM_USE_FPU
+	uint32_t CalcStepTimeFromDistance(const DDA &dda, float ds, float accelStopDs, float decelStartDs) const noexcept SPEED_CRITICAL;
+#endif
+#if DM_USE_STEP_BATCH
+	uint32_t CalcStepBatch(float p, float q, float tBase, bool negate, uint32_t shiftFactor) noexcept SPEED_CRITICAL;
+	uint32_t GetBatchShiftFactor(uint32_t stepsToLimit) const noexcept SPEED_CRITICAL;
+#endif
 
 	static DriveMovement *freeList;
 	static unsigned int numCreated;
+#if DM_USE_STEP_BATCH
+	static bool stepBatching;							// true if we calculate step times in batches during the acceleration and deceleration phases
+#endif
 
 	// Parameters common to Cartesian, delta and extruder moves
 
@@ -206,7 +245,10 @@ private:
 	uint8_t direction : 1,								// true=forwards, false=backwards
 			directionChanged : 1,						// set by CalcNextStepTime if the direction is changed
 			fullCurrent : 1,							// true if the drivers are set to the full current, false if they are set to the standstill current
-			isDelta : 1;								// true if this DM uses segment-free delta kinematics
+			isDelta : 1,								// true if this DM uses segment-free delta kinematics
+			isShaped : 1,								// true if this DM is executing the MoveSegments of a move with input shaping
+			isBatched : 1,								// true if the current group of steps was calculated as a batch using forward differences
+			isArc : 1;									// true if this DM is moving an axis of a native arc move
 	uint8_t stepsTillRecalc;							// how soon we need to recalculate
 
 	uint32_t totalSteps;								// total number of steps for this move
@@ -254,6 +296,16 @@ private:
 			uint32_t decelStartStep;					// the first step number at which we are decelerating
 			uint32_t compensationClocks;				// the pressure advance time in clocks
 			uint32_t accelCompensationClocks;			// compensationClocks * (1 - startSpeed/topSpeed)
+#if DM_USE_STEP_BATCH
+			// The following are used when calculating step times in batches. Within a batch the step time is a quadratic function of the step number.
+			float fBatchTime;							// the time of the next step relative to batchStartTime
+			float fBatchInterval;						// the interval between the next step and the one after it
+			float fBatchIntervalDelta;					// the amount by which the step interval changes at each step
+			float fBatchSqrt;							// the square root we calculated for the last step of the previous batch
+			uint32_t batchStartTime;					// the whole number of clocks at the start of the current batch
+			uint32_t batchSqrtStep;						// the step number that fBatchSqrt relates to
+			DMState batchState;							// the state that fBatchSqrt relates to
+#endif
 		} cart;
 
 		struct DeltaParameters							// Parameters for delta movement
@@ -278,6 +330,45 @@ private:
 			uint32_t decelStartDsK;
 #endif
 		} delta;
+
+#if DM_USE_FPU
+		struct ShapedParameters							// Parameters for moves that have input shaping applied, which are executed as a list of MoveSegments
+		{
+			// The position in steps during the current segment is f0 + fB * t + 0.5 * fA * t^2 where t is the time in step clocks since the start of the segment
+			const MoveSegment *currentSegment;			// the segment we are executing
+			float stepsPerMm;							// steps per unit distance along the move, negative if this drive moves backwards
+			float pressureAdvanceClocks;				// the pressure advance time in step clocks, zero if pressure advance doesn't apply
+			float startOffset;							// the pressure advance offset in steps at the start of the move, so that the position starts at zero
+			float f0;
+			float fB;
+			float fA;
+			float limit;								// the position in steps at which the current monotonic part of the current segment ends
+			int32_t position;							// the position after the last step of the current batch of steps
+			int32_t finalPosition;						// the position at the end of the move
+			uint32_t batchEndStep;						// the step number of the last step of the current batch
+		} shaped;
+#endif
+
+#if DM_USE_ARCS
+		struct ArcParameters							// Parameters for an axis that is moving in a native arc
+		{
+			// The position in steps relative to the start of the move is offset + radius * cos(angle), where angle increases from startAngle in proportion to the distance moved.
+			// The position is monotonic between consecutive multiples of pi, so we execute the move in pieces between those angles.
+			float offset;								// the position of the arc centre in steps relative to the start position
+			float radius;								// the arc radius in steps
+			float startAngle;							// the angle at the start of the move
+			float endAngle;								// the angle at the end of the move
+			float distancePerRadian;					// the distance moved along the path for each radian that the angle increases
+			float pieceStartDistance;					// the distance along the path at the start of the current piece, less startAngle * distancePerRadian
+			float accelStopDistance;					// the distance along the path at which acceleration ends
+			float decelStartDistance;					// the distance along the path at which deceleration starts
+			int32_t pieceNumber;						// the number of the current piece, which is the number of multiples of pi in the angle at its start
+			int32_t position;							// the position after the last step of the current batch of steps
+			int32_t pieceEndPosition;					// the position at the end of the current piece
+			int32_t finalPosition;						// the position at the end of the move
+			uint32_t batchEndStep;						// the step number of the last step of the current batch
+		} arc;
+#endif
 	} mp;
 
 	static constexpr uint32_t NoStepTime = 0xFFFFFFFF;	// value to indicate that no further steps are needed when calculating the next step time
@@ -301,9 +392,20 @@ inline bool DriveMovement::CalcNextStepTime(const DDA &dda) noexcept
 		if (stepsTillRecalc != 0)
 		{
 			--stepsTillRecalc;			// we are doing double/quad/octal stepping
+#if DM_USE_STEP_BATCH
+			if (isBatched)
+			{
+				mp.cart.fBatchTime += mp.cart.fBatchInterval;
+				mp.cart.fBatchInterval += mp.cart.fBatchIntervalDelta;
+				nextStepTime = mp.cart.batchStartTime + (uint32_t)mp.cart.fBatchTime;
+			}
+			else
+#endif
+			{
 #if EVEN_STEPS
-			nextStepTime += stepInterval;
+				nextStepTime += stepInterval;
 #endif
+			}
 #if SAME70
 			asm volatile("nop");
 			asm volatile("nop");
@@ -314,7 +416,14 @@ inline bool DriveMovement::CalcNextStepTime(const DDA &dda) noexcept
 #endif
 			return true;
 		}
-		return (isDelta) ? CalcNextStepTimeDeltaFull(dda) : CalcNextStepTimeCartesianFull(dda);
+		return (isDelta) ? CalcNextStepTimeDeltaFull(dda)
+#if DM_USE_FPU
+				: (isShaped) ? CalcNextStepTimeShapedFull(dda)
+#endif
+#if DM_USE_ARCS
+				: (isArc) ? CalcNextStepTimeArcFull(dda)
+#endif
+					: CalcNextStepTimeCartesianFull(dda);
 	}
 
 	state = DMState::idle;
@@ -333,6 +442,18 @@ inline bool DriveMovement::CalcNextStepTime(const DDA &dda) noexcept
 // We have already taken nextSteps - 1 steps, unless nextStep is zero.
 inline int32_t DriveMovement::GetNetStepsLeft() const noexcept
 {
+#if DM_USE_FPU
+	if (isShaped)
+	{
+		return mp.shaped.finalPosition - GetNetStepsTaken();
+	}
+#endif
+#if DM_USE_ARCS
+	if (isArc)
+	{
+		return mp.arc.finalPosition - GetNetStepsTaken();
+	}
+#endif
 	int32_t netStepsLeft;
 	if (reverseStartStep > totalSteps)		// if no reverse phase
 	{
@@ -354,6 +475,21 @@ inline int32_t DriveMovement::GetNetStepsLeft() const noexcept
 // We have already taken nextSteps - 1 steps, unless nextStep is zero.
 inline int32_t DriveMovement::GetNetStepsTaken() const noexcept
 {
+#if DM_USE_FPU
+	if (isShaped)
+	{
+		// Any steps of the current batch that we haven't taken yet are all in the current direction
+		const int32_t stepsPending = (int32_t)(mp.shaped.batchEndStep + 1 - nextStep);
+		return (direction) ? mp.shaped.position - stepsPending : mp.shaped.position + stepsPending;
+	}
+#endif
+#if DM_USE_ARCS
+	if (isArc)
+	{
+		const int32_t stepsPending = (int32_t)(mp.arc.batchEndStep + 1 - nextStep);
+		return (direction) ? mp.arc.position - stepsPending : mp.arc.position + stepsPending;
+	}
+#endif
 	int32_t netStepsTaken;
 	if (nextStep < reverseStartStep || reverseStartStep > totalSteps)				// if no reverse phase, or not started it yet
 	{
@@ -9,7 +9,10 @@
 
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Platform/RepRap.h>
+#include <Platform/Platform.h>
 #include "StepTimer.h"
+#include "MoveSegment.h"
+#include "DriveMovement.h"
 
 // Object model table and functions
 // Note: if using GCC version 7.3.1 20180622 and lambda functions are used in this table, you must compile this file with option -std=gnu++17.
@@ -19,17 +22,34 @@
 #define OBJECT_MODEL_FUNC(...) OBJECT_MODEL_FUNC_BODY(InputShaper, __VA_ARGS__)
 #define OBJECT_MODEL_FUNC_IF(...) OBJECT_MODEL_FUNC_IF_BODY(InputShaper, __VA_ARGS__)
 
+constexpr ObjectModelArrayDescriptor InputShaper::amplitudesArrayDescriptor =
+{
+	nullptr,					// no lock needed
+	[] (const ObjectModel *self, const ObjectExplorationContext&) noexcept -> size_t { return ((const InputShaper*)self)->numImpulses; },
+	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue { return ExpressionValue(((const InputShaper*)self)->amplitudes[context.GetLastIndex()], 3); }
+};
+
+constexpr ObjectModelArrayDescriptor InputShaper::delaysArrayDescriptor =
+{
+	nullptr,					// no lock needed
+	[] (const ObjectModel *self, const ObjectExplorationContext&) noexcept -> size_t { return ((const InputShaper*)self)->numImpulses; },
+	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue
+			{ return ExpressionValue(((const InputShaper*)self)->delays[context.GetLastIndex()] * (1000.0/(float)StepTimer::StepClockRate), 2); }
+};
+
 constexpr ObjectModelTableEntry InputShaper::objectModelTable[] =
 {
 	// Within each group, these entries must be in alphabetical order
 	// 0. InputShaper members
+	{ "amplitudes",				OBJECT_MODEL_FUNC_NOSELF(&amplitudesArrayDescriptor), 					ObjectModelEntryFlags::none },
 	{ "damping",				OBJECT_MODEL_FUNC(self->GetFloatDamping(), 2), 							ObjectModelEntryFlags::none },
+	{ "delays",					OBJECT_MODEL_FUNC_NOSELF(&delaysArrayDescriptor), 						ObjectModelEntryFlags::none },
 	{ "frequency",				OBJECT_MODEL_FUNC(self->GetFrequency(), 2), 							ObjectModelEntryFlags::none },
 	{ "minimumAcceleration",	OBJECT_MODEL_FUNC(self->minimumAcceleration, 1),						ObjectModelEntryFlags::none },
 	{ "type", 					OBJECT_MODEL_FUNC(self->type.ToString()), 								ObjectModelEntryFlags::none },
 };
 
-constexpr uint8_t InputShaper::objectModelTableDescriptor[] = { 1, 4 };
+constexpr uint8_t InputShaper::objectModelTableDescriptor[] = { 1, 6 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(InputShaper)
 
@@ -37,7 +57,10 @@ InputShaper::InputShaper() noexcept
 	: halfPeriod((uint16_t)lrintf(StepTimer::StepClockRate/(2 * DefaultFrequency))),
 	  damping(lrintf(DefaultDamping * 65536)),
 	  minimumAcceleration(DefaultMinimumAcceleration),
-	  type(InputShaperType::none)
+	  type(InputShaperType::none),
+	  numImpulses(0),
+	  averageDelay(0.0),
+	  numMovesShaped(0), numMovesPartShaped(0), numMovesNotShaped(0), numMovesSmoothed(0)
 {
 }
 
@@ -60,7 +83,7 @@ GCodeResult InputShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THRO
 	if (gb.Seen('S'))
 	{
 		seen = true;
-		damping = (uint16_t)lrintf(63336 * gb.GetLimitedFValue('S', 0.0, 0.99));
+		damping = (uint16_t)lrintf(65535 * gb.GetLimitedFValue('S', 0.0, 0.99));
 	}
 
 	if (gb.Seen('P'))
@@ -68,7 +91,12 @@ GCodeResult InputShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THRO
 		String<StringLength20> shaperName;
 		gb.GetReducedString(shaperName.GetRef());
 		const InputShaperType newType(shaperName.c_str());
-		if (!newType.IsValid())
+		if (!newType.IsValid()
+#if !DM_USE_FPU
+			// The impulse-based shapers need floating point maths in the step ISR
+			|| (newType != InputShaperType::daa && newType != InputShaperType::none)
+#endif
+		   )
 		{
 			reply.printf("Unsupported input shaper type '%s'", shaperName.c_str());
 			return GCodeResult::error;
@@ -84,6 +112,7 @@ GCodeResult InputShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THRO
 
 	if (seen)
 	{
+		CalculateImpulses();
 		reprap.MoveUpdated();
 	}
 	else if (type != InputShaperType::none)
@@ -98,6 +127,366 @@ GCodeResult InputShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THRO
 	return GCodeResult::ok;
 }
 
+// Calculate the amplitudes and delays of the impulses for the current shaper type, frequency and damping.
+// The formulas are the standard ones for these shapers. All the delays are multiples of the damped period of the ringing.
+void InputShaper::CalculateImpulses() noexcept
+{
+	const float zeta = GetFloatDamping();
+	const float sqrtOneMinusZetaSquared = fastSqrtf(1.0 - fsquare(zeta));
+	const float dampedPeriod = (float)(2 * halfPeriod)/sqrtOneMinusZetaSquared;			// in step clocks
+	const float k = expf(-zeta * Pi/sqrtOneMinusZetaSquared);
+
+	switch (type.RawValue())
+	{
+	case InputShaperType::zv:
+		numImpulses = 2;
+		amplitudes[0] = 1.0;
+		amplitudes[1] = k;
+		delays[0] = 0.0;
+		delays[1] = 0.5 * dampedPeriod;
+		break;
+
+	case InputShaperType::zvd:
+		numImpulses = 3;
+		amplitudes[0] = 1.0;
+		amplitudes[1] = 2 * k;
+		amplitudes[2] = fsquare(k);
+		delays[0] = 0.0;
+		delays[1] = 0.5 * dampedPeriod;
+		delays[2] = dampedPeriod;
+		break;
+
+	case InputShaperType::mzv:
+		{
+			const float k2 = expf(-0.75 * zeta * Pi/sqrtOneMinusZetaSquared);
+			numImpulses = 3;
+			amplitudes[0] = 1.0 - 1.0/sqrtf(2.0);
+			amplitudes[1] = (sqrtf(2.0) - 1.0) * k2;
+			amplitudes[2] = amplitudes[0] * fsquare(k2);
+			delays[0] = 0.0;
+			delays[1] = 0.375 * dampedPeriod;
+			delays[2] = 0.75 * dampedPeriod;
+		}
+		break;
+
+	case InputShaperType::ei:
+		numImpulses = 3;
+		amplitudes[0] = 0.25 * (1.0 + VibrationTolerance);
+		amplitudes[1] = 0.5 * (1.0 - VibrationTolerance) * k;
+		amplitudes[2] = amplitudes[0] * fsquare(k);
+		delays[0] = 0.0;
+		delays[1] = 0.5 * dampedPeriod;
+		delays[2] = dampedPeriod;
+		break;
+
+	case InputShaperType::ei2:
+		{
+			const float vSquared = fsquare(VibrationTolerance);
+			const float x = cbrtf(vSquared * (sqrtf(1.0 - vSquared) + 1.0));
+			numImpulses = 4;
+			amplitudes[0] = (3 * fsquare(x) + 2 * x + 3 * vSquared)/(16 * x);
+			amplitudes[1] = (0.5 - amplitudes[0]) * k;
+			amplitudes[2] = amplitudes[1] * k;
+			amplitudes[3] = amplitudes[0] * fsquare(k) * k;
+			delays[0] = 0.0;
+			delays[1] = 0.5 * dampedPeriod;
+			delays[2] = dampedPeriod;
+			delays[3] = 1.5 * dampedPeriod;
+		}
+		break;
+
+	default:
+		numImpulses = 0;
+		averageDelay = 0.0;
+		return;
+	}
+
+	// Normalise the amplitudes so that the shaped acceleration reaches the same speed as the unshaped acceleration
+	float sum = 0.0;
+	for (size_t i = 0; i < numImpulses; ++i)
+	{
+		sum += amplitudes[i];
+	}
+	averageDelay = 0.0;
+	for (size_t i = 0; i < numImpulses; ++i)
+	{
+		amplitudes[i] /= sum;
+		averageDelay += amplitudes[i] * delays[i];
+	}
+}
+
+// Build the impulse sequence for a move, sorted in order of increasing delay, and return the number of impulses.
+// If applyShaping is true the sequence includes the input shaper impulses. If smoothingClocks is nonzero, each impulse is also split into a staircase of SmoothingImpulses
+// equal impulses spread over that time. Convolving an acceleration phase with the staircase changes the acceleration in SmoothingImpulses equal steps instead of all at once.
+// This is not a jerk-limited profile, because the acceleration still changes in steps.
+size_t InputShaper::GetMoveImpulses(bool applyShaping, uint32_t smoothingClocks, float moveAmplitudes[], float moveDelays[]) const noexcept
+{
+	size_t numMoveImpulses;
+	if (applyShaping)
+	{
+		numMoveImpulses = numImpulses;
+		memcpy(moveAmplitudes, amplitudes, numImpulses * sizeof(amplitudes[0]));
+		memcpy(moveDelays, delays, numImpulses * sizeof(delays[0]));
+	}
+	else
+	{
+		numMoveImpulses = 1;
+		moveAmplitudes[0] = 1.0;
+		moveDelays[0] = 0.0;
+	}
+
+	if (smoothingClocks != 0)
+	{
+		// Convolve the impulses with a staircase of SmoothingImpulses equal impulses, inserting each new impulse in order of delay
+		const size_t numBaseImpulses = numMoveImpulses;
+		float baseAmplitudes[MaxImpulses], baseDelays[MaxImpulses];
+		memcpy(baseAmplitudes, moveAmplitudes, numBaseImpulses * sizeof(moveAmplitudes[0]));
+		memcpy(baseDelays, moveDelays, numBaseImpulses * sizeof(moveDelays[0]));
+		numMoveImpulses = 0;
+		for (size_t i = 0; i < numBaseImpulses; ++i)
+		{
+			for (size_t j = 0; j < SmoothingImpulses; ++j)
+			{
+				const float delay = baseDelays[i] + (float)(smoothingClocks * j)/(float)SmoothingImpulses;
+				size_t k = numMoveImpulses;
+				while (k != 0 && moveDelays[k - 1] > delay)
+				{
+					moveDelays[k] = moveDelays[k - 1];
+					moveAmplitudes[k] = moveAmplitudes[k - 1];
+					--k;
+				}
+				moveDelays[k] = delay;
+				moveAmplitudes[k] = baseAmplitudes[i]/(float)SmoothingImpulses;
+				++numMoveImpulses;
+			}
+		}
+	}
+	return numMoveImpulses;
+}
+
+// Build the list of constant-acceleration segments needed to execute a trapezoidal move with its acceleration and deceleration phases convolved with an impulse sequence.
+// Shaping a phase makes it last longer by the total delay of the impulses and covers extra distance, which we take from the steady speed phase.
+// If the steady speed phase isn't long enough to do that for both phases, we shape just one of them. If we can't shape either, return nullptr so that the move is executed unshaped.
+// On entry the speeds are in mm/sec and the accelerations are in mm/sec^2. On return, clocksNeeded has been updated if we returned any segments,
+// and shapedAccel and shapedDecel say which phases we shaped so that the decision can be passed to expansion boards.
+MoveSegment *InputShaper::GetSegments(float totalDistance, float accelDistance, float decelDistance,
+										float startSpeed, float topSpeed, float endSpeed, float acceleration, float deceleration,
+										bool applyShaping, uint32_t smoothingClocks, uint32_t& clocksNeeded, bool& shapedAccel, bool& shapedDecel) noexcept
+{
+	float moveAmplitudes[MaxImpulses * SmoothingImpulses];
+	float moveDelays[MaxImpulses * SmoothingImpulses];
+	const size_t numMoveImpulses = GetMoveImpulses(applyShaping, smoothingClocks, moveAmplitudes, moveDelays);
+
+	// Work out which phases we can shape
+	const float u = startSpeed/(float)StepTimer::StepClockRate;
+	const float v = topSpeed/(float)StepTimer::StepClockRate;
+	const float w = endSpeed/(float)StepTimer::StepClockRate;
+	const float steadyDistance = totalDistance - accelDistance - decelDistance;
+	float extraAccelDistance, extraDecelDistance;
+	GetExtraDistances(moveAmplitudes, moveDelays, numMoveImpulses, u, v, w, extraAccelDistance, extraDecelDistance);
+	bool shapeAccel = (v > u && extraAccelDistance <= steadyDistance);
+	bool shapeDecel = (v > w && extraDecelDistance <= steadyDistance);
+	if (shapeAccel && shapeDecel && extraAccelDistance + extraDecelDistance > steadyDistance)
+	{
+		// We can only shape one of the phases, so choose the one with the larger speed change
+		if (v - u >= v - w)
+		{
+			shapeDecel = false;
+		}
+		else
+		{
+			shapeAccel = false;
+		}
+	}
+
+	shapedAccel = shapeAccel;
+	shapedDecel = shapeDecel;
+	if (!shapeAccel && !shapeDecel)
+	{
+		if (applyShaping)
+		{
+			++numMovesNotShaped;
+		}
+		return nullptr;
+	}
+
+	if (applyShaping)
+	{
+		if (shapeAccel && shapeDecel)
+		{
+			++numMovesShaped;
+		}
+		else
+		{
+			++numMovesPartShaped;
+		}
+	}
+	if (smoothingClocks != 0)
+	{
+		++numMovesSmoothed;
+	}
+
+	return BuildSegments(moveAmplitudes, moveDelays, numMoveImpulses, steadyDistance, u, v, w,
+							acceleration/(float)StepTimer::StepClockRateSquared, deceleration/(float)StepTimer::StepClockRateSquared,
+							shapeAccel, extraAccelDistance, shapeDecel, extraDecelDistance, clocksNeeded);
+}
+
+#if SUPPORT_REMOTE_COMMANDS
+
+// Build the segments for a move received from the main board, which has already decided which phases to smooth. Expansion boards don't apply input shaping.
+// We use the main board's decision instead of making our own, because the speeds and distances that we reconstruct from the movement message are subject to rounding error.
+// The move has unit total distance. On return, clocksNeeded has been updated if we returned any segments.
+MoveSegment *InputShaper::GetRemoteSegments(float accelDistance, float decelDistance, float startSpeed, float topSpeed, float endSpeed, float acceleration, float deceleration,
+											uint32_t smoothingClocks, bool smoothAccel, bool smoothDecel, uint32_t& clocksNeeded) noexcept
+{
+	const float u = startSpeed/(float)StepTimer::StepClockRate;
+	const float v = topSpeed/(float)StepTimer::StepClockRate;
+	const float w = endSpeed/(float)StepTimer::StepClockRate;
+	smoothAccel = smoothAccel && v > u;
+	smoothDecel = smoothDecel && v > w;
+	if (smoothingClocks == 0 || (!smoothAccel && !smoothDecel))
+	{
+		return nullptr;
+	}
+
+	float moveAmplitudes[SmoothingImpulses];
+	float moveDelays[SmoothingImpulses];
+	const size_t numMoveImpulses = GetMoveImpulses(false, smoothingClocks, moveAmplitudes, moveDelays);
+	float extraAccelDistance, extraDecelDistance;
+	GetExtraDistances(moveAmplitudes, moveDelays, numMoveImpulses, u, v, w, extraAccelDistance, extraDecelDistance);
+	++numMovesSmoothed;
+	return BuildSegments(moveAmplitudes, moveDelays, numMoveImpulses, 1.0 - accelDistance - decelDistance, u, v, w,
+							acceleration/(float)StepTimer::StepClockRateSquared, deceleration/(float)StepTimer::StepClockRateSquared,
+							smoothAccel, extraAccelDistance, smoothDecel, extraDecelDistance, clocksNeeded);
+}
+
+#endif
+
+// Calculate the extra distance that shaping the acceleration and deceleration phases would cover. The speeds are in mm per step clock.
+/*static*/ void InputShaper::GetExtraDistances(const float moveAmplitudes[], const float moveDelays[], size_t numMoveImpulses, float u, float v, float w,
+												float& extraAccelDistance, float& extraDecelDistance) noexcept
+{
+	float moveAverageDelay = 0.0;
+	for (size_t i = 0; i < numMoveImpulses; ++i)
+	{
+		moveAverageDelay += moveAmplitudes[i] * moveDelays[i];
+	}
+	const float shapingTime = moveDelays[numMoveImpulses - 1];
+	extraAccelDistance = (v * shapingTime) - ((v - u) * moveAverageDelay);
+	extraDecelDistance = (w * shapingTime) + ((v - w) * moveAverageDelay);
+}
+
+// Build the segments for a move given the impulse sequence and which phases to shape. The speeds and accelerations are in step clock units.
+/*static*/ MoveSegment *InputShaper::BuildSegments(const float moveAmplitudes[], const float moveDelays[], size_t numMoveImpulses, float steadyDistance,
+													float u, float v, float w, float a, float d,
+													bool shapeAccel, float extraAccelDistance, bool shapeDecel, float extraDecelDistance, uint32_t& clocksNeeded) noexcept
+{
+	MoveSegment *firstSegment = nullptr;
+	MoveSegment *lastSegment = nullptr;
+	float segStartTime = 0.0, segStartDistance = 0.0, segStartSpeed = u;
+
+	// Function to append a segment to the list
+	auto addSegment = [&firstSegment, &lastSegment, &segStartTime, &segStartDistance, &segStartSpeed](float duration, float accel) noexcept -> void
+	{
+		MoveSegment * const seg = MoveSegment::Allocate(nullptr);
+		seg->SetParameters(segStartTime, duration, segStartDistance, segStartSpeed, accel);
+		if (lastSegment == nullptr)
+		{
+			firstSegment = seg;
+		}
+		else
+		{
+			lastSegment->SetNext(seg);
+		}
+		lastSegment = seg;
+		segStartTime += duration;
+		segStartDistance = seg->GetEndDistance();
+		segStartSpeed = seg->GetEndSpeed();
+	};
+
+	// Function to append the segments of a shaped acceleration or deceleration phase.
+	// Each impulse starts a copy of the unshaped acceleration scaled by the impulse amplitude, and that copy ends phaseTime later.
+	// So we walk through the start and end events in time order, keeping track of the total amplitude of the copies that are active.
+	auto addShapedPhase = [moveAmplitudes, moveDelays, numMoveImpulses, &addSegment](float phaseTime, float accel) noexcept -> void
+	{
+		float amplitude = 0.0;
+		float lastEventTime = 0.0;
+		size_t startIndex = 0, endIndex = 0;
+		while (endIndex < numMoveImpulses)
+		{
+			const bool isStart = startIndex < numMoveImpulses && moveDelays[startIndex] <= moveDelays[endIndex] + phaseTime;
+			const float eventTime = (isStart) ? moveDelays[startIndex] : moveDelays[endIndex] + phaseTime;
+			if (eventTime > lastEventTime)
+			{
+				addSegment(eventTime - lastEventTime, accel * amplitude);
+				lastEventTime = eventTime;
+			}
+			if (isStart)
+			{
+				amplitude += moveAmplitudes[startIndex++];
+			}
+			else
+			{
+				amplitude -= moveAmplitudes[endIndex++];
+			}
+		}
+	};
+
+	float steadyDistanceLeft = steadyDistance;
+	if (v > u)
+	{
+		const float accelTime = (v - u)/a;
+		if (shapeAccel)
+		{
+			addShapedPhase(accelTime, a);
+			steadyDistanceLeft -= extraAccelDistance;
+		}
+		else
+		{
+			addSegment(accelTime, a);
+		}
+	}
+
+	if (shapeDecel)
+	{
+		steadyDistanceLeft -= extraDecelDistance;
+	}
+	if (steadyDistanceLeft > 0.0)
+	{
+		addSegment(steadyDistanceLeft/v, 0.0);
+	}
+
+	if (v > w)
+	{
+		const float decelTime = (v - w)/d;
+		if (shapeDecel)
+		{
+			addShapedPhase(decelTime, -d);
+		}
+		else
+		{
+			addSegment(decelTime, -d);
+		}
+	}
+
+	clocksNeeded = (uint32_t)segStartTime;
+	return firstSegment;
+}
+
+void InputShaper::Diagnostics(MessageType mtype) noexcept
+{
+	if (numImpulses != 0)
+	{
+		reprap.GetPlatform().MessageF(mtype, "Input shaping: moves shaped %" PRIu32 ", part shaped %" PRIu32 ", not shaped %" PRIu32 ", segments created %u\n",
+										numMovesShaped, numMovesPartShaped, numMovesNotShaped, MoveSegment::NumCreated());
+	}
+	if (numMovesSmoothed != 0)
+	{
+		reprap.GetPlatform().MessageF(mtype, "Acceleration smoothing: moves %" PRIu32 "\n", numMovesSmoothed);
+	}
+	numMovesShaped = numMovesPartShaped = numMovesNotShaped = numMovesSmoothed = 0;
+}
+
 // Return the full period in seconds
 float InputShaper::GetFullPeriod() const noexcept
 {
@@ -12,10 +12,17 @@
 #include <General/NamedEnum.h>
 #include <ObjectModel/ObjectModel.h>
 
+class MoveSegment;
+
 // These names must be in alphabetical order and lowercase
 NamedEnum(InputShaperType, uint8_t,
 	daa,
+	ei,
+	ei2,
+	mzv,
 	none,
+	zv,
+	zvd,
 );
 
 class InputShaper INHERIT_OBJECT_MODEL
@@ -29,21 +36,57 @@ public:
 	float GetFloatDamping() const noexcept;
 	float GetMinimumAcceleration() const noexcept { return minimumAcceleration; }
 	InputShaperType GetType() const noexcept { return type; }
+	bool UsesImpulses() const noexcept { return numImpulses != 0; }				// return true if the shaper type is one that is applied by convolving the acceleration with a sequence of impulses
 
 	GCodeResult Configure(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);	// process M593
 
+	MoveSegment *GetSegments(float totalDistance, float accelDistance, float decelDistance,
+								float startSpeed, float topSpeed, float endSpeed, float acceleration, float deceleration,
+								bool applyShaping, uint32_t smoothingClocks, uint32_t& clocksNeeded, bool& shapedAccel, bool& shapedDecel) noexcept;
+#if SUPPORT_REMOTE_COMMANDS
+	MoveSegment *GetRemoteSegments(float accelDistance, float decelDistance, float startSpeed, float topSpeed, float endSpeed, float acceleration, float deceleration,
+									uint32_t smoothingClocks, bool smoothAccel, bool smoothDecel, uint32_t& clocksNeeded) noexcept;
+#endif
+	void RecordUnshapedMove() noexcept { ++numMovesNotShaped; }
+	void Diagnostics(MessageType mtype) noexcept;
+
+	static constexpr unsigned int MaxImpulses = 4;
+	static constexpr unsigned int SmoothingImpulses = 4;							// the number of equal steps in which acceleration smoothing changes the acceleration
+
 protected:
 	DECLARE_OBJECT_MODEL
+	OBJECT_MODEL_ARRAY(amplitudes)
+	OBJECT_MODEL_ARRAY(delays)
 
 private:
+	void CalculateImpulses() noexcept;												// calculate the impulse sequence from the shaper type, frequency and damping
+	size_t GetMoveImpulses(bool applyShaping, uint32_t smoothingClocks, float moveAmplitudes[], float moveDelays[]) const noexcept;
+	static void GetExtraDistances(const float moveAmplitudes[], const float moveDelays[], size_t numMoveImpulses, float u, float v, float w,
+									float& extraAccelDistance, float& extraDecelDistance) noexcept;
+	static MoveSegment *BuildSegments(const float moveAmplitudes[], const float moveDelays[], size_t numMoveImpulses, float steadyDistance,
+										float u, float v, float w, float a, float d,
+										bool shapeAccel, float extraAccelDistance, bool shapeDecel, float extraDecelDistance, uint32_t& clocksNeeded) noexcept;
+
 	static constexpr float DefaultFrequency = 40.0;
 	static constexpr float DefaultDamping = 0.2;
 	static constexpr float DefaultMinimumAcceleration = 10.0;
+	static constexpr float VibrationTolerance = 0.05;								// the residual vibration that the EI shapers are designed to allow
 
 	uint16_t halfPeriod;							// half the period of ringing that we don't want to excite, in step clocks
 	uint16_t damping;								// damping factor of the ringing as a 16-bit fractional number
 	float minimumAcceleration;						// the minimum value that we reduce acceleration to
 	InputShaperType type;
+	uint8_t numImpulses;							// the number of impulses in the shaper, or zero if the shaper type doesn't use impulses
+
+	float amplitudes[MaxImpulses];					// the amplitudes of the impulses, which sum to 1
+	float delays[MaxImpulses];						// the time of each impulse relative to the first one, in step clocks
+	float averageDelay;								// the amplitude-weighted average of the impulse delays, in step clocks
+
+	// Statistics, reset when we report diagnostics
+	uint32_t numMovesShaped;						// moves that had both acceleration and deceleration shaped
+	uint32_t numMovesPartShaped;					// moves that had only one of acceleration and deceleration shaped
+	uint32_t numMovesNotShaped;						// moves that we were unable to shape, e.g. because there was no steady speed phase to absorb the shaping
+	uint32_t numMovesSmoothed;						// moves that had at least one phase smoothed
 };
 
 #endif /* SRC_MOVEMENT_INPUTSHAPER_H_ */
@@ -86,12 +86,14 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 {
 	// Within each group, these entries must be in alphabetical order
 	// 0. Move members
+	{ "accelerationSmoothing",	OBJECT_MODEL_FUNC(self->accelerationSmoothingTime, 3),									ObjectModelEntryFlags::none },
 	{ "axes",					OBJECT_MODEL_FUNC_NOSELF(&axesArrayDescriptor), 										ObjectModelEntryFlags::live },
 	{ "calibration",			OBJECT_MODEL_FUNC(self, 3),																ObjectModelEntryFlags::none },
 	{ "compensation",			OBJECT_MODEL_FUNC(self, 6),																ObjectModelEntryFlags::none },
 	{ "currentMove",			OBJECT_MODEL_FUNC(self, 2),																ObjectModelEntryFlags::live },
 	{ "extruders",				OBJECT_MODEL_FUNC_NOSELF(&extrudersArrayDescriptor),									ObjectModelEntryFlags::live },
 	{ "idle",					OBJECT_MODEL_FUNC(self, 1),																ObjectModelEntryFlags::none },
+	{ "junctionDeviation",		OBJECT_MODEL_FUNC(self->junctionDeviation, 3),											ObjectModelEntryFlags::none },
 	{ "kinematics",				OBJECT_MODEL_FUNC(self->kinematics),													ObjectModelEntryFlags::none },
 	{ "printingAcceleration",	OBJECT_MODEL_FUNC(self->maxPrintingAcceleration, 1),									ObjectModelEntryFlags::none },
 	{ "queue",					OBJECT_MODEL_FUNC_NOSELF(&queueArrayDescriptor),										ObjectModelEntryFlags::none },
@@ -150,7 +152,7 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 	{ "tanYZ",					OBJECT_MODEL_FUNC(self->tanYZ, 4),														ObjectModelEntryFlags::none },
 };
 
-constexpr uint8_t Move::objectModelTableDescriptor[] = { 9, 15, 2, 4 + SUPPORT_LASER, 3, 2, 2, 5 + (HAS_MASS_STORAGE || HAS_LINUX_INTERFACE), 2, 4 };
+constexpr uint8_t Move::objectModelTableDescriptor[] = { 9, 17, 2, 4 + SUPPORT_LASER, 3, 2, 2, 5 + (HAS_MASS_STORAGE || HAS_LINUX_INTERFACE), 2, 4 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(Move)
 
@@ -165,8 +167,8 @@ Move::Move() noexcept
 #if SUPPORT_ASYNC_MOVES
 	  heightController(nullptr),
 #endif
-	  maxPrintingAcceleration(10000.0), maxTravelAcceleration(10000.0),
-	  jerkPolicy(0),
+	  maxPrintingAcceleration(10000.0), maxTravelAcceleration(10000.0), accelerationSmoothingTime(0.0),
+	  jerkPolicy(0), junctionDeviation(0.0),
 	  numCalibratedFactors(0)
 {
 	// Kinematics must be set up here because GCodes::Init asks the kinematics for the assumed initial position
@@ -203,6 +205,7 @@ void Move::Init() noexcept
 
 	simulationMode = 0;
 	longestGcodeWaitInterval = 0;
+	maxMeshTransformTime = totalMeshTransformTime = numMeshTransforms = 0;
 	bedLevellingMoveAvailable = false;
 
 	moveTask.Create(MoveStart, "Move", this, TaskPriority::Move);
@@ -277,7 +280,23 @@ void Move::Exit() noexcept
 					{
 						if (nextMove.moveType == 0)
 						{
-							AxisAndBedTransform(nextMove.coords, nextMove.tool, true);
+							if (usingMesh)
+							{
+								// Record how long the transform takes, because mesh compensation is the expensive part
+								const uint32_t transformStartTime = StepTimer::GetTimerTicks();
+								AxisAndBedTransform(nextMove.coords, nextMove.tool, true);
+								const uint32_t transformTime = StepTimer::GetTimerTicks() - transformStartTime;
+								if (transformTime > maxMeshTransformTime)
+								{
+									maxMeshTransformTime = transformTime;
+								}
+								totalMeshTransformTime += transformTime;
+								++numMeshTransforms;
+							}
+							else
+							{
+								AxisAndBedTransform(nextMove.coords, nextMove.tool, true);
+							}
 						}
 
 						if (mainDDARing.AddStandardMove(nextMove, !IsRawMotorMove(nextMove.moveType)))
@@ -416,6 +435,40 @@ bool Move::IsAccessibleProbePoint(float axesCoords[MaxAxes], AxesBitmap axes) co
 	return kinematics->IsReachable(axesCoords, axes, false);
 }
 
+// Return true if we can execute an arc in the plane of the specified axes as a single move instead of dividing it into straight line segments.
+// The arc step generator needs each arc axis to be driven directly by its own motors, and the axis and bed transforms must not distort the arc.
+bool Move::CanUseNativeArc(size_t axis0, size_t axis1) const noexcept
+{
+#if DM_USE_ARCS
+	if (   kinematics->GetKinematicsType() != KinematicsType::cartesian
+		|| usingMesh
+		|| tanXY != 0.0 || tanYZ != 0.0 || tanXZ != 0.0
+	   )
+	{
+		return false;
+	}
+
+# if SUPPORT_CAN_EXPANSION
+	// Expansion boards can't execute arcs
+	const Platform& platform = reprap.GetPlatform();
+	for (size_t axis : { axis0, axis1 })
+	{
+		const AxisDriversConfig& config = platform.GetAxisDriversConfig(axis);
+		for (size_t i = 0; i < config.numDrivers; ++i)
+		{
+			if (config.driverNumbers[i].IsRemote())
+			{
+				return false;
+			}
+		}
+	}
+# endif
+	return true;
+#else
+	return false;
+#endif
+}
+
 // Pause the print as soon as we can, returning true if we are able to skip any moves and updating 'rp' to the first move we skipped.
 bool Move::PausePrint(RestorePoint& rp) noexcept
 {
@@ -447,6 +500,14 @@ void Move::Diagnostics(MessageType mtype) noexcept
 						DriveMovement::NumCreated(), longestGcodeWaitInterval, scratchString.c_str(), (double)zShift);
 	longestGcodeWaitInterval = 0;
 
+	if (numMeshTransforms != 0)
+	{
+		constexpr float StepClocksToMicros = 1000000.0/(float)StepTimer::StepClockRate;
+		p.MessageF(mtype, "Mesh compensation: %" PRIu32 " moves, max %.1fus, avg %.2fus\n",
+					numMeshTransforms, (double)(maxMeshTransformTime * StepClocksToMicros), (double)((float)totalMeshTransformTime * StepClocksToMicros/numMeshTransforms));
+		maxMeshTransformTime = totalMeshTransformTime = numMeshTransforms = 0;
+	}
+
 #if 0	// debug only
 	scratchString.copy("Steps requested/done:");
 	for (size_t driver = 0; driver < NumDirectDrivers; ++driver)
@@ -480,6 +541,8 @@ void Move::Diagnostics(MessageType mtype) noexcept
 	maxDelay = maxDelayIncrease = 0;
 #endif
 
+	shaper.Diagnostics(mtype);
+
 #if SUPPORT_ASYNC_MOVES
 	mainDDARing.Diagnostics(mtype, "Main");
 	auxDDARing.Diagnostics(mtype, "Aux");
@@ -984,6 +1047,27 @@ GCodeResult Move::ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply)
 		seen = true;
 		maxTravelAcceleration = gb.GetFValue();
 	}
+	if (gb.Seen('J'))
+	{
+		const float smoothingTime = max<float>(gb.GetFValue(), 0.0);
+#if DM_USE_FPU
+		constexpr float MaxSmoothingTime = (float)MaxSmoothingClocks/(float)StepTimer::StepClockRate;
+		if (smoothingTime > MaxSmoothingTime)
+		{
+			reply.printf("Acceleration smoothing time must not exceed %.3fs", (double)MaxSmoothingTime);
+			return GCodeResult::error;
+		}
+#else
+		// Acceleration smoothing needs floating point maths in the step ISR
+		if (smoothingTime != 0.0)
+		{
+			reply.copy("Acceleration smoothing is not supported on this board");
+			return GCodeResult::error;
+		}
+#endif
+		seen = true;
+		accelerationSmoothingTime = smoothingTime;
+	}
 	if (seen)
 	{
 		reprap.MoveUpdated();
@@ -991,10 +1075,22 @@ GCodeResult Move::ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply)
 	else
 	{
 		reply.printf("Maximum printing acceleration %.1f, maximum travel acceleration %.1f", (double)maxPrintingAcceleration, (double)maxTravelAcceleration);
+		if (accelerationSmoothingTime > 0.0)
+		{
+			reply.catf(", acceleration smoothing time %.3fs", (double)accelerationSmoothingTime);
+		}
 	}
 	return GCodeResult::ok;
 }
 
+// Get the acceleration smoothing time in step clocks, or zero if acceleration smoothing is not in use.
+// The result is a multiple of SmoothingClockUnit so that it can be sent to expansion boards.
+uint32_t Move::GetSmoothingClocks() const noexcept
+{
+	return (accelerationSmoothingTime <= 0.0) ? 0
+			: min<uint32_t>((uint32_t)lrintf((accelerationSmoothingTime * (float)StepTimer::StepClockRate)/(float)SmoothingClockUnit) * SmoothingClockUnit, MaxSmoothingClocks);
+}
+
 // Process M595
 GCodeResult Move::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
@@ -59,7 +59,7 @@ public:
 	void GetCurrentMachinePosition(float m[MaxAxes], bool disableMotorMapping) const noexcept; // Get the current position in untransformed coords
 	void GetCurrentUserPosition(float m[MaxAxes], uint8_t moveType, const Tool *tool) const noexcept;
 																			// Return the position (after all queued moves have been executed) in transformed coords
-	int32_t GetEndPoint(size_t drive) const noexcept;					 	// Get the current position of a motor
+	int32_t GetEndPoint(size_t drive) noexcept;					 	// Get the current position of a motor
 	float LiveCoordinate(unsigned int axisOrExtruder, const Tool *tool) noexcept; // Gives the last point at the end of the last complete DDA
 	void MoveAvailable() noexcept;											// Called from GCodes to tell the Move task that a move is available
 	bool WaitingForAllMovesFinished() noexcept;								// Tell the lookahead ring we are waiting for it to empty and return true if it is
@@ -96,6 +96,11 @@ public:
 
 	float GetMaxPrintingAcceleration() const noexcept { return maxPrintingAcceleration; }
 	float GetMaxTravelAcceleration() const noexcept { return maxTravelAcceleration; }
+	float GetAccelerationSmoothingTime() const noexcept { return accelerationSmoothingTime; }
+	uint32_t GetSmoothingClocks() const noexcept;										// Get the acceleration smoothing time in step clocks, or zero if acceleration smoothing is not in use
+
+	static constexpr uint32_t SmoothingClockUnit = 32;									// smoothing times are multiples of this number of step clocks
+	static constexpr uint32_t MaxSmoothingClocks = 2047 * SmoothingClockUnit;			// the longest smoothing time, limited by the field in the CAN movement message
 	InputShaper& GetShaper() noexcept { return shaper; }
 
 	void Diagnostics(MessageType mtype) noexcept;							// Report useful stuff
@@ -110,6 +115,7 @@ public:
 	void AdjustMotorPositions(const float adjustment[], size_t numMotors) noexcept;			// Perform motor endpoint adjustment
 	const char* GetGeometryString() const noexcept { return kinematics->GetName(true); }
 	bool IsAccessibleProbePoint(float axesCoords[MaxAxes], AxesBitmap axes) const noexcept;
+	bool CanUseNativeArc(size_t axis0, size_t axis1) const noexcept;						// Return true if we can execute an arc in the plane of these axes as a single move
 
 	// Temporary kinematics functions
 	bool IsDeltaMode() const noexcept { return kinematics->GetKinematicsType() == KinematicsType::linearDelta; }
@@ -167,6 +173,8 @@ public:
 
 	unsigned int GetJerkPolicy() const noexcept { return jerkPolicy; }
 	void SetJerkPolicy(unsigned int jp) noexcept { jerkPolicy = jp; }
+	float GetJunctionDeviation() const noexcept { return junctionDeviation; }
+	void SetJunctionDeviation(float jd) noexcept { junctionDeviation = jd; }
 
 #if HAS_SMART_DRIVERS
 	uint32_t GetStepInterval(size_t axis, uint32_t microstepShift) const noexcept;			// Get the current step interval for this axis or extruder
@@ -246,11 +254,16 @@ private:
 
 	float maxPrintingAcceleration;
 	float maxTravelAcceleration;
+	float accelerationSmoothingTime;					// The time in seconds over which acceleration changes are spread, or zero for trapezoidal acceleration
 
 	unsigned int jerkPolicy;							// When we allow jerk
+	float junctionDeviation;							// The junction deviation used to limit cornering speed between linear moves, or zero to use the jerk limits
 	unsigned int idleCount;								// The number of times Spin was called and had no new moves to process
 	uint32_t idleStartTime;								// the time when we started to idle
 	uint32_t longestGcodeWaitInterval;					// the longest we had to wait for a new GCode
+	uint32_t maxMeshTransformTime;						// the longest time in step clocks that transforming a move with mesh compensation took
+	uint32_t totalMeshTransformTime;					// the total time in step clocks spent transforming moves with mesh compensation
+	uint32_t numMeshTransforms;							// the number of moves transformed with mesh compensation
 
 	float tangents[3]; 									// Axis compensation - 90 degrees + angle gives angle between axes
 	float& tanXY = tangents[0];
@@ -299,7 +312,7 @@ inline void Move::GetCurrentMachinePosition(float m[MaxAxes], bool disableMotorM
 }
 
 // Get the current position of a motor
-inline int32_t Move::GetEndPoint(size_t drive) const noexcept
+inline int32_t Move::GetEndPoint(size_t drive) noexcept
 {
 	return mainDDARing.GetEndPoint(drive);
 }
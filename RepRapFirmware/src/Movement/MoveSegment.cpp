@@ -0,0 +1,59 @@
+/*
+ * MoveSegment.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#include "MoveSegment.h"
+
+// Static members
+
+MoveSegment *MoveSegment::freeList = nullptr;
+unsigned int MoveSegment::numCreated = 0;
+
+void MoveSegment::InitialAllocate(unsigned int num) noexcept
+{
+	while (num > numCreated)
+	{
+		freeList = new MoveSegment(freeList);
+		++numCreated;
+	}
+}
+
+// Allocate a MoveSegment, from the freelist if possible, else create a new one
+MoveSegment *MoveSegment::Allocate(MoveSegment *p_next) noexcept
+{
+	MoveSegment * seg = freeList;
+	if (seg != nullptr)
+	{
+		freeList = seg->next;
+		seg->next = p_next;
+	}
+	else
+	{
+		seg = new MoveSegment(p_next);
+		++numCreated;
+	}
+	return seg;
+}
+
+// Return a list of segments to the free list
+void MoveSegment::ReleaseAll(MoveSegment *item) noexcept
+{
+	while (item != nullptr)
+	{
+		MoveSegment * const itemNext = item->next;
+		item->next = freeList;
+		freeList = item;
+		item = itemNext;
+	}
+}
+
+void MoveSegment::DebugPrint() const noexcept
+{
+	debugPrintf("seg t=%.1f dur=%.1f s=%.4f u=%.4e a=%.4e\n",
+					(double)startTime, (double)duration, (double)startDistance, (double)startSpeed, (double)acceleration);
+}
+
+// End
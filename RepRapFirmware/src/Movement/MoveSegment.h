@@ -0,0 +1,70 @@
+/*
+ * MoveSegment.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  A MoveSegment describes a part of a move during which the acceleration is constant.
+ *  Moves that have input shaping applied are described by a linked list of these, which is shared by all the local DriveMovements of the DDA.
+ *  All values are in step clock units, and distances are measured along the move in the same units as DDA::totalDistance.
+ */
+
+#ifndef SRC_MOVEMENT_MOVESEGMENT_H_
+#define SRC_MOVEMENT_MOVESEGMENT_H_
+
+#include <RepRapFirmware.h>
+#include <Platform/Tasks.h>
+
+class MoveSegment
+{
+public:
+	MoveSegment(MoveSegment *p_next) noexcept : next(p_next) { }
+
+	void* operator new(size_t count) { return Tasks::AllocPermanent(count); }
+	void* operator new(size_t count, std::align_val_t align) { return Tasks::AllocPermanent(count, align); }
+	void operator delete(void* ptr) noexcept {}
+	void operator delete(void* ptr, std::align_val_t align) noexcept {}
+
+	MoveSegment *GetNext() const noexcept { return next; }
+	void SetNext(MoveSegment *p_next) noexcept { next = p_next; }
+
+	void SetParameters(float p_startTime, float p_duration, float p_startDistance, float p_startSpeed, float p_acceleration) noexcept;
+
+	float GetStartTime() const noexcept { return startTime; }
+	float GetDuration() const noexcept { return duration; }
+	float GetEndTime() const noexcept { return startTime + duration; }
+	float GetStartDistance() const noexcept { return startDistance; }
+	float GetStartSpeed() const noexcept { return startSpeed; }
+	float GetAcceleration() const noexcept { return acceleration; }
+	float GetEndSpeed() const noexcept { return startSpeed + acceleration * duration; }
+	float GetEndDistance() const noexcept { return startDistance + (startSpeed + 0.5 * acceleration * duration) * duration; }
+
+	void DebugPrint() const noexcept;
+
+	static void InitialAllocate(unsigned int num) noexcept;
+	static unsigned int NumCreated() noexcept { return numCreated; }
+	static MoveSegment *Allocate(MoveSegment *p_next) noexcept;
+	static void ReleaseAll(MoveSegment *item) noexcept;
+
+private:
+	static MoveSegment *freeList;
+	static unsigned int numCreated;
+
+	MoveSegment *next;								// the next segment of this move, or nullptr if this is the last one
+	float startTime;								// the time at which this segment starts, in step clocks since the start of the move
+	float duration;									// how long this segment lasts, in step clocks
+	float startDistance;							// how far along the move we are at the start of this segment
+	float startSpeed;								// the speed at the start of this segment, in distance units per step clock
+	float acceleration;								// the acceleration during this segment, in distance units per step clock squared. Negative when decelerating.
+};
+
+inline void MoveSegment::SetParameters(float p_startTime, float p_duration, float p_startDistance, float p_startSpeed, float p_acceleration) noexcept
+{
+	startTime = p_startTime;
+	duration = p_duration;
+	startDistance = p_startDistance;
+	startSpeed = p_startSpeed;
+	acceleration = p_acceleration;
+}
+
+#endif /* SRC_MOVEMENT_MOVESEGMENT_H_ */
@@ -18,6 +18,7 @@ void RawMove::SetDefaults(size_t firstDriveToZero) noexcept
 	checkEndstops = false;
 	reduceAcceleration = false;
 	hasPositiveExtrusion = false;
+	isNativeArc = false;
 	filePos = noFilePosition;
 	tool = nullptr;
 	cosXyAngle = 1.0;
@@ -20,6 +20,8 @@ struct RawMove
 	FilePosition filePos;											// offset in the file being printed at the start of reading this move
 	float proportionDone;											// what proportion of the entire move has been done when this segment is complete
 	float cosXyAngle;												// the cosine of the change in XY angle between the previous move and this move
+	float arcCentreCoords[2];										// if this is a native arc move, the machine coordinates of the arc centre on the two arc axes
+	float arcAngle;													// if this is a native arc move, the angle that it turns through, positive if anticlockwise
 	const Tool *tool;												// which tool (if any) is being used
 #if SUPPORT_LASER || SUPPORT_IOBITS
 	LaserPwmOrIoBits laserPwmOrIoBits;								// the laser PWM or port bit settings required
@@ -36,6 +38,9 @@ struct RawMove
 			usingStandardFeedrate : 1,								// true if this move uses the standard feed rate
 			checkEndstops : 1,										// true if any endstops or the Z probe can terminate the move
 			reduceAcceleration : 1;									// true if Z probing so we should limit the Z acceleration
+	uint8_t isNativeArc;											// true if this is an arc move that the Move subsystem should execute as a single move
+	uint8_t arcAxes[2];												// if this is a native arc move, the two axes that the arc is in after axis mapping
+	uint8_t spare;
 	// If adding any more fields, keep the total size a multiple of 4 bytes so that we can use our optimised assignment operator
 
 	void SetDefaults(size_t firstDriveToZero) noexcept;				// set up default values
@@ -33,6 +33,12 @@ uint32_t StepTimer::maxInterval = 0;
 uint32_t StepTimer::lastTimerResult = 0;
 #endif
 
+#ifdef HOST_SIM
+// The simulation has no timer peripheral. The step clock is derived from the simulated time and the compare match is held here.
+static volatile bool hostCompareEnabled = false;
+static volatile uint32_t hostCompareTime;
+#endif
+
 #if SUPPORT_REMOTE_COMMANDS
 
 volatile uint32_t StepTimer::localTimeOffset = 0;
@@ -57,7 +63,9 @@ void StepTimer::Init() noexcept
 	// 1.067us resolution on the Duet WiFi/Ethernet/Maestro (120MHz clock)
 	// On Duet 3 we need a step clock rate that can be programmed on SAME70, SAME5x and SAMC21 processors. We choose 750kHz (1.333us resolution)
 
-#if SAME5x
+#if defined(HOST_SIM)
+	hostCompareEnabled = false;
+#elif SAME5x
 	// Step clock runs at 750KHz, same as other Duet 3 boards
 	EnableTcClock(StepTcNumber, GclkNum48MHz);
 	EnableTcClock(StepTcNumber + 1, GclkNum48MHz);
@@ -164,7 +172,9 @@ void StepTimer::Init() noexcept
 	// Get the current timer value into 'rslt'
 	// If we don't disable interrupts here then maxInterval ends up at -3. Presumably, this means we get an interrupt while we are within this code and the ISR calls it again.
 	const irqflags_t flags = IrqSave();
-# if SAME5x
+# if defined(HOST_SIM)
+	const uint32_t rslt = (uint32_t)((ullPortGetSimulatedTime() * (StepClockRate/1000))/1000000);
+# elif SAME5x
 	StepTc->CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
 	// On the SAME5x it isn't enough just to wait for SYNCBUSY.COUNT here, nor is it enough just to use a DSB instruction first
 	while (StepTc->CTRLBSET.bit.CMD != 0) { }
@@ -214,7 +224,10 @@ bool StepTimer::ScheduleTimerInterrupt(uint32_t tim) noexcept
 		return true;												// tell the caller to simulate an interrupt instead
 	}
 
-#if SAME5x
+#if defined(HOST_SIM)
+	hostCompareTime = tim;
+	hostCompareEnabled = true;
+#elif SAME5x
 	StepTc->CC[0].reg = tim;
 	while (StepTc->SYNCBUSY.reg & TC_SYNCBUSY_CC0) { }
 	StepTc->INTFLAG.reg = TC_INTFLAG_MC0;							// clear any existing compare match
@@ -234,7 +247,9 @@ bool StepTimer::ScheduleTimerInterrupt(uint32_t tim) noexcept
 // Make sure we get no timer interrupts
 void StepTimer::DisableTimerInterrupt() noexcept
 {
-#if SAME5x
+#if defined(HOST_SIM)
+	hostCompareEnabled = false;
+#elif SAME5x
 	StepTc->INTENCLR.reg = TC_INTFLAG_MC0;
 #elif defined(__LPC17xx__)
 	STEP_TC->MCR &= ~(1u<<SBIT_MR0I);								 // disable Int on MR1
@@ -410,6 +425,25 @@ void STEP_TC_HANDLER() noexcept
 	}
 }
 
+#ifdef HOST_SIM
+
+uint64_t StepTimer::HostServiceInterrupt(uint64_t now) noexcept
+{
+	while (hostCompareEnabled)
+	{
+		const int32_t diff = (int32_t)(hostCompareTime - GetTimerTicks());
+		if (diff > 0)
+		{
+			return now + ((uint64_t)diff * 1000000 + StepClockRate/1000 - 1)/(StepClockRate/1000);
+		}
+		hostCompareEnabled = false;
+		Interrupt();
+	}
+	return UINT64_MAX;
+}
+
+#endif
+
 StepTimer::StepTimer() noexcept : next(nullptr), callback(nullptr), active(false)
 {
 }
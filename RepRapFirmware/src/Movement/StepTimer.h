@@ -63,6 +63,11 @@ public:
 	// ISR called from StepTimer
 	static void Interrupt() noexcept;
 
+#ifdef HOST_SIM
+	// Run the step interrupt if it is due at simulated time 'now' (in nanoseconds). Return the simulated time at which it is next due, or UINT64_MAX.
+	static uint64_t HostServiceInterrupt(uint64_t now) noexcept;
+#endif
+
 #if SAME70 || SAME5x
 	// All Duet 3 boards use a common step clock rate of 750kHz so that we can sync the clocks over CAN
 	static constexpr uint32_t StepClockRate = 48000000/64;						// 750kHz
@@ -360,6 +360,8 @@ static inline uint8_t Reflect(uint8_t b) noexcept
 {
 #if SAMC21
 	return SlowReflect(b);
+#elif defined(HOST_SIM)
+	return __RBIT(b) >> 24;
 #else
 	uint32_t temp = b;
 	asm("rbit %0,%1" : "=r" (temp) : "r" (temp));
@@ -23,6 +23,7 @@ const char serviceUnavailableResponse[] = "HTTP/1.1 503 Service Unavailable\r\n\
 static_assert(ARRAY_SIZE(serviceUnavailableResponse) <= OUTPUT_BUFFER_SIZE, "OUTPUT_BUFFER_SIZE too small");
 
 const uint32_t HttpReceiveTimeout = 2000;
+const size_t MaxModelWaiters = NumHttpResponders - 1;		// how many responders may hold rr_model requests, leaving at least one free to serve other requests
 
 // Text for a human-readable 404 page
 const char* const ErrorPagePart1 =
@@ -56,6 +57,7 @@ bool HttpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		numQualKeys = 0;
 		numHeaderKeys = 0;
 		commandWords[0] = clientMessage;
+		modelWaitDone = false;
 
 		if (reprap.Debug(moduleWebserver))
 		{
@@ -112,6 +114,28 @@ bool HttpResponder::Spin() noexcept
 		(void)SendFileInfo(millis() - startedProcessingRequestAt >= MaxFileInfoGetTime);
 		return true;
 
+#if SUPPORT_OBJECT_MODEL
+	case ResponderState::waitingForModelChange:
+		if (!skt->CanRead())
+		{
+			ConnectionLost();						// the client has given up waiting
+			return true;
+		}
+		{
+			const bool changed = reprap.GetModelChangeSeq() != modelWaitSeq;
+			if (changed || millis() - startedProcessingRequestAt >= modelWaitTime)
+			{
+				// Process the request again, this time without waiting
+				--numModelWaiters;
+				++((changed) ? modelWaitsChanged : modelWaitsTimedOut);
+				modelWaitDone = true;
+				responderState = ResponderState::processingRequest;
+				return true;
+			}
+		}
+		return false;
+#endif
+
 #if HAS_MASS_STORAGE
 	case ResponderState::uploading:
 		DoUpload();
@@ -622,6 +646,23 @@ bool HttpResponder::GetJsonResponse(const char* request, OutputBuffer *&response
 		OutputBuffer::ReleaseAll(response);
 		const char *const filterVal = GetKeyValue("key");
 		const char *const flagsVal = GetKeyValue("flags");
+		const char *const waitVal = GetKeyValue("wait");
+		const char *const changesSince = (flagsVal == nullptr) ? nullptr : strchr(flagsVal, 'c');
+		if (waitVal != nullptr && changesSince != nullptr && !modelWaitDone && numModelWaiters < MaxModelWaiters)
+		{
+			// The client wants only the changes since the sequence number it already has and is prepared to wait for them.
+			// If nothing has changed yet then hold the request until something does or we time out.
+			const uint32_t seq = StrToU32(changesSince + 1);
+			if (seq == reprap.GetModelChangeSeq())
+			{
+				modelWaitSeq = seq;
+				modelWaitTime = min<uint32_t>(StrToU32(waitVal), MaxModelWaitTime);
+				++numModelWaiters;
+				responderState = ResponderState::waitingForModelChange;
+				return false;
+			}
+		}
+		modelWaitDone = false;
 		response = reprap.GetModelResponse(filterVal, flagsVal);
 	}
 #endif
@@ -651,6 +692,19 @@ const char* HttpResponder::GetKeyValue(const char *key) const noexcept
 	return nullptr;
 }
 
+// Return the value of the specified header, or nullptr if not present
+const char* HttpResponder::GetHeaderValue(const char *key) const noexcept
+{
+	for (size_t i = 0; i < numHeaderKeys; ++i)
+	{
+		if (StringEqualsIgnoreCase(headers[i].key, key))
+		{
+			return headers[i].value;
+		}
+	}
+	return nullptr;
+}
+
 // Called to process a FileInfo request, which may take several calls
 // Return true if complete
 bool HttpResponder::SendFileInfo(bool quitEarly) noexcept
@@ -757,6 +811,7 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 #if HAS_MASS_STORAGE
 	FileStore *fileToSend = nullptr;
 	bool zip = false;
+	time_t lastModified = 0;
 
 	if (isWebFile)
 	{
@@ -785,40 +840,91 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 		}
 		else
 		{
-			for (;;)
+			// See if we have looked up this file before. If so then we may not need to access the SD card at all.
+			WebFileCacheEntry * const entry = FindCachedWebFile(nameOfFileToSend);
+			if (entry != nullptr)
 			{
-				// Try to open a gzipped version of the file first
-				if (!StringEndsWithIgnoreCase(nameOfFileToSend, ".gz") && strlen(nameOfFileToSend) + 3 <= MaxFilenameLength)
+				if (IsNotModified(entry->lastModified, entry->length, entry->zip))
 				{
-					String<MaxFilenameLength> nameBuf;
-					nameBuf.copy(nameOfFileToSend);
-					nameBuf.cat(".gz");
-					fileToSend = GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameBuf.c_str(), OpenMode::read);
-					if (fileToSend != nullptr)
-					{
-						zip = true;
-						break;
-					}
+					++notModifiedResponses;
+					SendNotModified(entry->lastModified, entry->length, entry->zip);
+					return;
 				}
 
-				// That failed, so try to open the normal version of the file
-				fileToSend = GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameOfFileToSend, OpenMode::read);
-				if (fileToSend != nullptr)
+				if (entry->source != WebFileSource::requested)
 				{
-					break;
+					nameOfFileToSend = (entry->source == WebFileSource::index) ? INDEX_PAGE_FILE : OLD_INDEX_PAGE_FILE;
 				}
-
-				if (StringEqualsIgnoreCase(nameOfFileToSend, INDEX_PAGE_FILE))
+				zip = entry->zip;
+				lastModified = entry->lastModified;
+				fileToSend = OpenWebFile(nameOfFileToSend, zip);
+				if (fileToSend == nullptr)
 				{
-					nameOfFileToSend = OLD_INDEX_PAGE_FILE;			// the index file wasn't found, so try the old one
+					entry->requestedName.Clear();							// the file has gone, so search for it again
 				}
-				else if (!strchr(nameOfFileToSend, '.'))			// if we were asked to return a file without a '.' in the name, return the index page
+			}
+
+			if (fileToSend == nullptr)
+			{
+				const char * const requestedName = nameOfFileToSend;
+				zip = false;
+				for (;;)
 				{
-					nameOfFileToSend = INDEX_PAGE_FILE;
+					// Try to open a gzipped version of the file first
+					if (!StringEndsWithIgnoreCase(nameOfFileToSend, ".gz") && strlen(nameOfFileToSend) + 3 <= MaxFilenameLength)
+					{
+						fileToSend = OpenWebFile(nameOfFileToSend, true);
+						if (fileToSend != nullptr)
+						{
+							zip = true;
+							break;
+						}
+					}
+
+					// That failed, so try to open the normal version of the file
+					fileToSend = OpenWebFile(nameOfFileToSend, false);
+					if (fileToSend != nullptr)
+					{
+						break;
+					}
+
+					if (StringEqualsIgnoreCase(nameOfFileToSend, INDEX_PAGE_FILE))
+					{
+						nameOfFileToSend = OLD_INDEX_PAGE_FILE;			// the index file wasn't found, so try the old one
+					}
+					else if (!strchr(nameOfFileToSend, '.'))			// if we were asked to return a file without a '.' in the name, return the index page
+					{
+						nameOfFileToSend = INDEX_PAGE_FILE;
+					}
+					else
+					{
+						break;
+					}
 				}
-				else
+
+				if (fileToSend != nullptr)
 				{
-					break;
+					// Remember where we found the file and when it was last modified, so that we can validate the client's copy next time without searching again
+					String<MaxFilenameLength> path;
+					if (MassStorage::CombineName(path.GetRef(), GetPlatform().GetWebDir(), nameOfFileToSend))
+					{
+						if (zip)
+						{
+							path.cat(".gz");								// there is room because we checked the length of the name before opening the file
+						}
+						lastModified = MassStorage::GetLastModifiedTime(path.c_str());
+					}
+					const WebFileSource source = (nameOfFileToSend == requestedName) ? WebFileSource::requested
+												: StringEqualsIgnoreCase(nameOfFileToSend, INDEX_PAGE_FILE) ? WebFileSource::index
+													: WebFileSource::oldIndex;
+					CacheWebFile(requestedName, source, zip, lastModified, fileToSend->Length());
+					if (IsNotModified(lastModified, fileToSend->Length(), zip))
+					{
+						++notModifiedResponses;
+						SendNotModified(lastModified, fileToSend->Length(), zip);
+						fileToSend->Close();
+						return;
+					}
 				}
 			}
 		}
@@ -858,6 +964,11 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 					);
 		AddCorsHeader();
 	}
+	else if (lastModified != 0)
+	{
+		// Let the client cache web files, but make it check with us that its copy is still current before using it
+		AddValidators(lastModified, fileToSend->Length(), zip);
+	}
 
 	const char* contentType;
 	if (StringEndsWithIgnoreCase(nameOfFileToSend, ".png"))
@@ -908,6 +1019,151 @@ void HttpResponder::SendFile(const char* nameOfFileToSend, bool isWebFile) noexc
 #endif
 }
 
+#if HAS_MASS_STORAGE
+
+// Open a file in the web directory, optionally adding the .gz extension to its name
+FileStore *HttpResponder::OpenWebFile(const char *name, bool zip) noexcept
+{
+	if (!zip)
+	{
+		return GetPlatform().OpenFile(GetPlatform().GetWebDir(), name, OpenMode::read);
+	}
+
+	String<MaxFilenameLength> nameBuf;
+	nameBuf.copy(name);
+	nameBuf.cat(".gz");
+	return GetPlatform().OpenFile(GetPlatform().GetWebDir(), nameBuf.c_str(), OpenMode::read);
+}
+
+// Return true if the request was conditional and the client's copy of the file is still current.
+// If-Modified-Since is ignored when If-None-Match is present. We only accept an If-Modified-Since date that matches the Last-Modified date we sent,
+// because that is what browsers send back to us; if the client sends a different date then we just send the file again.
+bool HttpResponder::IsNotModified(time_t lastModified, FilePosition length, bool zip) const noexcept
+{
+	if (lastModified == 0)
+	{
+		return false;
+	}
+
+	const char * const ifNoneMatch = GetHeaderValue("If-None-Match");
+	if (ifNoneMatch != nullptr)
+	{
+		String<StringLength50> eTag;
+		GetETag(eTag.GetRef(), lastModified, length, zip);
+		return strstr(ifNoneMatch, eTag.c_str()) != nullptr || StringEqualsIgnoreCase(ifNoneMatch, "*");
+	}
+
+	const char * const ifModifiedSince = GetHeaderValue("If-Modified-Since");
+	if (ifModifiedSince != nullptr)
+	{
+		String<StringLength50> date;
+		GetHttpDate(date.GetRef(), lastModified);
+		return StringEqualsIgnoreCase(ifModifiedSince, date.c_str());
+	}
+	return false;
+}
+
+// Add the headers that let the client check whether its cached copy of a web file is current
+void HttpResponder::AddValidators(time_t lastModified, FilePosition length, bool zip) noexcept
+{
+	String<StringLength50> str;
+	GetETag(str.GetRef(), lastModified, length, zip);
+	outBuf->catf("ETag: %s\r\n", str.c_str());
+	GetHttpDate(str.GetRef(), lastModified);
+	outBuf->catf("Last-Modified: %s\r\n"
+				 "Cache-Control: no-cache\r\n", str.c_str());
+}
+
+// Tell the client that its cached copy of a web file is still current
+void HttpResponder::SendNotModified(time_t lastModified, FilePosition length, bool zip) noexcept
+{
+	if (reprap.Debug(moduleWebserver))
+	{
+		GetPlatform().Message(UsbMessage, "Webserver: sending 304 Not Modified\n");
+	}
+
+	outBuf->copy("HTTP/1.1 304 Not Modified\r\n");
+	AddValidators(lastModified, length, zip);
+	outBuf->cat("Connection: close\r\n\r\n");
+	Commit();
+}
+
+// Look for a web file in the cache, returning the entry if we find it
+/*static*/ HttpResponder::WebFileCacheEntry *HttpResponder::FindCachedWebFile(const char *name) noexcept
+{
+	// If any file on the volume holding the web files has changed since we last looked, or the card has been remounted, forget everything
+	const uint16_t seq = MassStorage::GetVolumeSeq(0);
+	if (seq != webFileCacheVolumeSeq)
+	{
+		webFileCacheVolumeSeq = seq;
+		for (WebFileCacheEntry& e : webFileCache)
+		{
+			e.requestedName.Clear();
+		}
+	}
+
+	for (WebFileCacheEntry& e : webFileCache)
+	{
+		if (!e.requestedName.IsEmpty() && e.requestedName.EqualsIgnoreCase(name))
+		{
+			e.lastUsed = ++webFileCacheUseCount;
+			++webFileCacheHits;
+			return &e;
+		}
+	}
+	++webFileCacheMisses;
+	return nullptr;
+}
+
+// Remember the result of looking up a web file, replacing the least recently used entry
+/*static*/ void HttpResponder::CacheWebFile(const char *name, WebFileSource source, bool zip, time_t lastModified, FilePosition length) noexcept
+{
+	if (lastModified == 0 || strlen(name) > MaxCachedWebFileNameLength)
+	{
+		return;
+	}
+
+	WebFileCacheEntry *victim = &webFileCache[0];
+	for (WebFileCacheEntry& e : webFileCache)
+	{
+		if (e.requestedName.IsEmpty())
+		{
+			victim = &e;
+			break;
+		}
+		if (e.lastUsed < victim->lastUsed)
+		{
+			victim = &e;
+		}
+	}
+
+	victim->requestedName.copy(name);
+	victim->source = source;
+	victim->zip = zip;
+	victim->lastModified = lastModified;
+	victim->length = length;
+	victim->lastUsed = ++webFileCacheUseCount;
+}
+
+// Make an entity tag for a web file. We don't have a hash of the contents, so we use the modification time and length.
+/*static*/ void HttpResponder::GetETag(const StringRef& str, time_t lastModified, FilePosition length, bool zip) noexcept
+{
+	str.printf("\"%" PRIx32 "-%" PRIx32 "%s\"", (uint32_t)lastModified, (uint32_t)length, (zip) ? "z" : "");
+}
+
+// Format a date in the form used in HTTP headers, e.g. "Sun, 17 Oct 2021 09:30:00 GMT"
+/*static*/ void HttpResponder::GetHttpDate(const StringRef& str, time_t t) noexcept
+{
+	static const char * const dayNames[7] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+	tm timeInfo;
+	gmtime_r(&t, &timeInfo);
+	str.printf("%s, %02d %s %04d %02d:%02d:%02d GMT",
+				dayNames[timeInfo.tm_wday], timeInfo.tm_mday, MassStorage::GetMonthName(timeInfo.tm_mon + 1), timeInfo.tm_year + 1900,
+				timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
+}
+
+#endif
+
 void HttpResponder::SendGCodeReply() noexcept
 {
 	{
@@ -1344,6 +1600,16 @@ void HttpResponder::Terminate(NetworkProtocol protocol, NetworkInterface *interf
 	}
 }
 
+// This overrides the version in class UploadingNetworkResponder
+void HttpResponder::ConnectionLost() noexcept
+{
+	if (responderState == ResponderState::waitingForModelChange)
+	{
+		--numModelWaiters;
+	}
+	UploadingNetworkResponder::ConnectionLost();
+}
+
 // This overrides the version in class NetworkResponder
 void HttpResponder::CancelUpload() noexcept
 {
@@ -1499,6 +1765,14 @@ void HttpResponder::Diagnostics(MessageType mt) const noexcept
 /*static*/ void HttpResponder::CommonDiagnostics(MessageType mtype) noexcept
 {
 	GetPlatform().MessageF(mtype, "HTTP sessions: %u of %u\n", numSessions, MaxHttpSessions);
+#if SUPPORT_OBJECT_MODEL
+	GetPlatform().MessageF(mtype, "Model requests waiting %u, completed by change %u, timed out %u\n", numModelWaiters, modelWaitsChanged, modelWaitsTimedOut);
+	modelWaitsChanged = modelWaitsTimedOut = 0;
+#endif
+#if HAS_MASS_STORAGE
+	GetPlatform().MessageF(mtype, "Web file cache hits %u, misses %u, not modified responses %u\n", webFileCacheHits, webFileCacheMisses, notModifiedResponses);
+	webFileCacheHits = webFileCacheMisses = notModifiedResponses = 0;
+#endif
 }
 
 void HttpResponder::AddCorsHeader() noexcept
@@ -1514,11 +1788,23 @@ void HttpResponder::AddCorsHeader() noexcept
 HttpResponder::HttpSession HttpResponder::sessions[MaxHttpSessions];
 unsigned int HttpResponder::numSessions = 0;
 unsigned int HttpResponder::clientsServed = 0;
+unsigned int HttpResponder::numModelWaiters = 0;
+unsigned int HttpResponder::modelWaitsChanged = 0;
+unsigned int HttpResponder::modelWaitsTimedOut = 0;
 
 volatile uint16_t HttpResponder::seq = 0;
 volatile OutputStack HttpResponder::gcodeReply;
 Mutex HttpResponder::gcodeReplyMutex;
 
+#if HAS_MASS_STORAGE
+HttpResponder::WebFileCacheEntry HttpResponder::webFileCache[NumWebFileCacheEntries];
+uint32_t HttpResponder::webFileCacheUseCount = 0;
+uint16_t HttpResponder::webFileCacheVolumeSeq = 0;
+unsigned int HttpResponder::webFileCacheHits = 0;
+unsigned int HttpResponder::webFileCacheMisses = 0;
+unsigned int HttpResponder::notModifiedResponses = 0;
+#endif
+
 #endif // SUPPORT_HTTP
 
 // End
@@ -28,6 +28,7 @@ public:
 	static void CommonDiagnostics(MessageType mtype) noexcept;
 
 protected:
+	void ConnectionLost() noexcept override;
 	void CancelUpload() noexcept override;
 	void SendData() noexcept override;
 
@@ -44,6 +45,13 @@ private:
 	static const uint32_t HttpSessionTimeout = 8000;	// HTTP session timeout in milliseconds
 	static const uint32_t MaxFileInfoGetTime = 2000;	// maximum length of time we spend getting file info, to avoid the client timing out (actual time will be a little longer than this)
 	static const uint32_t MaxBufferWaitTime = 1000;		// maximum length of time we spend waiting for a buffer before we discard gcodeReply buffers
+	static const uint32_t MaxModelWaitTime = 5000;		// maximum length of time we hold a rr_model request waiting for a change, must be less than HttpSessionTimeout
+#ifdef __LPC17xx__
+	static const size_t NumWebFileCacheEntries = 4;		// number of web file lookups we remember
+#else
+	static const size_t NumWebFileCacheEntries = 16;	// number of web file lookups we remember
+#endif
+	static const size_t MaxCachedWebFileNameLength = 63;	// requests for web files with longer names than this are not cached. DWC uses much shorter names.
 
 	enum class HttpParseState
 	{
@@ -76,6 +84,27 @@ private:
 		uint16_t postPort;
 	};
 
+#if HAS_MASS_STORAGE
+	// Which file we served in response to a request for a web file
+	enum class WebFileSource : uint8_t
+	{
+		requested,					// the file that was asked for
+		index,						// the index page, because the file asked for had no extension and didn't exist
+		oldIndex					// the old index page, because the index page didn't exist
+	};
+
+	// The result of looking up a web file on the SD card, so that we don't need to do it again when a browser reloads the page
+	struct WebFileCacheEntry
+	{
+		String<MaxCachedWebFileNameLength> requestedName;	// the name the client asked for, without the leading '/'. Empty if the entry is unused.
+		time_t lastModified;
+		FilePosition length;
+		uint32_t lastUsed;
+		WebFileSource source;
+		bool zip;
+	};
+#endif
+
 	bool Authenticate() noexcept;
 	bool CheckAuthenticated() noexcept;
 	bool RemoveAuthentication() noexcept;
@@ -93,9 +122,19 @@ private:
 
 #if HAS_MASS_STORAGE
 	void DoUpload() noexcept;
+	FileStore *OpenWebFile(const char *name, bool zip) noexcept;
+	bool IsNotModified(time_t lastModified, FilePosition length, bool zip) const noexcept;
+	void AddValidators(time_t lastModified, FilePosition length, bool zip) noexcept;
+	void SendNotModified(time_t lastModified, FilePosition length, bool zip) noexcept;
+
+	static WebFileCacheEntry *FindCachedWebFile(const char *name) noexcept;
+	static void CacheWebFile(const char *name, WebFileSource source, bool zip, time_t lastModified, FilePosition length) noexcept;
+	static void GetETag(const StringRef& str, time_t lastModified, FilePosition length, bool zip) noexcept;
+	static void GetHttpDate(const StringRef& str, time_t t) noexcept;
 #endif
 
 	const char* GetKeyValue(const char *key) const noexcept;	// return the value of the specified key, or nullptr if not present
+	const char* GetHeaderValue(const char *key) const noexcept;	// return the value of the specified header, or nullptr if not present
 
 	static void RemoveSession(size_t sessionToRemove) noexcept;
 
@@ -123,15 +162,30 @@ private:
 	time_t fileLastModified;
 	bool postFileGotCrc;
 
+	// rr_model requests that wait for the object model to change
+	uint32_t modelWaitSeq;							// the change sequence number the client already has
+	uint32_t modelWaitTime;							// how long to wait for it to change
+	bool modelWaitDone;								// true if we have finished waiting and are now processing the request again
+
 	// Keeping track of HTTP sessions
 	static HttpSession sessions[MaxHttpSessions];
 	static unsigned int numSessions;
 	static unsigned int clientsServed;
+	static unsigned int numModelWaiters;			// how many responders are holding rr_model requests
+	static unsigned int modelWaitsChanged, modelWaitsTimedOut;
 
 	// Responses from GCodes class
 	static volatile uint16_t seq;					// Sequence number for G-Code replies
 	static volatile OutputStack gcodeReply;
 	static Mutex gcodeReplyMutex;
+
+#if HAS_MASS_STORAGE
+	// Cache of web file lookups. It is only accessed by the Network task, so it doesn't need a mutex.
+	static WebFileCacheEntry webFileCache[NumWebFileCacheEntries];
+	static uint32_t webFileCacheUseCount;
+	static uint16_t webFileCacheVolumeSeq;			// the sequence number of the volume holding the web files when we last checked the cache
+	static unsigned int webFileCacheHits, webFileCacheMisses, notModifiedResponses;
+#endif
 };
 
 #endif /* SRC_NETWORKING_HTTPRESPONDER_H_ */
@@ -36,6 +36,20 @@ void NetworkResponder::Commit(ResponderState nextState, bool report) noexcept
 	}
 }
 
+// This is called when the socket didn't accept any of the data we tried to send. Check whether the connection has been closed.
+void NetworkResponder::SendFailed() noexcept
+{
+	if (!skt->CanSend())
+	{
+		// The connection has been lost or the other end has closed it
+		if (reprap.Debug(moduleWebserver))
+		{
+			debugPrintf("Can't send anymore\n");
+		}
+		ConnectionLost();
+	}
+}
+
 // Send our data.
 // We send outBuf first, then outStack, and finally fileBeingSent.
 void NetworkResponder::SendData() noexcept
@@ -61,19 +75,11 @@ void NetworkResponder::SendData() noexcept
 			const size_t sent = skt->Send(reinterpret_cast<const uint8_t *>(outBuf->UnreadData()), bytesLeft);
 			if (sent == 0)
 			{
-				// Check whether the connection has been closed
-				if (!skt->CanSend())
-				{
-					// The connection has been lost or the other end has closed it
-					if (reprap.Debug(moduleWebserver))
-					{
-						debugPrintf("Can't send anymore\n");
-					}
-					ConnectionLost();
-				}
+				SendFailed();
 				return;
 			}
 
+			OutputBuffer::RecordBytesSent(sent);
 			outBuf->Taken(sent);				// tell the output buffer how much data we have taken
 			if (sent < bytesLeft)
 			{
@@ -122,15 +128,7 @@ void NetworkResponder::SendData() noexcept
 			const size_t sent = skt->Send(fileBuffer->UnreadData(), remaining);
 			if (sent == 0)
 			{
-				// Check whether the connection has been closed
-				if (!skt->CanSend())
-				{
-					if (reprap.Debug(moduleWebserver))
-					{
-						debugPrintf("Can't send anymore\n");
-					}
-					ConnectionLost();
-				}
+				SendFailed();
 				return;
 			}
 
@@ -44,6 +44,7 @@ protected:
 		// HTTP responder additional states
 		processingRequest,
 		gettingFileInfo,								// getting file info
+		waitingForModelChange,							// holding a rr_model request until the object model changes
 
 		// FTP responder additional states
 		waitingForPasvPort,
@@ -60,6 +61,7 @@ protected:
 
 	void Commit(ResponderState nextState = ResponderState::free, bool report = true) noexcept;
 	virtual void SendData() noexcept;
+	void SendFailed() noexcept;
 	virtual void ConnectionLost() noexcept;
 
 	IPAddress GetRemoteIP() const noexcept;
@@ -60,10 +60,10 @@ void TelnetResponder::ConnectionLost() noexcept
 		{
 			numSessions--;
 		}
-		if (gcodeReply != nullptr && clientsServed > numSessions)
+		if (!gcodeReply.IsEmpty() && clientsServed > numSessions)
 		{
 			// Make sure the G-code reply is freed after it is sent to all clients
-			OutputBuffer::ReleaseAll(gcodeReply);
+			gcodeReply.ReleaseAll();
 			clientsServed = 0;
 		}
 	}
@@ -75,7 +75,7 @@ bool TelnetResponder::SendGCodeReply() noexcept
 {
 	MutexLocker lock(gcodeReplyMutex);
 
-	if (gcodeReply != nullptr)
+	if (!gcodeReply.IsEmpty())
 	{
 		bool clearReply = false;
 		clientsServed++;
@@ -83,7 +83,7 @@ bool TelnetResponder::SendGCodeReply() noexcept
 		{
 			// Yes - make sure the Network class doesn't discard its buffers yet
 			// NB: This must happen here, because NetworkTransaction::Write() might already release OutputBuffers
-			gcodeReply->IncreaseReferences(1);
+			gcodeReply.IncreaseReferences(1);
 		}
 		else
 		{
@@ -93,16 +93,16 @@ bool TelnetResponder::SendGCodeReply() noexcept
 
 		if (reprap.Debug(moduleWebserver))
 		{
-			GetPlatform().MessageF(UsbMessage, "Sending G-Code reply to Telnet client %d of %d (length %u)\n", clientsServed, numSessions, gcodeReply->DataLength());
+			GetPlatform().MessageF(UsbMessage, "Sending G-Code reply to Telnet client %d of %d (length %u)\n", clientsServed, numSessions, gcodeReply.DataLength());
 		}
 
-		// Send the whole G-Code reply as plain text to the client
-		outStack.Push(gcodeReply);
+		// Send the whole G-Code reply as plain text to the client. The line endings have already been converted, so all clients share the same buffers.
+		outStack.Append(gcodeReply);
 
 		// Possibly clean up the G-code reply once again
 		if (clearReply)
 		{
-			gcodeReply = nullptr;
+			gcodeReply.Clear();
 		}
 		return true;
 	}
@@ -304,7 +304,7 @@ void TelnetResponder::ProcessLine() noexcept
 
 	clientsServed = 0;
 	numSessions = 0;
-	OutputBuffer::ReleaseAll(gcodeReply);
+	gcodeReply.ReleaseAll();
 }
 
 /*static*/ void TelnetResponder::HandleGCodeReply(const char *reply) noexcept
@@ -313,28 +313,21 @@ void TelnetResponder::ProcessLine() noexcept
 	{
 		MutexLocker lock(gcodeReplyMutex);
 
-		// We need a valid OutputBuffer to start the conversion from NL to CRNL
-		if (gcodeReply == nullptr && !OutputBuffer::Allocate(gcodeReply))
+		// Add the reply to the last buffer if we can, because the stack of pending replies is short. We can't add it to a buffer that is shared with other responders.
+		OutputBuffer *buf = gcodeReply.GetLastItem();
+		if (buf == nullptr || buf->IsReferenced())
 		{
-			// No more space available to store this reply, stop here
-			return;
-		}
-
-		// Write entire content to new output buffers, but this time with \r\n instead of \n
-		while (*reply != 0)
-		{
-			if (*reply == '\n' && gcodeReply->cat('\r') == 0)
+			if (!OutputBuffer::Allocate(buf))
 			{
-				// No more space available, stop here
+				// No more space available to store this reply, stop here
 				return;
 			}
-			if (gcodeReply->cat(*reply) == 0)
+			if (!gcodeReply.Push(buf))
 			{
-				// No more space available, stop here
 				return;
 			}
-			reply++;
 		}
+		(void)CatConvertingLineEndings(buf, reply, strlen(reply));
 
 		// Send it to the clients
 		clientsServed = 0;
@@ -347,11 +340,12 @@ void TelnetResponder::ProcessLine() noexcept
 	{
 		MutexLocker lock(gcodeReplyMutex);
 
-		// We need a valid OutputBuffer to start the conversion from NL to CRNL
-		if (gcodeReply == nullptr && !OutputBuffer::Allocate(gcodeReply))
+		// Convert the line endings once, into buffers that all clients can share
+		OutputBuffer *buf;
+		if (!OutputBuffer::Allocate(buf))
 		{
 			OutputBuffer::Truncate(reply, OUTPUT_BUFFER_SIZE);
-			if (!OutputBuffer::Allocate(gcodeReply))
+			if (!OutputBuffer::Allocate(buf))
 			{
 				// If we're really short on memory, release the G-Code reply instantly
 				OutputBuffer::ReleaseAll(reply);
@@ -359,20 +353,12 @@ void TelnetResponder::ProcessLine() noexcept
 			}
 		}
 
-		// Write entire content to new output buffers, but this time with \r\n instead of \n
-		do {
-			const char *data = reply->Data();
-			for(size_t i = 0; i < reply->DataLength(); i++)
-			{
-				if (*data == '\n')
-				{
-					gcodeReply->cat('\r');
-				}
-				gcodeReply->cat(*data);
-				data++;
-			}
-			reply = OutputBuffer::Release(reply);
-		} while (reply != nullptr);
+		for (const OutputBuffer *item = reply; item != nullptr && CatConvertingLineEndings(buf, item->Data(), item->DataLength()); item = item->Next()) { }
+		OutputBuffer::ReleaseAll(reply);
+		if (!gcodeReply.Push(buf))
+		{
+			return;
+		}
 
 		// Send it to the clients
 		clientsServed = 0;
@@ -384,6 +370,33 @@ void TelnetResponder::ProcessLine() noexcept
 	}
 }
 
+// Append text to an output buffer, converting \n to \r\n as Telnet requires. We copy whole lines rather than single characters.
+// Return true if there was room for all of it.
+/*static*/ bool TelnetResponder::CatConvertingLineEndings(OutputBuffer *buf, const char *src, size_t len) noexcept
+{
+	while (len != 0)
+	{
+		const char * const lf = reinterpret_cast<const char *>(memchr(src, '\n', len));
+		if (lf == nullptr)
+		{
+			const size_t copied = buf->cat(src, len);
+			OutputBuffer::RecordBytesCopied(copied);
+			return copied == len;
+		}
+
+		const size_t lineLength = lf - src;
+		const size_t copied = buf->cat(src, lineLength);
+		OutputBuffer::RecordBytesCopied(copied);
+		if (copied < lineLength || buf->cat("\r\n", 2) < 2)
+		{
+			return false;
+		}
+		src = lf + 1;
+		len -= lineLength + 1;
+	}
+	return true;
+}
+
 void TelnetResponder::Diagnostics(MessageType mt) const noexcept
 {
 	GetPlatform().MessageF(mt, " Telnet(%d), %u sessions", (int)responderState, numSessions);
@@ -391,7 +404,7 @@ void TelnetResponder::Diagnostics(MessageType mt) const noexcept
 
 unsigned int TelnetResponder::numSessions = 0;
 unsigned int TelnetResponder::clientsServed = 0;
-OutputBuffer *TelnetResponder::gcodeReply = nullptr;
+volatile OutputStack TelnetResponder::gcodeReply;
 Mutex TelnetResponder::gcodeReplyMutex;
 
 #endif
@@ -30,6 +30,7 @@ private:
 	void ConnectionLost() noexcept override;
 
 	bool SendGCodeReply() noexcept;
+	static bool CatConvertingLineEndings(OutputBuffer *buf, const char *src, size_t len) noexcept;
 
 	bool haveCompleteLine;
 	char clientMessage[GCODE_LENGTH];
@@ -38,7 +39,7 @@ private:
 
 	static unsigned int numSessions;
 	static unsigned int clientsServed;
-	static OutputBuffer *gcodeReply;
+	static volatile OutputStack gcodeReply;
 	static Mutex gcodeReplyMutex;
 
 	static const uint32_t TelnetSetupDuration = 4000;	// ignore the first Telnet request within this duration (in ms)
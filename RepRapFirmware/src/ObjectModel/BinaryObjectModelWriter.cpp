@@ -0,0 +1,92 @@
+/*
+ * BinaryObjectModelWriter.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#include "BinaryObjectModelWriter.h"
+
+#if SUPPORT_BINARY_OBJECT_MODEL
+
+void BinaryObjectModelWriter::Start(OutputBuffer *p_buf) noexcept
+{
+	buf = p_buf;
+	initialLength = buf->Length();
+	numKeys = 0;
+	for (const char *& name : keyNames)
+	{
+		name = nullptr;
+	}
+}
+
+// Write the name of an object model table entry. Names in the tables are constant, so we can recognise them by their address.
+void BinaryObjectModelWriter::WriteKey(const char *name) noexcept
+{
+	size_t slot = (reinterpret_cast<uintptr_t>(name) >> 1) & (KeyTableSize - 1);
+	while (keyNames[slot] != nullptr)
+	{
+		if (keyNames[slot] == name)
+		{
+			WriteTag(BinaryObjectModelTag::key);
+			buf->cat((char)keyNumbers[slot]);
+			return;
+		}
+		slot = (slot + 1) & (KeyTableSize - 1);
+	}
+
+	if (numKeys < MaxNumberedKeys)
+	{
+		keyNames[slot] = name;
+		keyNumbers[slot] = (uint8_t)numKeys++;
+		WriteName(BinaryObjectModelTag::newKey, name);
+	}
+	else
+	{
+		WriteName(BinaryObjectModelTag::literalKey, name);
+	}
+}
+
+void BinaryObjectModelWriter::WriteLiteralKey(const char *name) noexcept
+{
+	WriteName(BinaryObjectModelTag::literalKey, name);
+}
+
+void BinaryObjectModelWriter::WriteName(BinaryObjectModelTag tag, const char *name) noexcept
+{
+	const size_t len = min<size_t>(strlen(name), 255);
+	WriteTag(tag);
+	buf->cat((char)len);
+	WriteBytes(name, len);
+}
+
+void BinaryObjectModelWriter::WriteFloat(float f, uint32_t digits) noexcept
+{
+	if (std::isnan(f) || std::isinf(f))
+	{
+		WriteTag(BinaryObjectModelTag::nullValue);							// same as the JSON report
+	}
+	else
+	{
+		WriteTag(BinaryObjectModelTag::float32);
+		buf->cat((char)digits);
+		WriteBytes(&f, sizeof(f));
+	}
+}
+
+// Write a string value. A null pointer is written as an empty string, as in the JSON report.
+void BinaryObjectModelWriter::WriteString(const char *s) noexcept
+{
+	if (s == nullptr)
+	{
+		s = "";
+	}
+	const uint16_t len = (uint16_t)min<size_t>(strlen(s), 65535);
+	WriteTag(BinaryObjectModelTag::string);
+	WriteBytes(&len, sizeof(len));
+	WriteBytes(s, len);
+}
+
+#endif
+
+// End
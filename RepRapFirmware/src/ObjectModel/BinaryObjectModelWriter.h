@@ -0,0 +1,55 @@
+/*
+ * BinaryObjectModelWriter.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  A BinaryObjectModelWriter encodes object model values into an OutputBuffer chain using the tags in LinuxMessageFormats.h.
+ *  Key names from the object model tables are numbered the first time they are sent in a response, so that arrays of objects only carry each key name once.
+ */
+
+#ifndef SRC_OBJECTMODEL_BINARYOBJECTMODELWRITER_H_
+#define SRC_OBJECTMODEL_BINARYOBJECTMODELWRITER_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_BINARY_OBJECT_MODEL
+
+#include <Linux/LinuxMessageFormats.h>
+#include <Platform/OutputMemory.h>
+
+class BinaryObjectModelWriter
+{
+public:
+	BinaryObjectModelWriter() noexcept : buf(nullptr), initialLength(0), numKeys(0) { }
+
+	void Start(OutputBuffer *p_buf) noexcept;							// start a new response, forgetting the key numbers we have sent
+	size_t Length() const noexcept { return buf->Length() - initialLength; }
+
+	void WriteTag(BinaryObjectModelTag tag) noexcept { buf->cat((char)tag); }
+	void WriteKey(const char *name) noexcept;							// write a key name that remains valid until the next call to Start
+	void WriteLiteralKey(const char *name) noexcept;					// write a key name that may be stored temporarily, e.g. a variable name
+	void WriteBool(bool b) noexcept { WriteTag((b) ? BinaryObjectModelTag::boolTrue : BinaryObjectModelTag::boolFalse); }
+	void WriteInt(int32_t i) noexcept { WriteTag(BinaryObjectModelTag::int32); WriteBytes(&i, sizeof(i)); }
+	void WriteUInt(uint32_t u) noexcept { WriteTag(BinaryObjectModelTag::uint32); WriteBytes(&u, sizeof(u)); }
+	void WriteUInt64(uint64_t u) noexcept { WriteTag(BinaryObjectModelTag::uint64); WriteBytes(&u, sizeof(u)); }
+	void WriteFloat(float f, uint32_t digits) noexcept;
+	void WriteString(const char *s) noexcept;
+
+private:
+	static constexpr size_t KeyTableSize = 128;							// must be a power of 2
+	static constexpr unsigned int MaxNumberedKeys = 96;					// keep the hash table no more than 75% full
+
+	void WriteBytes(const void *p, size_t len) noexcept { buf->cat(reinterpret_cast<const char *>(p), len); }
+	void WriteName(BinaryObjectModelTag tag, const char *name) noexcept;
+
+	OutputBuffer *buf;
+	size_t initialLength;
+	unsigned int numKeys;
+	const char *keyNames[KeyTableSize];									// hash table of the key names we have numbered, indexed by their address
+	uint8_t keyNumbers[KeyTableSize];
+};
+
+#endif
+
+#endif /* SRC_OBJECTMODEL_BINARYOBJECTMODELWRITER_H_ */
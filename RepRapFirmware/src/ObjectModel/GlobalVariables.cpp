@@ -7,6 +7,7 @@
 
 #include "GlobalVariables.h"
 #include <Platform/OutputMemory.h>
+#include "BinaryObjectModelWriter.h"
 
 // This function is not used in this class
 const ObjectModelClassDescriptor *GlobalVariables::GetObjectModelClassDescriptor() const noexcept { return nullptr; }
@@ -35,6 +36,32 @@ void GlobalVariables::ReportAsJson(OutputBuffer *buf, ObjectExplorationContext&
 	buf->cat('}');
 }
 
+#if SUPPORT_BINARY_OBJECT_MODEL
+
+// Construct a binary representation of the global variables. As for JSON, we ignore any remaining key or flags and report all the variables.
+void GlobalVariables::ReportAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, uint8_t tableNumber, const char *filter) const noexcept
+		THROWS(GCodeException)
+{
+	writer.WriteTag(BinaryObjectModelTag::objectStart);
+	if (context.IncreaseDepth())
+	{
+		{
+			ReadLocker locker(lock);			// make sure that no other task modifies the list while we are traversing it
+			vars.IterateWhile([this, &writer, &context, classDescriptor](unsigned int index, const Variable& v) noexcept -> bool
+								{
+									writer.WriteLiteralKey(v.GetName().Ptr());		// variable names are not constant, so don't number them
+									ReportItemAsBinary(writer, context, classDescriptor, v.GetValue());
+									return true;
+								}
+							 );
+		}
+		context.DecreaseDepth();
+	}
+	writer.WriteTag(BinaryObjectModelTag::objectEnd);
+}
+
+#endif
+
 ReadLockedPointer<const VariableSet> GlobalVariables::GetForReading() noexcept
 {
 	ReadLocker locker(lock);
@@ -29,6 +29,10 @@ protected:
 	// This overrides the standard definition because the variable names are not fixed
 	void ReportAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, uint8_t tableNumber, const char *filter) const noexcept override
 			THROWS(GCodeException);
+#if SUPPORT_BINARY_OBJECT_MODEL
+	void ReportAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, uint8_t tableNumber, const char *filter) const noexcept override
+			THROWS(GCodeException);
+#endif
 
 private:
 	VariableSet vars;
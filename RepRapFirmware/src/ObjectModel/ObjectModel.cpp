@@ -16,6 +16,7 @@
 #include <General/SafeStrtod.h>
 #include <General/IP4String.h>
 #include <Hardware/ExceptionHandlers.h>
+#include "BinaryObjectModelWriter.h"
 
 namespace StackUsage
 {
@@ -267,9 +268,10 @@ ObjectModel::ObjectModel() noexcept
 
 // Constructor used when reporting the OM as JSON
 ObjectExplorationContext::ObjectExplorationContext(bool wal, const char *reportFlags, unsigned int initialMaxDepth, size_t initialBufferOffset) noexcept
-	: startMillis(millis()), initialBufOffset(initialBufferOffset), maxDepth(initialMaxDepth), currentDepth(0), startElement(0), nextElement(-1), numIndicesProvided(0), numIndicesCounted(0),
-	  line(-1), column(-1),
-	  shortForm(false), onlyLive(false), includeVerbose(false), wantArrayLength(wal), includeNulls(false), includeObsolete(false), obsoleteFieldQueried(false), wantExists(false)
+	: startMillis(millis()), initialBufOffset(initialBufferOffset), maxDepth(initialMaxDepth), currentDepth(0), startElement(0), nextElement(-1), changedSince(0),
+	  numIndicesProvided(0), numIndicesCounted(0), line(-1), column(-1),
+	  shortForm(false), onlyLive(false), includeVerbose(false), wantArrayLength(wal), includeNulls(false), includeObsolete(false), obsoleteFieldQueried(false), wantExists(false),
+	  changesOnly(false)
 {
 	while (true)
 	{
@@ -308,6 +310,19 @@ ObjectExplorationContext::ObjectExplorationContext(bool wal, const char *reportF
 				++reportFlags;
 			}
 			break;
+		case 'c':
+			// Top-level delta mode: report only the live values of top-level keys that have not changed since the client last received a change sequence number
+			changesOnly = true;
+			changedSince = 0;
+			while (isdigit(*reportFlags))
+			{
+				changedSince = (10 * changedSince) + (*reportFlags - '0');
+				++reportFlags;
+			}
+			break;
+		case 'b':
+			// The binary encoding was requested, which the caller handles
+			break;
 		case ' ':
 		case ',':
 			break;
@@ -320,9 +335,10 @@ ObjectExplorationContext::ObjectExplorationContext(bool wal, const char *reportF
 
 // Constructor when evaluating expressions
 ObjectExplorationContext::ObjectExplorationContext(bool wal, bool wex, int p_line, int p_col) noexcept
-	: startMillis(millis()), initialBufOffset(0), maxDepth(99), currentDepth(0), startElement(0), nextElement(-1), numIndicesProvided(0), numIndicesCounted(0),
-	  line(p_line), column(p_col),
-	  shortForm(false), onlyLive(false), includeVerbose(true), wantArrayLength(wal), includeNulls(false), includeObsolete(true), obsoleteFieldQueried(false), wantExists(wex)
+	: startMillis(millis()), initialBufOffset(0), maxDepth(99), currentDepth(0), startElement(0), nextElement(-1), changedSince(0),
+	  numIndicesProvided(0), numIndicesCounted(0), line(p_line), column(p_col),
+	  shortForm(false), onlyLive(false), includeVerbose(true), wantArrayLength(wal), includeNulls(false), includeObsolete(true), obsoleteFieldQueried(false), wantExists(wex),
+	  changesOnly(false)
 {
 }
 
@@ -364,7 +380,11 @@ GCodeException ObjectExplorationContext::ConstructParseException(const char *msg
 // Call this before making a recursive call, or before calling a function that needs a lot of stack from a recursive function
 void ObjectExplorationContext::CheckStack(uint32_t calledFunctionStackUsage) const THROWS(GCodeException)
 {
+#ifdef HOST_SIM
+	const char * const stackPtr = static_cast<const char*>(__builtin_frame_address(0));
+#else
 	register const char * stackPtr asm ("sp");
+#endif
 	const char *stackLimit = (const char*)TaskBase::GetCallerTaskHandle() + sizeof(TaskBase);
 	if (stackLimit + calledFunctionStackUsage + (StackUsage::Throw + StackUsage::Margin) < stackPtr)
 	{
@@ -407,6 +427,9 @@ void ObjectModel::ReportAsJson(OutputBuffer* buf, ObjectExplorationContext& cont
 				size_t numEntries = descriptor[tableNumber + 1];
 				while (numEntries != 0)
 				{
+					// If the client only wants changes and this top-level key hasn't changed, report just its live values
+					const bool unchanged = context.ReportingChangesOnly() && context.AtTopLevel() && !HasChangedSince(tbl->GetName(), context.GetChangedSince());
+					const bool wasOnlyLive = (unchanged) ? context.SetOnlyLive(true) : false;
 					if (tbl->Matches(filter, context))
 					{
 						if (tbl->ReportAsJson(buf, context, classDescriptor, this, filter, !added))
@@ -414,6 +437,10 @@ void ObjectModel::ReportAsJson(OutputBuffer* buf, ObjectExplorationContext& cont
 							added = true;
 						}
 					}
+					if (unchanged)
+					{
+						(void)context.SetOnlyLive(wasOnlyLive);
+					}
 					--numEntries;
 					++tbl;
 				}
@@ -449,11 +476,16 @@ void ObjectModel::ReportAsJson(OutputBuffer *buf, const char *filter, const char
 {
 	const unsigned int defaultMaxDepth = (wantArrayLength) ? 99 : (filter[0] == 0) ? 1 : 99;
 	ObjectExplorationContext context(wantArrayLength, reportFlags, defaultMaxDepth, buf->Length());
+	const uint32_t changeSeq = GetChangeSeq();					// get this first so that the client doesn't miss changes made while we are reporting
 	ReportAsJson(buf, context, nullptr, 0, filter);
 	if (context.GetNextElement() >= 0)
 	{
 		buf->catf(",\"next\":%d", context.GetNextElement());
 	}
+	if (context.ReportingChangesOnly())
+	{
+		buf->catf(",\"seq\":%" PRIu32, changeSeq);
+	}
 }
 
 // Function to report a value or object as JSON
@@ -776,6 +808,259 @@ void ObjectModel::ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext&
 	buf->cat(']');
 }
 
+#if SUPPORT_BINARY_OBJECT_MODEL
+
+// Return true if a query asked for the binary encoding and is simple enough for us to provide it
+/*static*/ bool ObjectModel::CanReportAsBinary(const char *filter, const char *reportFlags) noexcept
+{
+	return strchr(reportFlags, 'b') != nullptr && strpbrk(filter, ".[#*^") == nullptr;
+}
+
+// Construct a binary representation of those parts of the object model requested by the SBC. This version is called on the root of the tree.
+void ObjectModel::ReportAsBinary(BinaryObjectModelWriter& writer, const char *filter, const char *reportFlags) const THROWS(GCodeException)
+{
+	const unsigned int defaultMaxDepth = (filter[0] == 0) ? 1 : 99;
+	ObjectExplorationContext context(false, reportFlags, defaultMaxDepth, writer.Length());
+	const uint32_t changeSeq = GetChangeSeq();					// get this first so that the client doesn't miss changes made while we are reporting
+	ReportAsBinary(writer, context, nullptr, 0, filter);
+	if (context.GetNextElement() >= 0)
+	{
+		writer.WriteKey("next");
+		writer.WriteInt(context.GetNextElement());
+	}
+	if (context.ReportingChangesOnly())
+	{
+		writer.WriteKey("seq");
+		writer.WriteUInt(changeSeq);
+	}
+}
+
+// Report this object in binary. The filter is either empty or the name of a single key in this object.
+void ObjectModel::ReportAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor,
+									uint8_t tableNumber, const char *filter) const THROWS(GCodeException)
+{
+	if (context.IncreaseDepth())
+	{
+		bool added = false;
+		if (classDescriptor == nullptr)
+		{
+			classDescriptor = GetObjectModelClassDescriptor();
+		}
+
+		while (classDescriptor != nullptr)
+		{
+			const uint8_t * const descriptor = classDescriptor->omd;
+			if (tableNumber < descriptor[0])
+			{
+				const ObjectModelTableEntry *tbl = classDescriptor->omt;
+				for (size_t i = 0; i < tableNumber; ++i)
+				{
+					tbl += descriptor[i + 1];
+				}
+
+				size_t numEntries = descriptor[tableNumber + 1];
+				while (numEntries != 0)
+				{
+					// If the client only wants changes and this top-level key hasn't changed, report just its live values
+					const bool unchanged = context.ReportingChangesOnly() && context.AtTopLevel() && !HasChangedSince(tbl->GetName(), context.GetChangedSince());
+					const bool wasOnlyLive = (unchanged) ? context.SetOnlyLive(true) : false;
+					if (tbl->Matches(filter, context))
+					{
+						const ExpressionValue val = tbl->func(this, context);
+						if (val.GetType() != TypeCode::None || context.ShouldIncludeNulls())
+						{
+							if (*filter == 0)
+							{
+								if (!added)
+								{
+									writer.WriteTag(BinaryObjectModelTag::objectStart);
+								}
+								writer.WriteKey(tbl->GetName());
+							}
+							ReportItemAsBinary(writer, context, classDescriptor, val);
+							added = true;
+						}
+					}
+					if (unchanged)
+					{
+						(void)context.SetOnlyLive(wasOnlyLive);
+					}
+					--numEntries;
+					++tbl;
+				}
+			}
+			if (tableNumber != 0)
+			{
+				break;
+			}
+			classDescriptor = classDescriptor->parent;			// do parent table too
+		}
+
+		if (added)
+		{
+			if (*filter == 0)
+			{
+				writer.WriteTag(BinaryObjectModelTag::objectEnd);
+			}
+		}
+		else if (*filter == 0)
+		{
+			writer.WriteTag(BinaryObjectModelTag::objectStart);
+			writer.WriteTag(BinaryObjectModelTag::objectEnd);
+		}
+		else
+		{
+			writer.WriteTag(BinaryObjectModelTag::nullValue);
+		}
+		context.DecreaseDepth();
+	}
+	else
+	{
+		writer.WriteTag(BinaryObjectModelTag::objectStart);
+		writer.WriteTag(BinaryObjectModelTag::objectEnd);
+	}
+}
+
+// Report a value in binary. Values are encoded with the same types as in the JSON report, except that we don't convert them to text.
+// This function is recursive, so keep its stack usage low.
+void ObjectModel::ReportItemAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor,
+										const ExpressionValue& val) const THROWS(GCodeException)
+{
+	switch (val.GetType())
+	{
+	case TypeCode::ObjectModel:
+		if (val.omVal == nullptr)					// OM arrays may contain null entries
+		{
+			writer.WriteTag(BinaryObjectModelTag::nullValue);
+		}
+		else
+		{
+			val.omVal->ReportAsBinary(writer, context, (val.omVal == this) ? classDescriptor : nullptr, val.param, "");
+		}
+		break;
+
+	case TypeCode::Array:
+		ReportArrayAsBinary(writer, context, classDescriptor, val.omadVal);
+		break;
+
+	case TypeCode::Float:
+		writer.WriteFloat(val.fVal, val.param);
+		break;
+
+	case TypeCode::Uint32:
+	case TypeCode::Enum32:
+		writer.WriteUInt(val.uVal);
+		break;
+
+	case TypeCode::Uint64:
+		writer.WriteUInt64(((uint64_t)val.param << 32) | val.uVal);
+		break;
+
+	case TypeCode::Int32:
+		writer.WriteInt(val.iVal);
+		break;
+
+	case TypeCode::Bool:
+		writer.WriteBool(val.bVal);
+		break;
+
+	case TypeCode::CString:
+		writer.WriteString(val.sVal);
+		break;
+
+	case TypeCode::HeapString:
+		writer.WriteString(val.shVal.Get().Ptr());
+		break;
+
+	case TypeCode::Bitmap16:
+	case TypeCode::Bitmap32:
+		if (context.ShortFormReport())
+		{
+			writer.WriteUInt(val.uVal);
+		}
+		else
+		{
+			ReportBitmapAsBinaryArray(writer, val.uVal);
+		}
+		break;
+
+	case TypeCode::Bitmap64:
+		if (context.ShortFormReport())
+		{
+			writer.WriteUInt64(val.Get56BitValue());
+		}
+		else
+		{
+			ReportBitmapAsBinaryArray(writer, val.Get56BitValue());
+		}
+		break;
+
+	case TypeCode::Char:
+	case TypeCode::IPAddress:
+	case TypeCode::DateTime:
+	case TypeCode::DriverId:
+	case TypeCode::MacAddress:
+	case TypeCode::Special:
+#if SUPPORT_CAN_EXPANSION
+	case TypeCode::CanExpansionBoardDetails:
+#endif
+		ReportAsBinaryString(writer, val);
+		break;
+
+	case TypeCode::None:
+	default:
+		writer.WriteTag(BinaryObjectModelTag::nullValue);
+		break;
+	}
+}
+
+// Report an entire array in binary
+void ObjectModel::ReportArrayAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor,
+										const ObjectModelArrayDescriptor *omad) const THROWS(GCodeException)
+{
+	const bool isRootArray = (writer.Length() == context.GetInitialBufferOffset());	// it's a root array if we haven't started writing the result yet
+	ReadLocker lock(omad->lockPointer);
+
+	writer.WriteTag(BinaryObjectModelTag::arrayStart);
+	const size_t count = omad->GetNumElements(this, context);
+	const size_t startElement = (isRootArray) ? context.GetStartElement() : 0;
+	for (size_t i = startElement; i < count; ++i)
+	{
+		// Support retrieving just part of the array in case it is too large to write all of it to the buffer
+		if (i != startElement && isRootArray && writer.Length() >= (OUTPUT_BUFFER_SIZE * (OUTPUT_BUFFER_COUNT - RESERVED_OUTPUT_BUFFERS))/2)
+		{
+			context.SetNextElement(i);
+			break;
+		}
+		context.AddIndex(i);
+		const ExpressionValue element = omad->GetElement(this, context);
+		ReportItemAsBinary(writer, context, classDescriptor, element);
+		context.RemoveIndex();
+	}
+	if (isRootArray && context.GetNextElement() < 0)
+	{
+		context.SetNextElement(0);
+	}
+	writer.WriteTag(BinaryObjectModelTag::arrayEnd);
+}
+
+// Separate function to avoid the string being allocated on the stack frame of a recursive function
+void ObjectModel::ReportAsBinaryString(BinaryObjectModelWriter& writer, const ExpressionValue& val) noexcept
+{
+	String<MaxFilenameLength> rslt;
+	val.AppendAsString(rslt.GetRef());
+	writer.WriteString(rslt.c_str());
+}
+
+void ObjectModel::ReportBitmapAsBinaryArray(BinaryObjectModelWriter& writer, uint64_t bits) noexcept
+{
+	writer.WriteTag(BinaryObjectModelTag::arrayStart);
+	Bitmap<uint64_t>::MakeFromRaw(bits).Iterate([&writer](unsigned int bn, unsigned int count) noexcept { writer.WriteUInt(bn); });
+	writer.WriteTag(BinaryObjectModelTag::arrayEnd);
+}
+
+#endif
+
 // Find the requested entry
 const ObjectModelTableEntry* ObjectModel::FindObjectModelTableEntry(const ObjectModelClassDescriptor *classDescriptor, uint8_t tableNumber, const char* idString) const noexcept
 {
@@ -907,6 +1192,35 @@ decrease(strlen(idString))	// recursion variant
 	throw context.ConstructParseException("unknown value '%s'", idString);
 }
 
+// Find the table entry for the first element of an ID string in the main table of this object or its parent classes
+// On success, return the entry and set classDescriptor to the descriptor of the class whose table it was found in
+const ObjectModelTableEntry *ObjectModel::FindTopLevelEntry(const char *idString, const ObjectModelClassDescriptor *& classDescriptor) const noexcept
+{
+	for (classDescriptor = GetObjectModelClassDescriptor(); classDescriptor != nullptr; classDescriptor = classDescriptor->parent)
+	{
+		const ObjectModelTableEntry * const e = FindObjectModelTableEntry(classDescriptor, 0, idString);
+		if (e != nullptr)
+		{
+			return e;
+		}
+	}
+	return nullptr;
+}
+
+// Get the value of an object given the table entry that matches the first element of idString
+// This is a copy of the code in GetObjectValue above, which we don't call from there to avoid increasing the stack usage of the recursive path
+ExpressionValue ObjectModel::GetObjectValueUsingEntry(ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelTableEntry *e, const char *idString) const THROWS(GCodeException)
+{
+	if (e->IsObsolete())
+	{
+		context.SetObsoleteFieldQueried();
+	}
+	idString = GetNextElement(idString);
+	const ExpressionValue val = e->func(this, context);
+	context.CheckStack(StackUsage::GetObjectValue_noTable);
+	return GetObjectValue(context, classDescriptor, val, idString);
+}
+
 ExpressionValue ObjectModel::GetObjectValue(ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ExpressionValue& val, const char *idString) const THROWS(GCodeException)
 decrease(strlen(idString))	// recursion variant
 {
@@ -97,7 +97,7 @@ struct ExpressionValue
 		const ObjectModel *omVal;					// object of some class derived form ObjectModel
 		const ObjectModelArrayDescriptor *omadVal;
 		StringHandle shVal;
-		uint32_t whole;								// a member we can use to copy the whole thing safely, at least as big as all the others. Assumes all other members are trivially copyable.
+		uintptr_t whole;							// a member we can use to copy the whole thing safely, at least as big as all the others. Assumes all other members are trivially copyable.
 	};
 
 	static_assert(sizeof(whole) >= sizeof(shVal));
@@ -213,6 +213,10 @@ public:
 	bool WantArrayLength() const noexcept { return wantArrayLength; }
 	bool WantExists() const noexcept { return wantExists; }
 	bool ShouldIncludeNulls() const noexcept { return includeNulls; }
+	bool ReportingChangesOnly() const noexcept { return changesOnly; }
+	uint32_t GetChangedSince() const noexcept { return changedSince; }
+	bool AtTopLevel() const noexcept { return currentDepth == 1; }
+	bool SetOnlyLive(bool b) noexcept { const bool ret = onlyLive; onlyLive = b; return ret; }
 	uint64_t GetStartMillis() const { return startMillis; }
 	size_t GetInitialBufferOffset() const noexcept { return initialBufOffset; }
 
@@ -232,6 +236,7 @@ private:
 	unsigned int currentDepth;
 	unsigned int startElement;
 	int nextElement;
+	uint32_t changedSince;							// in top-level delta mode, the change sequence number that the client has already seen
 	size_t numIndicesProvided;						// the number of indices provided, when we are doing a value lookup
 	size_t numIndicesCounted;						// the number of indices passed in the search string
 	int32_t indices[MaxIndices];
@@ -244,7 +249,8 @@ private:
 				includeNulls : 1,
 				includeObsolete : 1,
 				obsoleteFieldQueried : 1,
-				wantExists : 1;
+				wantExists : 1,
+				changesOnly : 1;
 };
 
 // Entry to describe an array of objects or values. These must be brace-initializable into flash memory.
@@ -257,6 +263,7 @@ public:
 };
 
 struct ObjectModelClassDescriptor;
+class BinaryObjectModelWriter;
 
 // Class from which other classes that represent part of the object model are derived
 class ObjectModel
@@ -271,6 +278,12 @@ public:
 	// Get the value of an object via the table
 	ExpressionValue GetObjectValue(ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, const char *idString, uint8_t tableNumber) const THROWS(GCodeException);
 
+	// Find the table entry for the first element of an ID string, so that callers that evaluate the same ID repeatedly need only look it up once
+	const ObjectModelTableEntry *FindTopLevelEntry(const char *idString, const ObjectModelClassDescriptor *& classDescriptor) const noexcept;
+
+	// Get the value of an object given the table entry for the first element of the ID string, as returned by FindTopLevelEntry
+	ExpressionValue GetObjectValueUsingEntry(ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelTableEntry *e, const char *idString) const THROWS(GCodeException);
+
 	// Function to report a value or object as JSON. This does not need to handle 'var' or 'global' because those are checked for before this is called.
 	void ReportItemAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor,
 							const ExpressionValue& val, const char *filter) const THROWS(GCodeException);
@@ -278,11 +291,28 @@ public:
 	// Skip the current element in the ID or filter string
 	static const char* GetNextElement(const char *id) noexcept;
 
+#if SUPPORT_BINARY_OBJECT_MODEL
+	// Return true if a query asked for the binary encoding and is simple enough for us to provide it, i.e. the filter is empty or a single top-level key
+	static bool CanReportAsBinary(const char *filter, const char *reportFlags) noexcept;
+
+	// Construct a binary representation of those parts of the object model requested by the SBC. This version is called only on the root of the tree.
+	void ReportAsBinary(BinaryObjectModelWriter& writer, const char *filter, const char *reportFlags) const THROWS(GCodeException);
+#endif
+
 protected:
 	// Construct a JSON representation of those parts of the object model requested by the user
 	// Overridden in class GlobalVariables
 	virtual void ReportAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, uint8_t tableNumber, const char *filter) const THROWS(GCodeException);
 
+#if SUPPORT_BINARY_OBJECT_MODEL
+	// Construct a binary representation of this object. Overridden in class GlobalVariables.
+	virtual void ReportAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, uint8_t tableNumber, const char *filter) const THROWS(GCodeException);
+
+	// Report a value or an entire array in binary
+	void ReportItemAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ExpressionValue& val) const THROWS(GCodeException);
+	void ReportArrayAsBinary(BinaryObjectModelWriter& writer, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelArrayDescriptor *omad) const THROWS(GCodeException);
+#endif
+
 	// Report an entire array as JSON
 	void ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelArrayDescriptor *omad, const char *filter) const THROWS(GCodeException);
 
@@ -294,6 +324,10 @@ protected:
 
 	virtual const ObjectModelClassDescriptor *GetObjectModelClassDescriptor() const noexcept = 0;
 
+	// Support for top-level delta mode, in which only the top-level keys that have changed since the client last asked are reported in full. Overridden in class RepRap.
+	virtual uint32_t GetChangeSeq() const noexcept { return 0; }
+	virtual bool HasChangedSince(const char *key, uint32_t seq) const noexcept { return true; }
+
 	__attribute__ ((noinline)) void ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor,
 															const ExpressionValue& val, const char *filter) const THROWS(GCodeException);
 private:
@@ -303,6 +337,10 @@ private:
 	__attribute__ ((noinline)) static void ReportFloat(OutputBuffer *buf, const ExpressionValue& val) noexcept;
 	__attribute__ ((noinline)) static void ReportBitmap1632Long(OutputBuffer *buf, const ExpressionValue& val) noexcept;
 	__attribute__ ((noinline)) static void ReportBitmap64Long(OutputBuffer *buf, const ExpressionValue& val) noexcept;
+#if SUPPORT_BINARY_OBJECT_MODEL
+	__attribute__ ((noinline)) static void ReportAsBinaryString(BinaryObjectModelWriter& writer, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportBitmapAsBinaryArray(BinaryObjectModelWriter& writer, uint64_t bits) noexcept;
+#endif
 
 #if SUPPORT_CAN_EXPANSION
 	__attribute__ ((noinline)) static void ReportExpansionBoardDetail(OutputBuffer *buf, const ExpressionValue& val) noexcept;
@@ -8,7 +8,7 @@
 #include "Variable.h"
 #include <Platform/OutputMemory.h>
 
-Variable::Variable(const char *str, ExpressionValue pVal, int8_t pScope) noexcept : name(str), val(pVal), scope(pScope)
+Variable::Variable(const char *str, ExpressionValue pVal, int8_t pScope) noexcept : name(str), val(pVal), scope(pScope), nameHash(HashName(str))
 {
 }
 
@@ -18,27 +18,60 @@ Variable::~Variable()
 	val.Release();
 }
 
-Variable* VariableSet::Lookup(const char *str) noexcept
+// Compute a 16-bit hash of a variable name. This is the FNV-1a hash folded to 16 bits.
+/*static*/ uint16_t Variable::HashName(const char *str) noexcept
 {
-	Variable *v;
-	for (v = root; v != nullptr; v = v->next)
+	uint32_t hash = 2166136261u;
+	while (*str != 0)
 	{
-		auto vname = v->name.Get();
-		if (strcmp(vname.Ptr(), str) == 0)
-		{
-			break;
-		}
+		hash = (hash ^ (uint8_t)*str++) * 16777619u;
 	}
-	return v;
+	return (uint16_t)((hash >> 16) ^ hash);
+}
+
+// Return true if this variable has the specified name. 'hash' must be the hash of the name.
+bool Variable::NameMatches(const char *str, uint16_t hash) const noexcept
+{
+	if (hash != nameHash)
+	{
+		return false;
+	}
+	auto vname = name.Get();
+	return strcmp(vname.Ptr(), str) == 0;
+}
+
+#ifdef HOST_SIM
+bool VariableSet::useIndex = true;
+#endif
+
+Variable* VariableSet::Lookup(const char *str) noexcept
+{
+	return const_cast<Variable*>(static_cast<const VariableSet*>(this)->Lookup(str));
 }
 
 const Variable* VariableSet::Lookup(const char *str) const noexcept
 {
+	const uint16_t hash = Variable::HashName(str);
+#ifdef HOST_SIM
+	if (index != nullptr && useIndex)
+#else
+	if (index != nullptr)
+#endif
+	{
+		for (const Variable *v = index[hash & (indexSize - 1)]; v != nullptr; v = v->nextInBucket)
+		{
+			if (v->NameMatches(str, hash))
+			{
+				return v;
+			}
+		}
+		return nullptr;
+	}
+
 	const Variable *v;
 	for (v = root; v != nullptr; v = v->next)
 	{
-		auto vname = v->name.Get();
-		if (strcmp(vname.Ptr(), str) == 0)
+		if (v->NameMatches(str, hash))
 		{
 			break;
 		}
@@ -50,6 +83,80 @@ void VariableSet::Insert(Variable *toInsert) noexcept
 {
 	toInsert->next = root;
 	root = toInsert;
+	++numVariables;
+	if (index == nullptr)
+	{
+		if (numVariables >= IndexThreshold)
+		{
+			BuildIndex(MinIndexSize);
+		}
+	}
+	else if (numVariables > 2 * indexSize && indexSize < MaxIndexSize)
+	{
+		BuildIndex(2 * indexSize);
+	}
+	else
+	{
+		// Add the new variable at the start of its bucket, so that it hides any older variable with the same name
+		Variable **const bucket = &index[toInsert->nameHash & (indexSize - 1)];
+		toInsert->nextInBucket = *bucket;
+		*bucket = toInsert;
+	}
+}
+
+// Replace the index by one with the specified number of buckets
+void VariableSet::BuildIndex(unsigned int size) noexcept
+{
+	delete[] index;
+	index = new Variable*[size];
+	indexSize = size;
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		index[i] = nullptr;
+	}
+
+	// The main list is most recent first, so add each variable at the end of its bucket to keep the buckets in the same order
+	for (Variable *v = root; v != nullptr; v = v->next)
+	{
+		Variable **p = &index[v->nameHash & (size - 1)];
+		while (*p != nullptr)
+		{
+			p = &(*p)->nextInBucket;
+		}
+		v->nextInBucket = nullptr;
+		*p = v;
+	}
+}
+
+void VariableSet::RemoveFromIndex(const Variable *v) noexcept
+{
+	if (index != nullptr)
+	{
+		for (Variable **p = &index[v->nameHash & (indexSize - 1)]; *p != nullptr; p = &(*p)->nextInBucket)
+		{
+			if (*p == v)
+			{
+				*p = v->nextInBucket;
+				break;
+			}
+		}
+	}
+}
+
+// Remove a variable from the set and delete it. 'prev' is the variable before it in the main list, or nullptr if it is the first one.
+void VariableSet::Unlink(Variable *prev, Variable *v) noexcept
+{
+	if (prev == nullptr)
+	{
+		root = v->next;
+	}
+	else
+	{
+		prev->next = v->next;
+	}
+	RemoveFromIndex(v);
+	--numVariables;
+	delete v;
 }
 
 // Remove all variables with a scope greater than the parameter
@@ -58,45 +165,28 @@ void VariableSet::EndScope(uint8_t blockNesting) noexcept
 	Variable *prev = nullptr;
 	for (Variable *v = root; v != nullptr; )
 	{
+		Variable * const next = v->next;
 		if (v->scope > blockNesting)
 		{
-			Variable *temp = v;
-			v = v->next;
-			if (prev == nullptr)
-			{
-				root = v;
-			}
-			else
-			{
-				prev->next = v;
-			}
-			delete temp;
+			Unlink(prev, v);
 		}
 		else
 		{
 			prev = v;
-			v = v->next;
 		}
+		v = next;
 	}
 }
 
 void VariableSet::Delete(const char *str) noexcept
 {
+	const uint16_t hash = Variable::HashName(str);
 	Variable *prev = nullptr;
 	for (Variable *v = root; v != nullptr; v = v->next)
 	{
-		auto vname = v->name.Get();
-		if (strcmp(vname.Ptr(), str) == 0)
+		if (v->NameMatches(str, hash))
 		{
-			if (prev == nullptr)
-			{
-				root = v->next;
-			}
-			else
-			{
-				prev->next = v->next;
-			}
-			delete v;
+			Unlink(prev, v);
 			break;
 		}
 		prev = v;
@@ -111,6 +201,9 @@ void VariableSet::Clear() noexcept
 		root = v->next;
 		delete v;
 	}
+	delete[] index;
+	index = nullptr;
+	indexSize = numVariables = 0;
 }
 
 VariableSet::~VariableSet()
@@ -123,7 +216,12 @@ void VariableSet::AssignFrom(VariableSet& other) noexcept
 {
 	Clear();
 	root = other.root;
+	index = other.index;
+	indexSize = other.indexSize;
+	numVariables = other.numVariables;
 	other.root = nullptr;
+	other.index = nullptr;
+	other.indexSize = other.numVariables = 0;
 }
 
 void VariableSet::IterateWhile(function_ref<bool(unsigned int, const Variable&) /*noexcept*/ > func) const noexcept
@@ -31,19 +31,29 @@ public:
 	void Assign(ExpressionValue ev) noexcept { val = ev; }
 	const Variable *GetNext() const noexcept { return next; }
 
+	static uint16_t HashName(const char *str) noexcept;
+
 private:
+	bool NameMatches(const char *str, uint16_t hash) const noexcept;
+
 	Variable *next;
+	Variable *nextInBucket;						// the next variable in the same bucket of the index, if the set has an index
 	StringHandle name;
 	ExpressionValue val;
 	int8_t scope;								// -1 for a parameter, else the block nesting level when it was created
+	uint16_t nameHash;							// hash of the name, so that we only need to lock the string heap and compare names when the hashes match
 };
 
 // Class to represent a collection of variables.
-// For now this is just a linked list, but it could be changed to a hash table for faster lookup and insertion.
+// This is a linked list with the most recently created variable first, which is the order in which the object model reports them.
+// Each variable stores a hash of its name, so a lookup only needs to compare the names of variables whose hashes match.
+// When a set grows to IndexThreshold variables we also build an index of buckets selected by the hash, so that a lookup in a large set
+// such as the global variables only visits the variables in one bucket. Each bucket lists its variables most recent first, like the main list.
+// Most sets of local variables never reach the threshold, so they don't pay for the index.
 class VariableSet
 {
 public:
-	VariableSet() noexcept : root(nullptr) { }
+	VariableSet() noexcept : root(nullptr), index(nullptr), indexSize(0), numVariables(0) { }
 	~VariableSet();
 	VariableSet(const VariableSet&) = delete;
 	VariableSet& operator=(const VariableSet& other) = delete;
@@ -59,8 +69,23 @@ public:
 
 	void IterateWhile(function_ref<bool(unsigned int index, const Variable& v) /*noexcept*/ > func) const noexcept;
 
+#ifdef HOST_SIM
+	static bool useIndex;						// the host benchmark clears this to time lookups that search the whole list
+#endif
+
 private:
+	static constexpr unsigned int IndexThreshold = 8;		// the number of variables at which we build the index
+	static constexpr unsigned int MinIndexSize = 16;		// the initial number of buckets, must be a power of 2
+	static constexpr unsigned int MaxIndexSize = 256;		// the maximum number of buckets, must be a power of 2
+
+	void BuildIndex(unsigned int size) noexcept;
+	void RemoveFromIndex(const Variable *v) noexcept;
+	void Unlink(Variable *prev, Variable *v) noexcept;
+
 	Variable *root;
+	Variable **index;							// the buckets, or nullptr if the set hasn't grown large enough to need them
+	uint16_t indexSize;							// the number of buckets, zero or a power of 2
+	uint16_t numVariables;
 };
 
 #endif /* SRC_GCODES_VARIABLE_H_ */
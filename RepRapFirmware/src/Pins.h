@@ -180,6 +180,26 @@
 # endif
 #endif
 
+// Binary G-code files are decoded by the same parser that handles pre-tokenised codes from the SBC
+#ifndef SUPPORT_BINARY_GCODE_FILES
+# define SUPPORT_BINARY_GCODE_FILES	(HAS_LINUX_INTERFACE && HAS_MASS_STORAGE)
+#endif
+
+// Expressions inside loops in files are compiled to bytecode and cached, on processors with enough RAM
+#ifndef SUPPORT_EXPRESSION_CACHE
+# define SUPPORT_EXPRESSION_CACHE	(SAME70 || SAME5x)
+#endif
+
+// Files being printed from the SD card are read ahead by a separate task, on processors with enough RAM
+#ifndef SUPPORT_FILE_PREFETCH
+# define SUPPORT_FILE_PREFETCH		(HAS_MASS_STORAGE && (SAME70 || SAME5x))
+#endif
+
+// The object model can be sent to the SBC in a compact binary encoding instead of JSON
+#ifndef SUPPORT_BINARY_OBJECT_MODEL
+# define SUPPORT_BINARY_OBJECT_MODEL	(HAS_LINUX_INTERFACE && SUPPORT_OBJECT_MODEL)
+#endif
+
 #ifndef SUPPORT_ASYNC_MOVES
 # define SUPPORT_ASYNC_MOVES	0
 #endif
@@ -7,6 +7,9 @@
  * The string heap uses two structures.
  * Each index block is an array of pointers to the actual data. This allows the data to be moved when the heap is compacted. The first pointer in the block points to the next index block.
  * The heap itself is a sequence of blocks. Each block comprises a 2-byte length count followed by the null-terminated string. The length count is always even and the lowest bit is set if the block is free.
+ *
+ * The heap is compacted incrementally. Each step is done while holding the write lock, but it moves only a limited amount of data, so tasks reading strings are not held up for long.
+ * Between steps, the free space that the collector has accumulated in the heap block it is compacting is marked as a single free storage space, so that the heap can still be walked.
  */
 
 #include "Heap.h"
@@ -14,12 +17,15 @@
 #include <Platform/Platform.h>
 #include <Platform/RepRap.h>
 #include <General/String.h>
+#include <Movement/StepTimer.h>
 #include <atomic>
 
 #define CHECK_HANDLES	(1)							// set nonzero to check that handles are valid before dereferencing them
 
 constexpr size_t IndexBlockSlots = 99;				// number of 4-byte handles per index block, plus one for link to next index block
 constexpr size_t HeapBlockSize = 2048;				// the size of each heap block
+constexpr size_t MaxGcBytesPerStep = 256;			// the maximum amount of string data that an incremental garbage collection step moves
+constexpr size_t GcStartThreshold = 512;			// start an incremental collection when there is at least this amount of recyclable space
 
 struct StorageSpace
 {
@@ -71,86 +77,131 @@ size_t StringHandle::heapUsed = 0;
 std::atomic<size_t> StringHandle::heapToRecycle = 0;
 unsigned int StringHandle::gcCyclesDone = 0;
 
+HeapBlock *StringHandle::gcBlock = nullptr;
+size_t StringHandle::gcFreeStart = 0;
+size_t StringHandle::gcScanOffset = 0;
+uint32_t StringHandle::gcBytesMoved = 0;
+uint32_t StringHandle::gcMaxPauseTicks = 0;
+
+// Do a complete garbage collection, finishing any incremental collection that is in progress
 /*static*/ void StringHandle::GarbageCollect() noexcept
 {
 	WriteLocker locker(heapLock);
 	GarbageCollectInternal();
 }
 
+// Do a step of incremental garbage collection if one is needed. This never waits for the heap lock.
+/*static*/ void StringHandle::Spin() noexcept
+{
+	if ((gcBlock != nullptr || heapToRecycle >= GcStartThreshold) && heapLock.ConditionalLockForWriting())
+	{
+		const uint32_t startTicks = StepTimer::GetTimerTicks();
+		(void)GarbageCollectStep(MaxGcBytesPerStep);
+		RecordPause(startTicks);
+		heapLock.ReleaseWriter();
+	}
+}
+
+// Compact the whole heap. Must own the write lock when calling this.
+// If an incremental cycle is in progress then it has already passed some blocks, so we finish it and then do a complete cycle.
 /*static*/ void StringHandle::GarbageCollectInternal() noexcept
 {
 #if CHECK_HANDLES
 	RRF_ASSERT(heapLock.GetWriteLockOwner() == TaskBase::GetCallerTaskHandle());
 #endif
 
-	heapUsed = 0;
-	for (HeapBlock *currentBlock = heapRoot; currentBlock != nullptr; )
+	const uint32_t startTicks = StepTimer::GetTimerTicks();
+	if (gcBlock != nullptr)
+	{
+		(void)GarbageCollectStep(SIZE_MAX);
+	}
+	(void)GarbageCollectStep(SIZE_MAX);
+	RecordPause(startTicks);
+}
+
+/*static*/ void StringHandle::RecordPause(uint32_t startTicks) noexcept
+{
+	const uint32_t pauseTicks = StepTimer::GetTimerTicks() - startTicks;
+	if (pauseTicks > gcMaxPauseTicks)
+	{
+		gcMaxPauseTicks = pauseTicks;
+	}
+}
+
+// Do some garbage collection, moving no more than about maxBytesToMove bytes of string data. Must own the write lock when calling this.
+// Starts a new collection cycle if none is in progress. Returns true if the collection cycle has been completed.
+/*static*/ bool StringHandle::GarbageCollectStep(size_t maxBytesToMove) noexcept
+{
+	if (gcBlock == nullptr)
 	{
-		// Skip any used blocks at the start because they won't be moved
-		char *p = currentBlock->data;
-		while (p < currentBlock->data + currentBlock->allocated)
+		if (heapRoot == nullptr)
 		{
-			const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
-			if (len & 1u)					// if this slot has been marked as free
-			{
-				break;
-			}
-			p += len + sizeof(StorageSpace::length);
+			return true;
 		}
+		gcBlock = heapRoot;
+		gcFreeStart = gcScanOffset = 0;
+	}
 
-		if (p < currentBlock->data + currentBlock->allocated)					// if we found an unused block before we reached the end
+	size_t bytesMoved = 0;
+	do
+	{
+		char * const data = gcBlock->data;
+		while (gcScanOffset < gcBlock->allocated)
 		{
-			char* startSkip = p;
-
-			for (;;)
+			size_t len = reinterpret_cast<StorageSpace*>(data + gcScanOffset)->length;
+			if (len & 1u)
+			{
+				gcScanOffset += (len & ~1u) + sizeof(StorageSpace::length);			// this space is free so add it to the gap
+			}
+			else if (gcFreeStart == gcScanOffset)
+			{
+				gcScanOffset += len + sizeof(StorageSpace::length);					// no free space found yet, so this one doesn't need to move
+				gcFreeStart = gcScanOffset;
+			}
+			else if (bytesMoved >= maxBytesToMove)
 			{
-				// Find the end of the unused blocks
-				while (p < currentBlock->data + currentBlock->allocated)
+				// Mark the gap as a single free space so that the heap can be walked, then stop until the next step
+				reinterpret_cast<StorageSpace*>(data + gcFreeStart)->length = (gcScanOffset - gcFreeStart - sizeof(StorageSpace::length)) | 1u;
+				return false;
+			}
+			else
+			{
+				// Find as many contiguous used spaces as the remaining budget allows, always including at least one
+				size_t runEnd = gcScanOffset;
+				unsigned int numHandlesToAdjust = 0;
+				do
 				{
-					const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
-					if ((len & 1u) == 0)
+					runEnd += len + sizeof(StorageSpace::length);
+					++numHandlesToAdjust;
+					if (runEnd >= gcBlock->allocated || runEnd - gcScanOffset >= maxBytesToMove - bytesMoved)
 					{
 						break;
 					}
-					p += (len & ~1u) + sizeof(StorageSpace::length);
-				}
-
-				if (p >= currentBlock->data + currentBlock->allocated)
-				{
-					currentBlock->allocated = startSkip - currentBlock->data;	// the unused blocks were at the end so just change the allocated size
-					break;
-				}
-				else
-				{
-					// Find all the contiguous blocks
-					char *startUsed = p;
-					unsigned int numHandlesToAdjust = 0;
-					while (p < currentBlock->data + currentBlock->allocated)
-					{
-						const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
-						if (len & 1u)
-						{
-							break;
-						}
-						++numHandlesToAdjust;
-						p += len + sizeof(StorageSpace::length);
-					}
-
-					// Move the contiguous blocks down
-					memmove(startSkip, startUsed, p - startUsed);
-					//TODO make this more efficient by building up a small table of several adjustments, so we need to make fewer passes through the index
-					AdjustHandles(startUsed, p, startUsed - startSkip, numHandlesToAdjust);
-					startSkip += p - startUsed;
-				}
+					len = reinterpret_cast<StorageSpace*>(data + runEnd)->length;
+				} while ((len & 1u) == 0);
+
+				// Move the contiguous spaces down
+				const size_t runLength = runEnd - gcScanOffset;
+				memmove(data + gcFreeStart, data + gcScanOffset, runLength);
+				AdjustHandles(data + gcScanOffset, data + runEnd, gcScanOffset - gcFreeStart, numHandlesToAdjust);
+				gcFreeStart += runLength;
+				gcScanOffset = runEnd;
+				bytesMoved += runLength;
+				gcBytesMoved += runLength;
 			}
 		}
 
-		heapUsed += currentBlock->allocated;
-		currentBlock = currentBlock->next;
-	}
+		// We have reached the end of this block, so release the free space at the end of it
+		const size_t reclaimed = gcBlock->allocated - gcFreeStart;
+		gcBlock->allocated = gcFreeStart;
+		heapUsed -= reclaimed;
+		heapToRecycle -= reclaimed;
+		gcBlock = gcBlock->next;
+		gcFreeStart = gcScanOffset = 0;
+	} while (gcBlock != nullptr);
 
-	heapToRecycle = 0;
 	++gcCyclesDone;
+	return true;
 }
 
 // Find all handles pointing to storage between startAddr and endAddr and move the pointers down by amount moveDown
@@ -441,7 +492,7 @@ ReadLockedPointer<const char> StringHandle::Get() const noexcept
 
 #if CHECK_HANDLES
 	// Check that the handle points into an index block
-	RRF_ASSERT(((uint32_t)slotPtr & 3) == 0);
+	RRF_ASSERT(((uintptr_t)slotPtr & 3) == 0);
 	bool ok = false;
 	for (IndexBlock *indexBlock = indexRoot; indexBlock != nullptr; indexBlock = indexBlock->next)
 	{
@@ -469,7 +520,7 @@ size_t StringHandle::GetLength() const noexcept
 
 #if CHECK_HANDLES
 	// Check that the handle points into an index block and is not null
-	RRF_ASSERT(((uint32_t)slotPtr & 3) == 0);
+	RRF_ASSERT(((uintptr_t)slotPtr & 3) == 0);
 	bool ok = false;
 	for (IndexBlock *indexBlock = indexRoot; indexBlock != nullptr; indexBlock = indexBlock->next)
 	{
@@ -494,8 +545,10 @@ size_t StringHandle::GetLength() const noexcept
 	{
 		temp.copy("Heap OK");
 	}
-	temp.catf(", handles allocated/used %u/%u, heap memory allocated/used/recyclable %u/%u/%u, gc cycles %u\n",
-					handlesAllocated, (unsigned int)handlesUsed, heapAllocated, heapUsed, (unsigned int)heapToRecycle, gcCyclesDone);
+	temp.catf(", handles allocated/used %u/%u, heap memory allocated/used/recyclable %u/%u/%u, gc cycles %u, bytes moved %" PRIu32 ", max pause %" PRIu32 "us\n",
+					handlesAllocated, (unsigned int)handlesUsed, heapAllocated, heapUsed, (unsigned int)heapToRecycle, gcCyclesDone,
+					gcBytesMoved, (uint32_t)(((uint64_t)gcMaxPauseTicks * 1000000u)/StepTimer::GetTickRate()));
+	gcBytesMoved = gcMaxPauseTicks = 0;
 	reprap.GetPlatform().Message(mt, temp.c_str());
 }
 
@@ -38,6 +38,7 @@ public:
 	void Assign(const char *s) noexcept;
 
 	static void GarbageCollect() noexcept;
+	static void Spin() noexcept;
 //	static size_t GetWastedSpace() noexcept { return spaceToRecycle; }
 //	static size_t GetIndexSpace() noexcept { return totalIndexSpace; }
 //	static size_t GetHeapSpace() noexcept { return totalHeapSpace; }
@@ -51,6 +52,8 @@ protected:
 	static IndexSlot *AllocateHandle() noexcept;
 	static StorageSpace *AllocateSpace(size_t length) noexcept;
 	static void GarbageCollectInternal() noexcept;
+	static bool GarbageCollectStep(size_t maxBytesToMove) noexcept;
+	static void RecordPause(uint32_t startTicks) noexcept;
 	static void AdjustHandles(char *startAddr, char *endAddr, size_t moveDown, unsigned int numHandles) noexcept;
 
 	IndexSlot *slotPtr;
@@ -64,6 +67,13 @@ protected:
 	static size_t heapUsed;
 	static std::atomic<size_t> heapToRecycle;
 	static unsigned int gcCyclesDone;
+
+	// Incremental garbage collector state. The space between gcFreeStart and gcScanOffset in gcBlock is free.
+	static HeapBlock *gcBlock;								// the heap block being compacted, or nullptr if no collection is in progress
+	static size_t gcFreeStart;								// offset in gcBlock of the start of the free gap
+	static size_t gcScanOffset;								// offset in gcBlock of the next storage space to examine
+	static uint32_t gcBytesMoved;
+	static uint32_t gcMaxPauseTicks;
 };
 
 // Version of StringHandle that updates the reference counts automatically
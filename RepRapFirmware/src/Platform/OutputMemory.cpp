@@ -13,6 +13,8 @@
 /*static*/ OutputBuffer * volatile OutputBuffer::freeOutputBuffers = nullptr;		// Messages may also be sent by ISRs,
 /*static*/ volatile size_t OutputBuffer::usedOutputBuffers = 0;						// so make these volatile.
 /*static*/ volatile size_t OutputBuffer::maxUsedOutputBuffers = 0;
+/*static*/ volatile uint32_t OutputBuffer::bytesSent = 0;
+/*static*/ volatile uint32_t OutputBuffer::bytesCopied = 0;
 
 //*************************************************************************************************
 // OutputBuffer class implementation
@@ -308,6 +310,7 @@ size_t OutputBuffer::EncodeReply(OutputBuffer *src) noexcept
 		{
 			bytesWritten += EncodeChar(src->Data()[index]);
 		}
+		RecordBytesCopied(src->DataLength());
 		src = Release(src);
 	}
 
@@ -472,8 +475,9 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 
 /*static*/ void OutputBuffer::Diagnostics(MessageType mtype) noexcept
 {
-	reprap.GetPlatform().MessageF(mtype, "Used output buffers: %d of %d (%d max)\n",
-			usedOutputBuffers, OUTPUT_BUFFER_COUNT, maxUsedOutputBuffers);
+	reprap.GetPlatform().MessageF(mtype, "Used output buffers: %d of %d (%d max), bytes passed to sockets %" PRIu32 ", copied out %" PRIu32 "\n",
+			usedOutputBuffers, OUTPUT_BUFFER_COUNT, maxUsedOutputBuffers, bytesSent, bytesCopied);
+	bytesSent = bytesCopied = 0;
 }
 
 //*************************************************************************************************
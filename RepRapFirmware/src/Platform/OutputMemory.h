@@ -92,6 +92,11 @@ public:
 
 	static void Diagnostics(MessageType mtype) noexcept;
 
+	// Keep track of how much data network responders pass to their sockets straight from output buffers, and how much is copied out of output
+	// buffers first (Telnet line ending conversion, JSON encoding of replies and SBC transfers). Copies made by the sockets themselves aren't counted.
+	static void RecordBytesSent(size_t len) noexcept { bytesSent += len; }
+	static void RecordBytesCopied(size_t len) noexcept { bytesCopied += len; }
+
 	static unsigned int GetFreeBuffers() noexcept { return OUTPUT_BUFFER_COUNT - usedOutputBuffers; }
 
 private:
@@ -112,6 +117,8 @@ private:
 	static OutputBuffer * volatile freeOutputBuffers;		// Messages may be sent by multiple tasks
 	static volatile size_t usedOutputBuffers;				// so make these volatile.
 	static volatile size_t maxUsedOutputBuffers;
+	static volatile uint32_t bytesSent;						// bytes passed to network sockets directly from output buffers
+	static volatile uint32_t bytesCopied;					// bytes copied from output buffers to other buffers before being sent
 };
 
 inline uint32_t OutputBuffer::GetAge() const noexcept
@@ -2311,15 +2311,15 @@ GCodeResult Platform::DiagnosticTest(GCodeBuffer& gb, const StringRef& reply, Ou
 					"\nGCodes %08" PRIx32 "-%08" PRIx32
 					"\nMove %08" PRIx32 "-%08" PRIx32
 					"\nHeat %08" PRIx32 "-%08" PRIx32
-					, reinterpret_cast<uint32_t>(this), reinterpret_cast<uint32_t>(this) + sizeof(Platform) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(this), (uint32_t)reinterpret_cast<uintptr_t>(this) + sizeof(Platform) - 1
 #if HAS_LINUX_INTERFACE
-					, reinterpret_cast<uint32_t>(&reprap.GetLinuxInterface())
-					, (reinterpret_cast<uint32_t>(&reprap.GetLinuxInterface()) == 0) ? 0 : reinterpret_cast<uint32_t>(&reprap.GetLinuxInterface()) + sizeof(LinuxInterface)
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetLinuxInterface())
+					, ((uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetLinuxInterface()) == 0) ? 0 : (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetLinuxInterface()) + sizeof(LinuxInterface)
 #endif
-					, reinterpret_cast<uint32_t>(&reprap.GetNetwork()), reinterpret_cast<uint32_t>(&reprap.GetNetwork()) + sizeof(Network) - 1
-					, reinterpret_cast<uint32_t>(&reprap.GetGCodes()), reinterpret_cast<uint32_t>(&reprap.GetGCodes()) + sizeof(GCodes) - 1
-					, reinterpret_cast<uint32_t>(&reprap.GetMove()), reinterpret_cast<uint32_t>(&reprap.GetMove()) + sizeof(Move) - 1
-					, reinterpret_cast<uint32_t>(&reprap.GetHeat()), reinterpret_cast<uint32_t>(&reprap.GetHeat()) + sizeof(Heat) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetNetwork()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetNetwork()) + sizeof(Network) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetGCodes()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetGCodes()) + sizeof(GCodes) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetMove()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetMove()) + sizeof(Move) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetHeat()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetHeat()) + sizeof(Heat) - 1
 				);
 
 		MessageF(MessageType::GenericMessage,
@@ -2341,22 +2341,22 @@ GCodeResult Platform::DiagnosticTest(GCodeBuffer& gb, const StringRef& reply, Ou
 					"\nExpansionManager %08" PRIx32 "-%08" PRIx32
 #endif
 
-					, reinterpret_cast<uint32_t>(&reprap.GetPrintMonitor()), reinterpret_cast<uint32_t>(&reprap.GetPrintMonitor()) + sizeof(PrintMonitor) - 1
-					, reinterpret_cast<uint32_t>(&reprap.GetFansManager()), reinterpret_cast<uint32_t>(&reprap.GetFansManager()) + sizeof(FansManager) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetPrintMonitor()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetPrintMonitor()) + sizeof(PrintMonitor) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetFansManager()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetFansManager()) + sizeof(FansManager) - 1
 #if SUPPORT_ROLAND
-					, reinterpret_cast<uint32_t>(&reprap.GetRoland()), reinterpret_cast<uint32_t>(&reprap.GetRoland()) + sizeof(Roland) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetRoland()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetRoland()) + sizeof(Roland) - 1
 #endif
 #if SUPPORT_SCANNER
-					, reinterpret_cast<uint32_t>(&reprap.GetScanner()), reinterpret_cast<uint32_t>(&reprap.GetScanner()) + sizeof(Scanner) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetScanner()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetScanner()) + sizeof(Scanner) - 1
 #endif
 #if SUPPORT_IOBITS
-					, reinterpret_cast<uint32_t>(&reprap.GetPortControl()), reinterpret_cast<uint32_t>(&reprap.GetPortControl()) + sizeof(PortControl) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetPortControl()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetPortControl()) + sizeof(PortControl) - 1
 #endif
 #if SUPPORT_12864_LCD
-					, reinterpret_cast<uint32_t>(&reprap.GetDisplay()), reinterpret_cast<uint32_t>(&reprap.GetDisplay()) + sizeof(Display) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetDisplay()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetDisplay()) + sizeof(Display) - 1
 #endif
 #if SUPPORT_CAN_EXPANSION
-					, reinterpret_cast<uint32_t>(&reprap.GetExpansion()), reinterpret_cast<uint32_t>(&reprap.GetExpansion()) + sizeof(ExpansionManager) - 1
+					, (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetExpansion()), (uint32_t)reinterpret_cast<uintptr_t>(&reprap.GetExpansion()) + sizeof(ExpansionManager) - 1
 #endif
 				);
 		break;
@@ -21,6 +21,7 @@
 #include "Fans/FansManager.h"
 #include <Hardware/SoftwareReset.h>
 #include <Hardware/ExceptionHandlers.h>
+#include <ObjectModel/BinaryObjectModelWriter.h>
 #include "Version.h"
 
 #ifdef DUET_NG
@@ -420,7 +421,7 @@ ReadWriteLock RepRap::toolListLock;
 
 RepRap::RepRap() noexcept
 	: boardsSeq(0), directoriesSeq(0), fansSeq(0), heatSeq(0), inputsSeq(0), jobSeq(0), moveSeq(0), globalSeq(0),
-	  networkSeq(0), scannerSeq(0), sensorsSeq(0), spindlesSeq(0), stateSeq(0), toolsSeq(0), volumesSeq(0),
+	  networkSeq(0), scannerSeq(0), sensorsSeq(0), spindlesSeq(0), stateSeq(0), toolsSeq(0), volumesSeq(0), changeSeq(1),
 	  toolList(nullptr), currentTool(nullptr), lastWarningMillis(0),
 	  activeExtruders(0), activeToolHeaters(0), numToolsToReport(0),
 	  ticksInSpinState(0), heatTaskIdleTicks(0),
@@ -434,6 +435,10 @@ RepRap::RepRap() noexcept
 #endif
 {
 	ClearDebug();
+	for (uint32_t& seq : sectionChangedAt)
+	{
+		seq = 1;										// so that a client that has seen nothing gets everything
+	}
 	// Don't call constructors for other objects here
 }
 
@@ -763,6 +768,9 @@ void RepRap::Spin() noexcept
 	ticksInSpinState = 0;
 	spinningModule = noModule;
 
+	// Do a little garbage collection on the string heap if needed
+	StringHandle::Spin();
+
 	// Check if we need to send diagnostics
 	if (diagnosticsDestination != MessageType::NoDestinationMessage)
 	{
@@ -1299,12 +1307,16 @@ void RepRap::Tick() noexcept
 				heat->SwitchOffAllLocalFromISR();								// can't call SwitchOffAll because remote heaters can't be turned off from inside a ISR
 				platform->EmergencyDisableDrivers();
 
+#ifdef HOST_SIM
+				SoftwareReset((heatTaskStuck) ? SoftwareResetReason::heaterWatchdog : SoftwareResetReason::stuckInSpin);
+#else
 				// We now save the stack when we get stuck in a spin loop
 				__asm volatile("mrs r2, psp");
 				register const uint32_t * stackPtr asm ("r2");					// we want the PSP not the MSP
 				SoftwareReset(
 					(heatTaskStuck) ? SoftwareResetReason::heaterWatchdog : SoftwareResetReason::stuckInSpin,
 					stackPtr + 5);												// discard uninteresting registers, keep LR PC PSR
+#endif
 			}
 		}
 	}
@@ -2417,6 +2429,72 @@ OutputBuffer *RepRap::GetModelResponse(const char *key, const char *flags) const
 	return outBuf;
 }
 
+#if SUPPORT_BINARY_OBJECT_MODEL
+
+// Return a query into the object model in binary, or return nullptr if no buffer available. The caller must check that ObjectModel::CanReportAsBinary returns true.
+OutputBuffer *RepRap::GetBinaryModelResponse(BinaryObjectModelWriter& writer, const char *key, const char *flags) const THROWS(GCodeException)
+{
+	OutputBuffer *outBuf;
+	if (OutputBuffer::Allocate(outBuf))
+	{
+		if (key == nullptr) { key = ""; }
+		if (flags == nullptr) { flags = ""; }
+
+		writer.Start(outBuf);
+		writer.WriteTag(BinaryObjectModelTag::objectStart);
+		writer.WriteKey("key");
+		writer.WriteString(key);
+		writer.WriteKey("flags");
+		writer.WriteString(flags);
+		writer.WriteKey("result");
+
+		try
+		{
+			reprap.ReportAsBinary(writer, key, flags);
+			writer.WriteTag(BinaryObjectModelTag::objectEnd);
+			if (outBuf->HadOverflow())
+			{
+				OutputBuffer::ReleaseAll(outBuf);
+			}
+		}
+		catch (...)
+		{
+			OutputBuffer::ReleaseAll(outBuf);
+			throw;
+		}
+	}
+
+	return outBuf;
+}
+
+#endif
+
+// Names of the top-level keys whose changes we track, in the same order as the ModelSection enumeration
+const char * const RepRap::modelSectionNames[(size_t)ModelSection::numSections] =
+{
+	"boards", "directories", "fans", "global", "heat", "inputs", "job", "move", "network", "scanner", "sensors", "spindles", "state", "tools", "volumes"
+};
+
+// Return true if the top-level key may have changed since the client received change sequence number 'seq'.
+// Keys that don't have a sequence number of their own (limits, seqs) only change when the firmware is restarted, apart from their live values.
+// If the client's sequence number is higher than ours then it was issued before the firmware was restarted, so everything has changed.
+bool RepRap::HasChangedSince(const char *key, uint32_t seq) const noexcept
+{
+	if (seq > changeSeq)
+	{
+		return true;
+	}
+
+	for (size_t i = 0; i < (size_t)ModelSection::numSections; ++i)
+	{
+		if (strcmp(key, modelSectionNames[i]) == 0)
+		{
+			return sectionChangedAt[i] > seq;
+		}
+	}
+	return seq == 0;
+}
+
 #endif
 
 // Send a beep. We send it to both PanelDue and the web interface.
@@ -2838,6 +2916,10 @@ void RepRap::PrepareToLoadIap() noexcept
 
 void RepRap::StartIap(const char *filename) noexcept
 {
+#ifdef HOST_SIM
+	// The host simulation can't run other firmware, so end the simulation
+	SoftwareReset(SoftwareResetReason::user);
+#else
 	// Disable all interrupts, then reallocate the vector table and program entry point to the new IAP binary
 	// This does essentially what the Atmel AT02333 paper suggests (see 3.2.2 ff)
 
@@ -2917,6 +2999,7 @@ void RepRap::StartIap(const char *filename) noexcept
 	__asm volatile ("orr r1, r1, #1");
 	__asm volatile ("bx r1");
 	for (;;) { }							// to keep gcc happy
+#endif
 }
 
 #endif
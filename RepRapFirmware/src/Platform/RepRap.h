@@ -26,6 +26,7 @@ Licence: GPL
 #include <RTOSIface/RTOSIface.h>
 #include <General/function_ref.h>
 #include <ObjectModel/GlobalVariables.h>
+#include <atomic>
 
 #if SUPPORT_CAN_EXPANSION
 # include <CAN/ExpansionManager.h>
@@ -155,6 +156,9 @@ public:
 
 #if SUPPORT_OBJECT_MODEL
 	OutputBuffer *GetModelResponse(const char *key, const char *flags) const THROWS(GCodeException);
+#if SUPPORT_BINARY_OBJECT_MODEL
+	OutputBuffer *GetBinaryModelResponse(BinaryObjectModelWriter& writer, const char *key, const char *flags) const THROWS(GCodeException);
+#endif
 #endif
 
 	void Beep(unsigned int freq, unsigned int ms) noexcept;
@@ -184,27 +188,35 @@ public:
 
 	void KickHeatTaskWatchdog() noexcept { heatTaskIdleTicks = 0; }
 
-	void BoardsUpdated() noexcept { ++boardsSeq; }
-	void DirectoriesUpdated() noexcept { ++directoriesSeq; }
-	void FansUpdated() noexcept { ++fansSeq; }
-	void GlobalUpdated() noexcept { ++globalSeq; }
-	void HeatUpdated() noexcept { ++heatSeq; }
-	void InputsUpdated() noexcept { ++inputsSeq; }
-	void JobUpdated() noexcept { ++jobSeq; }
-	void MoveUpdated() noexcept { ++moveSeq; }
-	void NetworkUpdated() noexcept { ++networkSeq; }
-	void ScannerUpdated() noexcept { ++scannerSeq; }
-	void SensorsUpdated() noexcept { ++sensorsSeq; }
-	void SpindlesUpdated() noexcept { ++spindlesSeq; }
-	void StateUpdated() noexcept { ++stateSeq; }
-	void ToolsUpdated() noexcept { ++toolsSeq; }
-	void VolumesUpdated() noexcept { ++volumesSeq; }
+	void BoardsUpdated() noexcept { ++boardsSeq; SectionChanged(ModelSection::boards); }
+	void DirectoriesUpdated() noexcept { ++directoriesSeq; SectionChanged(ModelSection::directories); }
+	void FansUpdated() noexcept { ++fansSeq; SectionChanged(ModelSection::fans); }
+	void GlobalUpdated() noexcept { ++globalSeq; SectionChanged(ModelSection::global); }
+	void HeatUpdated() noexcept { ++heatSeq; SectionChanged(ModelSection::heat); }
+	void InputsUpdated() noexcept { ++inputsSeq; SectionChanged(ModelSection::inputs); }
+	void JobUpdated() noexcept { ++jobSeq; SectionChanged(ModelSection::job); }
+	void MoveUpdated() noexcept { ++moveSeq; SectionChanged(ModelSection::move); }
+	void NetworkUpdated() noexcept { ++networkSeq; SectionChanged(ModelSection::network); }
+	void ScannerUpdated() noexcept { ++scannerSeq; SectionChanged(ModelSection::scanner); }
+	void SensorsUpdated() noexcept { ++sensorsSeq; SectionChanged(ModelSection::sensors); }
+	void SpindlesUpdated() noexcept { ++spindlesSeq; SectionChanged(ModelSection::spindles); }
+	void StateUpdated() noexcept { ++stateSeq; SectionChanged(ModelSection::state); }
+	void ToolsUpdated() noexcept { ++toolsSeq; SectionChanged(ModelSection::tools); }
+	void VolumesUpdated() noexcept { ++volumesSeq; SectionChanged(ModelSection::volumes); }
+
+#if SUPPORT_OBJECT_MODEL
+	uint32_t GetModelChangeSeq() const noexcept { return changeSeq; }	// this changes whenever any of the sequence numbers above changes
+#endif
 
 	ReadLockedPointer<const VariableSet> GetGlobalVariablesForReading() noexcept { return globalVariables.GetForReading(); }
 	WriteLockedPointer<VariableSet> GetGlobalVariablesForWriting() noexcept { return globalVariables.GetForWriting(); }
 
 protected:
 	DECLARE_OBJECT_MODEL
+#if SUPPORT_OBJECT_MODEL
+	uint32_t GetChangeSeq() const noexcept override { return changeSeq; }
+	bool HasChangedSince(const char *key, uint32_t seq) const noexcept override;
+#endif
 	OBJECT_MODEL_ARRAY(boards)
 	OBJECT_MODEL_ARRAY(fans)
 	OBJECT_MODEL_ARRAY(gpout)
@@ -266,6 +278,15 @@ private:
 	uint16_t boardsSeq, directoriesSeq, fansSeq, heatSeq, inputsSeq, jobSeq, moveSeq, globalSeq;;
 	uint16_t networkSeq, scannerSeq, sensorsSeq, spindlesSeq, stateSeq, toolsSeq, volumesSeq;
 
+	// Change tracking for top-level delta mode. Each top-level key that has a sequence number records the value of changeSeq when it last changed.
+	// Changes are tracked per top-level key only, so a change anywhere under a key causes the whole key to be reported.
+	enum class ModelSection : uint8_t { boards = 0, directories, fans, global, heat, inputs, job, move, network, scanner, sensors, spindles, state, tools, volumes, numSections };
+	static const char * const modelSectionNames[(size_t)ModelSection::numSections];
+	void SectionChanged(ModelSection s) noexcept { sectionChangedAt[(size_t)s] = changeSeq.fetch_add(1) + 1; }
+
+	std::atomic<uint32_t> changeSeq;			// atomic because sections are changed by several tasks
+	uint32_t sectionChangedAt[(size_t)ModelSection::numSections];
+
 	GlobalVariables globalVariables;
 
 	Tool* toolList;								// the tool list is sorted in order of increasing tool number
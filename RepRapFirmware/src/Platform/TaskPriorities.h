@@ -20,6 +20,7 @@ namespace TaskPriority
     constexpr int TcpPriority  = 2;
     //EMAC priority = 3 defined in FreeRTOSIPConfig.h
 #endif
+	constexpr int FilePrefetchPriority = 2;					// higher than the main task so that it can keep the buffers full
     constexpr int HeatPriority = 3;
 	constexpr int Move = 4;
 	constexpr int SensorsPriority = 4;
@@ -19,7 +19,7 @@
 # include <efc/efc.h>		// for efc_enable_cloe()
 #endif
 
-#if SAME5x
+#if SAME5x && !defined(HOST_SIM)
 # include <hpl_user_area.h>
 #endif
 
@@ -30,13 +30,15 @@
 
 const uint8_t memPattern = 0xA5;		// this must be the same pattern as FreeRTOS because we use common code for checking for stack overflow
 
+#ifndef HOST_SIM
 extern char _end;						// defined in linker script
 extern char _estack;					// defined in linker script
+#endif
 
-// Define replacement standard library functions
+// Define replacement standard library functions. The host simulation has its own version of this file.
 #include <syscalls.h>
 
-#ifndef DEBUG
+#if !defined(DEBUG) && !defined(HOST_SIM)
 extern uint32_t _firmware_crc;			// defined in linker script
 #endif
 
@@ -133,7 +135,7 @@ void *Tasks::GetNVMBuffer(const uint32_t *stk) noexcept
 {
 	pinMode(DiagPin, (DiagOnPolarity) ? OUTPUT_LOW : OUTPUT_HIGH);	// set up diag LED for debugging and turn it off
 
-#if !defined(DEBUG) && !defined(__LPC17xx__)	// don't check the CRC of a debug build because debugger breakpoints mess up the CRC
+#if !defined(DEBUG) && !defined(__LPC17xx__) && !defined(HOST_SIM)	// don't check the CRC of a debug build because debugger breakpoints mess up the CRC
 	// Check the integrity of the firmware by checking the firmware CRC
 	{
 		const char *firmwareStart = reinterpret_cast<const char*>(SCB->VTOR & 0xFFFFFF80);
@@ -153,8 +155,9 @@ void *Tasks::GetNVMBuffer(const uint32_t *stk) noexcept
 			}
 		}
 	}
-#endif	// !defined(DEBUG) && !defined(__LPC17xx__)
+#endif	// !defined(DEBUG) && !defined(__LPC17xx__) && !defined(HOST_SIM)
 
+#ifndef HOST_SIM
 	// Fill the free memory with a pattern so that we can check for stack usage and memory corruption
 	char* heapend = heapTop;
 	register const char * stack_ptr asm ("sp");
@@ -162,8 +165,9 @@ void *Tasks::GetNVMBuffer(const uint32_t *stk) noexcept
 	{
 		*heapend++ = memPattern;
 	}
+#endif
 
-#if SAME5x
+#if SAME5x && !defined(HOST_SIM)
 	{
 		const uint32_t bootloaderSize = SCB->VTOR & 0xFFFFFF80;
 		if (bootloaderSize == 0x4000)
@@ -246,6 +250,9 @@ extern "C" [[noreturn]] void MainTask(void *pvParameters) noexcept
 // Return the amount of free handler stack space. It may be negative if the stack has overflowed into the area reserved for the heap.
 static ptrdiff_t GetHandlerFreeStack() noexcept
 {
+#ifdef HOST_SIM
+	return 0;								// interrupts in the host simulation don't have a stack of their own
+#else
 	const char * const ramend = &_estack;
 	const char * stack_lwm = sysStackLimit;
 	while (stack_lwm < ramend && *stack_lwm == memPattern)
@@ -253,6 +260,7 @@ static ptrdiff_t GetHandlerFreeStack() noexcept
 		++stack_lwm;
 	}
 	return stack_lwm - sysStackLimit;
+#endif
 }
 
 ptrdiff_t Tasks::GetNeverUsedRam() noexcept
@@ -292,6 +300,7 @@ void Tasks::Diagnostics(MessageType mtype) noexcept
 	p.Message(mtype, "=== RTOS ===\n");
 	// Print memory stats
 	{
+#ifndef HOST_SIM
 		const char * const ramstart =
 #if SAME5x
 			(char *) HSRAM_ADDR;
@@ -301,6 +310,7 @@ void Tasks::Diagnostics(MessageType mtype) noexcept
 			(char *) IRAM_ADDR;
 #endif
 		p.MessageF(mtype, "Static ram: %d\n", &_end - ramstart);
+#endif
 
 #ifdef __LPC17xx__
 		p.MessageF(mtype, "Dynamic Memory (RTOS Heap 5): %d free, %d never used\n", xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize() );
@@ -408,12 +418,16 @@ extern "C" void vApplicationTickHook() noexcept
 	reprap.Tick();
 }
 
+#ifndef HOST_SIM
+
 // We don't need the time zone functionality. Declaring these saves 8Kb.
 extern "C" void __tzset() noexcept { }
 extern "C" void __tz_lock() noexcept { }
 extern "C" void __tz_unlock() noexcept { }
 extern "C" void _tzset_unlocked() noexcept { }
 
+#endif
+
 #if SUPPORT_CAN_EXPANSION
 
 // Functions called by CanMessageBuffer in CANlib
@@ -203,7 +203,7 @@ void CRC32::Update(const char *s, size_t len) noexcept
 		uint32_t reflectedCrc = Reflect(crc);
 		TaskCriticalSectionLocker lock;			// we need exclusive use of the CRC unit
 
-		if ((reinterpret_cast<uint32_t>(s) & 3) != 0)
+		if ((reinterpret_cast<uintptr_t>(s) & 3) != 0)
 		{
 			// Process any bytes at the start until we reach a dword boundary
 			DMAC->CRCCTRL.reg = DMAC_CRCCTRL_CRCBEATSIZE_BYTE | DMAC_CRCCTRL_CRCSRC_DISABLE | DMAC_CRCCTRL_CRCPOLY_CRC32;	// disable the CRC unit
@@ -212,7 +212,7 @@ void CRC32::Update(const char *s, size_t len) noexcept
 			do
 			{
 				DMAC->CRCDATAIN.reg = *s++;
-			} while ((reinterpret_cast<uint32_t>(s) & 3) != 0 && s != end);
+			} while ((reinterpret_cast<uintptr_t>(s) & 3) != 0 && s != end);
 
 			reflectedCrc = DMAC->CRCCHKSUM.reg;
 			DMAC->CRCSTATUS.reg = DMAC_CRCSTATUS_CRCBUSY;
@@ -259,7 +259,7 @@ void CRC32::Update(const char *s, size_t len) noexcept
 		uint32_t locCrc = crc;
 
 		// Process any bytes at the start until we reach a dword boundary
-		while ((reinterpret_cast<uint32_t>(s) & 3) != 0 && s != end)
+		while ((reinterpret_cast<uintptr_t>(s) & 3) != 0 && s != end)
 		{
 			locCrc = (CRC_32_TAB[(locCrc ^ *s++) & 0xFF] ^ (locCrc >> 8));
 		}
@@ -3,7 +3,7 @@
 
 #include <RepRapFirmware.h>
 
-#if SAME5x
+#if SAME5x && !defined(HOST_SIM)				// the host simulation has no CRC unit
 # define USE_SAME5x_HARDWARE_CRC	1
 #else
 # define USE_SAME5x_HARDWARE_CRC	0
@@ -21,11 +21,20 @@ class FileData
 public:
 	friend class FileGCodeInput;
 
+#if SUPPORT_BINARY_GCODE_FILES
+	enum class GCodeFormat : uint8_t { unknown = 0, text, binary };
+
+	FileData() noexcept : f(nullptr), gcodeFormat(GCodeFormat::unknown) {}
+#else
 	FileData() noexcept : f(nullptr) {}
+#endif
 
 	FileData(const FileData& other) noexcept
 	{
 		f = other.f;
+#if SUPPORT_BINARY_GCODE_FILES
+		gcodeFormat = other.gcodeFormat;
+#endif
 		if (f != nullptr)
 		{
 			f->Duplicate();
@@ -37,6 +46,9 @@ public:
 	{
 		Close();	// close any existing file
 		f = pfile;
+#if SUPPORT_BINARY_GCODE_FILES
+		gcodeFormat = GCodeFormat::unknown;
+#endif
 	}
 
 	bool IsLive() const noexcept { return f != nullptr; }
@@ -113,15 +125,24 @@ public:
 	{
 		Close();
 		f = other.f;
+#if SUPPORT_BINARY_GCODE_FILES
+		gcodeFormat = other.gcodeFormat;
+#endif
 		other.Init();
 	}
 
 private:
 	FileStore *f;
+#if SUPPORT_BINARY_GCODE_FILES
+	GCodeFormat gcodeFormat;							// set by FileGCodeInput the first time it reads from this file
+#endif
 
 	void Init() noexcept
 	{
 		f = nullptr;
+#if SUPPORT_BINARY_GCODE_FILES
+		gcodeFormat = GCodeFormat::unknown;
+#endif
 	}
 
 	// Private assignment operator to prevent us assigning these objects
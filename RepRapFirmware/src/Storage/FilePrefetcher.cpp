@@ -0,0 +1,219 @@
+/*
+ * FilePrefetcher.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ */
+
+#include "FilePrefetcher.h"
+
+#if SUPPORT_FILE_PREFETCH
+
+#include "FileStore.h"
+#include <Platform/Platform.h>
+#include <Platform/RepRap.h>
+#include <Platform/TaskPriorities.h>
+
+constexpr uint32_t FilePrefetchTaskStackWords = 400;				// FatFS, the SD card driver and debugPrintf when a read fails
+
+const uint32_t FilePrefetcher::latencyBucketLimits[NumLatencyBuckets - 1] = { 2, 5, 10, 20, 50, 100 };	// upper limits of the read time buckets in milliseconds
+
+FilePrefetcher *FilePrefetcher::prefetchers = nullptr;
+uint32_t FilePrefetcher::readCounts[NumLatencyBuckets] = { 0 };
+uint32_t FilePrefetcher::longestReadTime = 0;
+uint32_t FilePrefetcher::stalls = 0;
+
+FilePrefetcher::FilePrefetcher() noexcept
+	: task(nullptr), file(nullptr), blocksFilled(0), blocksTaken(0), takeOffset(0), consumerPosition(0), firstBlockSize(BlockSize), atEof(false), readError(false)
+{
+	fileMutex.Create("FilePrefetch");
+	next = prefetchers;
+	prefetchers = this;
+}
+
+// Start reading ahead from the current position of a file. Must be called by the task that will consume the data.
+void FilePrefetcher::Start(FileStore *f) noexcept
+{
+	StopInternal(true);
+	{
+		MutexLocker lock(fileMutex);
+		blocksFilled = blocksTaken = 0;
+		takeOffset = 0;
+		atEof = readError = false;
+		consumerPosition = f->Position();
+		firstBlockSize = BlockSize - (consumerPosition % BlockSize);
+		file = f;
+	}
+
+	if (task == nullptr)
+	{
+		// Create the task the first time we need it
+		Task<FilePrefetchTaskStackWords> * const t = new Task<FilePrefetchTaskStackWords>;
+		t->Create(TaskStart, "FILEREAD", this, TaskPriority::FilePrefetchPriority);
+		task = t;
+	}
+	else
+	{
+		task->Give();
+	}
+}
+
+// Stop reading ahead and set the file position back to where the consumer had read up to
+void FilePrefetcher::Stop() noexcept
+{
+	StopInternal(true);
+}
+
+void FilePrefetcher::StopInternal(bool rewind) noexcept
+{
+	if (file != nullptr)
+	{
+		MutexLocker lock(fileMutex);							// wait for any read in progress to complete
+		FileStore * const f = file;
+		if (f != nullptr)
+		{
+			file = nullptr;
+			blocksFilled = blocksTaken = 0;
+			takeOffset = 0;
+			if (rewind && f->Position() != consumerPosition)
+			{
+				(void)f->Seek(consumerPosition);
+			}
+		}
+	}
+}
+
+// Return data that has been read ahead. If there is none then wait for any read in progress to complete, or read it now.
+// Only ever returns data from one block, so it may return fewer bytes than requested even when we are not at the end of the file.
+int FilePrefetcher::Read(char *buf, size_t nBytes) noexcept
+{
+	if (blocksTaken == blocksFilled)
+	{
+		if (readError)
+		{
+			return -1;
+		}
+		if (atEof)
+		{
+			return 0;
+		}
+
+		if (blocksFilled != 0)
+		{
+			++stalls;											// don't count the first read after Start, because there was no time to prefetch anything
+		}
+		MutexLocker lock(fileMutex);
+		if (CanFillBlock() && blocksTaken == blocksFilled)
+		{
+			FillBlock();
+		}
+		if (blocksTaken == blocksFilled)
+		{
+			return (readError) ? -1 : 0;
+		}
+	}
+
+	const size_t index = blocksTaken % NumBlocks;
+	const size_t bytesToCopy = min<size_t>(nBytes, blockLength[index] - takeOffset);
+	memcpy(buf, blocks[index] + takeOffset, bytesToCopy);
+	takeOffset += bytesToCopy;
+	consumerPosition += bytesToCopy;
+	if (takeOffset == blockLength[index])
+	{
+		takeOffset = 0;
+		blocksTaken.fetch_add(1, std::memory_order_release);	// we have finished copying from the block so FillBlock may reuse it
+		task->Give();											// there is room to read another block
+	}
+	return (int)bytesToCopy;
+}
+
+// Read the next block from the file. We read into the first block just enough to make the following reads sector-aligned.
+void FilePrefetcher::FillBlock() noexcept
+{
+	const size_t index = blocksFilled % NumBlocks;
+	const size_t bytesToRead = (blocksFilled == 0) ? firstBlockSize : BlockSize;
+	const uint32_t startTime = millis();
+	const int bytesRead = file->Read(blocks[index], bytesToRead);
+	RecordReadTime(millis() - startTime);
+	if (bytesRead < 0)
+	{
+		readError = true;
+		return;
+	}
+
+	if ((size_t)bytesRead < bytesToRead)
+	{
+		atEof = true;
+	}
+	if (bytesRead != 0)
+	{
+		blockLength[index] = (uint16_t)bytesRead;
+		blocksFilled.fetch_add(1, std::memory_order_release);	// this makes the block and its length available to the consumer
+	}
+}
+
+/*static*/ void FilePrefetcher::RecordReadTime(uint32_t millisTaken) noexcept
+{
+	size_t bucket = 0;
+	while (bucket < NumLatencyBuckets - 1 && millisTaken >= latencyBucketLimits[bucket])
+	{
+		++bucket;
+	}
+	++readCounts[bucket];
+	if (millisTaken > longestReadTime)
+	{
+		longestReadTime = millisTaken;
+	}
+}
+
+/*static*/ void FilePrefetcher::TaskStart(void *param) noexcept
+{
+	static_cast<FilePrefetcher*>(param)->TaskLoop();
+}
+
+[[noreturn]] void FilePrefetcher::TaskLoop() noexcept
+{
+	for (;;)
+	{
+		// Read blocks until the buffer is full, releasing the mutex after each one so that the consumer can stop us
+		bool readBlock;
+		do
+		{
+			MutexLocker lock(fileMutex);
+			readBlock = CanFillBlock();
+			if (readBlock)
+			{
+				FillBlock();
+			}
+		} while (readBlock);
+
+		(void)TaskBase::Take();									// wait until a block has been consumed or we are given a new file
+	}
+}
+
+// This is called when a file is about to be closed. If we are reading ahead from it then stop.
+/*static*/ void FilePrefetcher::FileClosing(const FileStore *f) noexcept
+{
+	for (FilePrefetcher *p = prefetchers; p != nullptr; p = p->next)
+	{
+		if (p->IsActiveOn(f))
+		{
+			p->StopInternal(false);
+		}
+	}
+}
+
+/*static*/ void FilePrefetcher::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "File prefetch stalls %" PRIu32 ", longest read %" PRIu32 "ms, reads <2ms %" PRIu32 " <5ms %" PRIu32 " <10ms %" PRIu32 " <20ms %" PRIu32 " <50ms %" PRIu32 " <100ms %" PRIu32 " longer %" PRIu32 "\n",
+									stalls, longestReadTime, readCounts[0], readCounts[1], readCounts[2], readCounts[3], readCounts[4], readCounts[5], readCounts[6]);
+	stalls = longestReadTime = 0;
+	for (uint32_t& count : readCounts)
+	{
+		count = 0;
+	}
+}
+
+#endif
+
+// End
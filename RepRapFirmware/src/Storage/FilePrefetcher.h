@@ -0,0 +1,72 @@
+/*
+ * FilePrefetcher.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *
+ *  A FilePrefetcher reads ahead from a file in its own task, so that an occasional slow SD card read doesn't hold up the task that consumes the data.
+ *  While it is active, the position of the file is ahead of the data that the consumer has read, so use Position() to get the consumer's position.
+ */
+
+#ifndef SRC_STORAGE_FILEPREFETCHER_H_
+#define SRC_STORAGE_FILEPREFETCHER_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_FILE_PREFETCH
+
+#include <RTOSIface/RTOSIface.h>
+#include <atomic>
+
+class FileStore;
+
+class FilePrefetcher
+{
+public:
+	FilePrefetcher() noexcept;
+
+	void Start(FileStore *f) noexcept;								// start reading ahead from the current position of the file
+	void Stop() noexcept;											// stop reading ahead and set the file position back to where the consumer has read up to
+	bool IsActiveOn(const FileStore *f) const noexcept { return f != nullptr && file == f; }
+	int Read(char *buf, size_t nBytes) noexcept;					// return data that has been read ahead, reading it now if necessary
+	FilePosition Position() const noexcept { return consumerPosition; }	// return the file position that the consumer has read up to
+
+	static void FileClosing(const FileStore *f) noexcept;			// called by FileStore when a file is about to be closed
+	static void Diagnostics(MessageType mtype) noexcept;
+
+private:
+	static constexpr size_t BlockSize = 512;						// a multiple of the sector size, so that FatFS can read whole sectors directly into our buffers
+	static constexpr size_t NumBlocks = FilePrefetchBlocks;
+	static constexpr size_t NumLatencyBuckets = 7;
+	static const uint32_t latencyBucketLimits[NumLatencyBuckets - 1];
+
+	static void TaskStart(void *param) noexcept;
+	[[noreturn]] void TaskLoop() noexcept;
+	void StopInternal(bool rewind) noexcept;
+	bool CanFillBlock() const noexcept { return file != nullptr && !atEof && !readError && blocksFilled - blocksTaken < NumBlocks; }
+	void FillBlock() noexcept;										// must be called with fileMutex held
+	static void RecordReadTime(uint32_t millisTaken) noexcept;
+
+	FilePrefetcher *next;											// next in the list of all prefetchers
+	Mutex fileMutex;												// held while the file is being read or its position changed
+	TaskBase *task;
+	FileStore *volatile file;										// the file we are reading ahead from, or nullptr
+	std::atomic<uint32_t> blocksFilled;								// number of blocks read since we started, incremented only by FillBlock
+	std::atomic<uint32_t> blocksTaken;								// number of blocks consumed since we started, incremented only by Read
+	size_t takeOffset;												// how many bytes of the block at blocksTaken have been consumed
+	FilePosition consumerPosition;									// the file position that the consumer has read up to
+	size_t firstBlockSize;											// how many bytes we read into the first block, to align the following reads with sectors
+	volatile bool atEof;
+	volatile bool readError;
+	uint16_t blockLength[NumBlocks];
+	alignas(4) char blocks[NumBlocks][BlockSize];
+
+	static FilePrefetcher *prefetchers;
+	static uint32_t readCounts[NumLatencyBuckets];
+	static uint32_t longestReadTime;
+	static uint32_t stalls;											// how many times the consumer had to wait for data
+};
+
+#endif
+
+#endif /* SRC_STORAGE_FILEPREFETCHER_H_ */
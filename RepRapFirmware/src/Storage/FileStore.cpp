@@ -13,6 +13,7 @@
 # include "MassStorage.h"
 # include <Libraries/Fatfs/diskio.h>
 # include <Movement/StepTimer.h>
+# include "FilePrefetcher.h"
 #endif
 
 #if HAS_LINUX_INTERFACE
@@ -186,6 +187,9 @@ bool FileStore::Close() noexcept
 			else
 			{
 				IrqRestore(flags);
+#if SUPPORT_FILE_PREFETCH
+				FilePrefetcher::FileClosing(this);
+#endif
 				return ForceClose();
 			}
 		}
@@ -203,6 +207,12 @@ bool FileStore::Close() noexcept
 				usageMode = FileUseMode::free;
 			}
 			IrqRestore(flags);
+#if SUPPORT_FILE_PREFETCH
+			if (usageMode == FileUseMode::free)
+			{
+				FilePrefetcher::FileClosing(this);
+			}
+#endif
 			return true;
 		}
 	}
@@ -462,7 +472,9 @@ FRESULT FileStore::Store(const char *s, size_t len, size_t *bytesWritten) noexce
 	{
 		crc.Update(s, len);
 	}
-	const FRESULT writeStatus = f_write(&file, s, len, bytesWritten);
+	UINT bw;
+	const FRESULT writeStatus = f_write(&file, s, len, &bw);
+	*bytesWritten = bw;
 	return writeStatus;
 }
 
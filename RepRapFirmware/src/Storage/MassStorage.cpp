@@ -3,6 +3,7 @@
 #include <Platform/RepRap.h>
 #include <ObjectModel/ObjectModel.h>
 #include <Libraries/Fatfs/diskio.h>
+#include "FilePrefetcher.h"
 
 #include <Libraries/sd_mmc/sd_mmc.h>
 
@@ -1069,6 +1070,9 @@ void MassStorage::Diagnostics(MessageType mtype) noexcept
 	// Show the longest SD card write time
 	platform.MessageF(mtype, "SD card longest read time %.1fms, write time %.1fms, max retries %u\n",
 								(double)DiskioGetAndClearLongestReadTime(), (double)DiskioGetAndClearLongestWriteTime(), DiskioGetAndClearMaxRetryCount());
+#if SUPPORT_FILE_PREFETCH
+	FilePrefetcher::Diagnostics(mtype);
+#endif
 }
 
 # if SUPPORT_OBJECT_MODEL
@@ -0,0 +1,371 @@
+/*
+ * HeaterControlTest.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host test of heater control. A heater configured by M308, M950 and M307 drives a simulated first order process with dead time
+ *  (FOPDT) through the simulated ADC and PWM output, so that the firmware's own control code runs in the loop, ADC filtering included.
+ *  For heating gains 20% below, equal to and 20% above the model we time a heat up from ambient and a tool change from standby
+ *  using PID (M307 B0) and model-predictive control (M307 B2), then we turn on a part cooling fan that the model doesn't know about.
+ *  We check that model-predictive control overshoots by less than 1C and by no more than PID, that it settles no later than PID,
+ *  and that it recovers from the fan step without steady-state error.
+ *  Finally we fast tune the heater (M303 Q1) with a tool fan that the plant responds to, and check that the model it measures is
+ *  within 1% of the plant.
+ */
+
+#include "HostTest.h"
+#include "Check.h"
+#include <HostSim.h>
+#include <AnalogIn.h>
+#include <GCodes/GCodeBuffer/GCodeBuffer.h>
+#include <GCodes/GCodeBuffer/ExpressionParser.h>
+#include <GCodes/GCodeException.h>
+#include <Heating/Heat.h>
+#include <Fans/FansManager.h>
+#include <Platform/RepRap.h>
+#include <Tools/Tool.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// The heater model. These are typical values for a tool heater.
+static constexpr float ModelHeatingRate = 2.43;					// C/sec at full power
+static constexpr float ModelTimeConstant = 140.0;				// seconds
+static constexpr float ModelDeadTime = 5.5;						// seconds
+static constexpr float FanOnTimeConstant = 100.0;				// the time constant with the part cooling fan on, which the model doesn't know about
+
+// The temperature sensor is a filtered linear analog sensor with this range, so that the ADC reading is simple to calculate
+static constexpr float SensorMaxTemperature = 500.0;
+
+static constexpr uint32_t PlantStepMillis = 50;
+static constexpr float PlantStep = PlantStepMillis * MillisToSeconds;
+static constexpr float StandbyTemperature = 160.0;
+static constexpr float ActiveTemperature = 210.0;
+static constexpr float SettledBand = 1.0;						// the temperature must stay within this of the target for the heater to be settled
+static constexpr float HeatUpTime = 250.0;						// how long we allow for each test
+static constexpr float StandbyTime = 150.0;
+static constexpr float ToolChangeTime = 150.0;
+static constexpr float FanTime = 200.0;
+
+static constexpr float GainErrors[] = { -0.2, 0.0, 0.2 };
+
+// Fast tuning
+static constexpr float TuningTemperature = 200.0;
+static constexpr float TuningCoolingRateChangeFanOn = 1.0/FanOnTimeConstant - 1.0/ModelTimeConstant;
+static constexpr float MaxTuningTime = 600.0;					// the longest we allow for fast tuning, in seconds
+static constexpr float MaxTuningError = 0.01;					// the largest relative error we accept in each measured model parameter
+
+// A heater and its thermal mass, simulated as a first order process with dead time
+class FopdtPlant
+{
+public:
+	FopdtPlant(float pHeatingRate, float pCoolingRate, float pCoolingRateChangeFanOn, float deadTime) noexcept
+		: heatingRate(pHeatingRate), coolingRate(pCoolingRate), coolingRateChangeFanOn(pCoolingRateChangeFanOn), temperature(NormalAmbientTemperature),
+		  previousPwms((size_t)lrintf(deadTime/PlantStep), 0.0), nextPwm(0) { }
+
+	void SetCoolingRate(float rate) noexcept { coolingRate = rate; }
+	float GetTemperature() const noexcept { return temperature; }
+
+	// Apply the heater and fan PWMs for one step. The heater PWM takes effect after the dead time, the fan PWM immediately.
+	void Step(float pwm, float fanPwm) noexcept
+	{
+		const float delayedPwm = previousPwms[nextPwm];
+		previousPwms[nextPwm] = pwm;
+		nextPwm = (nextPwm + 1) % previousPwms.size();
+		temperature += (heatingRate * delayedPwm - (coolingRate + coolingRateChangeFanOn * fanPwm) * (temperature - NormalAmbientTemperature)) * PlantStep;
+	}
+
+private:
+	float heatingRate;
+	float coolingRate;
+	float coolingRateChangeFanOn;
+	float temperature;
+	std::vector<float> previousPwms;
+	size_t nextPwm;
+};
+
+// How the temperature responded to a change in the target or the load
+struct Response
+{
+	float overshoot;						// the greatest temperature above the target
+	float maxDeviation;						// the greatest difference from the target after the heater first settled, or after the load changed
+	float settleTime;						// the time after which the temperature stayed within SettledBand of the target
+	float finalError;						// the mean error over the last 30 seconds
+};
+
+static Pin heaterPin = NoPin;
+static Pin fanPin = NoPin;
+static AdcInput sensorInput = AdcInput::none;
+
+// Return the ADC reading that the sensor gives at the specified temperature
+static uint16_t SensorReading(float temperature) noexcept
+{
+	return (uint16_t)constrain<long>(lrintf(temperature * (float)(1u << AnalogIn::AdcBits)/SensorMaxTemperature), 0, (1u << AnalogIn::AdcBits) - 1);
+}
+
+// Run the plant for one step
+static void StepPlant(FopdtPlant& plant) noexcept
+{
+	plant.Step(HostSim::GetAnalogOutput(heaterPin), HostSim::GetAnalogOutput(fanPin));
+	HostSim::SetAnalogReading(sensorInput, SensorReading(plant.GetTemperature()));
+	HostTestDelay(PlantStepMillis);
+}
+
+// Run the plant for the specified time and record how the temperature responds
+static Response Run(FopdtPlant& plant, float target, float duration, bool loadChange) noexcept
+{
+	Response rslt = { 0.0, 0.0, 0.0, 0.0 };
+	float errorSum = 0.0;
+	unsigned int errorCount = 0;
+	bool reachedTarget = loadChange;
+	const unsigned int steps = (unsigned int)lrintf(duration/PlantStep);
+	for (unsigned int i = 0; i < steps; ++i)
+	{
+		StepPlant(plant);
+		const float error = plant.GetTemperature() - target;
+		const float time = (float)(i + 1) * PlantStep;
+		rslt.overshoot = max<float>(rslt.overshoot, error);
+		if (fabsf(error) > SettledBand)
+		{
+			rslt.settleTime = time;
+		}
+		if (!reachedTarget && fabsf(error) <= SettledBand)
+		{
+			reachedTarget = true;
+		}
+		if (reachedTarget)
+		{
+			rslt.maxDeviation = max<float>(rslt.maxDeviation, fabsf(error));
+		}
+		if (time > duration - 30.0)
+		{
+			errorSum += error;
+			++errorCount;
+		}
+	}
+	rslt.finalError = errorSum/(float)errorCount;
+	return rslt;
+}
+
+// Execute a heater, fan or tuning command and check that it succeeded
+static void Configure(GCodeBuffer& gb, const char *command) noexcept
+{
+	String<StringLength256> reply;
+	GCodeResult rslt;
+	gb.PutAndDecode(command);
+	try
+	{
+		Heat& heat = reprap.GetHeat();
+		FansManager& fans = reprap.GetFansManager();
+		bool error = false;
+		switch (gb.GetCommandNumber())
+		{
+		case 106:
+			gb.MustSee('P');
+			(void)fans.ConfigureFan(106, gb.GetUIValue(), gb, reply.GetRef(), error);
+			rslt = (error) ? GCodeResult::error : GCodeResult::ok;
+			break;
+
+		case 303:	rslt = heat.TuneHeater(gb, reply.GetRef()); break;
+		case 307:	rslt = heat.SetOrReportHeaterModel(gb, reply.GetRef()); break;
+		case 308:	rslt = heat.ConfigureSensor(gb, reply.GetRef()); break;
+		case 950:	rslt = (gb.Seen('F')) ? fans.ConfigureFanPort(gb, reply.GetRef()) : heat.ConfigureHeater(gb, reply.GetRef()); break;
+		default:	rslt = GCodeResult::error; break;
+		}
+	}
+	catch (const GCodeException& e)
+	{
+		e.GetMessage(reply.GetRef(), &gb);
+		rslt = GCodeResult::error;
+	}
+	if (rslt > GCodeResult::warning)
+	{
+		printf("%s: %s\n", command, reply.c_str());
+	}
+	CHECK(rslt <= GCodeResult::warning);
+}
+
+// Set the target temperature and turn the heater on
+static void SetTarget(float target) noexcept
+{
+	String<StringLength256> reply;
+	try
+	{
+		reprap.GetHeat().SetActiveTemperature(0, target);
+	}
+	catch (const GCodeException&)
+	{
+		CHECK(false);
+	}
+	CHECK(reprap.GetHeat().Activate(0, reply.GetRef()) == GCodeResult::ok);
+}
+
+// Simulate a heater with the specified gain error using the specified control mode, and return the responses to a heat up from ambient,
+// a tool change from standby and a fan step
+static void RunController(GCodeBuffer& gb, unsigned int controlMode, float gainError, Response responses[3]) noexcept
+{
+	String<StringLength100> command;
+	command.printf("M307 H0 R%.2f C%.1f D%.1f S1.0 V0 B%u", (double)ModelHeatingRate, (double)ModelTimeConstant, (double)ModelDeadTime, controlMode);
+	Configure(gb, command.c_str());
+
+	FopdtPlant plant(ModelHeatingRate * (1.0 + gainError), 1.0/ModelTimeConstant, 0.0, ModelDeadTime);
+	HostSim::SetAnalogReading(sensorInput, SensorReading(plant.GetTemperature()));
+	HostTestDelay(1000);											// let the sensor filter fill up
+
+	SetTarget(ActiveTemperature);
+	responses[0] = Run(plant, ActiveTemperature, HeatUpTime, false);
+
+	SetTarget(StandbyTemperature);
+	(void)Run(plant, StandbyTemperature, StandbyTime, false);
+	SetTarget(ActiveTemperature);
+	responses[1] = Run(plant, ActiveTemperature, ToolChangeTime, false);
+
+	plant.SetCoolingRate(1.0/FanOnTimeConstant);
+	responses[2] = Run(plant, ActiveTemperature, FanTime, true);
+
+	reprap.GetHeat().SwitchOff(0);
+}
+
+// Return the relative error in a measured value
+static float RelativeError(float measured, float actual) noexcept
+{
+	return fabsf(measured - actual)/actual;
+}
+
+// Return a heater model parameter from the object model, or NaN if it can't be read
+static float GetModelValue(const GCodeBuffer& gb, const char *field) noexcept
+{
+	String<StringLength50> expression;
+	expression.printf("heat.heaters[0].model.%s", field);
+	try
+	{
+		ExpressionParser parser(gb, expression.c_str(), expression.c_str() + expression.strlen());
+		const ExpressionValue val = parser.Parse();
+		return (val.GetType() == TypeCode::Float) ? val.fVal : NAN;
+	}
+	catch (const GCodeException&)
+	{
+		return NAN;
+	}
+}
+
+// Fast tune a heater that has a tool fan, and check that the measured model matches the plant
+static void RunFastTuning(GCodeBuffer& gb) noexcept
+{
+	// Create a tool that uses the heater and a fan, so that tuning measures the cooling rate at several fan speeds
+	Configure(gb, "M950 F0 C\"out4\"");
+	Configure(gb, "M106 P0 L0 B0");
+	LogicalPin lpin;
+	bool hardwareInverted;
+	CHECK(LookupPinName("out4", lpin, hardwareInverted));
+	fanPin = (Pin)lpin;
+	int32_t heaters[1] = { 0 };
+	String<StringLength100> reply;
+	Tool * const tool = Tool::Create(0, "", nullptr, 0, heaters, 1, AxesBitmap::MakeFromBits(X_AXIS), AxesBitmap::MakeFromBits(Y_AXIS), FansBitmap::MakeFromBits(0), -1, 0, -1, reply.GetRef());
+	CHECK(tool != nullptr);
+	if (tool == nullptr)
+	{
+		return;
+	}
+	reprap.AddTool(tool);
+
+	// The ADC filter delays the temperature readings by tens of milliseconds, which tuning correctly measures as part of the dead time.
+	// Read the sensor unfiltered so that we can compare the dead time with the plant's.
+	Configure(gb, "M308 S0 F0");
+
+	// Start from a model that is well away from the plant, so that the checks fail unless tuning replaced it
+	Configure(gb, "M307 H0 R1.0 C300 D2.0 S1.0 V0 B0");
+
+	// Start from cold, with the heater's average PWM back to zero
+	FopdtPlant plant(ModelHeatingRate, 1.0/ModelTimeConstant, TuningCoolingRateChangeFanOn, ModelDeadTime);
+	for (unsigned int i = 0; i < (unsigned int)lrintf(60.0/PlantStep); ++i)
+	{
+		StepPlant(plant);
+	}
+
+	String<StringLength100> command;
+	command.printf("M303 T0 S%.1f Q1", (double)TuningTemperature);
+	Configure(gb, command.c_str());
+	CHECK(reprap.GetHeat().GetStatus(0) == HeaterStatus::tuning);
+
+	float tuningTime = 0.0;
+	while (reprap.GetHeat().GetStatus(0) == HeaterStatus::tuning && tuningTime < MaxTuningTime)
+	{
+		StepPlant(plant);
+		tuningTime += PlantStep;
+	}
+	CHECK(tuningTime < MaxTuningTime);
+
+	const float heatingRate = GetModelValue(gb, "heatingRate");
+	const float timeConstant = GetModelValue(gb, "timeConstant");
+	const float timeConstantFansOn = GetModelValue(gb, "timeConstantFansOn");
+	const float deadTime = GetModelValue(gb, "deadTime");
+	printf("Fast tuning took %.0fs: heating rate %.4f (%.4f), time constant %.2f (%.2f), with fan on %.2f (%.2f), dead time %.3f (%.3f)\n",
+			(double)tuningTime,
+			(double)heatingRate, (double)ModelHeatingRate,
+			(double)timeConstant, (double)ModelTimeConstant,
+			(double)timeConstantFansOn, (double)FanOnTimeConstant,
+			(double)deadTime, (double)ModelDeadTime);
+	CHECK(RelativeError(heatingRate, ModelHeatingRate) < MaxTuningError);
+	CHECK(RelativeError(timeConstant, ModelTimeConstant) < MaxTuningError);
+	CHECK(RelativeError(timeConstantFansOn, FanOnTimeConstant) < MaxTuningError);
+	CHECK(RelativeError(deadTime, ModelDeadTime) < MaxTuningError);
+}
+
+static void Report(const char *mode, float gainError, const char *test, const Response& r) noexcept
+{
+	printf("%-5s gain %+3d%% %-11s overshoot %5.2fC, max deviation %5.2fC, settled after %5.1fs, final error %+.3fC\n",
+			mode, (int)lrintf(gainError * 100.0), test, (double)r.overshoot, (double)r.maxDeviation, (double)r.settleTime, (double)r.finalError);
+}
+
+int RunHostTest(int argc, char *argv[]) noexcept
+{
+	LogicalPin lpin;
+	bool hardwareInverted;
+	CHECK(LookupPinName("out0", lpin, hardwareInverted));
+	heaterPin = (Pin)lpin;
+	sensorInput = PinToAdcChannel(TEMP_SENSE_PINS[0]);
+	HostSim::SetAnalogReading(sensorInput, SensorReading(NormalAmbientTemperature));		// so that the sensor is good when we create the heater
+
+	GCodeBuffer * const gb = new GCodeBuffer(GCodeChannel::File, nullptr, nullptr, GenericMessage);
+	String<StringLength100> command;
+	command.printf("M308 S0 P\"temp0\" Y\"linear-analog\" F1 B0 C%.1f", (double)SensorMaxTemperature);
+	Configure(*gb, command.c_str());
+	Configure(*gb, "M950 H0 C\"out0\" T0");
+
+	static constexpr const char *TestNames[3] = { "heat up", "tool change", "fan on" };
+	for (float gainError : GainErrors)
+	{
+		Response pid[3], mpc[3];
+		RunController(*gb, 0, gainError, pid);
+		RunController(*gb, 2, gainError, mpc);
+		for (size_t i = 0; i < 3; ++i)
+		{
+			Report("PID", gainError, TestNames[i], pid[i]);
+			Report("MPC", gainError, TestNames[i], mpc[i]);
+		}
+
+		// Heat up and tool change: less overshoot than PID, under 1C, and settling no later than PID
+		for (size_t i = 0; i < 2; ++i)
+		{
+			CHECK(mpc[i].overshoot < 1.0);
+			CHECK(mpc[i].overshoot <= pid[i].overshoot + 0.05);
+			CHECK(mpc[i].settleTime <= pid[i].settleTime);
+			CHECK(fabsf(mpc[i].finalError) < 0.2);
+		}
+
+		// Fan step: recovery to within the settled band and no steady-state error
+		CHECK(mpc[2].settleTime < FanTime - 30.0);
+		CHECK(fabsf(mpc[2].finalError) < 0.2);
+	}
+
+	RunFastTuning(*gb);
+
+	delete gb;
+	return CheckResult("HeaterControlTest");
+}
+
+// End
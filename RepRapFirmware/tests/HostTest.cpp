@@ -0,0 +1,55 @@
+/*
+ * HostTest.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Driver for the host tests that need the simulated firmware. The firmware's main task polls the USB port once it has initialised,
+ *  so we run the test the first time it asks for input and then end the process with the test's exit code.
+ */
+
+#include "HostTest.h"
+#include <HostSim.h>
+#include <Platform/RepRap.h>
+
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+
+static int testArgc = 0;
+static char **testArgv = nullptr;
+static bool testRunning = false;
+
+void AppHostInit(int argc, char *argv[]) noexcept
+{
+	testArgc = argc - 1;
+	testArgv = argv + 1;
+}
+
+size_t AppHostReadUsb(uint8_t *buffer, size_t maxBytes) noexcept
+{
+	if (testRunning)
+	{
+		return 0;													// the test called HostTestDelay, which runs the main loop
+	}
+	testRunning = true;
+	const int exitCode = RunHostTest(testArgc, testArgv);
+	fflush(stdout);
+	_exit(exitCode);												// the other firmware tasks are still running, so don't run the static destructors
+}
+
+uint64_t HostNanoseconds() noexcept
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void HostTestDelay(uint32_t ms) noexcept
+{
+	reprap.Spin();
+	delay(ms);
+}
+
+// End
@@ -0,0 +1,40 @@
+/*
+ * HostTest.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Driver for the host tests that need the simulated firmware. A host test is linked with the simulator objects in place of the
+ *  G-code replay driver. It runs in the firmware's main task once the firmware has initialised, so it can use the object model,
+ *  the G-code parser and the global variables the same way that the firmware does.
+ */
+
+#ifndef TESTS_HOSTTEST_H_
+#define TESTS_HOSTTEST_H_
+
+#include <cstdint>
+
+/**
+ * @brief The body of a host test, which each test defines
+ * @param argc Number of command line arguments not including the program name
+ * @param argv Command line arguments not including the program name
+ * @return The process exit code, 0 if the test passed
+ */
+extern int RunHostTest(int argc, char *argv[]) noexcept;
+
+/**
+ * @brief Read the host's monotonic clock. Host tests use this to time code because simulated time doesn't advance during a test.
+ * @return Host time in nanoseconds
+ */
+extern uint64_t HostNanoseconds() noexcept;
+
+/**
+ * @brief Let the other firmware tasks run for a time. Simulated time doesn't advance while a test is running code, so a test that
+ * simulates a process over time calls this between steps. It runs the firmware's main loop once so that the main task watchdog
+ * doesn't fire. The USB port returns no input while a test is running.
+ * @param ms Simulated time to wait in milliseconds
+ */
+extern void HostTestDelay(uint32_t ms) noexcept;
+
+#endif /* TESTS_HOSTTEST_H_ */
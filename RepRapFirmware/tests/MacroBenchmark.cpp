@@ -0,0 +1,207 @@
+/*
+ * MacroBenchmark.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host benchmark of variable lookup in macros. It creates a set of global variables and local variables of the size that our macro
+ *  libraries use, then evaluates expressions that refer to them the way a macro does, first using the VariableSet index and then
+ *  searching the whole list as Lookup did before the index existed. It checks that both methods give the same results, including
+ *  after variables have been deleted or have gone out of scope, and reports the expressions evaluated per second. It also times the
+ *  lookup of each global variable on its own, because in a macro the cost of parsing the expression hides much of the lookup time.
+ *
+ *  Usage: MacroBenchmark [passes]
+ */
+
+#include "HostTest.h"
+#include "Check.h"
+#include <GCodes/GCodeBuffer/GCodeBuffer.h>
+#include <GCodes/GCodeBuffer/ExpressionParser.h>
+#include <GCodes/GCodeException.h>
+#include <ObjectModel/Variable.h>
+#include <Platform/RepRap.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static constexpr unsigned int DefaultPasses = 2000;
+static constexpr unsigned int NumGlobals = 64;
+static constexpr unsigned int NumLocals = 12;
+
+// Expressions of the kind found in our macro libraries. Some refer to variables that don't exist or have been deleted.
+static constexpr const char *Expressions[] =
+{
+	"global.g0 + global.g63",
+	"global.g17 * var.v3 - var.v11",
+	"exists(global.g40) && exists(var.v0)",
+	"exists(global.missing)",
+	"global.deleted",
+	"var.v5 + 1",
+	"var.scoped",
+	"global.g31 > global.g32",
+	"global.shadowed",
+	"var.v7 + global.g62 + global.g1 + global.g33",
+};
+
+// Create the global and local variables
+static void CreateVariables(VariableSet& locals) noexcept
+{
+	WriteLockedPointer<VariableSet> globals = reprap.GetGlobalVariablesForWriting();
+	for (unsigned int i = 0; i < NumGlobals; ++i)
+	{
+		String<MaxVariableNameLength> name;
+		name.printf("g%u", i);
+		globals->Insert(new Variable(name.c_str(), ExpressionValue((int32_t)i), 0));
+	}
+	globals->Insert(new Variable("deleted", ExpressionValue(1.0f, 1), 0));
+	globals->Insert(new Variable("shadowed", ExpressionValue((int32_t)1), 0));
+	globals->Insert(new Variable("shadowed", ExpressionValue((int32_t)2), 0));
+	globals->Delete("deleted");
+
+	for (unsigned int i = 0; i < NumLocals; ++i)
+	{
+		String<MaxVariableNameLength> name;
+		name.printf("v%u", i);
+		locals.Insert(new Variable(name.c_str(), ExpressionValue((float)i * 0.5f, 1), 0));
+	}
+	locals.Insert(new Variable("scoped", ExpressionValue((int32_t)5), 1));
+	locals.EndScope(0);
+}
+
+// Convert the result of an expression to a float so that we can compare results
+static float ResultValue(const ExpressionValue& val) noexcept
+{
+	switch (val.GetType())
+	{
+	case TypeCode::Int32:	return (float)val.iVal;
+	case TypeCode::Float:	return val.fVal;
+	case TypeCode::Bool:	return (val.bVal) ? 1.0f : 0.0f;
+	default:				return -INFINITY;
+	}
+}
+
+// Evaluate every expression. If 'results' isn't null, record the results.
+static void EvaluateExpressions(const GCodeBuffer& gb, std::vector<float> *results) noexcept
+{
+	for (const char *expr : Expressions)
+	{
+		float val;
+		try
+		{
+			ExpressionParser parser(gb, expr, expr + strlen(expr));
+			val = ResultValue(parser.Parse());
+		}
+		catch (const GCodeException&)
+		{
+			val = NAN;
+		}
+		if (results != nullptr)
+		{
+			results->push_back(val);
+		}
+	}
+}
+
+// Evaluate the expressions for the requested number of passes and return the expressions evaluated per second
+static double TimeEvaluation(const GCodeBuffer& gb, unsigned int passes) noexcept
+{
+	const uint64_t startTime = HostNanoseconds();
+	for (unsigned int i = 0; i < passes; ++i)
+	{
+		EvaluateExpressions(gb, nullptr);
+	}
+	const uint64_t elapsedTime = HostNanoseconds() - startTime;
+	return (double)ARRAY_SIZE(Expressions) * passes * 1.0e9/(double)elapsedTime;
+}
+
+// Look up every global variable and one that doesn't exist for the requested number of passes and return the lookups per second.
+// This measures the lookup on its own, without the cost of parsing the expression.
+static double TimeLookups(unsigned int passes) noexcept
+{
+	ReadLockedPointer<const VariableSet> globals = reprap.GetGlobalVariablesForReading();
+	std::vector<String<MaxVariableNameLength>> names(NumGlobals + 1);
+	for (unsigned int i = 0; i < NumGlobals; ++i)
+	{
+		names[i].printf("g%u", i);
+	}
+	names[NumGlobals].copy("missing");
+
+	unsigned int found = 0;
+	const uint64_t startTime = HostNanoseconds();
+	for (unsigned int i = 0; i < passes; ++i)
+	{
+		for (const String<MaxVariableNameLength>& name : names)
+		{
+			if (globals->Lookup(name.c_str()) != nullptr)
+			{
+				++found;
+			}
+		}
+	}
+	const uint64_t elapsedTime = HostNanoseconds() - startTime;
+	CHECK(found == NumGlobals * passes);
+	return (double)names.size() * passes * 1.0e9/(double)elapsedTime;
+}
+
+// Return true if the results are the same, treating NaNs as equal
+static bool SameResults(const std::vector<float>& a, const std::vector<float>& b) noexcept
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i] != b[i] && !(std::isnan(a[i]) && std::isnan(b[i])))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int RunHostTest(int argc, char *argv[]) noexcept
+{
+	const unsigned int passes = (argc >= 1) ? (unsigned int)StrToU32(argv[0]) : DefaultPasses;
+
+	GCodeBuffer * const gb = new GCodeBuffer(GCodeChannel::File, nullptr, nullptr, GenericMessage);
+	CreateVariables(gb->GetVariables());
+
+	std::vector<float> indexedResults, scannedResults;
+	VariableSet::useIndex = true;
+	EvaluateExpressions(*gb, &indexedResults);
+	const double indexedRate = TimeEvaluation(*gb, passes);
+	const double indexedLookupRate = TimeLookups(passes);
+
+	VariableSet::useIndex = false;
+	EvaluateExpressions(*gb, &scannedResults);
+	const double scannedRate = TimeEvaluation(*gb, passes);
+	const double scannedLookupRate = TimeLookups(passes);
+	VariableSet::useIndex = true;
+
+	CHECK(SameResults(indexedResults, scannedResults));
+	CHECK(indexedResults.size() == ARRAY_SIZE(Expressions));
+	if (indexedResults.size() == ARRAY_SIZE(Expressions))
+	{
+		CHECK(indexedResults[0] == 63.0f);
+		CHECK(indexedResults[3] == 0.0f);
+		CHECK(std::isnan(indexedResults[4]));					// deleted
+		CHECK(std::isnan(indexedResults[6]));					// out of scope
+		CHECK(indexedResults[8] == 2.0f);						// the most recent variable with a name hides older ones
+	}
+
+	printf("%u global and %u local variables, %u expressions, %u passes\n", NumGlobals + 2, NumLocals, (unsigned int)ARRAY_SIZE(Expressions), passes);
+	printf("Indexed lookup: %.0f expressions/sec, %.0f global lookups/sec\n", indexedRate, indexedLookupRate);
+	printf("List search: %.0f expressions/sec, %.0f global lookups/sec\n", scannedRate, scannedLookupRate);
+	printf("Speedup: %.2f for expressions, %.2f for lookups\n", indexedRate/scannedRate, indexedLookupRate/scannedLookupRate);
+
+	gb->GetVariables().Clear();
+	reprap.GetGlobalVariablesForWriting()->Clear();
+	delete gb;
+	return CheckResult("MacroBenchmark");
+}
+
+// End
@@ -0,0 +1,234 @@
+/*
+ * ModelPollBenchmark.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host benchmark of the ways a client can keep a copy of the object model up to date. It simulates a client polling the firmware
+ *  while parts of the object model change, and counts the requests, bytes and host CPU time that each way costs per poll:
+ *   - full: fetch the whole model on every poll (flags "d99vn")
+ *   - seqs: fetch the live values and the sequence numbers (flags "d99fn"), then fetch each top-level key whose sequence number
+ *     changed (flags "d99vn"). This is what DWC and DSF do.
+ *   - delta: top-level delta mode (flags "d99vnc<seq>"), which returns the live values and every top-level key that changed
+ *     since the change sequence number that the client received last time, in one response.
+ *  It also checks that delta mode reports a changed key in full once and then goes back to reporting its live values only.
+ *
+ *  Usage: ModelPollBenchmark [polls]
+ */
+
+#include "HostTest.h"
+#include "Check.h"
+#include <Platform/RepRap.h>
+#include <Platform/OutputMemory.h>
+#include <GCodes/GCodeException.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static constexpr unsigned int DefaultPolls = 200;
+
+// The top-level keys that have sequence numbers in the seqs object
+static constexpr const char *SequencedKeys[] =
+{
+	"boards", "directories", "fans", "global", "heat", "inputs", "job", "move", "network", "scanner", "sensors", "spindles", "state", "tools", "volumes"
+};
+
+static constexpr size_t NumSequencedKeys = ARRAY_SIZE(SequencedKeys);
+
+// How often each part of the model changes in a scenario, in polls. Zero means never.
+struct Scenario
+{
+	const char *name;
+	unsigned int stateEvery;
+	unsigned int heatEvery;
+	unsigned int moveEvery;
+	unsigned int toolsEvery;
+};
+
+static constexpr Scenario Scenarios[] =
+{
+	{ "idle",		0,	0,	0,	0 },
+	{ "printing",	5,	10,	20,	50 },
+	{ "busy",		1,	2,	4,	10 },
+};
+
+// The cost of keeping the client up to date
+struct PollCost
+{
+	unsigned int requests = 0;
+	size_t bytes = 0;
+	uint64_t nanoseconds = 0;
+};
+
+// Fetch part of the object model. Return the response, or an empty string if there was an error.
+static std::string Request(const char *key, const char *flags, PollCost& cost) noexcept
+{
+	std::string response;
+	const uint64_t startTime = HostNanoseconds();
+	try
+	{
+		OutputBuffer *buf = reprap.GetModelResponse(key, flags);
+		if (buf != nullptr)
+		{
+			for (const OutputBuffer *b = buf; b != nullptr; b = b->Next())
+			{
+				response.append(b->Data(), b->DataLength());
+			}
+			OutputBuffer::ReleaseAll(buf);
+		}
+	}
+	catch (const GCodeException&)
+	{
+	}
+	cost.nanoseconds += HostNanoseconds() - startTime;
+	++cost.requests;
+	cost.bytes += response.length();
+	return response;
+}
+
+// Get the number that follows a quoted name in a JSON response, starting the search at 'startPos'. Return false if it isn't there.
+static bool GetNumber(const std::string& response, const char *name, size_t startPos, uint32_t& val) noexcept
+{
+	const std::string quotedName = std::string("\"") + name + "\":";
+	const size_t pos = response.find(quotedName, startPos);
+	if (pos == std::string::npos)
+	{
+		return false;
+	}
+	val = StrToU32(response.c_str() + pos + quotedName.length());
+	return true;
+}
+
+// A client that polls the live values and the sequence numbers, then fetches the keys whose sequence numbers have changed
+class SeqsClient
+{
+public:
+	SeqsClient() noexcept
+	{
+		for (uint32_t& s : seqs)
+		{
+			s = 0;
+		}
+	}
+
+	void Poll(PollCost& cost) noexcept
+	{
+		const std::string response = Request("", "d99fn", cost);
+		const size_t seqsPos = response.find("\"seqs\":{");
+		CHECK(seqsPos != std::string::npos);
+		if (seqsPos == std::string::npos)
+		{
+			return;
+		}
+		for (size_t i = 0; i < NumSequencedKeys; ++i)
+		{
+			uint32_t newSeq;
+			if (GetNumber(response, SequencedKeys[i], seqsPos, newSeq) && newSeq != seqs[i])
+			{
+				seqs[i] = newSeq;
+				(void)Request(SequencedKeys[i], "d99vn", cost);
+			}
+		}
+	}
+
+private:
+	uint32_t seqs[NumSequencedKeys];
+};
+
+// A client that uses top-level delta mode
+class DeltaClient
+{
+public:
+	DeltaClient() noexcept : seq(0) { }
+
+	// Poll for changes and return the response
+	std::string Poll(PollCost& cost) noexcept
+	{
+		String<StringLength20> flags;
+		flags.printf("d99vnc%" PRIu32, seq);
+		const std::string response = Request("", flags.c_str(), cost);
+		uint32_t newSeq;
+		const size_t seqPos = response.rfind(",\"seq\":");
+		CHECK(seqPos != std::string::npos && GetNumber(response, "seq", seqPos, newSeq));
+		if (seqPos != std::string::npos && GetNumber(response, "seq", seqPos, newSeq))
+		{
+			seq = newSeq;
+		}
+		return response;
+	}
+
+private:
+	uint32_t seq;
+};
+
+// Make the changes that the scenario calls for before this poll
+static void MakeChanges(const Scenario& scenario, unsigned int poll) noexcept
+{
+	if (scenario.stateEvery != 0 && poll % scenario.stateEvery == 0) { reprap.StateUpdated(); }
+	if (scenario.heatEvery != 0 && poll % scenario.heatEvery == 0) { reprap.HeatUpdated(); }
+	if (scenario.moveEvery != 0 && poll % scenario.moveEvery == 0) { reprap.MoveUpdated(); }
+	if (scenario.toolsEvery != 0 && poll % scenario.toolsEvery == 0) { reprap.ToolsUpdated(); }
+}
+
+static void Report(const char *method, const PollCost& cost, unsigned int polls) noexcept
+{
+	printf("  %-6s %5.2f requests/poll, %6.0f bytes/poll, %7.1fus/poll\n",
+			method, (double)cost.requests/(double)polls, (double)cost.bytes/(double)polls, (double)cost.nanoseconds/(double)(1000u * polls));
+}
+
+// Check that delta mode reports a changed key in full once, then reports only its live values
+static void CheckDeltaMode() noexcept
+{
+	static constexpr const char *NonLiveHeatField = "\"coldExtrudeTemperature\"";
+	PollCost cost;
+	DeltaClient client;
+	CHECK(client.Poll(cost).find(NonLiveHeatField) != std::string::npos);		// the first poll reports everything
+	CHECK(client.Poll(cost).find(NonLiveHeatField) == std::string::npos);
+	reprap.HeatUpdated();
+	CHECK(client.Poll(cost).find(NonLiveHeatField) != std::string::npos);
+	CHECK(client.Poll(cost).find(NonLiveHeatField) == std::string::npos);
+}
+
+int RunHostTest(int argc, char *argv[]) noexcept
+{
+	const unsigned int polls = (argc >= 1) ? (unsigned int)StrToU32(argv[0]) : DefaultPolls;
+
+	CheckDeltaMode();
+
+	printf("%u polls\n", polls);
+	for (const Scenario& scenario : Scenarios)
+	{
+		// Let each client get its first copy of the whole model before we start counting
+		SeqsClient seqsClient;
+		DeltaClient deltaClient;
+		PollCost fullCost, seqsCost, deltaCost;
+		seqsClient.Poll(seqsCost);
+		(void)deltaClient.Poll(deltaCost);
+		seqsCost = deltaCost = PollCost();
+
+		for (unsigned int poll = 1; poll <= polls; ++poll)
+		{
+			MakeChanges(scenario, poll);
+			(void)Request("", "d99vn", fullCost);
+			seqsClient.Poll(seqsCost);
+			(void)deltaClient.Poll(deltaCost);
+		}
+
+		CHECK(fullCost.requests == polls);
+		CHECK(deltaCost.requests == polls);
+		CHECK(deltaCost.bytes < fullCost.bytes);
+		printf("Scenario \"%s\"\n", scenario.name);
+		Report("full", fullCost, polls);
+		Report("seqs", seqsCost, polls);
+		Report("delta", deltaCost, polls);
+		printf("  delta mode compared with seqs: %.0f%% of the requests, %.0f%% of the bytes, %.0f%% of the time\n",
+				(double)(100u * deltaCost.requests)/(double)seqsCost.requests, (double)(100u * deltaCost.bytes)/(double)seqsCost.bytes,
+				(double)(100u * deltaCost.nanoseconds)/(double)seqsCost.nanoseconds);
+	}
+
+	return CheckResult("ModelPollBenchmark");
+}
+
+// End
@@ -0,0 +1,680 @@
+; Move list for the DDA::Prepare, lookahead and step ISR benchmark, recorded from slicer output.
+; Two layers of a 20mm diameter cylinder: three perimeters tessellated into 0.6mm segments, and rectilinear infill.
+; "make benchmark" replays it and reports the pipeline timing statistics from M122.
+M584 X0 Y1 Z2 E3
+M350 X16 Y16 Z16 E16 I1
+M92 X80 Y80 Z400 E420
+M203 X12000 Y12000 Z600 E3000
+M201 X3000 Y3000 Z200 E3000
+M204 P1500 T3000
+M566 X600 Y600 Z60 E300
+M563 P0 D0
+T0
+M302 P1
+M564 H0 S0
+G90
+M83
+G92 X0 Y0 Z0
+M122
+G1 Z0.200 F600
+G1 X59.600 Y50.000 F9000
+G1 F2400
+G1 X59.581 Y50.603 E0.02008
+G1 X59.524 Y51.203 E0.02008
+G1 X59.430 Y51.799 E0.02008
+G1 X59.298 Y52.387 E0.02008
+G1 X59.130 Y52.967 E0.02008
+G1 X58.926 Y53.534 E0.02008
+G1 X58.686 Y54.087 E0.02008
+G1 X58.413 Y54.625 E0.02008
+G1 X58.106 Y55.144 E0.02008
+G1 X57.767 Y55.643 E0.02008
+G1 X57.397 Y56.119 E0.02008
+G1 X56.998 Y56.572 E0.02008
+G1 X56.572 Y56.998 E0.02008
+G1 X56.119 Y57.397 E0.02008
+G1 X55.643 Y57.767 E0.02008
+G1 X55.144 Y58.106 E0.02008
+G1 X54.625 Y58.413 E0.02008
+G1 X54.087 Y58.686 E0.02008
+G1 X53.534 Y58.926 E0.02008
+G1 X52.967 Y59.130 E0.02008
+G1 X52.387 Y59.298 E0.02008
+G1 X51.799 Y59.430 E0.02008
+G1 X51.203 Y59.524 E0.02008
+G1 X50.603 Y59.581 E0.02008
+G1 X50.000 Y59.600 E0.02008
+G1 X49.397 Y59.581 E0.02008
+G1 X48.797 Y59.524 E0.02008
+G1 X48.201 Y59.430 E0.02008
+G1 X47.613 Y59.298 E0.02008
+G1 X47.033 Y59.130 E0.02008
+G1 X46.466 Y58.926 E0.02008
+G1 X45.913 Y58.686 E0.02008
+G1 X45.375 Y58.413 E0.02008
+G1 X44.856 Y58.106 E0.02008
+G1 X44.357 Y57.767 E0.02008
+G1 X43.881 Y57.397 E0.02008
+G1 X43.428 Y56.998 E0.02008
+G1 X43.002 Y56.572 E0.02008
+G1 X42.603 Y56.119 E0.02008
+G1 X42.233 Y55.643 E0.02008
+G1 X41.894 Y55.144 E0.02008
+G1 X41.587 Y54.625 E0.02008
+G1 X41.314 Y54.087 E0.02008
+G1 X41.074 Y53.534 E0.02008
+G1 X40.870 Y52.967 E0.02008
+G1 X40.702 Y52.387 E0.02008
+G1 X40.570 Y51.799 E0.02008
+G1 X40.476 Y51.203 E0.02008
+G1 X40.419 Y50.603 E0.02008
+G1 X40.400 Y50.000 E0.02008
+G1 X40.419 Y49.397 E0.02008
+G1 X40.476 Y48.797 E0.02008
+G1 X40.570 Y48.201 E0.02008
+G1 X40.702 Y47.613 E0.02008
+G1 X40.870 Y47.033 E0.02008
+G1 X41.074 Y46.466 E0.02008
+G1 X41.314 Y45.913 E0.02008
+G1 X41.587 Y45.375 E0.02008
+G1 X41.894 Y44.856 E0.02008
+G1 X42.233 Y44.357 E0.02008
+G1 X42.603 Y43.881 E0.02008
+G1 X43.002 Y43.428 E0.02008
+G1 X43.428 Y43.002 E0.02008
+G1 X43.881 Y42.603 E0.02008
+G1 X44.357 Y42.233 E0.02008
+G1 X44.856 Y41.894 E0.02008
+G1 X45.375 Y41.587 E0.02008
+G1 X45.913 Y41.314 E0.02008
+G1 X46.466 Y41.074 E0.02008
+G1 X47.033 Y40.870 E0.02008
+G1 X47.613 Y40.702 E0.02008
+G1 X48.201 Y40.570 E0.02008
+G1 X48.797 Y40.476 E0.02008
+G1 X49.397 Y40.419 E0.02008
+G1 X50.000 Y40.400 E0.02008
+G1 X50.603 Y40.419 E0.02008
+G1 X51.203 Y40.476 E0.02008
+G1 X51.799 Y40.570 E0.02008
+G1 X52.387 Y40.702 E0.02008
+G1 X52.967 Y40.870 E0.02008
+G1 X53.534 Y41.074 E0.02008
+G1 X54.087 Y41.314 E0.02008
+G1 X54.625 Y41.587 E0.02008
+G1 X55.144 Y41.894 E0.02008
+G1 X55.643 Y42.233 E0.02008
+G1 X56.119 Y42.603 E0.02008
+G1 X56.572 Y43.002 E0.02008
+G1 X56.998 Y43.428 E0.02008
+G1 X57.397 Y43.881 E0.02008
+G1 X57.767 Y44.357 E0.02008
+G1 X58.106 Y44.856 E0.02008
+G1 X58.413 Y45.375 E0.02008
+G1 X58.686 Y45.913 E0.02008
+G1 X58.926 Y46.466 E0.02008
+G1 X59.130 Y47.033 E0.02008
+G1 X59.298 Y47.613 E0.02008
+G1 X59.430 Y48.201 E0.02008
+G1 X59.524 Y48.797 E0.02008
+G1 X59.581 Y49.397 E0.02008
+G1 X59.600 Y50.000 E0.02008
+G1 X59.200 Y50.000 F9000
+G1 F2400
+G1 X59.180 Y50.602 E0.02005
+G1 X59.121 Y51.201 E0.02005
+G1 X59.023 Y51.795 E0.02005
+G1 X58.887 Y52.381 E0.02005
+G1 X58.712 Y52.957 E0.02005
+G1 X58.500 Y53.521 E0.02005
+G1 X58.251 Y54.069 E0.02005
+G1 X57.967 Y54.600 E0.02005
+G1 X57.650 Y55.111 E0.02005
+G1 X57.299 Y55.601 E0.02005
+G1 X56.917 Y56.066 E0.02005
+G1 X56.505 Y56.505 E0.02005
+G1 X56.066 Y56.917 E0.02005
+G1 X55.601 Y57.299 E0.02005
+G1 X55.111 Y57.650 E0.02005
+G1 X54.600 Y57.967 E0.02005
+G1 X54.069 Y58.251 E0.02005
+G1 X53.521 Y58.500 E0.02005
+G1 X52.957 Y58.712 E0.02005
+G1 X52.381 Y58.887 E0.02005
+G1 X51.795 Y59.023 E0.02005
+G1 X51.201 Y59.121 E0.02005
+G1 X50.602 Y59.180 E0.02005
+G1 X50.000 Y59.200 E0.02005
+G1 X49.398 Y59.180 E0.02005
+G1 X48.799 Y59.121 E0.02005
+G1 X48.205 Y59.023 E0.02005
+G1 X47.619 Y58.887 E0.02005
+G1 X47.043 Y58.712 E0.02005
+G1 X46.479 Y58.500 E0.02005
+G1 X45.931 Y58.251 E0.02005
+G1 X45.400 Y57.967 E0.02005
+G1 X44.889 Y57.650 E0.02005
+G1 X44.399 Y57.299 E0.02005
+G1 X43.934 Y56.917 E0.02005
+G1 X43.495 Y56.505 E0.02005
+G1 X43.083 Y56.066 E0.02005
+G1 X42.701 Y55.601 E0.02005
+G1 X42.350 Y55.111 E0.02005
+G1 X42.033 Y54.600 E0.02005
+G1 X41.749 Y54.069 E0.02005
+G1 X41.500 Y53.521 E0.02005
+G1 X41.288 Y52.957 E0.02005
+G1 X41.113 Y52.381 E0.02005
+G1 X40.977 Y51.795 E0.02005
+G1 X40.879 Y51.201 E0.02005
+G1 X40.820 Y50.602 E0.02005
+G1 X40.800 Y50.000 E0.02005
+G1 X40.820 Y49.398 E0.02005
+G1 X40.879 Y48.799 E0.02005
+G1 X40.977 Y48.205 E0.02005
+G1 X41.113 Y47.619 E0.02005
+G1 X41.288 Y47.043 E0.02005
+G1 X41.500 Y46.479 E0.02005
+G1 X41.749 Y45.931 E0.02005
+G1 X42.033 Y45.400 E0.02005
+G1 X42.350 Y44.889 E0.02005
+G1 X42.701 Y44.399 E0.02005
+G1 X43.083 Y43.934 E0.02005
+G1 X43.495 Y43.495 E0.02005
+G1 X43.934 Y43.083 E0.02005
+G1 X44.399 Y42.701 E0.02005
+G1 X44.889 Y42.350 E0.02005
+G1 X45.400 Y42.033 E0.02005
+G1 X45.931 Y41.749 E0.02005
+G1 X46.479 Y41.500 E0.02005
+G1 X47.043 Y41.288 E0.02005
+G1 X47.619 Y41.113 E0.02005
+G1 X48.205 Y40.977 E0.02005
+G1 X48.799 Y40.879 E0.02005
+G1 X49.398 Y40.820 E0.02005
+G1 X50.000 Y40.800 E0.02005
+G1 X50.602 Y40.820 E0.02005
+G1 X51.201 Y40.879 E0.02005
+G1 X51.795 Y40.977 E0.02005
+G1 X52.381 Y41.113 E0.02005
+G1 X52.957 Y41.288 E0.02005
+G1 X53.521 Y41.500 E0.02005
+G1 X54.069 Y41.749 E0.02005
+G1 X54.600 Y42.033 E0.02005
+G1 X55.111 Y42.350 E0.02005
+G1 X55.601 Y42.701 E0.02005
+G1 X56.066 Y43.083 E0.02005
+G1 X56.505 Y43.495 E0.02005
+G1 X56.917 Y43.934 E0.02005
+G1 X57.299 Y44.399 E0.02005
+G1 X57.650 Y44.889 E0.02005
+G1 X57.967 Y45.400 E0.02005
+G1 X58.251 Y45.931 E0.02005
+G1 X58.500 Y46.479 E0.02005
+G1 X58.712 Y47.043 E0.02005
+G1 X58.887 Y47.619 E0.02005
+G1 X59.023 Y48.205 E0.02005
+G1 X59.121 Y48.799 E0.02005
+G1 X59.180 Y49.398 E0.02005
+G1 X59.200 Y50.000 E0.02005
+G1 X58.800 Y50.000 F9000
+G1 F2400
+G1 X58.779 Y50.601 E0.02001
+G1 X58.718 Y51.198 E0.02001
+G1 X58.616 Y51.790 E0.02001
+G1 X58.474 Y52.374 E0.02001
+G1 X58.292 Y52.947 E0.02001
+G1 X58.071 Y53.506 E0.02001
+G1 X57.813 Y54.049 E0.02001
+G1 X57.519 Y54.572 E0.02001
+G1 X57.189 Y55.075 E0.02001
+G1 X56.826 Y55.554 E0.02001
+G1 X56.431 Y56.006 E0.02001
+G1 X56.006 Y56.431 E0.02001
+G1 X55.554 Y56.826 E0.02001
+G1 X55.075 Y57.189 E0.02001
+G1 X54.572 Y57.519 E0.02001
+G1 X54.049 Y57.813 E0.02001
+G1 X53.506 Y58.071 E0.02001
+G1 X52.947 Y58.292 E0.02001
+G1 X52.374 Y58.474 E0.02001
+G1 X51.790 Y58.616 E0.02001
+G1 X51.198 Y58.718 E0.02001
+G1 X50.601 Y58.779 E0.02001
+G1 X50.000 Y58.800 E0.02001
+G1 X49.399 Y58.779 E0.02001
+G1 X48.802 Y58.718 E0.02001
+G1 X48.210 Y58.616 E0.02001
+G1 X47.626 Y58.474 E0.02001
+G1 X47.053 Y58.292 E0.02001
+G1 X46.494 Y58.071 E0.02001
+G1 X45.951 Y57.813 E0.02001
+G1 X45.428 Y57.519 E0.02001
+G1 X44.925 Y57.189 E0.02001
+G1 X44.446 Y56.826 E0.02001
+G1 X43.994 Y56.431 E0.02001
+G1 X43.569 Y56.006 E0.02001
+G1 X43.174 Y55.554 E0.02001
+G1 X42.811 Y55.075 E0.02001
+G1 X42.481 Y54.572 E0.02001
+G1 X42.187 Y54.049 E0.02001
+G1 X41.929 Y53.506 E0.02001
+G1 X41.708 Y52.947 E0.02001
+G1 X41.526 Y52.374 E0.02001
+G1 X41.384 Y51.790 E0.02001
+G1 X41.282 Y51.198 E0.02001
+G1 X41.221 Y50.601 E0.02001
+G1 X41.200 Y50.000 E0.02001
+G1 X41.221 Y49.399 E0.02001
+G1 X41.282 Y48.802 E0.02001
+G1 X41.384 Y48.210 E0.02001
+G1 X41.526 Y47.626 E0.02001
+G1 X41.708 Y47.053 E0.02001
+G1 X41.929 Y46.494 E0.02001
+G1 X42.187 Y45.951 E0.02001
+G1 X42.481 Y45.428 E0.02001
+G1 X42.811 Y44.925 E0.02001
+G1 X43.174 Y44.446 E0.02001
+G1 X43.569 Y43.994 E0.02001
+G1 X43.994 Y43.569 E0.02001
+G1 X44.446 Y43.174 E0.02001
+G1 X44.925 Y42.811 E0.02001
+G1 X45.428 Y42.481 E0.02001
+G1 X45.951 Y42.187 E0.02001
+G1 X46.494 Y41.929 E0.02001
+G1 X47.053 Y41.708 E0.02001
+G1 X47.626 Y41.526 E0.02001
+G1 X48.210 Y41.384 E0.02001
+G1 X48.802 Y41.282 E0.02001
+G1 X49.399 Y41.221 E0.02001
+G1 X50.000 Y41.200 E0.02001
+G1 X50.601 Y41.221 E0.02001
+G1 X51.198 Y41.282 E0.02001
+G1 X51.790 Y41.384 E0.02001
+G1 X52.374 Y41.526 E0.02001
+G1 X52.947 Y41.708 E0.02001
+G1 X53.506 Y41.929 E0.02001
+G1 X54.049 Y42.187 E0.02001
+G1 X54.572 Y42.481 E0.02001
+G1 X55.075 Y42.811 E0.02001
+G1 X55.554 Y43.174 E0.02001
+G1 X56.006 Y43.569 E0.02001
+G1 X56.431 Y43.994 E0.02001
+G1 X56.826 Y44.446 E0.02001
+G1 X57.189 Y44.925 E0.02001
+G1 X57.519 Y45.428 E0.02001
+G1 X57.813 Y45.951 E0.02001
+G1 X58.071 Y46.494 E0.02001
+G1 X58.292 Y47.053 E0.02001
+G1 X58.474 Y47.626 E0.02001
+G1 X58.616 Y48.210 E0.02001
+G1 X58.718 Y48.802 E0.02001
+G1 X58.779 Y49.399 E0.02001
+G1 X58.800 Y50.000 E0.02001
+G1 F4800
+G1 X53.567 Y42.395
+G1 X57.605 Y46.433 E0.19013
+G1 X58.267 Y48.508
+G1 X51.492 Y41.733 E0.31906
+G1 X49.944 Y41.600
+G1 X58.400 Y50.056 E0.39821
+G1 X58.289 Y51.360
+G1 X48.640 Y41.711 E0.45440
+G1 X47.497 Y41.982
+G1 X58.018 Y52.503 E0.49549
+G1 X57.625 Y53.524
+G1 X46.476 Y42.375 E0.52504
+G1 X45.558 Y42.871
+G1 X57.129 Y54.442 E0.54494
+G1 X56.542 Y55.269
+G1 X44.731 Y43.458 E0.55622
+G1 X43.990 Y44.131
+G1 X55.869 Y56.010 E0.55940
+G1 X55.111 Y56.666
+G1 X43.334 Y44.889 E0.55462
+G1 X42.764 Y45.734
+G1 X54.266 Y57.236 E0.54168
+G1 X53.328 Y57.712
+G1 X42.288 Y46.672 E0.51995
+G1 X41.917 Y47.715
+G1 X52.285 Y58.083 E0.48827
+G1 X51.113 Y58.326
+G1 X41.674 Y48.887 E0.44453
+G1 X41.603 Y50.230
+G1 X49.770 Y58.397 E0.38461
+G1 X48.154 Y58.195
+G1 X41.805 Y51.846 E0.29896
+G1 X42.699 Y54.154
+G1 X45.846 Y57.301 E0.14818
+G1 Z0.400 F600
+G1 X59.600 Y50.000 F9000
+G1 F2400
+G1 X59.581 Y50.603 E0.02008
+G1 X59.524 Y51.203 E0.02008
+G1 X59.430 Y51.799 E0.02008
+G1 X59.298 Y52.387 E0.02008
+G1 X59.130 Y52.967 E0.02008
+G1 X58.926 Y53.534 E0.02008
+G1 X58.686 Y54.087 E0.02008
+G1 X58.413 Y54.625 E0.02008
+G1 X58.106 Y55.144 E0.02008
+G1 X57.767 Y55.643 E0.02008
+G1 X57.397 Y56.119 E0.02008
+G1 X56.998 Y56.572 E0.02008
+G1 X56.572 Y56.998 E0.02008
+G1 X56.119 Y57.397 E0.02008
+G1 X55.643 Y57.767 E0.02008
+G1 X55.144 Y58.106 E0.02008
+G1 X54.625 Y58.413 E0.02008
+G1 X54.087 Y58.686 E0.02008
+G1 X53.534 Y58.926 E0.02008
+G1 X52.967 Y59.130 E0.02008
+G1 X52.387 Y59.298 E0.02008
+G1 X51.799 Y59.430 E0.02008
+G1 X51.203 Y59.524 E0.02008
+G1 X50.603 Y59.581 E0.02008
+G1 X50.000 Y59.600 E0.02008
+G1 X49.397 Y59.581 E0.02008
+G1 X48.797 Y59.524 E0.02008
+G1 X48.201 Y59.430 E0.02008
+G1 X47.613 Y59.298 E0.02008
+G1 X47.033 Y59.130 E0.02008
+G1 X46.466 Y58.926 E0.02008
+G1 X45.913 Y58.686 E0.02008
+G1 X45.375 Y58.413 E0.02008
+G1 X44.856 Y58.106 E0.02008
+G1 X44.357 Y57.767 E0.02008
+G1 X43.881 Y57.397 E0.02008
+G1 X43.428 Y56.998 E0.02008
+G1 X43.002 Y56.572 E0.02008
+G1 X42.603 Y56.119 E0.02008
+G1 X42.233 Y55.643 E0.02008
+G1 X41.894 Y55.144 E0.02008
+G1 X41.587 Y54.625 E0.02008
+G1 X41.314 Y54.087 E0.02008
+G1 X41.074 Y53.534 E0.02008
+G1 X40.870 Y52.967 E0.02008
+G1 X40.702 Y52.387 E0.02008
+G1 X40.570 Y51.799 E0.02008
+G1 X40.476 Y51.203 E0.02008
+G1 X40.419 Y50.603 E0.02008
+G1 X40.400 Y50.000 E0.02008
+G1 X40.419 Y49.397 E0.02008
+G1 X40.476 Y48.797 E0.02008
+G1 X40.570 Y48.201 E0.02008
+G1 X40.702 Y47.613 E0.02008
+G1 X40.870 Y47.033 E0.02008
+G1 X41.074 Y46.466 E0.02008
+G1 X41.314 Y45.913 E0.02008
+G1 X41.587 Y45.375 E0.02008
+G1 X41.894 Y44.856 E0.02008
+G1 X42.233 Y44.357 E0.02008
+G1 X42.603 Y43.881 E0.02008
+G1 X43.002 Y43.428 E0.02008
+G1 X43.428 Y43.002 E0.02008
+G1 X43.881 Y42.603 E0.02008
+G1 X44.357 Y42.233 E0.02008
+G1 X44.856 Y41.894 E0.02008
+G1 X45.375 Y41.587 E0.02008
+G1 X45.913 Y41.314 E0.02008
+G1 X46.466 Y41.074 E0.02008
+G1 X47.033 Y40.870 E0.02008
+G1 X47.613 Y40.702 E0.02008
+G1 X48.201 Y40.570 E0.02008
+G1 X48.797 Y40.476 E0.02008
+G1 X49.397 Y40.419 E0.02008
+G1 X50.000 Y40.400 E0.02008
+G1 X50.603 Y40.419 E0.02008
+G1 X51.203 Y40.476 E0.02008
+G1 X51.799 Y40.570 E0.02008
+G1 X52.387 Y40.702 E0.02008
+G1 X52.967 Y40.870 E0.02008
+G1 X53.534 Y41.074 E0.02008
+G1 X54.087 Y41.314 E0.02008
+G1 X54.625 Y41.587 E0.02008
+G1 X55.144 Y41.894 E0.02008
+G1 X55.643 Y42.233 E0.02008
+G1 X56.119 Y42.603 E0.02008
+G1 X56.572 Y43.002 E0.02008
+G1 X56.998 Y43.428 E0.02008
+G1 X57.397 Y43.881 E0.02008
+G1 X57.767 Y44.357 E0.02008
+G1 X58.106 Y44.856 E0.02008
+G1 X58.413 Y45.375 E0.02008
+G1 X58.686 Y45.913 E0.02008
+G1 X58.926 Y46.466 E0.02008
+G1 X59.130 Y47.033 E0.02008
+G1 X59.298 Y47.613 E0.02008
+G1 X59.430 Y48.201 E0.02008
+G1 X59.524 Y48.797 E0.02008
+G1 X59.581 Y49.397 E0.02008
+G1 X59.600 Y50.000 E0.02008
+G1 X59.200 Y50.000 F9000
+G1 F2400
+G1 X59.180 Y50.602 E0.02005
+G1 X59.121 Y51.201 E0.02005
+G1 X59.023 Y51.795 E0.02005
+G1 X58.887 Y52.381 E0.02005
+G1 X58.712 Y52.957 E0.02005
+G1 X58.500 Y53.521 E0.02005
+G1 X58.251 Y54.069 E0.02005
+G1 X57.967 Y54.600 E0.02005
+G1 X57.650 Y55.111 E0.02005
+G1 X57.299 Y55.601 E0.02005
+G1 X56.917 Y56.066 E0.02005
+G1 X56.505 Y56.505 E0.02005
+G1 X56.066 Y56.917 E0.02005
+G1 X55.601 Y57.299 E0.02005
+G1 X55.111 Y57.650 E0.02005
+G1 X54.600 Y57.967 E0.02005
+G1 X54.069 Y58.251 E0.02005
+G1 X53.521 Y58.500 E0.02005
+G1 X52.957 Y58.712 E0.02005
+G1 X52.381 Y58.887 E0.02005
+G1 X51.795 Y59.023 E0.02005
+G1 X51.201 Y59.121 E0.02005
+G1 X50.602 Y59.180 E0.02005
+G1 X50.000 Y59.200 E0.02005
+G1 X49.398 Y59.180 E0.02005
+G1 X48.799 Y59.121 E0.02005
+G1 X48.205 Y59.023 E0.02005
+G1 X47.619 Y58.887 E0.02005
+G1 X47.043 Y58.712 E0.02005
+G1 X46.479 Y58.500 E0.02005
+G1 X45.931 Y58.251 E0.02005
+G1 X45.400 Y57.967 E0.02005
+G1 X44.889 Y57.650 E0.02005
+G1 X44.399 Y57.299 E0.02005
+G1 X43.934 Y56.917 E0.02005
+G1 X43.495 Y56.505 E0.02005
+G1 X43.083 Y56.066 E0.02005
+G1 X42.701 Y55.601 E0.02005
+G1 X42.350 Y55.111 E0.02005
+G1 X42.033 Y54.600 E0.02005
+G1 X41.749 Y54.069 E0.02005
+G1 X41.500 Y53.521 E0.02005
+G1 X41.288 Y52.957 E0.02005
+G1 X41.113 Y52.381 E0.02005
+G1 X40.977 Y51.795 E0.02005
+G1 X40.879 Y51.201 E0.02005
+G1 X40.820 Y50.602 E0.02005
+G1 X40.800 Y50.000 E0.02005
+G1 X40.820 Y49.398 E0.02005
+G1 X40.879 Y48.799 E0.02005
+G1 X40.977 Y48.205 E0.02005
+G1 X41.113 Y47.619 E0.02005
+G1 X41.288 Y47.043 E0.02005
+G1 X41.500 Y46.479 E0.02005
+G1 X41.749 Y45.931 E0.02005
+G1 X42.033 Y45.400 E0.02005
+G1 X42.350 Y44.889 E0.02005
+G1 X42.701 Y44.399 E0.02005
+G1 X43.083 Y43.934 E0.02005
+G1 X43.495 Y43.495 E0.02005
+G1 X43.934 Y43.083 E0.02005
+G1 X44.399 Y42.701 E0.02005
+G1 X44.889 Y42.350 E0.02005
+G1 X45.400 Y42.033 E0.02005
+G1 X45.931 Y41.749 E0.02005
+G1 X46.479 Y41.500 E0.02005
+G1 X47.043 Y41.288 E0.02005
+G1 X47.619 Y41.113 E0.02005
+G1 X48.205 Y40.977 E0.02005
+G1 X48.799 Y40.879 E0.02005
+G1 X49.398 Y40.820 E0.02005
+G1 X50.000 Y40.800 E0.02005
+G1 X50.602 Y40.820 E0.02005
+G1 X51.201 Y40.879 E0.02005
+G1 X51.795 Y40.977 E0.02005
+G1 X52.381 Y41.113 E0.02005
+G1 X52.957 Y41.288 E0.02005
+G1 X53.521 Y41.500 E0.02005
+G1 X54.069 Y41.749 E0.02005
+G1 X54.600 Y42.033 E0.02005
+G1 X55.111 Y42.350 E0.02005
+G1 X55.601 Y42.701 E0.02005
+G1 X56.066 Y43.083 E0.02005
+G1 X56.505 Y43.495 E0.02005
+G1 X56.917 Y43.934 E0.02005
+G1 X57.299 Y44.399 E0.02005
+G1 X57.650 Y44.889 E0.02005
+G1 X57.967 Y45.400 E0.02005
+G1 X58.251 Y45.931 E0.02005
+G1 X58.500 Y46.479 E0.02005
+G1 X58.712 Y47.043 E0.02005
+G1 X58.887 Y47.619 E0.02005
+G1 X59.023 Y48.205 E0.02005
+G1 X59.121 Y48.799 E0.02005
+G1 X59.180 Y49.398 E0.02005
+G1 X59.200 Y50.000 E0.02005
+G1 X58.800 Y50.000 F9000
+G1 F2400
+G1 X58.779 Y50.601 E0.02001
+G1 X58.718 Y51.198 E0.02001
+G1 X58.616 Y51.790 E0.02001
+G1 X58.474 Y52.374 E0.02001
+G1 X58.292 Y52.947 E0.02001
+G1 X58.071 Y53.506 E0.02001
+G1 X57.813 Y54.049 E0.02001
+G1 X57.519 Y54.572 E0.02001
+G1 X57.189 Y55.075 E0.02001
+G1 X56.826 Y55.554 E0.02001
+G1 X56.431 Y56.006 E0.02001
+G1 X56.006 Y56.431 E0.02001
+G1 X55.554 Y56.826 E0.02001
+G1 X55.075 Y57.189 E0.02001
+G1 X54.572 Y57.519 E0.02001
+G1 X54.049 Y57.813 E0.02001
+G1 X53.506 Y58.071 E0.02001
+G1 X52.947 Y58.292 E0.02001
+G1 X52.374 Y58.474 E0.02001
+G1 X51.790 Y58.616 E0.02001
+G1 X51.198 Y58.718 E0.02001
+G1 X50.601 Y58.779 E0.02001
+G1 X50.000 Y58.800 E0.02001
+G1 X49.399 Y58.779 E0.02001
+G1 X48.802 Y58.718 E0.02001
+G1 X48.210 Y58.616 E0.02001
+G1 X47.626 Y58.474 E0.02001
+G1 X47.053 Y58.292 E0.02001
+G1 X46.494 Y58.071 E0.02001
+G1 X45.951 Y57.813 E0.02001
+G1 X45.428 Y57.519 E0.02001
+G1 X44.925 Y57.189 E0.02001
+G1 X44.446 Y56.826 E0.02001
+G1 X43.994 Y56.431 E0.02001
+G1 X43.569 Y56.006 E0.02001
+G1 X43.174 Y55.554 E0.02001
+G1 X42.811 Y55.075 E0.02001
+G1 X42.481 Y54.572 E0.02001
+G1 X42.187 Y54.049 E0.02001
+G1 X41.929 Y53.506 E0.02001
+G1 X41.708 Y52.947 E0.02001
+G1 X41.526 Y52.374 E0.02001
+G1 X41.384 Y51.790 E0.02001
+G1 X41.282 Y51.198 E0.02001
+G1 X41.221 Y50.601 E0.02001
+G1 X41.200 Y50.000 E0.02001
+G1 X41.221 Y49.399 E0.02001
+G1 X41.282 Y48.802 E0.02001
+G1 X41.384 Y48.210 E0.02001
+G1 X41.526 Y47.626 E0.02001
+G1 X41.708 Y47.053 E0.02001
+G1 X41.929 Y46.494 E0.02001
+G1 X42.187 Y45.951 E0.02001
+G1 X42.481 Y45.428 E0.02001
+G1 X42.811 Y44.925 E0.02001
+G1 X43.174 Y44.446 E0.02001
+G1 X43.569 Y43.994 E0.02001
+G1 X43.994 Y43.569 E0.02001
+G1 X44.446 Y43.174 E0.02001
+G1 X44.925 Y42.811 E0.02001
+G1 X45.428 Y42.481 E0.02001
+G1 X45.951 Y42.187 E0.02001
+G1 X46.494 Y41.929 E0.02001
+G1 X47.053 Y41.708 E0.02001
+G1 X47.626 Y41.526 E0.02001
+G1 X48.210 Y41.384 E0.02001
+G1 X48.802 Y41.282 E0.02001
+G1 X49.399 Y41.221 E0.02001
+G1 X50.000 Y41.200 E0.02001
+G1 X50.601 Y41.221 E0.02001
+G1 X51.198 Y41.282 E0.02001
+G1 X51.790 Y41.384 E0.02001
+G1 X52.374 Y41.526 E0.02001
+G1 X52.947 Y41.708 E0.02001
+G1 X53.506 Y41.929 E0.02001
+G1 X54.049 Y42.187 E0.02001
+G1 X54.572 Y42.481 E0.02001
+G1 X55.075 Y42.811 E0.02001
+G1 X55.554 Y43.174 E0.02001
+G1 X56.006 Y43.569 E0.02001
+G1 X56.431 Y43.994 E0.02001
+G1 X56.826 Y44.446 E0.02001
+G1 X57.189 Y44.925 E0.02001
+G1 X57.519 Y45.428 E0.02001
+G1 X57.813 Y45.951 E0.02001
+G1 X58.071 Y46.494 E0.02001
+G1 X58.292 Y47.053 E0.02001
+G1 X58.474 Y47.626 E0.02001
+G1 X58.616 Y48.210 E0.02001
+G1 X58.718 Y48.802 E0.02001
+G1 X58.779 Y49.399 E0.02001
+G1 X58.800 Y50.000 E0.02001
+G1 F4800
+G1 X57.605 Y53.567
+G1 X53.567 Y57.605 E0.19013
+G1 X51.492 Y58.267
+G1 X58.267 Y51.492 E0.31906
+G1 X58.400 Y49.944
+G1 X49.944 Y58.400 E0.39821
+G1 X48.640 Y58.289
+G1 X58.289 Y48.640 E0.45440
+G1 X58.018 Y47.497
+G1 X47.497 Y58.018 E0.49549
+G1 X46.476 Y57.625
+G1 X57.625 Y46.476 E0.52504
+G1 X57.129 Y45.558
+G1 X45.558 Y57.129 E0.54494
+G1 X44.731 Y56.542
+G1 X56.542 Y44.731 E0.55622
+G1 X55.869 Y43.990
+G1 X43.990 Y55.869 E0.55940
+G1 X43.334 Y55.111
+G1 X55.111 Y43.334 E0.55462
+G1 X54.266 Y42.764
+G1 X42.764 Y54.266 E0.54168
+G1 X42.288 Y53.328
+G1 X53.328 Y42.288 E0.51995
+G1 X52.285 Y41.917
+G1 X41.917 Y52.285 E0.48827
+G1 X41.674 Y51.113
+G1 X51.113 Y41.674 E0.44453
+G1 X49.770 Y41.603
+G1 X41.603 Y49.770 E0.38461
+G1 X41.805 Y48.154
+G1 X48.154 Y41.805 E0.29896
+G1 X45.846 Y42.699
+G1 X42.699 Y45.846 E0.14818
+M400
+M122
@@ -0,0 +1,701 @@
+/*
+ * ObjectModelEncodingTest.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host test of the binary object model encoding that the SBC can ask for instead of JSON. It encodes a fixed object tree in both
+ *  encodings, decodes both of them and checks that they hold the same keys and values. Then it does the same for each top-level key
+ *  of the simulated firmware's object model, checking only the structure because live values can change between the two encodings.
+ *  It reports the size and encoding time of both encodings.
+ */
+
+#include "HostTest.h"
+#include "Check.h"
+#include <Platform/RepRap.h>
+#include <Platform/OutputMemory.h>
+#include <ObjectModel/BinaryObjectModelWriter.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+static constexpr unsigned int TimingPasses = 200;
+static constexpr const char *ReportFlags = "d99v";
+
+// Object model value decoded from either encoding
+struct DecodedValue
+{
+	enum class Kind : uint8_t { none, boolean, number, string, array, object };
+
+	Kind kind = Kind::none;
+	bool b = false;
+	int digits = -1;											// number of decimal places for a float in the binary encoding, else -1
+	double number = 0.0;
+	std::string str;
+	std::vector<DecodedValue> elements;
+	std::vector<std::pair<std::string, DecodedValue>> members;
+};
+
+// Decoder for the binary encoding described by BinaryObjectModelTag
+class BinaryDecoder
+{
+public:
+	BinaryDecoder(const std::string& data) noexcept : p(data.data()), end(data.data() + data.length()), ok(true) { }
+
+	bool Decode(DecodedValue& v) noexcept { ReadValue(v); return ok && p == end; }
+
+private:
+	bool ReadBytes(void *dst, size_t len) noexcept
+	{
+		if ((size_t)(end - p) < len)
+		{
+			ok = false;
+			return false;
+		}
+		memcpy(dst, p, len);
+		p += len;
+		return true;
+	}
+
+	BinaryObjectModelTag ReadTag() noexcept
+	{
+		uint8_t t = 0;
+		(void)ReadBytes(&t, 1);
+		return (BinaryObjectModelTag)t;
+	}
+
+	void ReadName(std::string& name) noexcept
+	{
+		uint8_t len = 0;
+		if (ReadBytes(&len, 1) && (size_t)(end - p) >= len)
+		{
+			name.assign(p, len);
+			p += len;
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+
+	// Read a key whose tag we have already read, returning false if the tag isn't a key tag
+	bool ReadKey(BinaryObjectModelTag tag, std::string& name) noexcept
+	{
+		switch (tag)
+		{
+		case BinaryObjectModelTag::newKey:
+			ReadName(name);
+			keyNames.push_back(name);
+			return true;
+
+		case BinaryObjectModelTag::literalKey:
+			ReadName(name);
+			return true;
+
+		case BinaryObjectModelTag::key:
+			{
+				uint8_t n = 0;
+				if (ReadBytes(&n, 1) && n < keyNames.size())
+				{
+					name = keyNames[n];
+					return true;
+				}
+			}
+			break;
+
+		default:
+			break;
+		}
+		ok = false;
+		return false;
+	}
+
+	void ReadValue(DecodedValue& v) noexcept
+	{
+		switch (ReadTag())
+		{
+		case BinaryObjectModelTag::nullValue:
+			v.kind = DecodedValue::Kind::none;
+			break;
+
+		case BinaryObjectModelTag::boolFalse:
+		case BinaryObjectModelTag::boolTrue:
+			v.kind = DecodedValue::Kind::boolean;
+			v.b = (p[-1] == (char)BinaryObjectModelTag::boolTrue);
+			break;
+
+		case BinaryObjectModelTag::int32:
+			{
+				int32_t i = 0;
+				(void)ReadBytes(&i, sizeof(i));
+				v.kind = DecodedValue::Kind::number;
+				v.number = i;
+			}
+			break;
+
+		case BinaryObjectModelTag::uint32:
+			{
+				uint32_t u = 0;
+				(void)ReadBytes(&u, sizeof(u));
+				v.kind = DecodedValue::Kind::number;
+				v.number = u;
+			}
+			break;
+
+		case BinaryObjectModelTag::uint64:
+			{
+				uint64_t u = 0;
+				(void)ReadBytes(&u, sizeof(u));
+				v.kind = DecodedValue::Kind::number;
+				v.number = (double)u;
+			}
+			break;
+
+		case BinaryObjectModelTag::float32:
+			{
+				uint8_t digits = 0;
+				float f = 0.0;
+				(void)ReadBytes(&digits, 1);
+				(void)ReadBytes(&f, sizeof(f));
+				v.kind = DecodedValue::Kind::number;
+				v.digits = digits;
+				v.number = f;
+			}
+			break;
+
+		case BinaryObjectModelTag::string:
+			{
+				uint16_t len = 0;
+				if (ReadBytes(&len, sizeof(len)) && (size_t)(end - p) >= len)
+				{
+					v.kind = DecodedValue::Kind::string;
+					v.str.assign(p, len);
+					p += len;
+				}
+				else
+				{
+					ok = false;
+				}
+			}
+			break;
+
+		case BinaryObjectModelTag::objectStart:
+			v.kind = DecodedValue::Kind::object;
+			while (ok)
+			{
+				const BinaryObjectModelTag tag = ReadTag();
+				if (tag == BinaryObjectModelTag::objectEnd)
+				{
+					break;
+				}
+				std::string name;
+				if (ReadKey(tag, name))
+				{
+					v.members.emplace_back(name, DecodedValue());
+					ReadValue(v.members.back().second);
+				}
+			}
+			break;
+
+		case BinaryObjectModelTag::arrayStart:
+			v.kind = DecodedValue::Kind::array;
+			while (ok)
+			{
+				if (p < end && *p == (char)BinaryObjectModelTag::arrayEnd)
+				{
+					++p;
+					break;
+				}
+				v.elements.emplace_back();
+				ReadValue(v.elements.back());
+			}
+			break;
+
+		default:
+			ok = false;
+			break;
+		}
+	}
+
+	const char *p;
+	const char *end;
+	bool ok;
+	std::vector<std::string> keyNames;
+};
+
+// Parser for the JSON that the firmware generates
+class JsonParser
+{
+public:
+	JsonParser(const std::string& data) noexcept : p(data.c_str()), ok(true) { }
+
+	bool Parse(DecodedValue& v) noexcept { ParseValue(v); SkipSpace(); return ok && *p == 0; }
+
+private:
+	void SkipSpace() noexcept
+	{
+		while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+		{
+			++p;
+		}
+	}
+
+	bool Expect(char c) noexcept
+	{
+		SkipSpace();
+		if (*p == c)
+		{
+			++p;
+			return true;
+		}
+		ok = false;
+		return false;
+	}
+
+	void ParseString(std::string& s) noexcept
+	{
+		if (!Expect('"'))
+		{
+			return;
+		}
+		while (*p != '"')
+		{
+			if (*p == 0)
+			{
+				ok = false;
+				return;
+			}
+			if (*p == '\\')
+			{
+				++p;
+				switch (*p)
+				{
+				case 'n':	s += '\n'; break;
+				case 'r':	s += '\r'; break;
+				case 't':	s += '\t'; break;
+				case 'u':
+					if (strlen(p) < 5)
+					{
+						ok = false;
+						return;
+					}
+					s += (char)StrHexToU32(std::string(p + 1, 4).c_str());
+					p += 4;
+					break;
+				case 0:		ok = false; return;
+				default:	s += *p; break;
+				}
+				++p;
+			}
+			else
+			{
+				s += *p++;
+			}
+		}
+		++p;
+	}
+
+	void ParseValue(DecodedValue& v) noexcept
+	{
+		SkipSpace();
+		if (*p == '{')
+		{
+			++p;
+			v.kind = DecodedValue::Kind::object;
+			SkipSpace();
+			if (*p == '}')
+			{
+				++p;
+				return;
+			}
+			while (ok)
+			{
+				std::string name;
+				ParseString(name);
+				if (!Expect(':'))
+				{
+					return;
+				}
+				v.members.emplace_back(name, DecodedValue());
+				ParseValue(v.members.back().second);
+				SkipSpace();
+				if (*p != ',')
+				{
+					(void)Expect('}');
+					break;
+				}
+				++p;
+			}
+		}
+		else if (*p == '[')
+		{
+			++p;
+			v.kind = DecodedValue::Kind::array;
+			SkipSpace();
+			if (*p == ']')
+			{
+				++p;
+				return;
+			}
+			while (ok)
+			{
+				v.elements.emplace_back();
+				ParseValue(v.elements.back());
+				SkipSpace();
+				if (*p != ',')
+				{
+					(void)Expect(']');
+					break;
+				}
+				++p;
+			}
+		}
+		else if (*p == '"')
+		{
+			v.kind = DecodedValue::Kind::string;
+			ParseString(v.str);
+		}
+		else if (strncmp(p, "null", 4) == 0)
+		{
+			p += 4;
+			v.kind = DecodedValue::Kind::none;
+		}
+		else if (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0)
+		{
+			v.kind = DecodedValue::Kind::boolean;
+			v.b = (*p == 't');
+			p += (v.b) ? 4 : 5;
+		}
+		else
+		{
+			char *endp;
+			v.kind = DecodedValue::Kind::number;
+			v.number = (strtod)(p, &endp);					// SafeStrtof would lose the precision of 64-bit integers, so bypass the macro that bans strtod
+			ok = ok && endp != p;
+			p = endp;
+		}
+	}
+
+	const char *p;
+	bool ok;
+};
+
+// Return true if the decoded JSON and binary values are the same. If 'compareValues' is false then only compare the structure.
+// A float in the binary encoding matches a JSON number if the JSON number is the float rounded to the number of decimal places given.
+static bool SameValue(const DecodedValue& json, const DecodedValue& bin, bool compareValues, const std::string& path) noexcept
+{
+	bool same = json.kind == bin.kind;
+	if (same)
+	{
+		switch (json.kind)
+		{
+		case DecodedValue::Kind::none:
+			break;
+
+		case DecodedValue::Kind::boolean:
+			same = !compareValues || json.b == bin.b;
+			break;
+
+		case DecodedValue::Kind::number:
+			if (compareValues)
+			{
+				const double tolerance = (bin.digits < 0) ? 0.0 : 0.5001 * pow(10.0, -bin.digits) + 1.0e-6 * fabs(bin.number);
+				same = fabs(json.number - bin.number) <= tolerance;
+			}
+			break;
+
+		case DecodedValue::Kind::string:
+			same = !compareValues || json.str == bin.str;
+			break;
+
+		case DecodedValue::Kind::array:
+			same = json.elements.size() == bin.elements.size();
+			for (size_t i = 0; same && i < json.elements.size(); ++i)
+			{
+				same = SameValue(json.elements[i], bin.elements[i], compareValues, path + "[" + std::to_string(i) + "]");
+			}
+			return same;												// we have already reported any difference in the elements
+
+		case DecodedValue::Kind::object:
+			same = json.members.size() == bin.members.size();
+			for (size_t i = 0; same && i < json.members.size(); ++i)
+			{
+				if (json.members[i].first != bin.members[i].first)
+				{
+					printf("%s: key %s in JSON but %s in binary\n", path.c_str(), json.members[i].first.c_str(), bin.members[i].first.c_str());
+					return false;
+				}
+				same = SameValue(json.members[i].second, bin.members[i].second, compareValues, path + "." + json.members[i].first);
+			}
+			return same;
+		}
+	}
+
+	if (!same)
+	{
+		printf("%s: JSON and binary values differ\n", path.c_str());
+	}
+	return same;
+}
+
+// Copy the contents of an output buffer chain into a string and release the buffers
+static std::string TakeBuffer(OutputBuffer *buf) noexcept
+{
+	std::string s;
+	for (const OutputBuffer *b = buf; b != nullptr; b = b->Next())
+	{
+		s.append(b->Data(), b->DataLength());
+	}
+	OutputBuffer::ReleaseAll(buf);
+	return s;
+}
+
+// The fixed object tree. An array of these is one of the values in it.
+class TestItem INHERIT_OBJECT_MODEL
+{
+public:
+	TestItem(const char *p_name, int32_t p_index, float p_value) noexcept : name(p_name), index(p_index), value(p_value) { }
+
+protected:
+	DECLARE_OBJECT_MODEL
+
+private:
+	const char *name;
+	int32_t index;
+	float value;
+};
+
+#define OBJECT_MODEL_FUNC(...) OBJECT_MODEL_FUNC_BODY(TestItem, __VA_ARGS__)
+
+constexpr ObjectModelTableEntry TestItem::objectModelTable[] =
+{
+	// These entries must be in alphabetical order
+	{ "index",		OBJECT_MODEL_FUNC(self->index),			ObjectModelEntryFlags::none },
+	{ "name",		OBJECT_MODEL_FUNC(self->name),			ObjectModelEntryFlags::none },
+	{ "value",		OBJECT_MODEL_FUNC(self->value, 2),		ObjectModelEntryFlags::live },
+};
+
+constexpr uint8_t TestItem::objectModelTableDescriptor[] = { 1, 3 };
+
+DEFINE_GET_OBJECT_MODEL_TABLE(TestItem)
+
+#undef OBJECT_MODEL_FUNC
+
+static const TestItem testItems[] =
+{
+	TestItem("first", 0, 1.25),
+	TestItem("second \"quoted\"", -7, -0.5),
+	TestItem("tab\tand\\backslash", 1000000, 12345.678),
+	TestItem("", 3, 0.0),
+};
+
+static const float testNumbers[] = { 0.0, 1.0, -1.5, 3.14159, 1.0e6, 0.001, NAN };
+
+class TestTree INHERIT_OBJECT_MODEL
+{
+protected:
+	DECLARE_OBJECT_MODEL
+	OBJECT_MODEL_ARRAY(items)
+	OBJECT_MODEL_ARRAY(numbers)
+};
+
+constexpr ObjectModelArrayDescriptor TestTree::itemsArrayDescriptor =
+{
+	nullptr,
+	[] (const ObjectModel *self, const ObjectExplorationContext&) noexcept -> size_t { return ARRAY_SIZE(testItems); },
+	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue { return ExpressionValue(&testItems[context.GetLastIndex()]); }
+};
+
+constexpr ObjectModelArrayDescriptor TestTree::numbersArrayDescriptor =
+{
+	nullptr,
+	[] (const ObjectModel *self, const ObjectExplorationContext&) noexcept -> size_t { return ARRAY_SIZE(testNumbers); },
+	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue { return ExpressionValue(testNumbers[context.GetLastIndex()], 3); }
+};
+
+#define OBJECT_MODEL_FUNC(...) OBJECT_MODEL_FUNC_BODY(TestTree, __VA_ARGS__)
+
+constexpr ObjectModelTableEntry TestTree::objectModelTable[] =
+{
+	// Within each group, these entries must be in alphabetical order
+	// 0. TestTree members
+	{ "bits",		OBJECT_MODEL_FUNC_NOSELF(Bitmap<uint32_t>::MakeFromRaw(0x80000015)),	ObjectModelEntryFlags::none },
+	{ "disabled",	OBJECT_MODEL_FUNC_NOSELF(false),										ObjectModelEntryFlags::none },
+	{ "enabled",	OBJECT_MODEL_FUNC_NOSELF(true),											ObjectModelEntryFlags::none },
+	{ "items",		OBJECT_MODEL_FUNC_NOSELF(&itemsArrayDescriptor),						ObjectModelEntryFlags::live },
+	{ "letter",		OBJECT_MODEL_FUNC_NOSELF('X'),											ObjectModelEntryFlags::none },
+	{ "missing",	OBJECT_MODEL_FUNC_NOSELF(nullptr),										ObjectModelEntryFlags::none },
+	{ "name",		OBJECT_MODEL_FUNC_NOSELF("Test tree"),									ObjectModelEntryFlags::none },
+	{ "negative",	OBJECT_MODEL_FUNC_NOSELF((int32_t)-123456),								ObjectModelEntryFlags::none },
+	{ "numbers",	OBJECT_MODEL_FUNC_NOSELF(&numbersArrayDescriptor),						ObjectModelEntryFlags::none },
+	{ "position",	OBJECT_MODEL_FUNC(self, 1),												ObjectModelEntryFlags::live },
+	{ "total",		OBJECT_MODEL_FUNC_NOSELF((uint64_t)123456789012),						ObjectModelEntryFlags::none },
+
+	// 1. position members
+	{ "x",			OBJECT_MODEL_FUNC_NOSELF(10.5, 3),										ObjectModelEntryFlags::live },
+	{ "y",			OBJECT_MODEL_FUNC_NOSELF(-0.125, 3),									ObjectModelEntryFlags::live },
+	{ "z",			OBJECT_MODEL_FUNC_NOSELF(0.2, 2),										ObjectModelEntryFlags::live },
+};
+
+constexpr uint8_t TestTree::objectModelTableDescriptor[] = { 2, 11, 3 };
+
+DEFINE_GET_OBJECT_MODEL_TABLE(TestTree)
+
+#undef OBJECT_MODEL_FUNC
+
+static TestTree testTree;
+
+// Encode the fixed tree in JSON and return the encoded data
+static std::string EncodeTreeAsJson() noexcept
+{
+	OutputBuffer *buf;
+	if (!OutputBuffer::Allocate(buf))
+	{
+		return std::string();
+	}
+	try
+	{
+		testTree.ReportAsJson(buf, "", ReportFlags, false);
+	}
+	catch (const GCodeException&)
+	{
+		OutputBuffer::ReleaseAll(buf);
+		return std::string();
+	}
+	return TakeBuffer(buf);
+}
+
+// Encode the fixed tree in binary and return the encoded data
+static std::string EncodeTreeAsBinary(BinaryObjectModelWriter& writer) noexcept
+{
+	OutputBuffer *buf;
+	if (!OutputBuffer::Allocate(buf))
+	{
+		return std::string();
+	}
+	try
+	{
+		writer.Start(buf);
+		testTree.ReportAsBinary(writer, "", ReportFlags);
+	}
+	catch (const GCodeException&)
+	{
+		OutputBuffer::ReleaseAll(buf);
+		return std::string();
+	}
+	return TakeBuffer(buf);
+}
+
+// Encode a top-level key of the firmware's object model in JSON, the same way as the SBC interface does
+static std::string EncodeModelAsJson(const char *key) noexcept
+{
+	try
+	{
+		OutputBuffer * const buf = reprap.GetModelResponse(key, ReportFlags);
+		return (buf == nullptr) ? std::string() : TakeBuffer(buf);
+	}
+	catch (const GCodeException&)
+	{
+		return std::string();
+	}
+}
+
+// Encode a top-level key of the firmware's object model in binary, the same way as the SBC interface does
+static std::string EncodeModelAsBinary(BinaryObjectModelWriter& writer, const char *key) noexcept
+{
+	const std::string flags = std::string(ReportFlags) + "b";
+	try
+	{
+		OutputBuffer * const buf = reprap.GetBinaryModelResponse(writer, key, flags.c_str());
+		return (buf == nullptr) ? std::string() : TakeBuffer(buf);
+	}
+	catch (const GCodeException&)
+	{
+		return std::string();
+	}
+}
+
+// Return the average time in microseconds that an encoding function takes
+template<class F> static double TimeEncoding(F encode) noexcept
+{
+	const uint64_t startTime = HostNanoseconds();
+	for (unsigned int i = 0; i < TimingPasses; ++i)
+	{
+		(void)encode();
+	}
+	return (double)(HostNanoseconds() - startTime) * 1.0e-3/TimingPasses;
+}
+
+// Decode both encodings and compare them, returning true if they are the same
+static bool CompareEncodings(const std::string& json, const std::string& binary, bool compareValues, const char *name) noexcept
+{
+	DecodedValue jsonValue, binaryValue;
+	const bool jsonOk = JsonParser(json).Parse(jsonValue);
+	const bool binaryOk = BinaryDecoder(binary).Decode(binaryValue);
+	if (!jsonOk)
+	{
+		printf("%s: can't parse the JSON\n", name);
+	}
+	if (!binaryOk)
+	{
+		printf("%s: can't decode the binary\n", name);
+	}
+	return jsonOk && binaryOk && SameValue(jsonValue, binaryValue, compareValues, name);
+}
+
+static void ReportSizes(const char *name, size_t jsonBytes, double jsonTime, size_t binaryBytes, double binaryTime) noexcept
+{
+	printf("%-12s JSON %6u bytes %8.1fus, binary %6u bytes %8.1fus, size ratio %.2f, time ratio %.2f\n",
+			name, (unsigned int)jsonBytes, jsonTime, (unsigned int)binaryBytes, binaryTime, (double)binaryBytes/(double)jsonBytes, binaryTime/jsonTime);
+}
+
+int RunHostTest(int argc, char *argv[]) noexcept
+{
+	BinaryObjectModelWriter * const writer = new BinaryObjectModelWriter;
+
+	// Check the fixed tree value by value
+	{
+		const std::string json = EncodeTreeAsJson();
+		const std::string binary = EncodeTreeAsBinary(*writer);
+		CHECK(json.length() != 0);
+		CHECK(binary.length() != 0);
+		CHECK(CompareEncodings(json, binary, true, "tree"));
+		ReportSizes("tree", json.length(), TimeEncoding([]() noexcept { return EncodeTreeAsJson(); }),
+					binary.length(), TimeEncoding([writer]() noexcept { return EncodeTreeAsBinary(*writer); }));
+	}
+
+	// Check the structure of the firmware's object model, one top-level key at a time as the SBC requests it
+	static constexpr const char *TopLevelKeys[] =
+	{
+		"boards", "directories", "fans", "global", "heat", "inputs", "job", "limits", "move", "network", "sensors", "spindles", "state", "tools", "volumes"
+	};
+
+	size_t totalJsonBytes = 0, totalBinaryBytes = 0;
+	double totalJsonTime = 0.0, totalBinaryTime = 0.0;
+	for (const char *key : TopLevelKeys)
+	{
+		const std::string json = EncodeModelAsJson(key);
+		const std::string binary = EncodeModelAsBinary(*writer, key);
+		CHECK(json.length() != 0);
+		CHECK(binary.length() != 0);
+		CHECK(CompareEncodings(json, binary, false, key));
+		const double jsonTime = TimeEncoding([key]() noexcept { return EncodeModelAsJson(key); });
+		const double binaryTime = TimeEncoding([writer, key]() noexcept { return EncodeModelAsBinary(*writer, key); });
+		ReportSizes(key, json.length(), jsonTime, binary.length(), binaryTime);
+		totalJsonBytes += json.length();
+		totalBinaryBytes += binary.length();
+		totalJsonTime += jsonTime;
+		totalBinaryTime += binaryTime;
+	}
+	ReportSizes("total", totalJsonBytes, totalJsonTime, totalBinaryBytes, totalBinaryTime);
+
+	delete writer;
+	return CheckResult("ObjectModelEncodingTest");
+}
+
+// End
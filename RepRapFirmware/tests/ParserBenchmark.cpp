@@ -0,0 +1,160 @@
+/*
+ * ParserBenchmark.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: agent
+ *  License: GNU GPL v3
+ *
+ *  Host benchmark of the string G-code parser. It feeds a G-code file through a GCodeBuffer and queries each command's parameters
+ *  the way the G0/G1 handler does, first using the parameter index that DecodeCommand builds and then scanning for each parameter
+ *  as Seen() did before the index existed. It checks that both methods return the same results and reports the lines per second.
+ *
+ *  Usage: ParserBenchmark [file.g [passes]]
+ *  The default file is MoveBenchmark.g, which was recorded from slicer output and is mostly G1 commands.
+ */
+
+#include "HostTest.h"
+#include "Check.h"
+#include <GCodes/GCodeBuffer/GCodeBuffer.h>
+#include <GCodes/GCodeBuffer/StringParser.h>
+#include <GCodes/GCodeException.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static constexpr const char *DefaultFile = "MoveBenchmark.g";
+static constexpr unsigned int DefaultPasses = 200;
+
+// The parameters that DoStraightMove looks for, in the order it looks for them, for a machine with three axes and one extruder
+static constexpr const char *QueriedLetters = "HRSPXYZEF";
+
+// Lines that aren't typical of slicer output, to check that the index finds the same parameters as the scan does
+static constexpr const char *ExtraLines[] =
+{
+	"G1 X{1+2} Y{move.axes[0].max} E0.5 F1200\n",
+	"M98 P\"X Y.g\" S3\n",
+	"G1 H1 R2 S1 P'X X10 Y5 E-1\n",
+	"G1 Z{var.missing} X1\n",
+	"M117 \"Set F to 100\" ; comment with X and Y\n",
+	"g1 x5 y6 e1e-3 f300\n",
+	"G1 X5 G1 Y6\n",
+};
+
+// Read the file and return the lines in it followed by the extra lines
+static std::vector<std::string> ReadLines(const char *fileName) noexcept
+{
+	std::vector<std::string> lines;
+	FILE * const f = fopen(fileName, "r");
+	if (f != nullptr)
+	{
+		char line[GCODE_LENGTH];
+		while (fgets(line, sizeof(line), f) != nullptr)
+		{
+			lines.emplace_back(line);
+		}
+		fclose(f);
+		lines.insert(lines.end(), std::begin(ExtraLines), std::end(ExtraLines));
+	}
+	return lines;
+}
+
+// Decode every line and query its parameters. If 'results' isn't null, record which parameters were seen and their values.
+static void ParseLines(GCodeBuffer& gb, const std::vector<std::string>& lines, std::vector<float> *results) noexcept
+{
+	for (const std::string& line : lines)
+	{
+		gb.PutAndDecode(line.c_str(), line.length());
+		if (gb.GetCommandLetter() != 'G' && gb.GetCommandLetter() != 'M')
+		{
+			continue;
+		}
+		for (const char *p = QueriedLetters; *p != 0; ++p)
+		{
+			float val;
+			if (!gb.Seen(*p))
+			{
+				val = -INFINITY;
+			}
+			else
+			{
+				try
+				{
+					val = gb.GetFValue();
+				}
+				catch (const GCodeException&)
+				{
+					val = NAN;
+				}
+			}
+			if (results != nullptr)
+			{
+				results->push_back(val);
+			}
+		}
+	}
+}
+
+// Parse the lines for the requested number of passes and return the lines per second
+static double TimeParsing(GCodeBuffer& gb, const std::vector<std::string>& lines, unsigned int passes) noexcept
+{
+	const uint64_t startTime = HostNanoseconds();
+	for (unsigned int i = 0; i < passes; ++i)
+	{
+		ParseLines(gb, lines, nullptr);
+	}
+	const uint64_t elapsedTime = HostNanoseconds() - startTime;
+	return (double)lines.size() * passes * 1.0e9/(double)elapsedTime;
+}
+
+// Return true if the results are the same, treating NaNs as equal
+static bool SameResults(const std::vector<float>& a, const std::vector<float>& b) noexcept
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i] != b[i] && !(std::isnan(a[i]) && std::isnan(b[i])))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int RunHostTest(int argc, char *argv[]) noexcept
+{
+	const char * const fileName = (argc >= 1) ? argv[0] : DefaultFile;
+	const unsigned int passes = (argc >= 2) ? (unsigned int)StrToU32(argv[1]) : DefaultPasses;
+	const std::vector<std::string> lines = ReadLines(fileName);
+	CHECK(lines.size() > ARRAY_SIZE(ExtraLines));
+
+	GCodeBuffer * const gb = new GCodeBuffer(GCodeChannel::File, nullptr, nullptr, GenericMessage);
+
+	std::vector<float> indexedResults, scannedResults;
+	StringParser::useParameterIndex = true;
+	ParseLines(*gb, lines, &indexedResults);
+	const double indexedRate = TimeParsing(*gb, lines, passes);
+
+	StringParser::useParameterIndex = false;
+	ParseLines(*gb, lines, &scannedResults);
+	const double scannedRate = TimeParsing(*gb, lines, passes);
+	StringParser::useParameterIndex = true;
+
+	CHECK(indexedResults.size() != 0);
+	CHECK(SameResults(indexedResults, scannedResults));
+
+	printf("%s: %u lines, %u passes, %u parameters queried per G or M command\n", fileName, (unsigned int)lines.size(), passes, (unsigned int)strlen(QueriedLetters));
+	printf("Indexed Seen(): %.0f lines/sec\n", indexedRate);
+	printf("Scanning Seen(): %.0f lines/sec\n", scannedRate);
+	printf("Speedup: %.2f\n", indexedRate/scannedRate);
+	delete gb;
+	return CheckResult("ParserBenchmark");
+}
+
+// End
@@ -0,0 +1,21 @@
+; Smoke test for the host simulation. "make check" replays this file and checks the final positions reported by M114,
+; with and without acceleration smoothing.
+M92 X80 Y80 Z400
+M203 X12000 Y12000 Z600
+M201 X3000 Y3000 Z200
+M564 H0 S0
+G90
+G1 X10 Y10 F6000
+G1 X50 Y20
+G1 X0 Y0
+G1 X20 Y60 Z0.5
+M400
+M114
+; Repeat the moves with acceleration smoothing, which must end at the same position
+M204 J0.02
+G1 X50 Y20
+G1 X0 Y0
+G1 X20 Y60 Z0.5
+M400
+M114
+M122